@@ -11,12 +11,18 @@ Modes:
 - CPython baseline
 - JIT Object Mode (full Python compatibility)
 - JIT Integer Mode (native int64)
+
+Timings use the calibrated loops of benchmarks/harness.py; run that script
+for the full suite (every mode, cold compile and first call, JSON output).
 """
 
 import justjit
-import time
+import os
 import sys
 
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "benchmarks"))
+from harness import measure  # noqa: E402
+
 
 # ============================================================================
 # Test Suite - CPython Baseline
@@ -399,25 +405,15 @@ def gcd_int(a, b):
 # Utilities
 # ============================================================================
 
-def benchmark(func, *args, warmup=3, iterations=10):
-    for _ in range(warmup):
-        try:
-            func(*args)
-        except:
-            return -1, None
-    
-    times = []
-    for _ in range(iterations):
-        start = time.perf_counter()
-        try:
-            result = func(*args)
-        except:
-            return -1, None
-        end = time.perf_counter()
-        times.append((end - start) * 1000)
-    
-    times.sort()
-    return times[len(times) // 2], result
+def benchmark(func, *args):
+    """Median ms per call of ``func(*args)``, and its result."""
+    try:
+        result = func(*args)
+        values = measure(lambda: func(*args))["values"]
+    except Exception:
+        return -1, None
+    values.sort()
+    return values[len(values) // 2] * 1000, result
 
 
 def verify(name, py_func, obj_func, int_func, *args):
@@ -0,0 +1,400 @@
+"""
+Benchmark cases for benchmarks/harness.py.
+
+Each case pairs a plain Python function (the CPython baseline) with the
+``@jit`` options it is compiled with and the arguments it is timed on.
+Kernels live at module level so the JIT can read their bytecode; the
+harness decorates them itself, inside the timed region, so the cold
+compile is measured on every run.
+"""
+
+import array
+import asyncio
+from collections import namedtuple
+
+
+# name:     unique case name (the --filter and JSON key)
+# group:    "mode", "generator", "coroutine", "inline_c" or "macro"
+# mode:     @jit mode, or None for inline C
+# func:     kernel (for inline C, the C source)
+# make_args: () -> args tuple, built fresh in each worker
+# options:  extra @jit keywords (inline_c keywords for inline C)
+# runner:   how one timed call is made: "call", "drain" (exhaust a
+#           generator), "await" (drive a coroutine to completion) or
+#           "asyncio" (asyncio.run the coroutine)
+Case = namedtuple("Case", "name group mode func make_args options runner")
+
+
+# ============================================================================
+# Kernels
+# ============================================================================
+
+def obj_mul_sum(a, b):
+    total = 0
+    for x in a:
+        total = total + x * b
+    return total
+
+
+def int_sum(n):
+    total = 0
+    i = 0
+    while i < n:
+        total = total + i
+        i = i + 1
+    return total
+
+
+def int_gcd(a, b):
+    while b != 0:
+        t = b
+        b = a % b
+        a = t
+    return a
+
+
+def float_poly(x, n):
+    acc = 0.0
+    i = 0.0
+    while i < n:
+        acc = acc + x * i * i + 0.5
+        i = i + 1.0
+    return acc
+
+
+def bool_xor(a, b):
+    return (a or b) and not (a and b)
+
+
+def int32_mix(a, b):
+    i = 0
+    while i < b:
+        a = a * 3 + 1
+        i = i + 1
+    return a
+
+
+def float32_loop(x, n):
+    acc = 0.0
+    i = 0.0
+    while i < n:
+        acc = acc + x * i
+        i = i + 1.0
+    return acc
+
+
+def complex_step(z, c):
+    return z * z + c
+
+
+def optional_add(a, b):
+    return a + b
+
+
+def ptr_get(arr, i):
+    return arr[i]
+
+
+def vec_axpy(a, b):
+    return a * 2.0 + b
+
+
+def ndarray_dot(a, b):
+    total = 0.0
+    for i in range(a.size):
+        total += a[i] * b[i]
+    return total
+
+
+def gen_count(n):
+    i = 0
+    while i < n:
+        yield i
+        i = i + 1
+
+
+def int_gen_squares(n):
+    i = 0
+    while i < n:
+        yield i * i
+        i = i + 1
+
+
+async def coro_chain(n):
+    total = 0
+    for i in range(n):
+        total = total + i
+    return total
+
+
+C_SUM = """
+long long c_sum(long long n) {
+    long long total = 0;
+    for (long long i = 0; i < n; i++) total += i;
+    return total;
+}
+"""
+
+
+# ============================================================================
+# Macro kernels: object-mode workloads (attributes, containers, method
+# calls, formatting, exceptions). Helpers they call stay interpreted, so the
+# numbers are end to end, as in an application.
+# ============================================================================
+
+def nbody(bodies, steps):
+    """Advance a list of [x, y, z, vx, vy, vz, mass] bodies; return the energy."""
+    bodies = [list(b) for b in bodies]  # Every call starts from the same state
+    dt = 0.01
+    n = len(bodies)
+    for _ in range(steps):
+        for i in range(n):
+            b1 = bodies[i]
+            for j in range(i + 1, n):
+                b2 = bodies[j]
+                dx = b1[0] - b2[0]
+                dy = b1[1] - b2[1]
+                dz = b1[2] - b2[2]
+                d2 = dx * dx + dy * dy + dz * dz
+                mag = dt / (d2 * d2 ** 0.5)
+                m1 = b1[6] * mag
+                m2 = b2[6] * mag
+                b1[3] -= dx * m2
+                b1[4] -= dy * m2
+                b1[5] -= dz * m2
+                b2[3] += dx * m1
+                b2[4] += dy * m1
+                b2[5] += dz * m1
+        for b in bodies:
+            b[0] += dt * b[3]
+            b[1] += dt * b[4]
+            b[2] += dt * b[5]
+    energy = 0.0
+    for b in bodies:
+        energy += 0.5 * b[6] * (b[3] * b[3] + b[4] * b[4] + b[5] * b[5])
+    return energy
+
+
+def _bodies():
+    return [[float(i), float(i * 2 % 5), float(i * 3 % 7), 0.01 * i, -0.02 * i, 0.005, 1.0 + i]
+            for i in range(5)]
+
+
+class Task:
+    """Richards-style task: a priority, a packet count and a state."""
+
+    __slots__ = ("name", "priority", "work", "done", "next_task")
+
+    def __init__(self, name, priority, work):
+        self.name = name
+        self.priority = priority
+        self.work = work
+        self.done = 0
+        self.next_task = None
+
+    def step(self, packet):
+        self.done += 1
+        self.work -= 1
+        return packet + self.priority
+
+
+def schedule(tasks, rounds):
+    """Round-robin the runnable tasks, richards style, through a linked list."""
+    head = None
+    for task in tasks:
+        task.work = rounds
+        task.done = 0
+        task.next_task = head
+        head = task
+    packet = 0
+    runnable = len(tasks)
+    while runnable:
+        task = head
+        prev = None
+        while task is not None:
+            if task.work > 0:
+                packet = task.step(packet) % 1000
+                if task.work == 0:
+                    runnable -= 1
+                    if prev is None:
+                        head = task.next_task
+                    else:
+                        prev.next_task = task.next_task
+            prev = task
+            task = task.next_task
+    return packet + sum(t.done for t in tasks)
+
+
+def _tasks():
+    return ([Task(f"t{i}", i % 4 + 1, 0) for i in range(10)], 200)
+
+
+def tree_walk(doc):
+    """Walk a JSON-like document: count nodes, sum numbers, collect keys."""
+    stack = [doc]
+    nodes = 0
+    total = 0
+    keys = set()
+    while stack:
+        node = stack.pop()
+        nodes += 1
+        if isinstance(node, dict):
+            for key, value in node.items():
+                keys.add(key)
+                stack.append(value)
+        elif isinstance(node, list):
+            stack.extend(node)
+        elif isinstance(node, (int, float)) and not isinstance(node, bool):
+            total += node
+    return nodes, total, len(keys)
+
+
+def _document():
+    def make(depth, seed):
+        if depth == 0:
+            return [seed, seed * 0.5, f"s{seed}", True, None]
+        return {f"k{depth}_{i}": make(depth - 1, seed + i) for i in range(4)}
+    return (make(4, 1),)
+
+
+def render(template, rows):
+    """Tiny template renderer: {{name}} substitution plus filters and formatting."""
+    out = []
+    parts = template.split("{{")
+    for row in rows:
+        line = [parts[0]]
+        for part in parts[1:]:
+            field, _, rest = part.partition("}}")
+            name, _, filt = field.strip().partition("|")
+            value = row.get(name, "")
+            if filt == "upper":
+                value = str(value).upper()
+            elif filt == "money":
+                value = f"{value:,.2f}"
+            line.append(str(value))
+            line.append(rest)
+        out.append("".join(line))
+    return "\n".join(out)
+
+
+def _render_args():
+    rows = [{"name": f"item{i}", "qty": i, "price": i * 3.25, "owner": "dept"} for i in range(200)]
+    return ("<tr><td>{{ name|upper }}</td><td>{{qty}}</td><td>{{price|money}}</td><td>{{owner}}</td></tr>", rows)
+
+
+def parse_numbers(tokens):
+    """Parse mixed tokens, counting the ones that raise."""
+    total = 0
+    bad = 0
+    for token in tokens:
+        try:
+            total += int(token)
+        except ValueError:
+            try:
+                total += int(float(token))
+            except ValueError:
+                bad += 1
+    return total, bad
+
+
+def _tokens():
+    return ([str(i) if i % 3 else f"{i}.5" if i % 2 else f"x{i}" for i in range(2000)],)
+
+
+def log_pipeline(lines):
+    """Generator stage: skip comments, split key=value, convert, filter."""
+    for line in lines:
+        if not line or line.startswith("#"):
+            continue
+        key, sep, value = line.partition("=")
+        if not sep:
+            continue
+        number = int(value)
+        if number % 2 == 0:
+            yield key.strip(), number
+
+
+def _log_lines():
+    return ([f"key{i} = {i}" if i % 5 else f"# comment {i}" for i in range(5000)],)
+
+
+async def echo_roundtrips(count):
+    """Start an asyncio echo server on localhost and send it `count` lines."""
+    async def handle(reader, writer):
+        while True:
+            line = await reader.readline()
+            if not line:
+                break
+            writer.write(line)
+        writer.close()
+
+    server = await asyncio.start_server(handle, "127.0.0.1", 0)
+    port = server.sockets[0].getsockname()[1]
+    reader, writer = await asyncio.open_connection("127.0.0.1", port)
+    received = 0
+    for i in range(count):
+        writer.write(b"ping %d\n" % i)
+        received += len(await reader.readline())
+    writer.close()
+    await writer.wait_closed()
+    server.close()
+    await server.wait_closed()
+    return received
+
+
+# ============================================================================
+# Cases
+# ============================================================================
+
+def _f64(n):
+    return array.array("d", (float(i) for i in range(n)))
+
+
+_buffers = []
+
+
+def _ptr_args():
+    buf = _f64(64)
+    _buffers.append(buf)  # ptr mode gets the raw address; keep the buffer alive
+    addr, _ = buf.buffer_info()
+    return (addr, 17)
+
+
+CASES = [
+    Case("object_mul_sum", "mode", "object", obj_mul_sum, lambda: (list(range(1000)), 3), {}, "call"),
+    Case("int_sum_while", "mode", "int", int_sum, lambda: (100_000,), {}, "call"),
+    Case("int_gcd", "mode", "int", int_gcd, lambda: (987654321, 123456789), {}, "call"),
+    Case("float_poly", "mode", "float", float_poly, lambda: (1.5, 10_000.0), {}, "call"),
+    Case("bool_xor", "mode", "bool", bool_xor, lambda: (True, False), {}, "call"),
+    Case("int32_mix", "mode", "int32", int32_mix, lambda: (1, 1000), {}, "call"),
+    Case("float32_loop", "mode", "float32", float32_loop, lambda: (1.5, 1000.0), {}, "call"),
+    Case("complex128_step", "mode", "complex128", complex_step, lambda: (0.5 + 0.5j, -0.4 + 0.6j), {}, "call"),
+    Case("complex64_step", "mode", "complex64", complex_step, lambda: (0.5 + 0.5j, -0.4 + 0.6j), {}, "call"),
+    Case("optional_f64_add", "mode", "optional_f64", optional_add, lambda: (1.5, 2.5), {}, "call"),
+    Case("ptr_get", "mode", "ptr", ptr_get, _ptr_args, {}, "call"),
+    Case("vec4f_axpy", "mode", "vec4f", vec_axpy,
+         lambda: (array.array("f", range(4096)), array.array("f", range(4096))), {}, "call"),
+    Case("ndarray_dot", "mode", "ndarray", ndarray_dot, lambda: (_f64(10_000), _f64(10_000)), {}, "call"),
+    Case("generator_count", "generator", "auto", gen_count, lambda: (10_000,), {}, "drain"),
+    Case("int_generator_squares", "generator", "int", int_gen_squares, lambda: (10_000,), {}, "drain"),
+    Case("coroutine_sum", "coroutine", "auto", coro_chain, lambda: (1000,), {}, "await"),
+    Case("inline_c_sum", "inline_c", None, C_SUM, lambda: (100_000,), {}, "call"),
+    Case("macro_nbody", "macro", "object", nbody, lambda: (_bodies(), 200), {}, "call"),
+    Case("macro_scheduler", "macro", "object", schedule, _tasks, {}, "call"),
+    Case("macro_tree_walk", "macro", "object", tree_walk, _document, {}, "call"),
+    Case("macro_template", "macro", "object", render, _render_args, {}, "call"),
+    Case("macro_exceptions", "macro", "object", parse_numbers, _tokens, {}, "call"),
+    Case("macro_generator_pipeline", "macro", "auto", log_pipeline, _log_lines, {}, "drain"),
+    Case("macro_asyncio_echo", "macro", "auto", echo_roundtrips, lambda: (200,), {}, "asyncio"),
+]
+
+# Python equivalents timed as the baseline of inline C cases
+C_BASELINES = {"inline_c_sum": int_sum}
+
+
+def find(name):
+    """Return the case called ``name``."""
+    for case in CASES:
+        if case.name == name:
+            return case
+    raise KeyError(name)
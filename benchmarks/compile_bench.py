@@ -0,0 +1,497 @@
+"""
+Compile latency and memory of the JIT itself.
+
+The harness times compiled code; this script times the compiler. Each case
+is one function of a corpus, compiled once in a fresh interpreter with the
+object cache disabled, through one compile entry point:
+
+- object:    JITCore::compile_function (object mode)
+- generator: JITCore::compile_generator, and compile_typed_generator for
+             generators in an int mode
+- int, float, bool, int32, float32, complex128:
+             the typed compile_*_function of that mode
+- inline_c:  InlineCCompiler::compile_and_execute
+
+The corpus has three sizes: small kernels, medium hand-written functions
+(a tokenizer, Collatz and prime counting loops, an integrator, C matrix
+and statistics routines) and huge machine-generated ones (the shapes of
+compile_scaling.py, and a generated C function).
+
+Reported per case, as the median over --processes interpreters:
+
+- decorate_ms: wall time of @jit(lazy=False) or inline_c
+- first_call_ms: the first call afterwards (lazy codegen, if any)
+- ir_ms, optimize_ms, codegen_ms: the JIT's phases, from justjit.stats()
+  (None for inline C, which records no stats)
+- ir_instructions, optimized_instructions, code_size: module size before
+  and after optimization, and bytes of machine code (inline C: instruction
+  lines of the last IR only)
+- peak_rss_delta_kb: growth of the process's peak RSS across the compile
+  (None where the resource module is missing, e.g. Windows)
+
+Usage:
+    python benchmarks/compile_bench.py
+    python benchmarks/compile_bench.py --filter huge_ --processes 5
+    python benchmarks/compile_bench.py --size small --json compile.json
+"""
+
+import argparse
+import dis
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+from collections import namedtuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import compile_scaling  # noqa: E402
+
+SCHEMA_VERSION = 1
+
+
+# name:   unique case name (the --filter and JSON key)
+# size:   "small", "medium" or "huge"
+# entry:  compile entry point measured (see the module docstring)
+# mode:   @jit mode, or None for inline C
+# source: () -> Python source defining `kernel` (C source for inline C)
+# args:   arguments of the first call (None: no call)
+Case = namedtuple("Case", "name size entry mode source args")
+
+
+# ============================================================================
+# Corpus
+# ============================================================================
+
+def _text(source):
+    return lambda: source
+
+
+SMALL_INT = """
+def kernel(a, b):
+    while b != 0:
+        a, b = b, a % b
+    return a
+"""
+
+SMALL_FLOAT = """
+def kernel(x, n):
+    acc = 0.0
+    i = 0.0
+    while i < n:
+        acc = acc + x * i * i + 0.5
+        i = i + 1.0
+    return acc
+"""
+
+SMALL_BOOL = """
+def kernel(a, b):
+    return (a or b) and not (a and b)
+"""
+
+SMALL_INT32 = """
+def kernel(x, lo, hi):
+    if x < lo:
+        return lo
+    if x > hi:
+        return hi
+    return x
+"""
+
+SMALL_FLOAT32 = """
+def kernel(a, b, t):
+    return a + (b - a) * t
+"""
+
+SMALL_COMPLEX = """
+def kernel(z, w):
+    return z * w + w / (z + 1)
+"""
+
+SMALL_OBJECT = """
+def kernel(words):
+    counts = {}
+    for word in words:
+        counts[word] = counts.get(word, 0) + 1
+    return counts
+"""
+
+SMALL_GENERATOR = """
+def kernel(n):
+    i = 0
+    while i < n:
+        yield i * i
+        i += 1
+"""
+
+SMALL_C = """
+long dot(long *a, long *b, long n) {
+    long total = 0;
+    for (long i = 0; i < n; i++) total += a[i] * b[i];
+    return total;
+}
+"""
+
+MEDIUM_OBJECT = """
+def kernel(text):
+    tokens = []
+    i = 0
+    n = len(text)
+    while i < n:
+        c = text[i]
+        if c.isspace():
+            i += 1
+        elif c.isdigit():
+            start = i
+            while i < n and (text[i].isdigit() or text[i] == "."):
+                i += 1
+            try:
+                tokens.append(("num", int(text[start:i])))
+            except ValueError:
+                tokens.append(("num", float(text[start:i])))
+        elif c.isalpha() or c == "_":
+            start = i
+            while i < n and (text[i].isalnum() or text[i] == "_"):
+                i += 1
+            word = text[start:i]
+            kind = "kw" if word in ("if", "else", "while", "return") else "name"
+            tokens.append((kind, word))
+        elif c in "\\"'":
+            end = text.find(c, i + 1)
+            if end < 0:
+                raise SyntaxError(f"unterminated string at {i}")
+            tokens.append(("str", text[i + 1:end]))
+            i = end + 1
+        elif text.startswith(("==", "!=", "<=", ">="), i):
+            tokens.append(("op", text[i:i + 2]))
+            i += 2
+        else:
+            tokens.append(("op", c))
+            i += 1
+    return tokens
+"""
+
+MEDIUM_INT = """
+def kernel(n, rounds):
+    best = 0
+    steps_total = 0
+    for start in range(1, n):
+        x = start
+        steps = 0
+        while x != 1 and steps < rounds:
+            if x % 2 == 0:
+                x = x // 2
+            elif x % 3 == 0:
+                x = x // 3 * 2 + 1
+            else:
+                x = 3 * x + 1
+            steps += 1
+        steps_total += steps
+        if steps > best:
+            best = steps
+    count = 0
+    for p in range(2, n):
+        d = 2
+        prime = 1
+        while d * d <= p:
+            if p % d == 0:
+                prime = 0
+                break
+            d += 1
+        count += prime
+    return best * 1000003 + steps_total + count
+"""
+
+MEDIUM_FLOAT = """
+def kernel(a, b, n):
+    h = (b - a) / n
+    total = 0.0
+    i = 0.0
+    while i <= n:
+        x = a + i * h
+        fx = x * x * x - 2.0 * x + 1.0
+        if x > 0.0:
+            fx = fx + 1.0 / (1.0 + x)
+        else:
+            fx = fx - x * 0.5
+        if i == 0.0 or i == n:
+            weight = 1.0
+        elif i % 2.0 == 1.0:
+            weight = 4.0
+        else:
+            weight = 2.0
+        total = total + weight * fx
+        i = i + 1.0
+    return total * h / 3.0
+"""
+
+MEDIUM_GENERATOR = """
+def kernel(rows):
+    for row in rows:
+        fields = row.split(",")
+        if len(fields) < 3:
+            continue
+        try:
+            qty = int(fields[1])
+            price = float(fields[2])
+        except ValueError:
+            continue
+        total = qty * price
+        if total > 1000.0:
+            yield fields[0], "large", total
+        elif total > 0.0:
+            yield fields[0], "small", total
+        else:
+            yield fields[0], "refund", -total
+"""
+
+MEDIUM_C = """
+#include <stdlib.h>
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void matmul(const double *a, const double *b, double *c, long n) {
+    for (long i = 0; i < n; i++)
+        for (long j = 0; j < n; j++) c[i * n + j] = 0.0;
+    for (long i = 0; i < n; i++)
+        for (long k = 0; k < n; k++) {
+            double aik = a[i * n + k];
+            for (long j = 0; j < n; j++) c[i * n + j] += aik * b[k * n + j];
+        }
+}
+
+double median(double *values, long n) {
+    qsort(values, (size_t)n, sizeof(double), compare_doubles);
+    if (n == 0) return 0.0;
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+long histogram(const double *values, long n, long *bins, long nbins, double lo, double hi) {
+    long outside = 0;
+    for (long i = 0; i < nbins; i++) bins[i] = 0;
+    for (long i = 0; i < n; i++) {
+        if (values[i] < lo || values[i] >= hi) { outside++; continue; }
+        long bin = (long)((values[i] - lo) / (hi - lo) * nbins);
+        bins[bin < nbins ? bin : nbins - 1]++;
+    }
+    return outside;
+}
+"""
+
+
+def _huge_python(shape, size):
+    return lambda: compile_scaling._source(shape, _statements(shape, size)).replace("def generated", "def kernel")
+
+
+def _statements(shape, size):
+    """Statements of ``shape`` that make about ``size`` bytecode instructions."""
+    namespace = {}
+    exec(compile_scaling._source(shape, 100), namespace)
+    per_sample = sum(1 for _ in dis.get_instructions(namespace["generated"]))
+    return max(1, size * 100 // per_sample)
+
+
+def _huge_c(statements):
+    body = "".join(f"    t = t * {k % 7 + 1} + (x > {k} ? x - {k} : {k} - x);\n" for k in range(statements))
+    return lambda: f"long generated(long x) {{\n    long t = 0;\n{body}    return t;\n}}\n"
+
+
+CASES = [
+    Case("small_int_gcd", "small", "int", "int", _text(SMALL_INT), (1071, 462)),
+    Case("small_float_poly", "small", "float", "float", _text(SMALL_FLOAT), (1.5, 100.0)),
+    Case("small_bool_xor", "small", "bool", "bool", _text(SMALL_BOOL), (True, False)),
+    Case("small_int32_clamp", "small", "int32", "int32", _text(SMALL_INT32), (5, 0, 3)),
+    Case("small_float32_lerp", "small", "float32", "float32", _text(SMALL_FLOAT32), (0.0, 1.0, 0.25)),
+    Case("small_complex128", "small", "complex128", "complex128", _text(SMALL_COMPLEX), (1 + 2j, 3 - 1j)),
+    Case("small_object_count", "small", "object", "object", _text(SMALL_OBJECT), (["a", "b", "a"],)),
+    Case("small_generator", "small", "generator", "object", _text(SMALL_GENERATOR), None),
+    Case("small_int_generator", "small", "generator", "int", _text(SMALL_GENERATOR), None),
+    Case("small_inline_c", "small", "inline_c", None, _text(SMALL_C), None),
+    Case("medium_object_tokenize", "medium", "object", "object", _text(MEDIUM_OBJECT), ("x = 12 + y_1",)),
+    Case("medium_int_collatz", "medium", "int", "int", _text(MEDIUM_INT), (50, 500)),
+    Case("medium_float_simpson", "medium", "float", "float", _text(MEDIUM_FLOAT), (0.0, 2.0, 100.0)),
+    Case("medium_generator_rows", "medium", "generator", "object", _text(MEDIUM_GENERATOR), None),
+    Case("medium_inline_c", "medium", "inline_c", None, _text(MEDIUM_C), None),
+    Case("huge_object_branches", "huge", "object", "object", _huge_python("branches", 20000), (7,)),
+    Case("huge_object_handlers", "huge", "object", "object", _huge_python("handlers", 20000), (7,)),
+    Case("huge_int_branches", "huge", "int", "int", _huge_python("branches", 20000), (7,)),
+    Case("huge_int_loops", "huge", "int", "int", _huge_python("loops", 20000), (7,)),
+    Case("huge_inline_c", "huge", "inline_c", None, _huge_c(2000), None),
+]
+
+CASES_BY_NAME = {case.name: case for case in CASES}
+
+
+# ============================================================================
+# Measurement (one case per interpreter)
+# ============================================================================
+
+def _peak_rss_kb():
+    try:
+        import resource
+    except ImportError:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return peak // 1024 if sys.platform == "darwin" else peak  # macOS reports bytes
+
+
+def _phase(records, key):
+    values = [r[key] for r in records if r[key] is not None and r[key] >= 0]
+    return sum(values) if values else None
+
+
+def measure(case):
+    """Compile ``case`` once in this interpreter; returns its result dict."""
+    import justjit
+
+    result = {"name": case.name, "size": case.size, "entry": case.entry, "mode": case.mode}
+    source = case.source()
+    if case.entry == "inline_c":
+        rss_before = _peak_rss_kb()
+        start = time.perf_counter()
+        justjit.inline_c(source)
+        result["decorate_ms"] = (time.perf_counter() - start) * 1e3
+        rss_after = _peak_rss_kb()
+        ir = justjit.dump_c_ir() or ""
+        result.update(first_call_ms=None, ir_ms=None, optimize_ms=None, codegen_ms=None,
+                      ir_instructions=sum(1 for line in ir.splitlines() if line.startswith("  ")),
+                      optimized_instructions=None, code_size=None, bytecode_instructions=None)
+    else:
+        namespace = {}
+        exec(compile(source, f"<{case.name}>", "exec"), namespace)
+        func = namespace["kernel"]
+        result["bytecode_instructions"] = sum(1 for _ in dis.get_instructions(func))
+        before = len(justjit.stats())
+        rss_before = _peak_rss_kb()
+        start = time.perf_counter()
+        compiled = justjit.jit(func, mode=case.mode, lazy=False)
+        result["decorate_ms"] = (time.perf_counter() - start) * 1e3
+        result["first_call_ms"] = None
+        if case.args is not None:
+            start = time.perf_counter()
+            compiled(*case.args)
+            result["first_call_ms"] = (time.perf_counter() - start) * 1e3
+        rss_after = _peak_rss_kb()
+        records = justjit.stats()[before:]
+        if compiled is func or not records:
+            raise RuntimeError("not compiled")
+        for key in ("ir_ms", "optimize_ms", "codegen_ms", "ir_instructions", "optimized_instructions",
+                    "code_size"):
+            result[key] = _phase(records, key)
+    result["peak_rss_delta_kb"] = None if rss_before is None else rss_after - rss_before
+    return result
+
+
+def spawn(case):
+    """Run ``case`` in a new interpreter; returns its result dict."""
+    env = dict(os.environ)
+    env["JUSTJIT_CACHE_DIR"] = ""  # Cold compiles: never load cached objects
+    cmd = [sys.executable, os.path.abspath(__file__), "--worker", case.name]
+    proc = subprocess.run(cmd, env=env, capture_output=True, text=True)
+    if proc.returncode != 0:
+        return {"name": case.name, "error": (proc.stderr.strip().splitlines() or ["failed"])[-1]}
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+METRICS = ("decorate_ms", "first_call_ms", "ir_ms", "optimize_ms", "codegen_ms", "ir_instructions",
+           "optimized_instructions", "code_size", "peak_rss_delta_kb")
+
+
+def merge(runs):
+    """Medians of the per-process results of one case, with every run kept."""
+    ok = [r for r in runs if "error" not in r]
+    if not ok:
+        return {"name": runs[0]["name"], "error": runs[0]["error"]}
+    first = ok[0]
+    merged = {key: first[key] for key in ("name", "size", "entry", "mode", "bytecode_instructions")}
+    merged["processes"] = len(ok)
+    for key in METRICS:
+        values = [r[key] for r in ok if r[key] is not None]
+        merged[key] = statistics.median(values) if values else None
+    merged["runs"] = ok
+    if len(runs) != len(ok):
+        merged["failed_processes"] = len(runs) - len(ok)
+    return merged
+
+
+# ============================================================================
+# Report
+# ============================================================================
+
+def _num(value, width, digits=1):
+    if value is None:
+        return f"{'-':>{width}}"
+    return f"{value:{width}.{digits}f}"
+
+
+def report(results):
+    print(f"\n{'Case':<24} {'Entry':<10} {'Wall ms':>8} {'IR ms':>8} {'Opt ms':>8} {'Code ms':>8} "
+          f"{'IR ins':>8} {'Opt ins':>8} {'Code B':>8} {'RSS KB':>8}")
+    print("-" * 110)
+    for r in results:
+        if "error" in r:
+            print(f"{r['name']:<24} error: {r['error']}")
+            continue
+        print(f"{r['name']:<24} {r['entry']:<10} {_num(r['decorate_ms'], 8)} {_num(r['ir_ms'], 8)} "
+              f"{_num(r['optimize_ms'], 8)} {_num(r['codegen_ms'], 8)} {_num(r['ir_instructions'], 8, 0)} "
+              f"{_num(r['optimized_instructions'], 8, 0)} {_num(r['code_size'], 8, 0)} "
+              f"{_num(r['peak_rss_delta_kb'], 8, 0)}")
+
+
+def metadata():
+    import justjit
+
+    return {
+        "schema": SCHEMA_VERSION,
+        "justjit": getattr(justjit, "__version__", "unknown"),
+        "python": sys.version.split()[0],
+        "implementation": platform.python_implementation(),
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "processor": platform.processor(),
+        "cpu_count": os.cpu_count(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+    }
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="JustJIT compile latency and memory benchmark")
+    parser.add_argument("--filter", default="", help="only run cases whose name contains this")
+    parser.add_argument("--size", choices=("small", "medium", "huge"), help="only run cases of this size")
+    parser.add_argument("--processes", type=int, default=3, help="fresh interpreters per case")
+    parser.add_argument("--list", action="store_true", help="list the cases and exit")
+    parser.add_argument("--json", metavar="PATH", help="write the results as JSON")
+    parser.add_argument("--worker", help=argparse.SUPPRESS)
+    args = parser.parse_args(argv)
+
+    if args.worker:
+        print(json.dumps(measure(CASES_BY_NAME[args.worker])))
+        return 0
+
+    cases = [c for c in CASES if args.filter in c.name and (args.size is None or c.size == args.size)]
+    if args.list:
+        for case in cases:
+            print(f"{case.name:<24} {case.size:<7} {case.entry}")
+        return 0
+
+    results = []
+    for case in cases:
+        print(f"  {case.name} ...", file=sys.stderr, flush=True)
+        results.append(merge([spawn(case) for _ in range(max(args.processes, 1))]))
+    report(results)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"metadata": metadata(), "results": results}, f, indent=2)
+        print(f"\nResults written to {args.json}")
+    return 1 if any("error" in r for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,164 @@
+"""
+Compile-time scaling on large machine-generated functions.
+
+Code generators emit functions far bigger than anything written by hand,
+and a pass that is quadratic in the bytecode only shows up there. This
+script builds synthetic functions of a given size, 10k to 100k bytecode
+instructions by default, compiles each once in this interpreter with the
+object cache disabled, and reports the JIT's own time for it (bytecode ->
+IR, optimization and codegen, from justjit.stats()) along with the
+decorator's total wall time.
+
+Shapes, each one statement repeated until the function is large enough:
+
+- branches: if/else on a comparison (many small blocks and merges)
+- loops:    a for loop over range() (back edges, FOR_ITER exits)
+- handlers: try/except around a division (exception table entries)
+
+The last column is the growth exponent between consecutive sizes: about
+1.0 means the compile time grows linearly with the function.
+
+Usage:
+    python benchmarks/compile_scaling.py
+    python benchmarks/compile_scaling.py --sizes 10000,50000 --shapes branches
+    python benchmarks/compile_scaling.py --mode int --shapes branches,loops
+    python benchmarks/compile_scaling.py --json scaling.json
+"""
+
+import argparse
+import dis
+import json
+import math
+import os
+import platform
+import sys
+import time
+
+os.environ["JUSTJIT_CACHE_DIR"] = ""  # Cold compiles: never load cached objects
+
+# shape: statement template ({k} is the statement's index)
+SHAPES = {
+    "branches": "    if a > {k}:\n        t += {k}\n    else:\n        t -= 1\n",
+    "loops": "    for i in range({k} % 7):\n        t += i\n",
+    "handlers": "    try:\n        t += a // ({k} % 5)\n    except ZeroDivisionError:\n        t -= 1\n",
+}
+
+# Modes a shape compiles in (int mode has no exception handling)
+SHAPE_MODES = {
+    "branches": ("object", "int"),
+    "loops": ("object", "int"),
+    "handlers": ("object",),
+}
+
+
+def _source(shape, statements):
+    body = "".join(SHAPES[shape].format(k=k) for k in range(statements))
+    return f"def generated(a):\n    t = 0\n{body}    return t\n"
+
+
+def build(shape, size):
+    """(function, instruction count) of about ``size`` instructions in ``shape``."""
+    def make(statements):
+        namespace = {}
+        exec(compile(_source(shape, statements), f"<{shape}>", "exec"), namespace)
+        func = namespace["generated"]
+        return func, sum(1 for _ in dis.get_instructions(func))
+
+    # Size grows linearly with the statement count: scale from a sample
+    sample = 100
+    _, per_sample = make(sample)
+    return make(max(1, size * sample // per_sample))
+
+
+def _jit_time_ms(records):
+    return sum((r["ir_ms"] or 0) + (r["optimize_ms"] or 0) + (r["codegen_ms"] or 0) for r in records)
+
+
+def run(shape, size, mode, repeats):
+    """Best-of-``repeats`` compile timings of one generated function."""
+    import justjit
+
+    best = None
+    for _ in range(max(repeats, 1)):
+        func, instructions = build(shape, size)
+        before = len(justjit.stats())
+        start = time.perf_counter()
+        compiled = justjit.jit(func, mode=mode, lazy=False)
+        decorate_ms = (time.perf_counter() - start) * 1e3
+        records = justjit.stats()[before:]
+        if compiled is func or not records:
+            return {"shape": shape, "mode": mode, "size": size, "instructions": instructions,
+                    "error": "not compiled"}
+        result = {
+            "shape": shape,
+            "mode": mode,
+            "size": size,
+            "instructions": instructions,
+            "decorate_ms": decorate_ms,
+            "jit_ms": _jit_time_ms(records),
+            "ir_ms": sum(r["ir_ms"] or 0 for r in records),
+            "optimize_ms": sum(r["optimize_ms"] or 0 for r in records),
+            "codegen_ms": sum(r["codegen_ms"] or 0 for r in records),
+        }
+        if best is None or result["jit_ms"] < best["jit_ms"]:
+            best = result
+    return best
+
+
+def report(results):
+    print(f"\n{'Shape':<10} {'Mode':<7} {'Instrs':>8} {'IR ms':>9} {'Opt ms':>9} {'Code ms':>9} "
+          f"{'JIT ms':>9} {'us/instr':>9} {'Growth':>7}")
+    print("-" * 86)
+    previous = None
+    for r in results:
+        if "error" in r:
+            print(f"{r['shape']:<10} {r['mode']:<7} {r['instructions']:>8} error: {r['error']}")
+            previous = None
+            continue
+        growth = "-"
+        if previous is not None and (previous["shape"], previous["mode"]) == (r["shape"], r["mode"]):
+            ratio = r["instructions"] / previous["instructions"]
+            if ratio > 1 and previous["jit_ms"] > 0:
+                growth = f"{math.log(r['jit_ms'] / previous['jit_ms']) / math.log(ratio):.2f}"
+        print(f"{r['shape']:<10} {r['mode']:<7} {r['instructions']:>8} {r['ir_ms']:9.1f} {r['optimize_ms']:9.1f} "
+              f"{r['codegen_ms']:9.1f} {r['jit_ms']:9.1f} {r['jit_ms'] * 1e3 / r['instructions']:9.2f} {growth:>7}")
+        previous = r
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="JustJIT compile-time scaling benchmark")
+    parser.add_argument("--sizes", default="10000,20000,50000,100000",
+                        help="comma separated instruction counts")
+    parser.add_argument("--shapes", default=",".join(SHAPES), help="comma separated shapes")
+    parser.add_argument("--mode", default="object", help="@jit mode (shapes that cannot compile in it are skipped)")
+    parser.add_argument("--repeats", type=int, default=1, help="compiles per size; the fastest is reported")
+    parser.add_argument("--json", metavar="PATH", help="write the results as JSON")
+    args = parser.parse_args(argv)
+
+    sizes = sorted(int(size) for size in args.sizes.split(","))
+    shapes = [shape for shape in args.shapes.split(",") if shape]
+    unknown = [shape for shape in shapes if shape not in SHAPES]
+    if unknown:
+        parser.error(f"unknown shape(s): {', '.join(unknown)}")
+
+    results = []
+    for shape in shapes:
+        if args.mode not in SHAPE_MODES[shape]:
+            print(f"  {shape}: no {args.mode} mode, skipped", file=sys.stderr)
+            continue
+        for size in sizes:
+            print(f"  {shape} {size} ...", file=sys.stderr, flush=True)
+            results.append(run(shape, size, args.mode, args.repeats))
+    report(results)
+
+    if args.json:
+        metadata = {"python": sys.version.split()[0], "platform": platform.platform(),
+                    "machine": platform.machine(), "date": time.strftime("%Y-%m-%dT%H:%M:%S%z")}
+        with open(args.json, "w") as f:
+            json.dump({"metadata": metadata, "results": results}, f, indent=2)
+        print(f"\nResults written to {args.json}")
+    return 1 if any("error" in r for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,292 @@
+"""
+JustJIT benchmark harness.
+
+Cases (see cases.py) cover every compilation mode, generators, coroutines,
+inline C and object-mode macro workloads (group "macro": nbody, a
+richards-style scheduler, a JSON tree walk, a template renderer,
+exception-heavy parsing, a generator pipeline and an asyncio echo server).
+
+Every case runs in fresh interpreters, one per process requested, with the
+object cache disabled, and each measures three things:
+
+- cold compile: time spent in the JIT (bytecode -> IR, optimization and
+  codegen, from justjit.stats()), plus the decorator's total wall time
+- first call: the first call after decoration, lazy codegen included
+- steady state: calibrated, repeated calls of the compiled function and of
+  the CPython baseline, pyperf style: the loop count doubles until one
+  sample takes at least --min-time, then --samples samples are taken
+
+Usage:
+    python benchmarks/harness.py                      # all cases, table
+    python benchmarks/harness.py --json results.json  # also write JSON
+    python benchmarks/harness.py --filter int_ --processes 5
+    python benchmarks/harness.py --group macro       # object-mode workloads
+
+The JSON holds the machine and version metadata and, per case, every
+sample, so runs from different releases can be compared.
+
+Compile times of very large functions are tracked separately, by
+benchmarks/compile_scaling.py.
+"""
+
+import argparse
+import asyncio
+import collections
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import cases  # noqa: E402
+
+SCHEMA_VERSION = 1
+
+
+# ============================================================================
+# Measurement
+# ============================================================================
+
+def calibrate(call, min_time):
+    """Loop count for which one sample of ``call`` takes at least ``min_time`` seconds."""
+    loops = 1
+    while True:
+        start = time.perf_counter()
+        for _ in range(loops):
+            call()
+        if time.perf_counter() - start >= min_time or loops >= 1 << 30:
+            return loops
+        loops *= 2
+
+
+def measure(call, *, min_time=0.02, samples=10, warmups=1):
+    """Per-call seconds of ``call``: one value per sample of a calibrated loop."""
+    loops = calibrate(call, min_time)
+    for _ in range(warmups):
+        for _ in range(loops):
+            call()
+    values = []
+    for _ in range(samples):
+        start = time.perf_counter()
+        for _ in range(loops):
+            call()
+        values.append((time.perf_counter() - start) / loops)
+    return {"loops": loops, "values": values}
+
+
+def summarize(values):
+    """Statistics of a list of seconds, in microseconds."""
+    if not values:
+        return None
+    us = [v * 1e6 for v in values]
+    return {
+        "mean_us": statistics.fmean(us),
+        "median_us": statistics.median(us),
+        "stdev_us": statistics.stdev(us) if len(us) > 1 else 0.0,
+        "min_us": min(us),
+        "max_us": max(us),
+        "n": len(us),
+    }
+
+
+def _runner(case, fn, args):
+    """Zero-argument callable making one timed call of ``fn`` as ``case`` asks."""
+    if case.runner == "drain":
+        return lambda: collections.deque(fn(*args), maxlen=0)
+    if case.runner == "asyncio":
+        return lambda: asyncio.run(fn(*args))
+    if case.runner == "await":
+        def drive():
+            coro = fn(*args)
+            try:
+                while True:
+                    coro.send(None)
+            except StopIteration as stop:
+                return stop.value
+        return drive
+    return lambda: fn(*args)
+
+
+# ============================================================================
+# Worker: one case in this (fresh) interpreter
+# ============================================================================
+
+def _jit_time_ms(records):
+    return sum((r["ir_ms"] or 0) + (r["optimize_ms"] or 0) + (r["codegen_ms"] or 0) for r in records)
+
+
+def run_case(case, min_time, samples):
+    import justjit
+
+    args = case.make_args()
+    stats_before = len(justjit.stats())
+
+    start = time.perf_counter()
+    if case.group == "inline_c":
+        compiled = justjit.inline_c(case.func, **case.options)
+        fn = compiled[compiled["functions"][0]]
+        baseline = cases.C_BASELINES.get(case.name)
+    else:
+        fn = justjit.jit(mode=case.mode, **case.options)(case.func)
+        baseline = case.func
+    decorated = time.perf_counter()
+    call = _runner(case, fn, args)
+    call()
+    first = time.perf_counter()
+    # Time what a module-level call reaches after its first call: the built
+    # wrapper, not the lazy stub in front of it
+    fn = getattr(fn, "_target", None) or fn
+    call = _runner(case, fn, args)
+
+    result = {
+        "name": case.name,
+        "group": case.group,
+        "mode": case.mode,
+        "decorate_ms": (decorated - start) * 1e3,
+        "first_call_ms": (first - decorated) * 1e3,
+        "cold_compile_ms": _jit_time_ms(justjit.stats()[stats_before:]),
+        "steady": measure(call, min_time=min_time, samples=samples),
+        "baseline": None,
+    }
+    if baseline is not None:
+        try:
+            base_call = _runner(case, baseline, args)
+            base_call()
+        except Exception as exc:  # e.g. ptr/vec kernels only make sense compiled
+            result["baseline_error"] = f"{type(exc).__name__}: {exc}"
+        else:
+            result["baseline"] = measure(base_call, min_time=min_time, samples=samples)
+    return result
+
+
+# ============================================================================
+# Driver
+# ============================================================================
+
+def metadata():
+    import justjit
+
+    return {
+        "schema": SCHEMA_VERSION,
+        "justjit": getattr(justjit, "__version__", "unknown"),
+        "python": sys.version.split()[0],
+        "implementation": platform.python_implementation(),
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "processor": platform.processor(),
+        "cpu_count": os.cpu_count(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+    }
+
+
+def spawn(case, args):
+    """Run ``case`` in a new interpreter; returns its result dict."""
+    env = dict(os.environ)
+    env["JUSTJIT_CACHE_DIR"] = ""  # Cold compiles: never load cached objects
+    cmd = [sys.executable, os.path.abspath(__file__), "--worker", case.name,
+           "--min-time", str(args.min_time), "--samples", str(args.samples)]
+    proc = subprocess.run(cmd, env=env, capture_output=True, text=True)
+    if proc.returncode != 0:
+        return {"name": case.name, "error": proc.stderr.strip().splitlines()[-1:] or ["failed"]}
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def merge(runs):
+    """Combine the per-process results of one case."""
+    ok = [r for r in runs if "error" not in r]
+    if not ok:
+        return {"name": runs[0]["name"], "error": runs[0]["error"][0]}
+    first = ok[0]
+    merged = {
+        "name": first["name"],
+        "group": first["group"],
+        "mode": first["mode"],
+        "processes": len(ok),
+        "decorate_ms": [r["decorate_ms"] for r in ok],
+        "first_call_ms": [r["first_call_ms"] for r in ok],
+        "cold_compile_ms": [r["cold_compile_ms"] for r in ok],
+        "steady": {"loops": [r["steady"]["loops"] for r in ok],
+                   "values": [v for r in ok for v in r["steady"]["values"]]},
+        "baseline": None,
+    }
+    merged["steady"]["stats"] = summarize(merged["steady"]["values"])
+    bases = [r["baseline"] for r in ok if r["baseline"] is not None]
+    if bases:
+        values = [v for b in bases for v in b["values"]]
+        merged["baseline"] = {"loops": [b["loops"] for b in bases], "values": values, "stats": summarize(values)}
+        merged["speedup"] = merged["baseline"]["stats"]["median_us"] / merged["steady"]["stats"]["median_us"]
+    elif "baseline_error" in first:
+        merged["baseline_error"] = first["baseline_error"]
+    failures = len(runs) - len(ok)
+    if failures:
+        merged["failed_processes"] = failures
+    return merged
+
+
+def _ms(values):
+    return f"{statistics.median(values):8.2f}"
+
+
+def _us(stats):
+    if stats is None:
+        return f"{'-':>11}"
+    return f"{stats['median_us']:9.2f}us"
+
+
+def report(results):
+    print(f"\n{'Case':<24} {'Compile':>8} {'1st call':>8} {'JIT':>11} {'+-':>7} {'CPython':>11} {'Speedup':>8}")
+    print(f"{'':<24} {'ms':>8} {'ms':>8}")
+    print("-" * 84)
+    for r in results:
+        if "error" in r:
+            print(f"{r['name']:<24} error: {r['error']}")
+            continue
+        steady = r["steady"]["stats"]
+        spread = f"{steady['stdev_us'] / steady['median_us'] * 100:5.1f}%" if steady["median_us"] else "-"
+        speedup = f"{r['speedup']:7.1f}x" if "speedup" in r else f"{'-':>8}"
+        base = r["baseline"]["stats"] if r["baseline"] else None
+        print(f"{r['name']:<24} {_ms(r['cold_compile_ms'])} {_ms(r['first_call_ms'])} {_us(steady)} "
+              f"{spread:>7} {_us(base)} {speedup}")
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="JustJIT benchmark harness")
+    parser.add_argument("--filter", default="", help="only run cases whose name contains this")
+    parser.add_argument("--group", help="only run cases of this group (mode, generator, coroutine, inline_c, macro)")
+    parser.add_argument("--processes", type=int, default=3, help="fresh interpreters per case")
+    parser.add_argument("--samples", type=int, default=10, help="steady-state samples per process")
+    parser.add_argument("--min-time", type=float, default=0.02, help="minimum seconds per sample")
+    parser.add_argument("--json", metavar="PATH", help="write the results as JSON")
+    parser.add_argument("--list", action="store_true", help="list the cases and exit")
+    parser.add_argument("--worker", metavar="CASE", help=argparse.SUPPRESS)
+    args = parser.parse_args(argv)
+
+    if args.worker:
+        print(json.dumps(run_case(cases.find(args.worker), args.min_time, args.samples)))
+        return 0
+
+    selected = [c for c in cases.CASES if args.filter in c.name and args.group in (None, c.group)]
+    if args.list:
+        for case in selected:
+            print(f"{case.name:<24} {case.group:<10} {case.mode or ''}")
+        return 0
+
+    results = []
+    for case in selected:
+        print(f"  {case.name} ...", file=sys.stderr, flush=True)
+        results.append(merge([spawn(case, args) for _ in range(max(args.processes, 1))]))
+    report(results)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"metadata": metadata(), "benchmarks": results}, f, indent=2)
+        print(f"\nResults written to {args.json}")
+    return 1 if any("error" in r for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,238 @@
+/*
+ * Native microbenchmarks of the JustJIT runtime (Google Benchmark).
+ *
+ * The Python harness measures whole calls from the interpreter; this one
+ * measures the runtime pieces those calls go through, from C++, so their
+ * cost shows at nanosecond resolution:
+ *
+ * - helpers compiled code calls: jit_box_int, jit_unbox_float and
+ *   jit_call_with_kwargs, looked up by symbol in the loaded _core
+ * - entries: the JITNativeFunction vectorcall of int, float and object-mode
+ *   kernels, and the create_{int,float}_callable_N lambdas of the same
+ *   kernels (JIT.get_int_callable / get_float_callable)
+ * - JITGenerator_send through PyIter_Send on a JIT generator
+ * - the JITCallable trampoline of an inline C function (skipped without
+ *   Clang)
+ *
+ * The kernels are compiled once at startup, before any timing, by the
+ * Python in kSetup; every benchmark then calls into code that is already
+ * loaded.
+ *
+ * Built with -DJUSTJIT_BUILD_BENCHMARKS=ON (target justjit_runtime_bench);
+ * justjit must be importable, e.g. installed with pip install -e . or on
+ * PYTHONPATH:
+ *
+ *     ./justjit_runtime_bench
+ *     ./justjit_runtime_bench --benchmark_filter=entry_ --benchmark_format=json
+ */
+
+#include <Python.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+    const char *kSetup = R"PY(
+import ctypes
+import justjit
+from justjit import _core, jit
+
+_lib = ctypes.CDLL(_core.__file__)
+helpers = {name: ctypes.cast(getattr(_lib, name), ctypes.c_void_p).value
+           for name in ("jit_box_int", "jit_unbox_float", "jit_call_with_kwargs")}
+
+@jit(mode="int")
+def int_add(a, b):
+    return a + b
+
+@jit(mode="float")
+def float_poly(x, y):
+    return x * x + 3.0 * y
+
+@jit
+def object_add(a, b):
+    return a + b
+
+@jit
+def echo():
+    value = 0
+    while True:
+        value = yield value
+
+# First calls compile the lazy kernels
+int_add(1, 2)
+float_poly(1.0, 2.0)
+object_add(1, 2)
+
+generator = echo()
+next(generator)
+
+try:
+    c_add = justjit.inline_c("long c_add(long a, long b) { return a + b; }")["c_add"]
+except Exception:
+    c_add = None
+
+# name: (callable, positional arguments)
+calls = {
+    "entry_int": (int_add, (3, 4)),
+    "entry_float": (float_poly, (1.5, 2.5)),
+    "entry_object": (object_add, (3, 4)),
+    "int_callable_2": (int_add._jit_instance.get_int_callable("int_add", 2), (3, 4)),
+    "float_callable_2": (float_poly._jit_instance.get_float_callable("float_poly", 2), (1.5, 2.5)),
+    "JITCallable_call": (c_add, (3, 4)),
+}
+)PY";
+
+    PyObject *setup_globals = nullptr;
+
+    PyObject *(*box_int)(int64_t) = nullptr;
+    double (*unbox_float)(PyObject *) = nullptr;
+    PyObject *(*call_with_kwargs)(PyObject *, PyObject **, size_t, PyObject *) = nullptr;
+
+    // Borrowed reference to a global of kSetup
+    PyObject *setup_global(const char *name)
+    {
+        return PyDict_GetItemString(setup_globals, name);
+    }
+
+    template <typename F>
+    void helper_address(const char *name, F &out)
+    {
+        PyObject *address = PyDict_GetItemString(setup_global("helpers"), name);
+        out = reinterpret_cast<F>(static_cast<uintptr_t>(PyLong_AsUnsignedLongLong(address)));
+    }
+
+    // Fail the benchmark with the pending Python exception
+    void fail(benchmark::State &state, const char *what)
+    {
+        PyErr_Print();
+        state.SkipWithError(what);
+    }
+
+    void BM_jit_box_int(benchmark::State &state)
+    {
+        int64_t value = 1 << 20;  // Outside the small int cache: allocates
+        for (auto _ : state)
+        {
+            PyObject *boxed = box_int(value++);
+            benchmark::DoNotOptimize(boxed);
+            Py_DECREF(boxed);
+        }
+    }
+    BENCHMARK(BM_jit_box_int);
+
+    void BM_jit_unbox_float(benchmark::State &state)
+    {
+        PyObject *value = PyFloat_FromDouble(2.5);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(unbox_float(value));
+        }
+        Py_DECREF(value);
+    }
+    BENCHMARK(BM_jit_unbox_float);
+
+    // object_add(3, b=4) the way CALL_KW hands it over
+    void BM_jit_call_with_kwargs(benchmark::State &state)
+    {
+        PyObject *callable = PyTuple_GET_ITEM(PyDict_GetItemString(setup_global("calls"), "entry_object"), 0);
+        PyObject *kwnames = Py_BuildValue("(s)", "b");
+        PyObject *args[2] = {PyLong_FromLong(3), PyLong_FromLong(4)};
+        for (auto _ : state)
+        {
+            PyObject *result = call_with_kwargs(callable, args, 2, kwnames);
+            if (result == nullptr)
+            {
+                fail(state, "call raised");
+                break;
+            }
+            Py_DECREF(result);
+        }
+        Py_DECREF(args[0]);
+        Py_DECREF(args[1]);
+        Py_DECREF(kwnames);
+    }
+    BENCHMARK(BM_jit_call_with_kwargs);
+
+    void BM_JITGenerator_send(benchmark::State &state)
+    {
+        PyObject *generator = setup_global("generator");
+        PyObject *value = PyLong_FromLong(7);
+        for (auto _ : state)
+        {
+            PyObject *result = nullptr;
+            if (PyIter_Send(generator, value, &result) != PYGEN_NEXT)
+            {
+                Py_XDECREF(result);
+                fail(state, "generator stopped");
+                break;
+            }
+            Py_DECREF(result);
+        }
+        Py_DECREF(value);
+    }
+    BENCHMARK(BM_JITGenerator_send);
+
+    // One vectorcall of calls[name] per iteration
+    void BM_call(benchmark::State &state, const char *name)
+    {
+        PyObject *entry = PyDict_GetItemString(setup_global("calls"), name);
+        PyObject *callable = PyTuple_GET_ITEM(entry, 0);
+        PyObject *args = PyTuple_GET_ITEM(entry, 1);
+        if (callable == Py_None)
+        {
+            state.SkipWithError("not available in this build");
+            return;
+        }
+        PyObject *const *argv = &PyTuple_GET_ITEM(args, 0);
+        size_t nargs = static_cast<size_t>(PyTuple_GET_SIZE(args));
+        for (auto _ : state)
+        {
+            PyObject *result = PyObject_Vectorcall(callable, argv, nargs, nullptr);
+            if (result == nullptr)
+            {
+                fail(state, "call raised");
+                break;
+            }
+            Py_DECREF(result);
+        }
+    }
+    BENCHMARK_CAPTURE(BM_call, entry_int, "entry_int");
+    BENCHMARK_CAPTURE(BM_call, entry_float, "entry_float");
+    BENCHMARK_CAPTURE(BM_call, entry_object, "entry_object");
+    BENCHMARK_CAPTURE(BM_call, int_callable_2, "int_callable_2");
+    BENCHMARK_CAPTURE(BM_call, float_callable_2, "float_callable_2");
+    BENCHMARK_CAPTURE(BM_call, JITCallable_call, "JITCallable_call");
+}
+
+int main(int argc, char **argv)
+{
+    Py_Initialize();
+    setup_globals = PyDict_New();
+    PyDict_SetItemString(setup_globals, "__builtins__", PyEval_GetBuiltins());
+    PyObject *done = PyRun_String(kSetup, Py_file_input, setup_globals, setup_globals);
+    if (done == nullptr)
+    {
+        PyErr_Print();
+        std::fprintf(stderr, "justjit_runtime_bench: setup failed (is justjit importable?)\n");
+        return 1;
+    }
+    Py_DECREF(done);
+    helper_address("jit_box_int", box_int);
+    helper_address("jit_unbox_float", unbox_float);
+    helper_address("jit_call_with_kwargs", call_with_kwargs);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    Py_DECREF(setup_globals);
+    Py_Finalize();
+    return 0;
+}
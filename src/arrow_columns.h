@@ -0,0 +1,288 @@
+/**
+ * arrow_columns.h - Arrow C Data Interface columns for ndarray-mode kernels
+ *
+ * Provides:
+ * - ArrowSchema / ArrowArray: the C Data Interface structs, as the Arrow
+ *   specification defines them
+ * - ArrowColumn: one primitive Arrow array (values buffer plus validity
+ *   bitmap), either moved in from a producer zero-copy or allocated here
+ *   for a kernel's output
+ * - arrow_validity_and: the validity bitmap of an elementwise result, the
+ *   AND of its inputs' bitmaps computed 64 rows per step
+ *
+ * Like typed_containers.h these never touch Python; the bindings wrap a
+ * column in the buffer protocol (its values) and the PyCapsule interface
+ * (__arrow_c_array__). Bitmaps are LSB-first bytes, as Arrow stores them,
+ * and are read and written byte by byte, so no host byte order is assumed.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace justjit {
+
+// ============================================================================
+// Primitive types: Arrow format string <-> buffer-protocol item format
+// ============================================================================
+struct ArrowPrimitive {
+    const char* arrow;  // C Data Interface format string
+    const char* item;   // struct format the kernels see (one character)
+    int64_t size;
+};
+
+inline constexpr ArrowPrimitive ARROW_PRIMITIVES[] = {
+    {"g", "d", 8}, {"f", "f", 4}, {"l", "q", 8}, {"i", "i", 4},
+    {"s", "h", 2}, {"S", "H", 2}, {"c", "b", 1}, {"C", "B", 1},
+};
+
+// The primitive an Arrow format string (or, with `item`, a struct format)
+// names, or nullptr
+inline const ArrowPrimitive* arrow_primitive(const char* format, bool item = false) {
+    for (const ArrowPrimitive& p : ARROW_PRIMITIVES) {
+        if (std::strcmp(item ? p.item : p.arrow, format) == 0) {
+            return &p;
+        }
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Validity bitmaps
+// ============================================================================
+
+// Bits [bit, bit + 64) of `bitmap`, bit `bit` lowest; bits at `end` and
+// past it read as 0 and their bytes are never touched
+inline uint64_t arrow_bitmap_word(const uint8_t* bitmap, int64_t bit, int64_t end) {
+    int64_t first = bit >> 3;
+    int64_t stop = ((bit + 64 < end ? bit + 64 : end) + 7) >> 3;  // At most 9 bytes
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    for (int64_t b = first; b < stop; ++b) {
+        int64_t k = b - first;
+        if (k < 8) {
+            lo |= static_cast<uint64_t>(bitmap[b]) << (8 * k);
+        } else {
+            hi = bitmap[b];
+        }
+    }
+    int shift = static_cast<int>(bit & 7);
+    uint64_t word = shift != 0 ? (lo >> shift) | (hi << (64 - shift)) : lo;
+    int64_t rows = end - bit;
+    return rows < 64 ? word & ((uint64_t(1) << rows) - 1) : word;
+}
+
+inline int64_t arrow_popcount(uint64_t x) {
+    // Compilers turn this into a popcnt instruction where there is one
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int64_t>((x * 0x0101010101010101ULL) >> 56);
+}
+
+// out (bit offset 0, room for ceil(length / 64) words) = AND of `count`
+// bitmaps, bitmap k starting at bit offsets[k]; a null bitmap means every
+// row is valid. One word of every input per 64 rows. Returns the null count.
+inline int64_t arrow_validity_and(uint8_t* out, const uint8_t* const* bitmaps, const int64_t* offsets, size_t count,
+                                  int64_t length) {
+    int64_t nulls = 0;
+    for (int64_t row = 0; row < length; row += 64) {
+        int64_t rows = length - row < 64 ? length - row : 64;
+        uint64_t valid = rows < 64 ? (uint64_t(1) << rows) - 1 : ~uint64_t(0);
+        for (size_t k = 0; k < count; ++k) {
+            if (bitmaps[k] != nullptr) {
+                valid &= arrow_bitmap_word(bitmaps[k], offsets[k] + row, offsets[k] + length);
+            }
+        }
+        for (int b = 0; b < 8; ++b) {
+            out[row / 8 + b] = static_cast<uint8_t>(valid >> (8 * b));
+        }
+        nulls += rows - arrow_popcount(valid);
+    }
+    return nulls;
+}
+
+// ============================================================================
+// ArrowColumn - One primitive Arrow array
+// ============================================================================
+struct ArrowColumn {
+    ArrowArray imported{};               // Owned while release is set (moved in from a producer)
+    const void* values_base = nullptr;   // buffers[1]; row i is at offset + i
+    const uint8_t* validity = nullptr;   // buffers[0]; nullptr when no row is null
+    uint8_t* owned_values = nullptr;     // Allocated columns own their buffers
+    uint8_t* owned_validity = nullptr;
+    int64_t length = 0;
+    int64_t offset = 0;
+    int64_t null_count = 0;
+    const ArrowPrimitive* type = nullptr;
+    // Buffer-protocol shape and stride of the values, which Py_buffer points at
+    std::ptrdiff_t shape = 0;
+    std::ptrdiff_t stride = 0;
+
+    ArrowColumn() = default;
+    ArrowColumn(const ArrowColumn&) = delete;
+    ArrowColumn& operator=(const ArrowColumn&) = delete;
+    ~ArrowColumn() {
+        if (imported.release != nullptr) {
+            imported.release(&imported);
+        }
+        std::free(owned_values);
+        std::free(owned_validity);
+    }
+
+    bool is_imported() const { return imported.release != nullptr; }
+    uint8_t* values() const {
+        uint8_t* base = static_cast<uint8_t*>(const_cast<void*>(values_base));
+        return base != nullptr ? base + offset * type->size : nullptr;
+    }
+    bool is_valid(int64_t row) const {
+        int64_t bit = offset + row;
+        return validity == nullptr || ((validity[bit >> 3] >> (bit & 7)) & 1) != 0;
+    }
+
+    // Take over `source` (a primitive array of `primitive`), leaving it
+    // released as the C Data Interface's move semantics ask. False, with
+    // `source` untouched, if it is not laid out as a primitive array.
+    bool import_array(ArrowArray* source, const ArrowPrimitive* primitive) {
+        if (source->n_buffers != 2 || source->n_children != 0 || source->dictionary != nullptr ||
+            source->length < 0 || source->offset < 0 || (source->length > 0 && source->buffers[1] == nullptr)) {
+            return false;
+        }
+        imported = *source;
+        source->release = nullptr;
+        type = primitive;
+        values_base = imported.buffers[1];
+        validity = imported.null_count != 0 ? static_cast<const uint8_t*>(imported.buffers[0]) : nullptr;
+        length = imported.length;
+        offset = imported.offset;
+        null_count = validity != nullptr ? imported.null_count : 0;
+        shape = static_cast<std::ptrdiff_t>(length);
+        stride = static_cast<std::ptrdiff_t>(type->size);
+        // null_count -1 means "not computed": count it once
+        if (null_count < 0) {
+            null_count = 0;
+            for (int64_t row = 0; row < length; row += 64) {
+                int64_t rows = length - row < 64 ? length - row : 64;
+                null_count += rows - arrow_popcount(arrow_bitmap_word(validity, offset + row, offset + length));
+            }
+        }
+        return true;
+    }
+
+    // Zero-filled values, every row valid; false if out of memory
+    bool allocate(const ArrowPrimitive* primitive, int64_t rows) {
+        type = primitive;
+        length = rows;
+        // Padded to 64 bytes, the alignment Arrow recommends for its buffers
+        size_t bytes = (static_cast<size_t>(rows) * static_cast<size_t>(type->size) + 63) & ~size_t(63);
+        owned_values = static_cast<uint8_t*>(std::calloc(bytes > 0 ? bytes : 64, 1));
+        values_base = owned_values;
+        shape = static_cast<std::ptrdiff_t>(length);
+        stride = static_cast<std::ptrdiff_t>(type->size);
+        return owned_values != nullptr;
+    }
+
+    // Mark row `row` of this (allocated) column valid or null; false if out
+    // of memory
+    bool set_valid(int64_t row, bool valid) {
+        if (validity == nullptr) {
+            if (valid) {
+                return true;
+            }
+            if (!ensure_owned_validity()) {
+                return false;
+            }
+            std::memset(owned_validity, 0xFF, validity_bytes());
+            validity = owned_validity;
+        }
+        uint8_t mask = static_cast<uint8_t>(1u << (row & 7));
+        bool was_valid = (owned_validity[row >> 3] & mask) != 0;
+        if (was_valid != valid) {
+            owned_validity[row >> 3] ^= mask;
+            null_count += valid ? -1 : 1;
+        }
+        return true;
+    }
+
+    // This (allocated) column's validity becomes the AND of `inputs`', which
+    // must all have its length. False if out of memory.
+    bool set_validity_and(const ArrowColumn* const* inputs, size_t count) {
+        std::vector<const uint8_t*> bitmaps;
+        std::vector<int64_t> offsets;
+        for (size_t k = 0; k < count; ++k) {
+            if (inputs[k]->validity != nullptr) {
+                bitmaps.push_back(inputs[k]->validity);
+                offsets.push_back(inputs[k]->offset);
+            }
+        }
+        if (bitmaps.empty()) {
+            validity = nullptr;
+            null_count = 0;
+            return true;
+        }
+        if (!ensure_owned_validity()) {
+            return false;
+        }
+        null_count = arrow_validity_and(owned_validity, bitmaps.data(), offsets.data(), bitmaps.size(), length);
+        validity = null_count != 0 ? owned_validity : nullptr;
+        return true;
+    }
+
+private:
+    // Whole 64-row words, padded to 64 bytes like the values
+    size_t validity_bytes() const { return ((static_cast<size_t>(length) + 511) / 512) * 64; }
+    bool ensure_owned_validity() {
+        if (owned_validity == nullptr) {
+            owned_validity = static_cast<uint8_t*>(std::calloc(validity_bytes() > 0 ? validity_bytes() : 64, 1));
+        }
+        return owned_validity != nullptr;
+    }
+};
+
+}  // namespace justjit
@@ -1,10 +1,99 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
 #include "jit_core.h"
+#include "typed_containers.h"
+#include "arrow_columns.h"
+#include "foreign_arrays.h"
+#include "buffer_pool.h"
+#include "cuda_offload.h"
+#include "numa_topology.h"
+
+#include <cstring>
+#include <vector>
 
 namespace nb = nanobind;
 using namespace nb::literals;
 
+namespace {
+
+// ArrowColumn's values as a one-dimensional buffer (read-only when imported)
+int arrow_column_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+     if (!nb::inst_ready(self)) {
+          PyErr_SetString(PyExc_BufferError, "ArrowColumn: not initialized");
+          view->obj = nullptr;
+          return -1;
+     }
+     justjit::ArrowColumn* column = nb::inst_ptr<justjit::ArrowColumn>(self);
+     if ((flags & PyBUF_WRITABLE) && column->is_imported()) {
+          PyErr_SetString(PyExc_BufferError, "ArrowColumn: an imported Arrow array is read-only");
+          view->obj = nullptr;
+          return -1;
+     }
+     static char empty = 0;
+     view->buf = column->length > 0 ? column->values() : static_cast<void*>(&empty);
+     view->obj = Py_NewRef(self);
+     view->len = static_cast<Py_ssize_t>(column->length * column->type->size);
+     view->readonly = column->is_imported() ? 1 : 0;
+     view->itemsize = static_cast<Py_ssize_t>(column->type->size);
+     view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(column->type->item) : nullptr;
+     view->ndim = 1;
+     view->shape = (flags & PyBUF_ND) ? &column->shape : nullptr;
+     view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &column->stride : nullptr;
+     view->suboffsets = nullptr;
+     view->internal = nullptr;
+     return 0;
+}
+
+PyType_Slot arrow_column_slots[] = {
+     {Py_bf_getbuffer, reinterpret_cast<void*>(arrow_column_getbuffer)},
+     {0, nullptr},
+};
+
+// Exported ArrowArray's private data: the buffer table and a reference to
+// the column, which keeps its values and bitmap alive until release
+struct ArrowExport {
+     const void* buffers[2];
+     PyObject* owner;
+};
+
+void arrow_export_release_schema(ArrowSchema* schema)
+{
+     schema->release = nullptr;
+}
+
+void arrow_export_release_array(ArrowArray* array)
+{
+     auto* data = static_cast<ArrowExport*>(array->private_data);
+     // Consumers may release from any thread
+     PyGILState_STATE gil = PyGILState_Ensure();
+     Py_DECREF(data->owner);
+     PyGILState_Release(gil);
+     delete data;
+     array->release = nullptr;
+}
+
+void arrow_schema_capsule_destructor(PyObject* capsule)
+{
+     auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+     if (schema->release != nullptr) {
+          schema->release(schema);
+     }
+     delete schema;
+}
+
+void arrow_array_capsule_destructor(PyObject* capsule)
+{
+     auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+     if (array->release != nullptr) {
+          array->release(array);
+     }
+     delete array;
+}
+
+}  // namespace
+
 NB_MODULE(_core, m)
 {
      // Disable leak warnings - our extension stores references to globals
@@ -21,47 +110,199 @@ NB_MODULE(_core, m)
          .def("set_dump_ir", &justjit::JITCore::set_dump_ir, "dump"_a, "Enable/disable IR capture for debugging")
          .def("get_dump_ir", &justjit::JITCore::get_dump_ir, "Check if IR dump is enabled")
          .def("get_last_ir", &justjit::JITCore::get_last_ir, "Get the LLVM IR from the last compiled function")
-         .def("compile", [](justjit::JITCore &self, nb::list instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::list exception_table, const std::string &name, int param_count, int total_locals, int nlocals)
-              { return self.compile_function(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "nlocals"_a = 3, "Compile a Python function to native code")
-         .def("compile_int", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_int_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile an integer-only function to native code (no Python object overhead)")
-         .def("compile_float", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_float_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a float-only function to native code (no Python object overhead)")
-         .def("compile_generator", [](justjit::JITCore &self, nb::list instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::list exception_table, const std::string &name, int param_count, int total_locals, int nlocals)
+         .def("set_dump_asm", &justjit::JITCore::set_dump_asm, "dump"_a, "Enable/disable assembly capture for debugging")
+         .def("get_dump_asm", &justjit::JITCore::get_dump_asm, "Check if assembly capture is enabled")
+         .def("get_last_asm", &justjit::JITCore::get_last_asm, "Get the native assembly of the last compiled module")
+         .def("release_function", &justjit::JITCore::release_function, "name"_a,
+              "Free the code, Python references and inline caches of compiled function `name`")
+         .def("get_compiled_names", &justjit::JITCore::get_compiled_names,
+              "Names of the functions compiled into this instance and not yet released")
+         .def("set_pipeline_options", &justjit::JITCore::set_pipeline_options,
+              "vectorize"_a = true, "inline"_a = true, "unroll"_a = 0,
+              "Tune the optimization pipeline (unroll: 0 = LLVM default, 1 = off, N = factor)")
+         .def("set_fastmath", &justjit::JITCore::set_fastmath, "flags"_a,
+              "Set the fast-math flags (nnan, ninf, nsz, arcp, contract, afn, reassoc, or fast) of later compiles")
+         .def("get_fastmath", &justjit::JITCore::get_fastmath, "Get the enabled fast-math flag names")
+         .def("set_vector_library", &justjit::JITCore::set_vector_library, "library"_a,
+              "Vector math library for vectorized math calls: none, libmvec, svml, sleef, accelerate or auto")
+         .def("get_vector_library", &justjit::JITCore::get_vector_library, "Get the resolved vector math library")
+         .def("set_target", &justjit::JITCore::set_target, "cpu"_a = "native", "features"_a = "native",
+              "Set the codegen CPU and feature string (e.g. '+avx2,+fma'); 'native' uses the host")
+         .def("get_target_cpu", &justjit::JITCore::get_target_cpu, "Get the resolved codegen CPU name")
+         .def("get_target_features", &justjit::JITCore::get_target_features, "Get the resolved codegen feature string")
+         .def("set_profiling", &justjit::JITCore::set_profiling, "enabled"_a,
+              "Record operand types at arithmetic, compare, subscript and attribute sites of later object-mode compiles")
+         .def("get_profiling", &justjit::JITCore::get_profiling, "Check if type profiling is enabled")
+         .def("set_parallel", &justjit::JITCore::set_parallel, "enabled"_a,
+              "Split map/reduce batch calls of native entries created afterwards across the thread pool")
+         .def("get_parallel", &justjit::JITCore::get_parallel, "Check if parallel batch calls are enabled")
+         .def("set_nogil", &justjit::JITCore::set_nogil, "enabled"_a,
+              "Release the GIL around calls of typed functions created afterwards whose code uses no Python API")
+         .def("get_nogil", &justjit::JITCore::get_nogil, "Check if nogil calls are enabled")
+         .def("set_overflow_checks", &justjit::JITCore::set_overflow_checks, "enabled"_a,
+              "Make later int mode compiles rerun calls whose results leave 64 bits in the interpreter (default True)")
+         .def("get_overflow_checks", &justjit::JITCore::get_overflow_checks, "Check if int mode overflow checks are enabled")
+         .def("set_bounds_checks", &justjit::JITCore::set_bounds_checks, "level"_a,
+              "Index checking for later ndarray compiles: 0 none, 1 unproven indices (default), 2 all")
+         .def("get_bounds_checks", &justjit::JITCore::get_bounds_checks, "Current ndarray bounds check level")
+         .def("set_poll_interval", &justjit::JITCore::set_poll_interval, "interval"_a,
+              "Back edges between eval-breaker polls for later compiles: 0 off, -1 the default (object mode only)")
+         .def("get_poll_interval", &justjit::JITCore::get_poll_interval, "Current loop poll interval")
+         .def("set_static_args", &justjit::JITCore::set_static_args, "args"_a,
+              "Fold [(param index, value), ...] into later typed compiles as IR constants")
+         .def("get_static_args", &justjit::JITCore::get_static_args, "Get the (param index, value) pairs set by set_static_args")
+         .def("set_entry_closures", &justjit::JITCore::set_entry_closures, "enabled"_a,
+              "Compile later object-mode closures to take their cells from the native entry, sharing one body")
+         .def("get_entry_closures", &justjit::JITCore::get_entry_closures, "Whether entry closures are enabled")
+         .def("set_budget_note", &justjit::JITCore::set_budget_note, "note"_a,
+              "Compile budget decision ('', 'size' or 'deferred') recorded in the stats of later modules")
+         .def("get_budget_note", &justjit::JITCore::get_budget_note, "Current compile budget note")
+         .def("set_parallel_loops", &justjit::JITCore::set_parallel_loops, "name"_a, "offsets"_a,
+              "Mark the FOR_ITER offsets of prange() loops for the next int/float compile of `name`")
+         .def("get_parallel_loops", &justjit::JITCore::get_parallel_loops, "name"_a,
+              "FOR_ITER offsets of the prange() loops the last compile of `name` runs on the pool")
+         .def("get_type_feedback", &justjit::JITCore::get_type_feedback, "name"_a,
+              "Get {offset: (opcode, count, kinds0, kinds1)} recorded for a profiled function")
+         .def("set_type_feedback", &justjit::JITCore::set_type_feedback, "name"_a, "feedback"_a,
+              "Specialize the next object-mode compile of `name` on feedback from get_type_feedback")
+         .def("get_branch_profile", &justjit::JITCore::get_branch_profile, "name"_a,
+              "Get (calls, {offset: (taken, not_taken)}) counted by a profiled function's conditional jumps")
+         .def("set_branch_profile", &justjit::JITCore::set_branch_profile, "name"_a, "profile"_a,
+              "Give the next object-mode compile of `name` entry counts and branch weights from get_branch_profile")
+         .def("set_speculation", &justjit::JITCore::set_speculation, "enabled"_a,
+              "Let later object-mode compiles with type feedback replace generic paths by deopt exits")
+         .def("get_speculation", &justjit::JITCore::get_speculation, "Check if speculation is enabled")
+         .def("get_deopt_sites", &justjit::JITCore::get_deopt_sites, "name"_a,
+              "Get the (offset, stack depth) of each speculative guard of `name`")
+         .def_static("take_deopt_frame", &justjit::JITCore::take_deopt_frame, "unbound"_a,
+                     "Take (offset, [locals..., stack...]) captured by this thread's last failed guard, or None")
+         .def("set_source_info", &justjit::JITCore::set_source_info, "name"_a, "qualname"_a, "filename"_a, "first_line"_a,
+              "Record the Python source of `name` for perf/debugger line tables and the perf map")
+         .def("set_opt_remarks", &justjit::JITCore::set_opt_remarks, "enabled"_a,
+              "Keep the LLVM optimization remarks of later compiles")
+         .def("get_opt_remarks_enabled", &justjit::JITCore::get_opt_remarks_enabled, "Check if optimization remarks are kept")
+         .def("get_opt_remarks", &justjit::JITCore::get_opt_remarks, "name"_a,
+              "Get the optimization remarks of the last compile of `name`, as dicts with a bytecode `offset`")
+         .def("compile", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::object exception_table, const std::string &name, int param_count, int total_locals, int nlocals, nb::dict jit_callees, nb::list osr_points, int region_end)
+              { return self.compile_function(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals, jit_callees, osr_points, region_end); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "nlocals"_a = 3, "jit_callees"_a = nb::dict(), "osr_points"_a = nb::list(), "region_end"_a = -1, "Compile a Python function to native code; jit_callees maps globals holding object-mode @jit entries to the entries, which are then called directly. osr_points, a list of (offset, stack depth), compiles an entry starting at those points instead (on-stack replacement, deopt resumption). region_end, with one point at a loop header, compiles only that loop; leaving it raises DeoptError with the frame for take_deopt_frame")
+         .def("compile_int", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, nb::list names)
+              { return self.compile_int_function(instructions, constants, name, param_count, total_locals, names); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "names"_a = nb::list(), "Compile an integer-only function to native code (no Python object overhead); names resolve calls to other @jit functions")
+         .def("compile_uint64", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, nb::list names)
+              { return self.compile_uint64_function(instructions, constants, name, param_count, total_locals, names); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "names"_a = nb::list(), "Compile an unsigned 64-bit function whose arithmetic wraps modulo 2**64 (hashing, checksums, PRNGs); names resolve calls to other uint64 @jit functions")
+         .def("compile_float", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, nb::list names)
+              { return self.compile_float_function(instructions, constants, name, param_count, total_locals, names); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "names"_a = nb::list(), "Compile a float-only function to native code (no Python object overhead); names resolve math.<fn> calls and calls to other @jit functions")
+         .def("compile_generator", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::object exception_table, const std::string &name, int param_count, int total_locals, int nlocals)
               { return self.compile_generator(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 0, "total_locals"_a = 1, "nlocals"_a = 1, "Compile a generator function to a state machine step function")
+         .def_static("decode_bytecode", &justjit::JITCore::decode_bytecode, "code"_a,
+                     "Decode a code object into (opcode, arg, offset) tuples, inline caches skipped")
+         .def_static("generator_supports_opcode", &justjit::JITCore::generator_supports_opcode, "opcode"_a,
+                     "Whether compile_generator can lower this opcode")
+         .def_static("function_supports_opcode", &justjit::JITCore::function_supports_opcode, "opcode"_a,
+                     "Whether compile can lower this opcode")
+         .def_static("loop_regions", &justjit::JITCore::loop_regions, "code"_a,
+                     "The (header, end) offset ranges of the loops of a code object that compile can take as a region")
+         .def("compile_typed_generator", &justjit::JITCore::compile_typed_generator, "instructions"_a, "constants"_a, "names"_a, "name"_a, "param_count"_a, "nlocals"_a, "stack_size"_a, "mode"_a,
+              "Compile an int- or float-mode generator whose locals stay unboxed across yields")
          .def("lookup", &justjit::JITCore::lookup_symbol, "name"_a)
          .def("get_callable", &justjit::JITCore::get_callable, "name"_a, "param_count"_a)
+         .def("get_osr_callable", &justjit::JITCore::get_osr_callable, "name"_a, "frame_sizes"_a, "unbound"_a,
+              "Get the callable of an OSR entry: it takes a point index and the list of its frame's locals and stack values, `unbound` for locals without a value")
          .def("get_int_callable", &justjit::JITCore::get_int_callable, "name"_a, "param_count"_a, "Get a callable for an integer-mode function")
          .def("get_float_callable", &justjit::JITCore::get_float_callable, "name"_a, "param_count"_a, "Get a callable for a float-mode function")
-         .def("compile_bool", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_bool", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_bool_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a bool-only function to native code (no Python object overhead)")
          .def("get_bool_callable", &justjit::JITCore::get_bool_callable, "name"_a, "param_count"_a, "Get a callable for a bool-mode function")
-         .def("compile_int32", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_int32_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a 32-bit integer function (C interop)")
+         .def("get_native_function", &justjit::JITCore::get_native_function, "name"_a, "param_count"_a, "mode"_a,
+              "fallback"_a = nb::none(),
+              "Get a vectorcall entry for an 'object', 'int', 'float' or 'bool' function; None if unsupported")
+         .def("compile_int32", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, nb::list names)
+              { return self.compile_int32_function(instructions, constants, name, param_count, total_locals, names); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "names"_a = nb::list(), "Compile a 32-bit integer function (C interop); names resolve rotl/rotr calls")
          .def("get_int32_callable", &justjit::JITCore::get_int32_callable, "name"_a, "param_count"_a, "Get a callable for an int32-mode function")
-         .def("compile_float32", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_float32_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a 32-bit float function (SIMD/ML)")
+         .def("compile_float32", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, nb::list names)
+              { return self.compile_float32_function(instructions, constants, name, param_count, total_locals, names); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "names"_a = nb::list(), "Compile a 32-bit float function (SIMD/ML); names resolve math.<fn> calls")
          .def("get_float32_callable", &justjit::JITCore::get_float32_callable, "name"_a, "param_count"_a, "Get a callable for a float32-mode function")
-         .def("compile_complex128", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_complex128", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_complex128_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a complex128 function (scientific computing)")
          .def("get_complex128_callable", &justjit::JITCore::get_complex128_callable, "name"_a, "param_count"_a, "Get a callable for a complex128-mode function")
-         .def("compile_ptr", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_ptr_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a ptr function (array access)")
-         .def("get_ptr_callable", &justjit::JITCore::get_ptr_callable, "name"_a, "param_count"_a, "Get a callable for a ptr-mode function")
-         .def("compile_vec4f", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_ptr", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, char elem_kind)
+              { return self.compile_ptr_function(instructions, constants, name, param_count, total_locals, elem_kind); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "elem_kind"_a = 'd', "Compile a ptr function (array access) over elem_kind items")
+         .def("get_ptr_callable", &justjit::JITCore::get_ptr_callable, "name"_a, "param_count"_a, "elem_kind"_a = 'd', "Get a callable for a ptr-mode function")
+         .def("compile_vec", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, char elem_kind, int lanes)
+              { return self.compile_vec_function(instructions, constants, name, param_count, total_locals, elem_kind, lanes); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a, "total_locals"_a, "elem_kind"_a, "lanes"_a, "Compile a <lanes x elem_kind> vector-mode function (elem_kind: f d i q)")
+         .def("get_vec_callable", &justjit::JITCore::get_vec_callable, "name"_a, "param_count"_a, "elem_kind"_a, "lanes"_a, "Get a callable for a vector-mode function")
+         .def("native_vector_lanes", &justjit::JITCore::native_vector_lanes, "elem_kind"_a, "Lanes of elem_kind in one vector register of the codegen target")
+         .def("compile_vec4f", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_vec4f_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec4f function (SSE SIMD)")
          .def("get_vec4f_callable", &justjit::JITCore::get_vec4f_callable, "name"_a, "param_count"_a, "Get a callable for a vec4f-mode function")
-         .def("compile_vec8i", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_vec8i", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_vec8i_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec8i function (AVX SIMD)")
          .def("get_vec8i_callable", &justjit::JITCore::get_vec8i_callable, "name"_a, "param_count"_a, "Get a callable for a vec8i-mode function")
-         .def("compile_complex64", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_complex64", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_complex64_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a complex64 function")
          .def("get_complex64_callable", &justjit::JITCore::get_complex64_callable, "name"_a, "param_count"_a, "Get a callable for a complex64-mode function")
-         .def("compile_optional_f64", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("get_complex_batch", &justjit::JITCore::get_complex_batch, "name"_a, "param_count"_a, "mode"_a, "(map, reduce, stream) batch callables of a complex128/complex64 function over complex buffers")
+         .def("get_cuda_batch", &justjit::JITCore::get_cuda_batch, "name"_a, "param_count"_a, "mode"_a, "(map, reduce) callables running an int/float function on the CUDA device; RuntimeError if it cannot run there")
+         .def("compile_optional_f64", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_optional_f64_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile an optional_f64 function")
          .def("get_optional_f64_callable", &justjit::JITCore::get_optional_f64_callable, "name"_a, "param_count"_a, "Get a callable for an optional_f64-mode function")
+         .def("compile_ndarray", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, const std::string &name, int param_count, int total_locals, const std::string &param_kinds)
+              { return self.compile_ndarray_function(instructions, constants, names, name, param_count, total_locals, param_kinds); }, "instructions"_a, "constants"_a, "names"_a, "name"_a, "param_count"_a, "total_locals"_a, "param_kinds"_a, "Compile an ndarray-mode specialization for the argument layout in param_kinds")
+         .def("get_ndarray_callable", &justjit::JITCore::get_ndarray_callable, "name"_a, "param_kinds"_a, "Get a callable for an ndarray-mode specialization")
+         .def("get_ndarray_written", &justjit::JITCore::get_ndarray_written, "name"_a,
+              "Bit mask of the parameters an ndarray-mode specialization stores into")
          .def("get_generator_callable", &justjit::JITCore::get_generator_callable, "name"_a, "param_count"_a, "total_locals"_a, "func_name"_a, "func_qualname"_a, "Get generator metadata for creating generator objects");
 
+     m.def("host_supports_cpu", &justjit::JITCore::host_supports_cpu, "cpu"_a,
+           "Whether code generated for LLVM CPU `cpu` (e.g. 'x86-64-v3') runs on this machine");
+     m.def("set_cache_dir", &justjit::JITCore::set_cache_dir, "path"_a,
+           "Set the on-disk object cache directory for typed-mode functions (empty string disables it)");
+     m.def("get_cache_dir", &justjit::JITCore::get_cache_dir,
+           "Get the on-disk object cache directory (empty if disabled)");
+     m.def("stats", &justjit::JITCore::get_compile_stats,
+           "Per-module compile statistics: timings, IR instruction counts, code size and mode");
+     m.def("clear_stats", &justjit::JITCore::clear_compile_stats,
+           "Drop the compile statistics recorded so far");
+     m.def("set_perf_mode", &justjit::JITCore::set_perf_mode, "mode"_a,
+           "Set Linux perf support: 'map', 'jitdump', 'all' or '' (before the first JIT is created)");
+     m.def("get_perf_mode", &justjit::JITCore::get_perf_mode,
+           "Get the Linux perf support mode ('' if off)");
+     m.def("set_gdb_support", &justjit::JITCore::set_gdb_support, "enabled"_a,
+           "Register JIT'd code with the GDB JIT interface (before the first JIT is created)");
+     m.def("get_gdb_support", &justjit::JITCore::get_gdb_support,
+           "Check if JIT'd code is registered with the GDB JIT interface");
+     m.def("set_pc_tables", &justjit::JITCore::set_pc_tables, "enabled"_a,
+           "Record PC -> bytecode offset tables of JIT'd code (before the first JIT is created)");
+     m.def("get_pc_tables", &justjit::JITCore::get_pc_tables,
+           "Check if PC -> bytecode offset tables are recorded");
+     m.def("pc_table", &justjit::JITCore::get_pc_table,
+           "Loaded functions with their native ranges and (pc, line, offset) rows");
+     m.def("lookup_pc", &justjit::JITCore::lookup_pc, "pc"_a,
+           "Function, line and bytecode offset of a native PC in JIT'd code, or None");
+     m.def("set_code_memory", &justjit::JITCore::set_code_memory, "mode"_a,
+           "Allocate JIT'd code from shared slabs: 'slab', 'huge' (2 MB aligned, THP) or '' (before the first JIT is created)");
+     m.def("get_code_memory", &justjit::JITCore::get_code_memory,
+           "Get the executable memory mode ('' if LLVM's default)");
+     m.def("code_memory_stats", &justjit::JITCore::get_code_memory_stats,
+           "Slab count, reserved bytes and bytes in use per purpose, or None without slabs");
+     m.def("memory_info", &justjit::JITCore::get_memory_info,
+           "Bytes of JIT'd code and data, pinned objects and live generator locals, in total and per function");
+     m.def("set_trace", &justjit::JITCore::set_trace, "enabled"_a,
+           "Emit per-opcode trace points in later compiles");
+     m.def("get_trace", &justjit::JITCore::get_trace,
+           "Check if later compiles get per-opcode trace points");
+     m.def("_drain_trace", &justjit::JITCore::drain_trace,
+           "Take the trace events recorded since the last drain");
+     m.def("set_latency_histograms", &justjit::JITCore::set_latency_histograms, "enabled"_a,
+           "Time native entry calls into per-function latency histograms");
+     m.def("get_latency_histograms", &justjit::JITCore::get_latency_histograms,
+           "Check if native entry calls are timed");
+     m.def("_read_latency_histograms", &justjit::JITCore::read_latency_histograms, "reset"_a,
+           "Per-function call counts, tick sums, maxima and (tick, count) buckets, with ticks per ns");
+     m.def("_start_pc_sampling", &justjit::JITCore::start_pc_sampling, "interval_us"_a,
+           "Start SIGPROF sampling of native PCs");
+     m.def("_stop_pc_sampling", &justjit::JITCore::stop_pc_sampling,
+           "Stop PC sampling; returns the samples per function, line and offset");
+
 #ifdef JUSTJIT_HAS_CLANG
      // InlineCCompiler - Compile C/C++ code at runtime using embedded Clang
      nb::class_<justjit::InlineCCompiler>(m, "InlineCCompiler")
@@ -70,8 +311,15 @@ NB_MODULE(_core, m)
          .def("add_include_path", &justjit::InlineCCompiler::add_include_path, "path"_a,
               "Add an include path for #include directives")
          .def("compile", &justjit::InlineCCompiler::compile_and_execute,
-              "code"_a, "lang"_a, "captured_vars"_a,
-              "Compile C/C++ code and return dict of callable functions")
+              "code"_a, "lang"_a, "captured_vars"_a, "opt_level"_a = 2, "march"_a = "",
+              "flags"_a = std::vector<std::string>(), "openmp"_a = false, "unit"_a = "", "nogil"_a = false,
+              "Compile C/C++ code and return dict of callable functions (march: CPU name or 'native'; "
+              "unit: add to a named unit, replacing same-named functions; nogil: release the GIL "
+              "even around code that touches Python objects without API calls)")
+         .def("unit_functions", &justjit::InlineCCompiler::unit_functions, "unit"_a,
+              "Names of the functions defined in a compilation unit")
+         .def("remove_unit", &justjit::InlineCCompiler::remove_unit, "unit"_a,
+              "Free a compilation unit's code (its callables must not be called afterwards)")
          .def("get_callable", &justjit::InlineCCompiler::get_c_callable,
               "name"_a, "signature"_a,
               "Get a callable for a previously compiled C function")
@@ -79,27 +327,476 @@ NB_MODULE(_core, m)
               "Get the LLVM IR from the last compilation");
 #endif // JUSTJIT_HAS_CLANG
 
+     // TypedList / TypedDict - unboxed storage ndarray-mode kernels index in
+     // place; items become Python ints / floats only when read from here
+     auto to_bits = [](char kind, nb::handle value) -> uint64_t {
+         if (kind == 'd') {
+             double d = nb::cast<double>(value);
+             uint64_t bits;
+             std::memcpy(&bits, &d, sizeof bits);
+             return bits;
+         }
+         if (PyFloat_Check(value.ptr())) {
+             throw nb::type_error("an int64 container holds ints, not float");
+         }
+         return static_cast<uint64_t>(nb::cast<int64_t>(value));
+     };
+     auto from_bits = [](char kind, uint64_t bits) -> nb::object {
+         if (kind == 'd') {
+             double d;
+             std::memcpy(&d, &bits, sizeof d);
+             return nb::float_(d);
+         }
+         return nb::int_(static_cast<int64_t>(bits));
+     };
+     auto check_kind = [](char kind) {
+         if (kind != 'q' && kind != 'd') {
+             throw nb::value_error("kind must be 'q' (int64) or 'd' (float64)");
+         }
+     };
+     auto list_slot = [](justjit::TypedList &list, int64_t i) -> int64_t {
+         if (i < 0) {
+             i += list.size;
+         }
+         if (i < 0 || i >= list.size) {
+             throw nb::index_error("TypedList index out of range");
+         }
+         return i;
+     };
+
+     auto dict_keys = [](const justjit::TypedDict &dict) {
+         nb::list out;
+         for (int64_t slot = 0; slot < dict.capacity; ++slot) {
+             if (dict.used[slot]) {
+                 out.append(dict.keys[slot]);
+             }
+         }
+         return out;
+     };
+
+     nb::class_<justjit::TypedList>(m, "TypedList")
+         .def("__init__", [check_kind](justjit::TypedList *self, char kind) {
+             check_kind(kind);
+             new (self) justjit::TypedList(kind);
+         }, "kind"_a = 'q', "Empty list of int64 ('q') or float64 ('d') items")
+         .def_ro("kind", &justjit::TypedList::kind)
+         .def("__len__", [](const justjit::TypedList &list) { return list.size; })
+         .def("__getitem__", [from_bits, list_slot](justjit::TypedList &list, int64_t i) {
+             return from_bits(list.kind, list.data[list_slot(list, i)]);
+         }, "index"_a)
+         .def("__setitem__", [to_bits, list_slot](justjit::TypedList &list, int64_t i, nb::handle value) {
+             list.data[list_slot(list, i)] = to_bits(list.kind, value);
+         }, "index"_a, "value"_a)
+         .def("append", [to_bits](justjit::TypedList &list, nb::handle value) {
+             if (!list.append(to_bits(list.kind, value))) {
+                 throw std::bad_alloc();
+             }
+         }, "value"_a)
+         .def("reserve", [](justjit::TypedList &list, int64_t capacity) {
+             if (!list.reserve(capacity)) {
+                 throw std::bad_alloc();
+             }
+         }, "capacity"_a, "Grow the storage to hold at least capacity items")
+         .def("clear", [](justjit::TypedList &list) { list.size = 0; })
+         .def("to_list", [from_bits](const justjit::TypedList &list) {
+             nb::list out;
+             for (int64_t i = 0; i < list.size; ++i) {
+                 out.append(from_bits(list.kind, list.data[i]));
+             }
+             return out;
+         }, "Copy of the items as a Python list");
+
+     nb::class_<justjit::TypedDict>(m, "TypedDict")
+         .def("__init__", [check_kind](justjit::TypedDict *self, char value_kind) {
+             check_kind(value_kind);
+             new (self) justjit::TypedDict(value_kind);
+         }, "value_kind"_a = 'd', "Empty dict from int64 keys to int64 ('q') or float64 ('d') values")
+         .def_ro("value_kind", &justjit::TypedDict::value_kind)
+         .def("__len__", [](const justjit::TypedDict &dict) { return dict.size; })
+         .def("__contains__", [](const justjit::TypedDict &dict, int64_t key) { return dict.find(key) >= 0; }, "key"_a)
+         .def("__getitem__", [from_bits](const justjit::TypedDict &dict, int64_t key) {
+             int64_t slot = dict.find(key);
+             if (slot < 0) {
+                 PyErr_SetObject(PyExc_KeyError, nb::int_(key).ptr());
+                 throw nb::python_error();
+             }
+             return from_bits(dict.value_kind, dict.values[slot]);
+         }, "key"_a)
+         .def("__setitem__", [to_bits](justjit::TypedDict &dict, int64_t key, nb::handle value) {
+             uint64_t bits = to_bits(dict.value_kind, value);
+             int64_t slot = dict.insert(key);
+             if (slot < 0) {
+                 throw std::bad_alloc();
+             }
+             dict.values[slot] = bits;
+         }, "key"_a, "value"_a)
+         .def("__delitem__", [](justjit::TypedDict &dict, int64_t key) {
+             if (!dict.erase(key)) {
+                 PyErr_SetObject(PyExc_KeyError, nb::int_(key).ptr());
+                 throw nb::python_error();
+             }
+         }, "key"_a)
+         .def("get", [from_bits](const justjit::TypedDict &dict, int64_t key, nb::object fallback) {
+             int64_t slot = dict.find(key);
+             return slot < 0 ? fallback : from_bits(dict.value_kind, dict.values[slot]);
+         }, "key"_a, "default"_a = nb::none())
+         .def("keys", dict_keys, "List of the keys, in table order")
+         .def("__iter__", [dict_keys](const justjit::TypedDict &dict) { return nb::iter(dict_keys(dict)); })
+         .def("items", [from_bits](const justjit::TypedDict &dict) {
+             nb::list out;
+             for (int64_t slot = 0; slot < dict.capacity; ++slot) {
+                 if (dict.used[slot]) {
+                     out.append(nb::make_tuple(dict.keys[slot], from_bits(dict.value_kind, dict.values[slot])));
+                 }
+             }
+             return out;
+         }, "List of (key, value) pairs, in table order")
+         .def("to_dict", [from_bits](const justjit::TypedDict &dict) {
+             nb::dict out;
+             for (int64_t slot = 0; slot < dict.capacity; ++slot) {
+                 if (dict.used[slot]) {
+                     out[nb::int_(dict.keys[slot])] = from_bits(dict.value_kind, dict.values[slot]);
+                 }
+             }
+             return out;
+         }, "Copy of the entries as a Python dict");
+
+     // Arrow columns: ndarray-mode kernels read their values buffer, and the
+     // justjit wrapper ANDs the inputs' validity into the output afterwards
+     auto column_row = [](const justjit::ArrowColumn &column, int64_t i) {
+          if (i < 0) {
+               i += column.length;
+          }
+          if (i < 0 || i >= column.length) {
+               throw nb::index_error("ArrowColumn index out of range");
+          }
+          return i;
+     };
+     auto column_value = [](const justjit::ArrowColumn &column, int64_t row) -> nb::object {
+          const uint8_t* item = column.values() + row * column.type->size;
+          switch (column.type->item[0]) {
+               case 'd': { double v; std::memcpy(&v, item, 8); return nb::float_(v); }
+               case 'f': { float v; std::memcpy(&v, item, 4); return nb::float_(v); }
+               case 'q': { int64_t v; std::memcpy(&v, item, 8); return nb::int_(v); }
+               case 'i': { int32_t v; std::memcpy(&v, item, 4); return nb::int_(v); }
+               case 'h': { int16_t v; std::memcpy(&v, item, 2); return nb::int_(v); }
+               case 'H': { uint16_t v; std::memcpy(&v, item, 2); return nb::int_(v); }
+               case 'b': return nb::int_(static_cast<int8_t>(*item));
+               default: return nb::int_(*item);
+          }
+     };
+
+     nb::class_<justjit::ArrowColumn>(m, "ArrowColumn", nb::type_slots(arrow_column_slots))
+         .def("__init__", [](justjit::ArrowColumn *self, const std::string &format, int64_t length) {
+             const justjit::ArrowPrimitive* type = justjit::arrow_primitive(format.c_str(), true);
+             if (type == nullptr) {
+                 throw nb::value_error(("ArrowColumn format must be one of 'd', 'f', 'q', 'i', 'h', 'H', 'b', 'B', "
+                                        "not '" + format + "'").c_str());
+             }
+             if (length < 0) {
+                 throw nb::value_error("ArrowColumn length must be non-negative");
+             }
+             new (self) justjit::ArrowColumn();
+             if (!self->allocate(type, length)) {
+                 throw std::bad_alloc();
+             }
+         }, "format"_a, "length"_a, "Zero-filled column of length items of a struct format, every row valid")
+         .def_static("from_arrow", [](nb::handle source) {
+             nb::object exported = source.attr("__arrow_c_array__")();
+             if (!nb::isinstance<nb::tuple>(exported) || nb::len(exported) != 2) {
+                 throw nb::type_error("ArrowColumn.from_arrow: __arrow_c_array__ must return (schema, array) capsules");
+             }
+             nb::tuple capsules = nb::borrow<nb::tuple>(exported);
+             auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsules[0].ptr(), "arrow_schema"));
+             auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsules[1].ptr(), "arrow_array"));
+             if (schema == nullptr || array == nullptr) {
+                 throw nb::python_error();
+             }
+             const justjit::ArrowPrimitive* type =
+                 schema->n_children == 0 && schema->dictionary == nullptr ? justjit::arrow_primitive(schema->format)
+                                                                          : nullptr;
+             if (type == nullptr) {
+                 throw nb::type_error(("ArrowColumn.from_arrow: Arrow format '" + std::string(schema->format) +
+                                       "' is not a primitive numeric type").c_str());
+             }
+             auto* column = new justjit::ArrowColumn();
+             if (array->release == nullptr || !column->import_array(array, type)) {
+                 delete column;
+                 throw nb::type_error("ArrowColumn.from_arrow: not a released-once primitive Arrow array");
+             }
+             return column;
+         }, "source"_a, nb::rv_policy::take_ownership,
+            "Column over an object's Arrow array (its __arrow_c_array__), without copying; read-only")
+         .def("__len__", [](const justjit::ArrowColumn &column) { return column.length; })
+         .def("__getitem__", [column_row, column_value](const justjit::ArrowColumn &column, int64_t i) -> nb::object {
+             int64_t row = column_row(column, i);
+             return column.is_valid(row) ? column_value(column, row) : nb::none();
+         }, "index"_a, "The value at index, or None where it is null")
+         .def("__setitem__", [column_row](justjit::ArrowColumn &column, int64_t i, nb::handle value) {
+             if (column.is_imported()) {
+                 throw nb::type_error("ArrowColumn: an imported Arrow array is read-only");
+             }
+             int64_t row = column_row(column, i);
+             if (!value.is_none()) {
+                 uint8_t* item = column.values() + row * column.type->size;
+                 switch (column.type->item[0]) {
+                      case 'd': { double v = nb::cast<double>(value); std::memcpy(item, &v, 8); break; }
+                      case 'f': { float v = nb::cast<float>(value); std::memcpy(item, &v, 4); break; }
+                      case 'q': { int64_t v = nb::cast<int64_t>(value); std::memcpy(item, &v, 8); break; }
+                      case 'i': { int32_t v = nb::cast<int32_t>(value); std::memcpy(item, &v, 4); break; }
+                      case 'h': { int16_t v = nb::cast<int16_t>(value); std::memcpy(item, &v, 2); break; }
+                      case 'H': { uint16_t v = nb::cast<uint16_t>(value); std::memcpy(item, &v, 2); break; }
+                      case 'b': *item = static_cast<uint8_t>(nb::cast<int8_t>(value)); break;
+                      default: *item = nb::cast<uint8_t>(value); break;
+                 }
+             }
+             if (!column.set_valid(row, !value.is_none())) {
+                 throw std::bad_alloc();
+             }
+         }, "index"_a, "value"_a, "Store value at index (None makes it null)")
+         .def("is_valid", [column_row](const justjit::ArrowColumn &column, int64_t i) {
+             return column.is_valid(column_row(column, i));
+         }, "index"_a)
+         .def_ro("null_count", &justjit::ArrowColumn::null_count)
+         .def_ro("offset", &justjit::ArrowColumn::offset)
+         .def_prop_ro("format", [](const justjit::ArrowColumn &column) { return column.type->item; },
+                      "Struct format of the values ('d', 'q', ...)")
+         .def_prop_ro("arrow_format", [](const justjit::ArrowColumn &column) { return column.type->arrow; },
+                      "Arrow C Data Interface format string of the values")
+         .def_prop_ro("writable", [](const justjit::ArrowColumn &column) { return !column.is_imported(); })
+         .def("to_pylist", [column_value](const justjit::ArrowColumn &column) {
+             nb::list out;
+             for (int64_t row = 0; row < column.length; ++row) {
+                 out.append(column.is_valid(row) ? column_value(column, row) : nb::none());
+             }
+             return out;
+         }, "Copy of the values as a Python list, None for nulls")
+         .def("propagate_validity", [](justjit::ArrowColumn &column, nb::sequence inputs) {
+             if (column.is_imported()) {
+                 throw nb::type_error("ArrowColumn: an imported Arrow array is read-only");
+             }
+             std::vector<const justjit::ArrowColumn*> columns;
+             for (nb::handle input : inputs) {
+                 if (!nb::isinstance<justjit::ArrowColumn>(input)) {
+                     continue;  // Scalars and plain arrays have no nulls
+                 }
+                 const justjit::ArrowColumn* source = nb::inst_ptr<justjit::ArrowColumn>(input);
+                 if (source->length != column.length) {
+                     throw nb::value_error("propagate_validity: input column lengths differ from the output's");
+                 }
+                 columns.push_back(source);
+             }
+             if (!column.set_validity_and(columns.data(), columns.size())) {
+                 throw std::bad_alloc();
+             }
+         }, "inputs"_a,
+            "Make each row null where any input column's row is null, 64 rows per bitmap word (elementwise kernels)")
+         .def("__arrow_c_array__", [](nb::handle self, nb::handle requested_schema) {
+             // requested_schema is a hint the C Data Interface lets producers ignore
+             (void)requested_schema;
+             justjit::ArrowColumn* column = nb::inst_ptr<justjit::ArrowColumn>(self);
+             auto* schema = new ArrowSchema{};
+             schema->format = column->type->arrow;
+             schema->name = "";
+             schema->flags = ARROW_FLAG_NULLABLE;
+             schema->release = arrow_export_release_schema;
+             auto* data = new ArrowExport{{column->validity, column->values_base}, Py_NewRef(self.ptr())};
+             auto* array = new ArrowArray{};
+             array->length = column->length;
+             array->null_count = column->validity != nullptr ? column->null_count : 0;
+             array->offset = column->offset;
+             array->n_buffers = 2;
+             array->buffers = data->buffers;
+             array->release = arrow_export_release_array;
+             array->private_data = data;
+             nb::object schema_capsule = nb::steal(PyCapsule_New(schema, "arrow_schema", arrow_schema_capsule_destructor));
+             if (!schema_capsule.is_valid()) {
+                 delete schema;
+                 arrow_export_release_array(array);
+                 delete array;
+                 throw nb::python_error();
+             }
+             nb::object array_capsule = nb::steal(PyCapsule_New(array, "arrow_array", arrow_array_capsule_destructor));
+             if (!array_capsule.is_valid()) {
+                 arrow_export_release_array(array);
+                 delete array;
+                 throw nb::python_error();
+             }
+             return nb::make_tuple(schema_capsule, array_capsule);
+         }, "requested_schema"_a = nb::none(),
+            "Arrow PyCapsule interface: (schema, array) capsules sharing this column's buffers");
+
+     m.def("foreign_array", [](nb::handle obj) -> nb::object {
+         PyObject* view = justjit::jit_foreign_array(obj.ptr());
+         if (view == nullptr) {
+             if (PyErr_Occurred()) {
+                 throw nb::python_error();
+             }
+             return nb::none();
+         }
+         return nb::steal(view);
+     }, "obj"_a,
+        "Buffer-protocol view sharing the memory of an __array_interface__ or DLPack (__dlpack__) array; "
+        "None if obj has neither");
+
+     m.def("bfloat16_view", [](nb::handle obj) -> nb::object {
+         PyObject* view = justjit::jit_bfloat16_view(obj.ptr());
+         if (view == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(view);
+     }, "obj"_a, "View of a buffer of 2-byte items (bfloat16 bits, usually stored as uint16) as bfloat16 ('E') items");
+
+     m.def("pooled_buffer", [](const std::string &format, Py_ssize_t itemsize, std::vector<Py_ssize_t> shape,
+                               bool zero) {
+         PyObject* buffer = justjit::jit_pooled_buffer(format.c_str(), itemsize, static_cast<int>(shape.size()),
+                                                       shape.data(), zero);
+         if (buffer == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(buffer);
+     }, "format"_a, "itemsize"_a, "shape"_a, "zero"_a = true,
+        "C-contiguous writable buffer from the 64-byte aligned result pool; its memory is reused once released");
+
+     m.def("buffer_pool_stats", []() {
+         justjit::BufferPoolStats stats = justjit::jit_buffer_pool_stats();
+         nb::dict out;
+         out["allocations"] = stats.allocations;
+         out["reused"] = stats.reused;
+         out["retained_bytes"] = stats.retained;
+         return out;
+     }, "Counters of the result buffer pool: buffers handed out, how many were reused, bytes held for reuse");
+
+     m.def("cuda_status", []() -> nb::object {
+         const char* why = justjit::jit_cuda_status();
+         return why == nullptr ? nb::none() : nb::str(why);
+     }, "None when target='cuda' kernels can run on CUDA device 0, else why they cannot");
+
+     m.def("to_device", [](nb::handle obj) {
+         PyObject* array = justjit::jit_to_device(obj.ptr());
+         if (array == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(array);
+     }, "obj"_a, "DeviceArray copy of a 1-D int64 or float64 buffer in CUDA device memory");
+
+     // Created here, before any compile embeds or matches it: a failure
+     // fails the import instead of leaving later users a NULL type
+     PyObject *deopt_error = justjit::jit_deopt_error();
+     if (deopt_error == nullptr) {
+         throw nb::python_error();
+     }
+     m.attr("DeoptError") = nb::borrow(deopt_error);
+
+     m.def("parallel_threads", &justjit::jit_parallel_threads,
+           "Number of threads parallel batch calls use (JUSTJIT_NUM_THREADS, default one per allowed CPU)");
+     m.def("_prange_stats", []() {
+         justjit::PrangeStats stats = justjit::jit_prange_stats();
+         nb::dict out;
+         out["runs"] = stats.runs;
+         out["chunks"] = stats.chunks;
+         out["threads"] = stats.threads;
+         return out;
+     }, "prange loop runs so far, and the chunks and distinct threads of the last one");
+
+     m.def("numa_topology", []() { return justjit::jit_numa_topology().nodes; },
+           "CPU numbers of each NUMA node the parallel pool places threads on");
+
+     m.def("set_numa_topology", [](std::vector<std::vector<int>> nodes) {
+         if (!justjit::jit_set_numa_topology(justjit::NumaTopology{std::move(nodes)})) {
+             throw std::runtime_error(
+                 "the NUMA topology must be non-empty lists of CPUs, set before the parallel pool starts");
+         }
+     }, "nodes"_a, "Place parallel threads on these NUMA nodes (lists of CPUs) instead of the detected ones");
+
+     m.def("run_pipeline", [](nb::handle source, nb::tuple stages, nb::handle reduce, nb::handle initial,
+                              Py_ssize_t batch, Py_ssize_t depth) {
+         PyObject* result = justjit::run_generator_pipeline(source.ptr(), stages.ptr(), reduce.ptr(), initial.ptr(),
+                                                            batch, depth);
+         if (result == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(result);
+     }, "source"_a, "stages"_a, "reduce"_a = nb::none(), "initial"_a = nb::none(), "batch"_a = 1024, "depth"_a = 4,
+        "Run a typed generator through a chain of @jit stages, one thread per stage (see justjit.pipeline)");
+
+     m.def("bind_arguments", &justjit::bind_call_arguments, "func"_a, "args"_a, "kwargs"_a,
+           "Bind a call to a function's parameters in local-slot order, applying defaults");
+
      // Expose the JITGenerator type and creation function
-     m.def("create_jit_generator", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
+     m.def("create_jit_generator", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname,
+                                      nb::object owner) {
          auto step_func = reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr);
          PyObject* gen = justjit::JITGenerator_New(step_func, static_cast<Py_ssize_t>(num_locals),
-                                                    name.ptr(), qualname.ptr());
+                                                    name.ptr(), qualname.ptr(), -1,
+                                                    owner.is_none() ? nullptr : owner.ptr());
          if (gen == nullptr) {
              throw nb::python_error();
          }
          return nb::steal(gen);
-     }, "step_func_addr"_a, "num_locals"_a, "name"_a, "qualname"_a,
-        "Create a new JIT generator object from a compiled step function");
+     }, "step_func_addr"_a, "num_locals"_a, "name"_a, "qualname"_a, "owner"_a = nb::none(),
+        "Create a new JIT generator object from a compiled step function (owner: JIT instance kept alive for it)");
      
      // Expose the JITCoroutine type and creation function
-     m.def("create_jit_coroutine", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
+     m.def("create_jit_coroutine", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname,
+                                      nb::object owner) {
          auto step_func = reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr);
          PyObject* coro = justjit::JITCoroutine_New(step_func, static_cast<Py_ssize_t>(num_locals),
-                                                     name.ptr(), qualname.ptr());
+                                                     name.ptr(), qualname.ptr(),
+                                                     owner.is_none() ? nullptr : owner.ptr());
          if (coro == nullptr) {
              throw nb::python_error();
          }
          return nb::steal(coro);
-     }, "step_func_addr"_a, "num_locals"_a, "name"_a, "qualname"_a,
-        "Create a new JIT coroutine object from a compiled step function");
+     }, "step_func_addr"_a, "num_locals"_a, "name"_a, "qualname"_a, "owner"_a = nb::none(),
+        "Create a new JIT coroutine object from a compiled step function (owner: JIT instance kept alive for it)");
+
+     // Callable that creates generators/coroutines and binds arguments natively
+     m.def("create_generator_factory", [](uint64_t step_func_addr, int64_t num_locals, nb::handle func,
+                                          nb::object name, nb::object qualname, const std::string &kind,
+                                          nb::object owner, int64_t object_locals) {
+         justjit::GeneratorFactoryKind factory_kind;
+         if (kind == "generator") {
+             factory_kind = justjit::GeneratorFactoryKind::GENERATOR;
+         } else if (kind == "coroutine") {
+             factory_kind = justjit::GeneratorFactoryKind::COROUTINE;
+         } else if (kind == "async_generator") {
+             factory_kind = justjit::GeneratorFactoryKind::ASYNC_GENERATOR;
+         } else {
+             throw nb::value_error(("unknown generator factory kind '" + kind + "'").c_str());
+         }
+         auto step_func = reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr);
+         PyObject* factory = justjit::JITGeneratorFactory_New(step_func, static_cast<Py_ssize_t>(num_locals),
+                                                                factory_kind, func.ptr(), name.ptr(), qualname.ptr(),
+                                                                owner.is_none() ? nullptr : owner.ptr(),
+                                                                static_cast<Py_ssize_t>(object_locals));
+         if (factory == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(factory);
+     }, "step_func_addr"_a, "num_locals"_a, "func"_a, "name"_a, "qualname"_a, "kind"_a = "generator",
+        "owner"_a = nb::none(), "object_locals"_a = -1,
+        "Create a callable that makes JIT generators (coroutines, async generators) with func's argument binding; "
+        "object_locals limits the slots holding references (typed generators)");
+
+     m.def("step_coroutines", [](nb::list coros, nb::handle ready, nb::list results, bool return_exceptions) {
+         PyObject* blocked = justjit::step_coroutines(coros.ptr(), ready.ptr(), results.ptr(), return_exceptions);
+         if (blocked == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(blocked);
+     }, "coros"_a, "ready"_a, "results"_a, "return_exceptions"_a = false,
+        "Resume the ready coroutines in one loop until each returns, raises or awaits a future; "
+        "returns the (index, future) pairs of the last kind (see justjit.gather)");
+
+     // mode='auto' callable dispatching on the exact argument types
+     m.def("create_dispatcher", [](nb::object name, nb::object miss) {
+         PyObject* dispatcher = justjit::JITDispatcher_New(name.ptr(), miss.ptr());
+         if (dispatcher == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(dispatcher);
+     }, "name"_a, "miss"_a,
+        "Create a callable routing each argument type signature to its registered variant; "
+        "calls no variant takes go to miss");
 }
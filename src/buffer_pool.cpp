@@ -0,0 +1,197 @@
+/**
+ * buffer_pool.cpp - Size-classed pool behind jit_pooled_buffer
+ *
+ * Sizes are rounded up to a power of two from 64 bytes to 64 MiB; each
+ * class keeps a free list, and up to kRetained bytes in all are kept for
+ * reuse. Larger buffers are allocated and freed directly. Every block is
+ * 64-byte aligned, a cache line and an AVX-512 vector.
+ *
+ * On a NUMA machine large zeroed buffers are zeroed on the parallel pool,
+ * so each page starts out on the node whose threads will work on it.
+ */
+
+#include "buffer_pool.h"
+#include "numa_topology.h"
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace justjit {
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+constexpr int kClasses = 21;                         // 64 B .. 64 MiB
+constexpr uint64_t kRetained = 64ull * 1024 * 1024;  // Free bytes kept for reuse
+constexpr size_t kFirstTouchBytes = 256 * 1024;      // 8-byte items of a parallel job (JIT_PARALLEL_MIN_ITEMS)
+
+struct BufferPool {
+    std::mutex mutex;
+    std::vector<void*> free[kClasses];
+    BufferPoolStats stats;
+};
+
+BufferPool& buffer_pool()
+{
+    // Never destroyed: buffers may be released during interpreter shutdown
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+// Size class holding `bytes`, or -1 for a direct allocation
+int size_class(size_t bytes)
+{
+    int k = 0;
+    while (k < kClasses && (kAlignment << k) < bytes) {
+        ++k;
+    }
+    return k < kClasses ? k : -1;
+}
+
+void* pool_allocate(size_t bytes, int klass)
+{
+    BufferPool& pool = buffer_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        ++pool.stats.allocations;
+        if (klass >= 0 && !pool.free[klass].empty()) {
+            void* block = pool.free[klass].back();
+            pool.free[klass].pop_back();
+            pool.stats.retained -= kAlignment << klass;
+            ++pool.stats.reused;
+            return block;
+        }
+    }
+    size_t capacity = klass >= 0 ? kAlignment << klass : (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    return ::operator new(capacity, std::align_val_t(kAlignment), std::nothrow);
+}
+
+void pool_release(void* block, int klass)
+{
+    if (klass >= 0) {
+        BufferPool& pool = buffer_pool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.stats.retained + (kAlignment << klass) <= kRetained) {
+            pool.free[klass].push_back(block);
+            pool.stats.retained += kAlignment << klass;
+            return;
+        }
+    }
+    ::operator delete(block, std::align_val_t(kAlignment));
+}
+
+struct PooledBufferObject {
+    PyObject_HEAD
+    void* data;
+    int klass;
+    int ndim;
+    Py_ssize_t itemsize;
+    Py_ssize_t length;  // In bytes
+    char format[8];
+    Py_ssize_t shape[PyBUF_MAX_NDIM];
+    Py_ssize_t strides[PyBUF_MAX_NDIM];
+};
+
+PyTypeObject* pooled_buffer_type = nullptr;
+
+int pooled_buffer_getbuffer(PyObject* obj, Py_buffer* view, int flags)
+{
+    auto* self = reinterpret_cast<PooledBufferObject*>(obj);
+    view->buf = self->data;
+    view->obj = Py_NewRef(obj);
+    view->len = self->length;
+    view->readonly = 0;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? self->format : nullptr;
+    view->ndim = self->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+void pooled_buffer_dealloc(PyObject* obj)
+{
+    auto* self = reinterpret_cast<PooledBufferObject*>(obj);
+    if (self->data != nullptr) {
+        pool_release(self->data, self->klass);
+    }
+    PyTypeObject* type = Py_TYPE(obj);
+    type->tp_free(obj);
+    Py_DECREF(type);
+}
+
+}  // namespace
+
+PyObject* jit_pooled_buffer(const char* format, Py_ssize_t itemsize, int ndim, const Py_ssize_t* shape, bool zero)
+{
+    if (std::strlen(format) >= sizeof(PooledBufferObject::format) || itemsize <= 0 || ndim < 0 ||
+        ndim > PyBUF_MAX_NDIM) {
+        PyErr_SetString(PyExc_ValueError, "unsupported pooled buffer layout");
+        return nullptr;
+    }
+    Py_ssize_t count = 1;
+    for (int d = 0; d < ndim; ++d) {
+        if (shape[d] < 0 || (shape[d] != 0 && count > PY_SSIZE_T_MAX / itemsize / shape[d])) {
+            PyErr_SetString(PyExc_ValueError, "pooled buffer shape is negative or too large");
+            return nullptr;
+        }
+        count *= shape[d];
+    }
+    if (pooled_buffer_type == nullptr) {
+        static PyType_Slot slots[] = {
+            {Py_bf_getbuffer, reinterpret_cast<void*>(pooled_buffer_getbuffer)},
+            {Py_tp_dealloc, reinterpret_cast<void*>(pooled_buffer_dealloc)},
+            {Py_tp_doc, const_cast<char*>("Array memory from the JIT's result buffer pool")},
+            {0, nullptr},
+        };
+        static PyType_Spec spec = {"justjit.PooledBuffer", sizeof(PooledBufferObject), 0, Py_TPFLAGS_DEFAULT, slots};
+        pooled_buffer_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+        if (pooled_buffer_type == nullptr) {
+            return nullptr;
+        }
+    }
+    auto* self = PyObject_New(PooledBufferObject, pooled_buffer_type);
+    if (self == nullptr) {
+        return nullptr;
+    }
+    self->data = nullptr;
+    size_t bytes = static_cast<size_t>(count * itemsize);
+    self->klass = size_class(bytes > 0 ? bytes : 1);
+    self->data = pool_allocate(bytes, self->klass);
+    if (self->data == nullptr) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    if (zero && bytes >= kFirstTouchBytes && jit_numa_topology().nodes.size() > 1) {
+        Py_BEGIN_ALLOW_THREADS
+        jit_first_touch_zero(self->data, bytes);
+        Py_END_ALLOW_THREADS
+    }
+    else if (zero) {
+        std::memset(self->data, 0, bytes);
+    }
+    self->ndim = ndim;
+    self->itemsize = itemsize;
+    self->length = static_cast<Py_ssize_t>(bytes);
+    std::strcpy(self->format, format);
+    Py_ssize_t stride = itemsize;
+    for (int d = ndim - 1; d >= 0; --d) {
+        self->shape[d] = shape[d];
+        self->strides[d] = stride;
+        stride *= shape[d];
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+BufferPoolStats jit_buffer_pool_stats()
+{
+    BufferPool& pool = buffer_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.stats;
+}
+
+}  // namespace justjit
@@ -0,0 +1,38 @@
+/**
+ * buffer_pool.h - Pooled, 64-byte aligned result buffers
+ *
+ * Provides:
+ * - jit_pooled_buffer: a writable, C-contiguous buffer-protocol object over
+ *   memory from a size-classed pool; the memory goes back to the pool when
+ *   the last view of it (a memoryview, a NumPy array's base) is released
+ * - jit_buffer_pool_stats: counters of the pool
+ *
+ * Array results (ndarray-mode outputs the wrapper allocates, NumPy results
+ * of vector and batch calls) come from here, so a kernel called in a loop
+ * reuses the previous call's memory instead of allocating and zeroing a
+ * fresh array each time.
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace justjit {
+
+struct BufferPoolStats {
+    uint64_t allocations = 0;  // Buffers handed out
+    uint64_t reused = 0;       // ... of which came from the pool
+    uint64_t retained = 0;     // Bytes held for reuse
+};
+
+// New reference to a buffer of `ndim` dimensions `shape` holding `format`
+// items of `itemsize` bytes, zero-filled when `zero`; NULL with an exception
+// set if out of memory
+PyObject* jit_pooled_buffer(const char* format, Py_ssize_t itemsize, int ndim, const Py_ssize_t* shape, bool zero);
+
+BufferPoolStats jit_buffer_pool_stats();
+
+}  // namespace justjit
@@ -0,0 +1,243 @@
+/**
+ * compile_arena.h - Bump allocation for the bytecode frontend's per-compile data
+ *
+ * Provides:
+ * - CompileArena: per-thread bump allocator whose blocks are kept and reused
+ *   by the next compile on the same thread
+ * - ArenaAllocator / ArenaVector: STL containers drawing from it
+ * - OffsetMap: flat map keyed by bytecode offset or local slot
+ *
+ * A compile opens a CompileArena::Scope; everything allocated inside is
+ * released at once when the scope closes. Containers must not outlive it.
+ * ndarray-mode calls open one too, for the items of list arguments they
+ * unbox.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace justjit {
+
+// ============================================================================
+// CompileArena - Per-thread bump allocator with scoped release
+// ============================================================================
+class CompileArena {
+public:
+    static constexpr size_t kMinBlock = 64 * 1024;
+    static constexpr size_t kRetained = 8 * 1024 * 1024;  // Kept across compiles
+
+    static CompileArena& current() {
+        thread_local CompileArena arena;
+        return arena;
+    }
+
+    void* allocate(size_t size, size_t align) {
+        while (block_ < blocks_.size()) {
+            Block& block = blocks_[block_];
+            size_t start = (used_ + align - 1) & ~(align - 1);
+            if (start + size <= block.size) {
+                used_ = start + size;
+                return block.data.get() + start;
+            }
+            ++block_;
+            used_ = 0;
+        }
+        size_t capacity = std::max(kMinBlock, blocks_.empty() ? size_t(0) : blocks_.back().size * 2);
+        capacity = std::max(capacity, size + align);
+        blocks_.push_back(Block{std::unique_ptr<char[]>(new char[capacity]), capacity});
+        block_ = blocks_.size() - 1;
+        used_ = 0;
+        return allocate(size, align);
+    }
+
+    // Releases what was allocated since construction; nests
+    class Scope {
+    public:
+        Scope() : arena_(current()), block_(arena_.block_), used_(arena_.used_) {}
+        ~Scope() { arena_.rewind(block_, used_); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CompileArena& arena_;
+        size_t block_;
+        size_t used_;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void rewind(size_t block, size_t used) {
+        block_ = block;
+        used_ = used;
+        if (block == 0 && used == 0) {
+            // Outermost scope: drop what an unusually large compile grew
+            size_t total = 0;
+            size_t keep = 0;
+            while (keep < blocks_.size() && total + blocks_[keep].size <= kRetained) {
+                total += blocks_[keep++].size;
+            }
+            if (blocks_.size() > std::max<size_t>(keep, 1)) {
+                blocks_.erase(blocks_.begin() + std::max<size_t>(keep, 1), blocks_.end());
+            }
+        }
+    }
+
+    std::vector<Block> blocks_;
+    size_t block_ = 0;
+    size_t used_ = 0;
+};
+
+// ============================================================================
+// ArenaAllocator - STL allocator over the current thread's CompileArena
+// ============================================================================
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    CompileArena* arena;
+
+    ArenaAllocator() noexcept : arena(&CompileArena::current()) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}  // Freed with the scope
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// ============================================================================
+// OffsetMap - Flat map from a small int key (bytecode offset, local slot)
+// ============================================================================
+// A slot array indexed by key points at entries bump-allocated one by one,
+// so references stay valid as the map grows, like the node-based maps it
+// replaces. Iteration is in key order. Negative keys (bytecode arguments
+// can be) go to a short side list.
+template<typename T>
+class OffsetMap {
+public:
+    struct Entry {
+        int first;
+        T second;
+    };
+
+    class iterator {
+    public:
+        iterator(const OffsetMap* map, size_t index) : map_(map), index_(index) { skip(); }
+        Entry& operator*() const { return *at(); }
+        Entry* operator->() const { return at(); }
+        iterator& operator++() { ++index_; skip(); return *this; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+    private:
+        // Negative keys first, then the slots
+        Entry* at() const {
+            size_t negatives = map_->negative_.size();
+            return index_ < negatives ? map_->negative_[index_] : map_->slots_[index_ - negatives];
+        }
+        void skip() {
+            size_t negatives = map_->negative_.size();
+            while (index_ >= negatives && index_ - negatives < map_->slots_.size() &&
+                   map_->slots_[index_ - negatives] == nullptr) {
+                ++index_;
+            }
+        }
+
+        const OffsetMap* map_;
+        size_t index_;
+    };
+
+    explicit OffsetMap(size_t key_limit = 0) { slots_.reserve(key_limit); }
+    OffsetMap(const OffsetMap&) = delete;
+    OffsetMap& operator=(const OffsetMap&) = delete;
+    OffsetMap(OffsetMap&&) = default;
+
+    ~OffsetMap() {
+        for (Entry* entry : negative_) {
+            entry->~Entry();
+        }
+        for (Entry* entry : slots_) {
+            if (entry != nullptr) {
+                entry->~Entry();
+            }
+        }
+    }
+
+    size_t count(int key) const { return lookup(key) != nullptr ? 1 : 0; }
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    T& operator[](int key) {
+        if (Entry* entry = lookup(key)) {
+            return entry->second;
+        }
+        Entry* entry = new (slots_.get_allocator().arena->allocate(sizeof(Entry), alignof(Entry))) Entry{key, T()};
+        if (key < 0) {
+            negative_.push_back(entry);
+        } else {
+            if (static_cast<size_t>(key) >= slots_.size()) {
+                slots_.resize(static_cast<size_t>(key) + 1, nullptr);
+            }
+            slots_[key] = entry;
+        }
+        ++size_;
+        return entry->second;
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, negative_.size() + slots_.size()); }
+
+    iterator find(int key) const {
+        if (key < 0) {
+            for (size_t i = 0; i < negative_.size(); ++i) {
+                if (negative_[i]->first == key) {
+                    return iterator(this, i);
+                }
+            }
+            return end();
+        }
+        if (lookup(key) == nullptr) {
+            return end();
+        }
+        return iterator(this, negative_.size() + static_cast<size_t>(key));
+    }
+
+private:
+    Entry* lookup(int key) const {
+        if (key < 0) {
+            for (Entry* entry : negative_) {
+                if (entry->first == key) {
+                    return entry;
+                }
+            }
+            return nullptr;
+        }
+        return static_cast<size_t>(key) < slots_.size() ? slots_[key] : nullptr;
+    }
+
+    ArenaVector<Entry*> slots_;
+    ArenaVector<Entry*> negative_;
+    size_t size_ = 0;
+};
+
+} // namespace justjit
@@ -0,0 +1,792 @@
+/**
+ * cuda_offload.cpp - CUDA driver calls behind jit(target='cuda')
+ *
+ * The few driver API entry points used are looked up in libcuda at run
+ * time. Kernels run on device 0 in its primary context, the one the CUDA
+ * runtime (and so CuPy, PyTorch and Numba) uses, so their device pointers
+ * are valid here. Every call synchronizes the context before its launch,
+ * which orders it after work queued for its operands on any stream, and
+ * again after it, so results are ready when the call returns.
+ */
+
+#include "cuda_offload.h"
+#include "foreign_arrays.h"
+
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace justjit {
+
+namespace {
+
+using CUresult = int;
+using CUdevice = int;
+using CUdeviceptr = unsigned long long;
+using CUcontext = void*;
+using CUmodule = void*;
+using CUfunction = void*;
+using CUstream = void*;
+
+constexpr CUresult CUDA_SUCCESS = 0;
+constexpr int CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR = 75;
+constexpr int CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR = 76;
+constexpr int CU_JIT_ERROR_LOG_BUFFER = 5;
+constexpr int CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES = 6;
+
+constexpr unsigned kBlockSize = 256;
+constexpr int64_t kMaxBlocks = 65535;      // Grid-stride loops cover longer maps
+constexpr int64_t kReduceThreads = 65536;  // Partial folds of a reduce, at most
+
+struct CudaDriver {
+    CUresult (*cuInit)(unsigned) = nullptr;
+    CUresult (*cuDeviceGetCount)(int*) = nullptr;
+    CUresult (*cuDeviceGet)(CUdevice*, int) = nullptr;
+    CUresult (*cuDeviceGetAttribute)(int*, int, CUdevice) = nullptr;
+    CUresult (*cuDevicePrimaryCtxRetain)(CUcontext*, CUdevice) = nullptr;
+    CUresult (*cuCtxPushCurrent)(CUcontext) = nullptr;
+    CUresult (*cuCtxPopCurrent)(CUcontext*) = nullptr;
+    CUresult (*cuCtxSynchronize)() = nullptr;
+    CUresult (*cuModuleLoadDataEx)(CUmodule*, const void*, unsigned, int*, void**) = nullptr;
+    CUresult (*cuModuleGetFunction)(CUfunction*, CUmodule, const char*) = nullptr;
+    CUresult (*cuModuleUnload)(CUmodule) = nullptr;
+    CUresult (*cuMemAlloc)(CUdeviceptr*, size_t) = nullptr;
+    CUresult (*cuMemFree)(CUdeviceptr) = nullptr;
+    CUresult (*cuMemcpyHtoD)(CUdeviceptr, const void*, size_t) = nullptr;
+    CUresult (*cuMemcpyDtoH)(void*, CUdeviceptr, size_t) = nullptr;
+    CUresult (*cuLaunchKernel)(CUfunction, unsigned, unsigned, unsigned, unsigned, unsigned, unsigned, unsigned,
+                               CUstream, void**, void**) = nullptr;
+    CUresult (*cuGetErrorString)(CUresult, const char**) = nullptr;
+
+    bool ready = false;
+    std::string error;  // Why not ready
+    CUcontext context = nullptr;
+    int capability = 0;
+};
+
+template <typename Fn>
+bool bind_symbol(void* library, const char* symbol, Fn& fn)
+{
+#ifdef _WIN32
+    fn = reinterpret_cast<Fn>(reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), symbol)));
+#else
+    fn = reinterpret_cast<Fn>(dlsym(library, symbol));
+#endif
+    return fn != nullptr;
+}
+
+std::string driver_error(const CudaDriver& driver, CUresult result, const char* call)
+{
+    const char* text = nullptr;
+    if (driver.cuGetErrorString == nullptr || driver.cuGetErrorString(result, &text) != CUDA_SUCCESS ||
+        text == nullptr) {
+        text = "unknown error";
+    }
+    return std::string(call) + " failed: " + text + " (" + std::to_string(result) + ")";
+}
+
+// Empty on success, else why the driver cannot be used
+std::string load_driver(CudaDriver& driver)
+{
+#ifdef _WIN32
+    void* library = reinterpret_cast<void*>(LoadLibraryA("nvcuda.dll"));
+#else
+    void* library = dlopen("libcuda.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr) {
+        library = dlopen("libcuda.so", RTLD_NOW | RTLD_LOCAL);
+    }
+#endif
+    if (library == nullptr) {
+        return "the CUDA driver (libcuda) is not installed";
+    }
+    bool bound = bind_symbol(library, "cuInit", driver.cuInit) &&
+                 bind_symbol(library, "cuDeviceGetCount", driver.cuDeviceGetCount) &&
+                 bind_symbol(library, "cuDeviceGet", driver.cuDeviceGet) &&
+                 bind_symbol(library, "cuDeviceGetAttribute", driver.cuDeviceGetAttribute) &&
+                 bind_symbol(library, "cuDevicePrimaryCtxRetain", driver.cuDevicePrimaryCtxRetain) &&
+                 bind_symbol(library, "cuCtxPushCurrent_v2", driver.cuCtxPushCurrent) &&
+                 bind_symbol(library, "cuCtxPopCurrent_v2", driver.cuCtxPopCurrent) &&
+                 bind_symbol(library, "cuCtxSynchronize", driver.cuCtxSynchronize) &&
+                 bind_symbol(library, "cuModuleLoadDataEx", driver.cuModuleLoadDataEx) &&
+                 bind_symbol(library, "cuModuleGetFunction", driver.cuModuleGetFunction) &&
+                 bind_symbol(library, "cuModuleUnload", driver.cuModuleUnload) &&
+                 bind_symbol(library, "cuMemAlloc_v2", driver.cuMemAlloc) &&
+                 bind_symbol(library, "cuMemFree_v2", driver.cuMemFree) &&
+                 bind_symbol(library, "cuMemcpyHtoD_v2", driver.cuMemcpyHtoD) &&
+                 bind_symbol(library, "cuMemcpyDtoH_v2", driver.cuMemcpyDtoH) &&
+                 bind_symbol(library, "cuLaunchKernel", driver.cuLaunchKernel) &&
+                 bind_symbol(library, "cuGetErrorString", driver.cuGetErrorString);
+    if (!bound) {
+        return "the CUDA driver lacks driver API entry points this needs";
+    }
+    CUresult result = driver.cuInit(0);
+    if (result != CUDA_SUCCESS) {
+        return driver_error(driver, result, "cuInit");
+    }
+    int count = 0;
+    result = driver.cuDeviceGetCount(&count);
+    if (result != CUDA_SUCCESS) {
+        return driver_error(driver, result, "cuDeviceGetCount");
+    }
+    if (count == 0) {
+        return "no CUDA device found";
+    }
+    CUdevice device = 0;
+    int major = 0;
+    int minor = 0;
+    if ((result = driver.cuDeviceGet(&device, 0)) != CUDA_SUCCESS ||
+        (result = driver.cuDeviceGetAttribute(&major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, device)) !=
+            CUDA_SUCCESS ||
+        (result = driver.cuDeviceGetAttribute(&minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, device)) !=
+            CUDA_SUCCESS) {
+        return driver_error(driver, result, "cuDeviceGet");
+    }
+    result = driver.cuDevicePrimaryCtxRetain(&driver.context, device);
+    if (result != CUDA_SUCCESS) {
+        return driver_error(driver, result, "cuDevicePrimaryCtxRetain");
+    }
+    driver.capability = major * 10 + minor;
+    return "";
+}
+
+// The driver, loaded on first use with the GIL held; the calls themselves
+// may run without it
+CudaDriver& cuda_driver()
+{
+    // Never destroyed: device memory may be freed during interpreter shutdown
+    static CudaDriver* driver = nullptr;
+    if (driver == nullptr) {
+        driver = new CudaDriver();
+        driver->error = load_driver(*driver);
+        driver->ready = driver->error.empty();
+    }
+    return *driver;
+}
+
+// Makes the primary context current for a scope
+struct ContextScope {
+    CudaDriver& driver;
+    CUresult result;
+
+    explicit ContextScope(CudaDriver& driver) : driver(driver), result(driver.cuCtxPushCurrent(driver.context)) {}
+    ~ContextScope()
+    {
+        if (result == CUDA_SUCCESS) {
+            CUcontext popped;
+            driver.cuCtxPopCurrent(&popped);
+        }
+    }
+};
+
+// The first failed driver call of a sequence made without the GIL
+struct CudaCalls {
+    CUresult result = CUDA_SUCCESS;
+    const char* failed = nullptr;
+
+    bool operator()(CUresult r, const char* call)
+    {
+        if (r != CUDA_SUCCESS && failed == nullptr) {
+            result = r;
+            failed = call;
+        }
+        return failed == nullptr;
+    }
+
+    // False with a RuntimeError set if a call failed; needs the GIL
+    bool check(const CudaDriver& driver) const
+    {
+        if (failed == nullptr) {
+            return true;
+        }
+        PyErr_Format(PyExc_RuntimeError, "CUDA error: %s", driver_error(driver, result, failed).c_str());
+        return false;
+    }
+};
+
+// --- DeviceArray: 1-D int64 / float64 device memory owned by justjit ---
+
+struct DeviceArrayObject {
+    PyObject_HEAD
+    CUdeviceptr data;
+    Py_ssize_t length;
+    char elem;  // 'q' int64, 'd' float64
+};
+
+PyTypeObject* device_array_type = nullptr;
+
+PyObject* host_array(char elem, Py_ssize_t n);
+
+void device_array_dealloc(PyObject* obj)
+{
+    auto* self = reinterpret_cast<DeviceArrayObject*>(obj);
+    if (self->data != 0) {
+        CudaDriver& driver = cuda_driver();
+        ContextScope scope(driver);
+        driver.cuMemFree(self->data);
+    }
+    PyTypeObject* type = Py_TYPE(obj);
+    type->tp_free(obj);
+    Py_DECREF(type);
+}
+
+Py_ssize_t device_array_length(PyObject* obj)
+{
+    return reinterpret_cast<DeviceArrayObject*>(obj)->length;
+}
+
+PyObject* device_array_interface(PyObject* obj, void*)
+{
+    auto* self = reinterpret_cast<DeviceArrayObject*>(obj);
+    // Synchronized before any call returns one: no stream to wait on
+    return Py_BuildValue("{s:(n),s:s,s:(KO),s:O,s:O,s:i}", "shape", self->length, "typestr",
+                         self->elem == 'q' ? "<i8" : "<f8", "data", self->data, Py_False, "strides", Py_None,
+                         "stream", Py_None, "version", 3);
+}
+
+PyObject* device_array_copy_to_host(PyObject* obj, PyObject*)
+{
+    auto* self = reinterpret_cast<DeviceArrayObject*>(obj);
+    PyObject* result = host_array(self->elem, self->length);
+    if (result == nullptr || self->length == 0) {
+        return result;
+    }
+    Py_buffer view;
+    if (PyObject_GetBuffer(result, &view, PyBUF_WRITABLE) < 0) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+    CudaDriver& driver = cuda_driver();
+    CudaCalls calls;
+    Py_BEGIN_ALLOW_THREADS
+    ContextScope scope(driver);
+    calls(scope.result, "cuCtxPushCurrent") && calls(driver.cuMemcpyDtoH(view.buf, self->data, view.len), "cuMemcpyDtoH");
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    if (!calls.check(driver)) {
+        Py_CLEAR(result);
+    }
+    return result;
+}
+
+// New DeviceArray of n uninitialized items
+PyObject* device_array_new(char elem, Py_ssize_t n)
+{
+    if (device_array_type == nullptr) {
+        static PyGetSetDef getset[] = {
+            {"__cuda_array_interface__", device_array_interface, nullptr, nullptr, nullptr},
+            {nullptr, nullptr, nullptr, nullptr, nullptr},
+        };
+        static PyMethodDef methods[] = {
+            {"copy_to_host", device_array_copy_to_host, METH_NOARGS, "The items, as an array.array"},
+            {nullptr, nullptr, 0, nullptr},
+        };
+        static PyType_Slot slots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void*>(device_array_dealloc)},
+            {Py_mp_length, reinterpret_cast<void*>(device_array_length)},
+            {Py_tp_getset, getset},
+            {Py_tp_methods, methods},
+            {Py_tp_doc, const_cast<char*>("1-D int64 or float64 array in CUDA device memory")},
+            {0, nullptr},
+        };
+        static PyType_Spec spec = {"justjit.DeviceArray", sizeof(DeviceArrayObject), 0, Py_TPFLAGS_DEFAULT, slots};
+        device_array_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+        if (device_array_type == nullptr) {
+            return nullptr;
+        }
+    }
+    auto* self = PyObject_New(DeviceArrayObject, device_array_type);
+    if (self == nullptr) {
+        return nullptr;
+    }
+    self->data = 0;
+    self->length = n;
+    self->elem = elem;
+    if (n > 0) {
+        CudaDriver& driver = cuda_driver();
+        CudaCalls calls;
+        ContextScope scope(driver);
+        calls(scope.result, "cuCtxPushCurrent") &&
+            calls(driver.cuMemAlloc(&self->data, static_cast<size_t>(n) * 8), "cuMemAlloc");
+        if (!calls.check(driver)) {
+            self->data = 0;
+            Py_DECREF(self);
+            return nullptr;
+        }
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+// New array.array of n zeroed int64 / float64 items
+PyObject* host_array(char elem, Py_ssize_t n)
+{
+    PyObject* array_module = PyImport_ImportModule("array");
+    if (array_module == nullptr) {
+        return nullptr;
+    }
+    PyObject* zeros = PyBytes_FromStringAndSize(nullptr, n * 8);
+    PyObject* result = nullptr;
+    if (zeros != nullptr) {
+        std::memset(PyBytes_AS_STRING(zeros), 0, n * 8);
+        result = PyObject_CallMethod(array_module, "array", "sO", elem == 'q' ? "q" : "d", zeros);
+        Py_DECREF(zeros);
+    }
+    Py_DECREF(array_module);
+    return result;
+}
+
+// --- Operands ---
+
+// One kernel operand: device memory of the caller's, or host items (a
+// buffer or a broadcast scalar) staged in memory of ours
+struct Operand {
+    Py_buffer view;
+    bool has_view = false;
+    std::vector<char> packed;    // Items of a strided host buffer, back to back
+    const void* host = nullptr;  // Host items to copy over
+    uint64_t scalar = 0;         // Broadcast scalar bits
+    CUdeviceptr base = 0;
+    int64_t stride = 0;       // Bytes between device items; 0 for a broadcast scalar
+    Py_ssize_t length = -1;   // -1 for a broadcast scalar
+    bool on_device = false;   // In the caller's device memory
+    bool staged = false;      // `base` is ours to free
+
+    ~Operand()
+    {
+        if (has_view) {
+            PyBuffer_Release(&view);
+        }
+    }
+};
+
+bool host_format_matches(const Py_buffer& view, char elem)
+{
+    const char* format = view.format != nullptr ? view.format : "B";
+    if (*format == '@' || *format == '=' || (PY_LITTLE_ENDIAN && *format == '<')) {
+        format++;
+    }
+    if (view.itemsize != 8 || format[0] == '\0' || format[1] != '\0') {
+        return false;
+    }
+    return elem == 'q' ? format[0] == 'q' || format[0] == 'l' : format[0] == 'd';
+}
+
+// Reads `obj`'s __cuda_array_interface__ into `op`: 1 for a device array,
+// 0 when `obj` has none, -1 with an exception set when it cannot be used
+int device_operand(const CudaKernel& kernel, const char* call, PyObject* obj, bool writable, Operand& op)
+{
+    PyObject* iface = PyObject_GetAttrString(obj, "__cuda_array_interface__");
+    if (iface == nullptr) {
+        if (PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            PyErr_Clear();
+            return 0;
+        }
+        return -1;
+    }
+    const char* expected = kernel.elem == 'q' ? "<i8" : "<f8";
+    PyObject* shape = PyDict_Check(iface) ? PyDict_GetItemString(iface, "shape") : nullptr;
+    PyObject* typestr = PyDict_Check(iface) ? PyDict_GetItemString(iface, "typestr") : nullptr;
+    PyObject* data = PyDict_Check(iface) ? PyDict_GetItemString(iface, "data") : nullptr;
+    PyObject* strides = PyDict_Check(iface) ? PyDict_GetItemString(iface, "strides") : nullptr;
+    PyObject* mask = PyDict_Check(iface) ? PyDict_GetItemString(iface, "mask") : nullptr;
+    int status = -1;
+    if (shape == nullptr || !PyTuple_Check(shape) || PyTuple_GET_SIZE(shape) != 1 || typestr == nullptr ||
+        !PyUnicode_Check(typestr) || PyUnicode_CompareWithASCIIString(typestr, expected) != 0) {
+        PyErr_Format(PyExc_TypeError, "%s.%s() device operands must be 1-D %s arrays", kernel.name.c_str(), call,
+                     kernel.elem == 'q' ? "int64" : "float64");
+    }
+    else if (mask != nullptr && mask != Py_None) {
+        PyErr_Format(PyExc_TypeError, "%s.%s() does not take masked device arrays", kernel.name.c_str(), call);
+    }
+    else if (data == nullptr || !PyTuple_Check(data) || PyTuple_GET_SIZE(data) != 2 ||
+             (strides != nullptr && strides != Py_None &&
+              (!PyTuple_Check(strides) || PyTuple_GET_SIZE(strides) != 1))) {
+        PyErr_Format(PyExc_TypeError, "%s.%s() got a malformed __cuda_array_interface__", kernel.name.c_str(), call);
+    }
+    else if (writable && PyObject_IsTrue(PyTuple_GET_ITEM(data, 1))) {
+        PyErr_Format(PyExc_TypeError, "%s.%s() output device array is read-only", kernel.name.c_str(), call);
+    }
+    else {
+        op.length = PyLong_AsSsize_t(PyTuple_GET_ITEM(shape, 0));
+        op.base = PyLong_AsUnsignedLongLong(PyTuple_GET_ITEM(data, 0));
+        op.stride = strides != nullptr && strides != Py_None ? PyLong_AsLongLong(PyTuple_GET_ITEM(strides, 0)) : 8;
+        op.on_device = true;
+        status = PyErr_Occurred() ? -1 : 1;
+        // Written in place: only items back to back are supported
+        if (status == 1 && writable && op.stride != 8) {
+            PyErr_Format(PyExc_TypeError, "%s.%s() output device array must be contiguous", kernel.name.c_str(), call);
+            status = -1;
+        }
+    }
+    Py_DECREF(iface);
+    return status;
+}
+
+// Fills `op` from `obj`: a device array, a 1-D host buffer of the kernel's
+// element type or (not `writable`) a scalar; false with an exception set
+bool take_operand(const CudaKernel& kernel, const char* call, PyObject* obj, bool writable, Operand& op)
+{
+    if (!writable && kernel.elem == 'q' && PyLong_CheckExact(obj)) {
+        int overflow = 0;
+        int64_t value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+        if (overflow != 0) {
+            PyErr_SetString(PyExc_OverflowError, "int too large for an int mode kernel");
+            return false;
+        }
+        std::memcpy(&op.scalar, &value, 8);
+        op.host = &op.scalar;
+        return !(value == -1 && PyErr_Occurred());
+    }
+    if (!writable && kernel.elem == 'd' && (PyFloat_CheckExact(obj) || PyLong_CheckExact(obj))) {
+        double value = PyFloat_AsDouble(obj);
+        std::memcpy(&op.scalar, &value, 8);
+        op.host = &op.scalar;
+        return !(value == -1.0 && PyErr_Occurred());
+    }
+    if (!PyObject_CheckBuffer(obj)) {
+        int found = device_operand(kernel, call, obj, writable, op);
+        if (found != 0) {
+            return found == 1;
+        }
+    }
+
+    int flags = PyBUF_STRIDES | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (jit_get_buffer(obj, &op.view, flags) < 0) {
+        return false;
+    }
+    op.has_view = true;
+    if (op.view.ndim != 1 || !host_format_matches(op.view, kernel.elem)) {
+        PyErr_Format(PyExc_TypeError, "%s.%s() operands must be 1-D %s buffers or device arrays, got ndim=%d format '%s'",
+                     kernel.name.c_str(), call, kernel.elem == 'q' ? "int64" : "float64", op.view.ndim,
+                     op.view.format != nullptr ? op.view.format : "B");
+        return false;
+    }
+    op.length = op.view.shape[0];
+    op.host = op.view.buf;
+    if (op.view.strides[0] != 8 && !writable) {
+        op.packed.resize(static_cast<size_t>(op.length) * 8);
+        if (PyBuffer_ToContiguous(op.packed.data(), &op.view, op.view.len, 'C') < 0) {
+            return false;
+        }
+        op.host = op.packed.data();
+    }
+    return true;
+}
+
+// Copies a host operand (not an output) to fresh device memory; no GIL needed
+bool stage_operand(CudaDriver& driver, CudaCalls& calls, Operand& op, bool copy)
+{
+    if (op.on_device) {
+        return true;
+    }
+    size_t bytes = op.length < 0 ? 8 : static_cast<size_t>(op.length) * 8;
+    if (!calls(driver.cuMemAlloc(&op.base, bytes), "cuMemAlloc")) {
+        return false;
+    }
+    op.staged = true;
+    op.stride = op.length < 0 ? 0 : 8;
+    return !copy || calls(driver.cuMemcpyHtoD(op.base, op.host, bytes), "cuMemcpyHtoD");
+}
+
+void release_staged(CudaDriver& driver, Operand& op)
+{
+    if (op.staged) {
+        driver.cuMemFree(op.base);
+        op.staged = false;
+    }
+}
+
+unsigned grid_for(int64_t threads)
+{
+    int64_t blocks = (threads + kBlockSize - 1) / kBlockSize;
+    return static_cast<unsigned>(blocks < kMaxBlocks ? blocks : kMaxBlocks);
+}
+
+}  // namespace
+
+const char* jit_cuda_status()
+{
+    CudaDriver& driver = cuda_driver();
+    return driver.ready ? nullptr : driver.error.c_str();
+}
+
+int jit_cuda_compute_capability()
+{
+    CudaDriver& driver = cuda_driver();
+    return driver.ready ? driver.capability : 0;
+}
+
+CudaKernel::CudaKernel(std::string name, char elem, int param_count)
+    : name(std::move(name)), elem(elem), param_count(param_count)
+{
+}
+
+CudaKernel::~CudaKernel()
+{
+    if (module != nullptr) {
+        CudaDriver& driver = cuda_driver();
+        ContextScope scope(driver);
+        driver.cuModuleUnload(module);
+    }
+}
+
+bool CudaKernel::load(const std::string& ptx)
+{
+    CudaDriver& driver = cuda_driver();
+    if (!driver.ready) {
+        PyErr_SetString(PyExc_RuntimeError, driver.error.c_str());
+        return false;
+    }
+    char log[4096] = {0};
+    int options[] = {CU_JIT_ERROR_LOG_BUFFER, CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES};
+    void* values[] = {log, reinterpret_cast<void*>(sizeof(log))};
+    std::string map_name = name + "__cuda_map";
+    std::string reduce_name = name + "__cuda_reduce";
+    CudaCalls calls;
+    ContextScope scope(driver);
+    calls(scope.result, "cuCtxPushCurrent") &&
+        calls(driver.cuModuleLoadDataEx(&module, ptx.c_str(), 2, options, values), "cuModuleLoadDataEx") &&
+        calls(driver.cuModuleGetFunction(&map, module, map_name.c_str()), "cuModuleGetFunction") &&
+        (param_count != 2 ||
+         calls(driver.cuModuleGetFunction(&reduce, module, reduce_name.c_str()), "cuModuleGetFunction"));
+    if (calls.failed != nullptr) {
+        PyErr_Format(PyExc_RuntimeError, "%s: the CUDA driver could not load its kernels: %s%s%s", name.c_str(),
+                     driver_error(driver, calls.result, calls.failed).c_str(), log[0] != '\0' ? "\n" : "", log);
+        return false;
+    }
+    return true;
+}
+
+PyObject* jit_cuda_map(const CudaKernel& kernel, PyObject* args, PyObject* kwargs)
+{
+    CudaDriver& driver = cuda_driver();
+    if (!driver.ready) {
+        PyErr_SetString(PyExc_RuntimeError, driver.error.c_str());
+        return nullptr;
+    }
+    PyObject* out = Py_None;
+    if (kwargs != nullptr) {
+        PyObject* key;
+        PyObject* value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (!PyUnicode_Check(key) || PyUnicode_CompareWithASCIIString(key, "out") != 0) {
+                PyErr_Format(PyExc_TypeError, "%s.map() got an unexpected keyword argument '%S'", kernel.name.c_str(),
+                             key);
+                return nullptr;
+            }
+            out = value;
+        }
+    }
+    Py_ssize_t nargs = PyTuple_GET_SIZE(args);
+    if (nargs != kernel.param_count) {
+        PyErr_Format(PyExc_TypeError, "%s.map() takes %d operand(s) but %zd were given", kernel.name.c_str(),
+                     kernel.param_count, nargs);
+        return nullptr;
+    }
+
+    std::vector<Operand> ops(nargs);
+    Py_ssize_t n = -1;
+    PyObject* first_host = nullptr;
+    bool any_device = false;
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        PyObject* item = PyTuple_GET_ITEM(args, i);
+        if (!take_operand(kernel, "map", item, false, ops[i])) {
+            return nullptr;
+        }
+        if (ops[i].length < 0) {
+            continue;
+        }
+        if (n >= 0 && ops[i].length != n) {
+            PyErr_Format(PyExc_ValueError, "%s.map() operands have lengths %zd and %zd", kernel.name.c_str(), n,
+                         ops[i].length);
+            return nullptr;
+        }
+        n = ops[i].length;
+        any_device = any_device || ops[i].on_device;
+        if (first_host == nullptr && !ops[i].on_device) {
+            first_host = item;
+        }
+    }
+    if (n < 0) {
+        PyErr_Format(PyExc_TypeError, "%s.map() needs at least one array operand", kernel.name.c_str());
+        return nullptr;
+    }
+
+    PyObject* result = out != Py_None         ? Py_NewRef(out)
+                       : any_device           ? device_array_new(kernel.elem, n)
+                       : kernel.alloc_result  ? kernel.alloc_result(kernel, first_host, n)
+                                              : host_array(kernel.elem, n);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    Operand out_op;
+    if (!take_operand(kernel, "map", result, true, out_op)) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+    if (out_op.length != n) {
+        PyErr_Format(PyExc_ValueError, "%s.map() output has length %zd, expected %zd", kernel.name.c_str(),
+                     out_op.length, n);
+        Py_DECREF(result);
+        return nullptr;
+    }
+    if (n == 0) {
+        return result;
+    }
+    // A strided host output is filled from a packed copy
+    bool scatter = !out_op.on_device && out_op.view.strides[0] != 8;
+    if (scatter) {
+        out_op.packed.resize(static_cast<size_t>(n) * 8);
+    }
+    void* host_out = scatter ? out_op.packed.data() : out_op.view.buf;
+
+    CudaCalls calls;
+    Py_BEGIN_ALLOW_THREADS
+    ContextScope scope(driver);
+    if (calls(scope.result, "cuCtxPushCurrent")) {
+        bool staged = true;
+        for (Operand& op : ops) {
+            staged = staged && stage_operand(driver, calls, op, true);
+        }
+        staged = staged && stage_operand(driver, calls, out_op, false);
+        if (staged) {
+            // Kernel parameters: (base, byte stride) per operand, then out and n
+            std::vector<void*> params;
+            for (Operand& op : ops) {
+                params.push_back(&op.base);
+                params.push_back(&op.stride);
+            }
+            int64_t count = n;
+            params.push_back(&out_op.base);
+            params.push_back(&count);
+            calls(driver.cuCtxSynchronize(), "cuCtxSynchronize") &&
+                calls(driver.cuLaunchKernel(kernel.map, grid_for(count), 1, 1, kBlockSize, 1, 1, 0, nullptr,
+                                            params.data(), nullptr),
+                      "cuLaunchKernel") &&
+                calls(driver.cuCtxSynchronize(), "cuCtxSynchronize") &&
+                (out_op.on_device ||
+                 calls(driver.cuMemcpyDtoH(host_out, out_op.base, static_cast<size_t>(n) * 8), "cuMemcpyDtoH"));
+        }
+        for (Operand& op : ops) {
+            release_staged(driver, op);
+        }
+        release_staged(driver, out_op);
+    }
+    Py_END_ALLOW_THREADS
+    if (!calls.check(driver) ||
+        (scatter && PyBuffer_FromContiguous(&out_op.view, out_op.packed.data(), out_op.view.len, 'C') < 0)) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+    return result;
+}
+
+PyObject* jit_cuda_reduce(const CudaKernel& kernel, PyObject* array)
+{
+    CudaDriver& driver = cuda_driver();
+    if (!driver.ready) {
+        PyErr_SetString(PyExc_RuntimeError, driver.error.c_str());
+        return nullptr;
+    }
+    if (kernel.reduce == nullptr) {
+        PyErr_Format(PyExc_TypeError, "%s.reduce() needs a two-parameter function", kernel.name.c_str());
+        return nullptr;
+    }
+    Operand op;
+    if (!take_operand(kernel, "reduce", array, false, op)) {
+        return nullptr;
+    }
+    if (op.length < 0) {
+        PyErr_Format(PyExc_TypeError, "%s.reduce() needs an array", kernel.name.c_str());
+        return nullptr;
+    }
+    int64_t n = op.length;
+    int64_t threads = n < kReduceThreads ? n : kReduceThreads;
+    int64_t chunk = threads > 0 ? (n + threads - 1) / threads : 1;
+    threads = (n + chunk - 1) / chunk;
+    PyObject* result = host_array(kernel.elem, threads);
+    if (result == nullptr || threads == 0) {
+        return result;
+    }
+    Py_buffer partials;
+    if (PyObject_GetBuffer(result, &partials, PyBUF_WRITABLE) < 0) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+
+    CudaCalls calls;
+    Py_BEGIN_ALLOW_THREADS
+    ContextScope scope(driver);
+    CUdeviceptr device_partials = 0;
+    if (calls(scope.result, "cuCtxPushCurrent") && stage_operand(driver, calls, op, true) &&
+        calls(driver.cuMemAlloc(&device_partials, partials.len), "cuMemAlloc")) {
+        // Kernel parameters: base, byte stride, n, items per thread, partials
+        void* params[] = {&op.base, &op.stride, &n, &chunk, &device_partials};
+        unsigned blocks = static_cast<unsigned>((threads + kBlockSize - 1) / kBlockSize);
+        calls(driver.cuCtxSynchronize(), "cuCtxSynchronize") &&
+            calls(driver.cuLaunchKernel(kernel.reduce, blocks, 1, 1, kBlockSize, 1, 1, 0, nullptr, params, nullptr),
+                  "cuLaunchKernel") &&
+            calls(driver.cuCtxSynchronize(), "cuCtxSynchronize") &&
+            calls(driver.cuMemcpyDtoH(partials.buf, device_partials, partials.len), "cuMemcpyDtoH");
+        driver.cuMemFree(device_partials);
+    }
+    release_staged(driver, op);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&partials);
+    if (!calls.check(driver)) {
+        Py_CLEAR(result);
+    }
+    return result;
+}
+
+PyObject* jit_to_device(PyObject* obj)
+{
+    CudaDriver& driver = cuda_driver();
+    if (!driver.ready) {
+        PyErr_SetString(PyExc_RuntimeError, driver.error.c_str());
+        return nullptr;
+    }
+    Py_buffer view;
+    if (jit_get_buffer(obj, &view, PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+        return nullptr;
+    }
+    char elem = host_format_matches(view, 'd') ? 'd' : host_format_matches(view, 'q') ? 'q' : '\0';
+    if (view.ndim != 1 || elem == '\0') {
+        PyErr_Format(PyExc_TypeError, "to_device() takes a 1-D int64 or float64 buffer, got ndim=%d format '%s'",
+                     view.ndim, view.format != nullptr ? view.format : "B");
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+    std::vector<char> packed;
+    const void* host = view.buf;
+    if (view.strides[0] != 8) {
+        packed.resize(static_cast<size_t>(view.len));
+        if (PyBuffer_ToContiguous(packed.data(), &view, view.len, 'C') < 0) {
+            PyBuffer_Release(&view);
+            return nullptr;
+        }
+        host = packed.data();
+    }
+    PyObject* result = device_array_new(elem, view.shape[0]);
+    if (result != nullptr && view.len > 0) {
+        CUdeviceptr data = reinterpret_cast<DeviceArrayObject*>(result)->data;
+        size_t bytes = static_cast<size_t>(view.len);
+        CudaCalls calls;
+        Py_BEGIN_ALLOW_THREADS
+        ContextScope scope(driver);
+        calls(scope.result, "cuCtxPushCurrent") && calls(driver.cuMemcpyHtoD(data, host, bytes), "cuMemcpyHtoD");
+        Py_END_ALLOW_THREADS
+        if (!calls.check(driver)) {
+            Py_CLEAR(result);
+        }
+    }
+    PyBuffer_Release(&view);
+    return result;
+}
+
+}  // namespace justjit
@@ -0,0 +1,71 @@
+/**
+ * cuda_offload.h - Batch kernels on an NVIDIA GPU (jit(target='cuda'))
+ *
+ * Provides:
+ * - jit_cuda_status: whether the CUDA driver and a device can be used
+ * - CudaKernel: the `<name>__cuda_map` / `<name>__cuda_reduce` kernels of
+ *   one int/float function, loaded from PTX into the device's primary
+ *   context
+ * - jit_cuda_map / jit_cuda_reduce: f.map() on the device, and the partial
+ *   folds f.reduce() finishes on the host
+ * - jit_to_device: a DeviceArray holding a copy of a host buffer
+ *
+ * Operands may be host buffers (copied over and back) or objects exposing
+ * __cuda_array_interface__ (CuPy, PyTorch, Numba, DeviceArray), whose
+ * memory the kernels use in place. The driver (libcuda) is loaded at run
+ * time: the extension does not link against the CUDA toolkit, and without
+ * a driver or a device jit_cuda_status says why.
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <string>
+
+namespace justjit {
+
+// NULL when kernels can run on CUDA device 0, else why not
+const char* jit_cuda_status();
+
+// Compute capability of device 0 as major * 10 + minor (0 if unusable)
+int jit_cuda_compute_capability();
+
+class CudaKernel {
+public:
+    // Kernels of `name`, a function of `param_count` 'q' (int64) or 'd'
+    // (float64) parameters, from the PTX of jit_core's emit_cuda_kernels
+    CudaKernel(std::string name, char elem, int param_count);
+    ~CudaKernel();
+    CudaKernel(const CudaKernel&) = delete;
+    CudaKernel& operator=(const CudaKernel&) = delete;
+
+    // Load `ptx`; false with a RuntimeError set (the driver's log included)
+    bool load(const std::string& ptx);
+
+    const std::string name;
+    const char elem;
+    const int param_count;
+    void* module = nullptr;  // CUmodule
+    void* map = nullptr;     // CUfunction `<name>__cuda_map`
+    void* reduce = nullptr;  // CUfunction `<name>__cuda_reduce`, two-parameter kernels only
+
+    // Host result of a map over n items whose first array operand is the
+    // host buffer `like` (set by the owner; NULL with an exception set)
+    PyObject* (*alloc_result)(const CudaKernel& kernel, PyObject* like, Py_ssize_t n) = nullptr;
+};
+
+// f.map(*operands, out=None) on the device. The result is `out` when given,
+// a DeviceArray when an operand is on the device, else alloc_result's buffer.
+PyObject* jit_cuda_map(const CudaKernel& kernel, PyObject* args, PyObject* kwargs);
+
+// Partial folds of `array` (every thread folds a run of consecutive items
+// from the run's first one), as an array.array for the host reduce loop to
+// fold in order; as with parallel=True this assumes the kernel associative
+PyObject* jit_cuda_reduce(const CudaKernel& kernel, PyObject* array);
+
+// New DeviceArray copy of the 1-D int64 or float64 buffer `obj`
+PyObject* jit_to_device(PyObject* obj);
+
+}  // namespace justjit
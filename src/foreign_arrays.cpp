@@ -0,0 +1,385 @@
+/**
+ * foreign_arrays.cpp - Buffer-protocol views of __array_interface__ and
+ * DLPack arrays
+ *
+ * A ForeignArray holds the producer (or its consumed DLPack capsule) and
+ * exports the producer's memory through the buffer protocol, so the array
+ * modes take it like any other buffer. No data is copied.
+ */
+
+#include "foreign_arrays.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace justjit {
+
+namespace {
+
+struct ForeignArrayObject {
+    PyObject_HEAD
+    PyObject* owner;           // Producer, or the "used_dltensor" capsule
+    DLManagedTensor* managed;  // Deleted with the view when from DLPack
+    char* data;
+    int readonly;
+    int ndim;
+    Py_ssize_t itemsize;
+    char format[4];
+    Py_ssize_t shape[PyBUF_MAX_NDIM];
+    Py_ssize_t strides[PyBUF_MAX_NDIM];  // In bytes
+};
+
+PyTypeObject* foreign_array_type = nullptr;
+
+bool foreign_c_contiguous(const ForeignArrayObject* self)
+{
+    Py_ssize_t expected = self->itemsize;
+    for (int d = self->ndim - 1; d >= 0; --d) {
+        if (self->shape[d] == 0) {
+            return true;
+        }
+        if (self->shape[d] != 1 && self->strides[d] != expected) {
+            return false;
+        }
+        expected *= self->shape[d];
+    }
+    return true;
+}
+
+int foreign_array_getbuffer(PyObject* obj, Py_buffer* view, int flags)
+{
+    auto* self = reinterpret_cast<ForeignArrayObject*>(obj);
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && self->readonly) {
+        PyErr_SetString(PyExc_BufferError, "array is read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !foreign_c_contiguous(self)) {
+        PyErr_SetString(PyExc_BufferError, "array is not C-contiguous");
+        view->obj = nullptr;
+        return -1;
+    }
+    Py_ssize_t count = 1;
+    for (int d = 0; d < self->ndim; ++d) {
+        count *= self->shape[d];
+    }
+    view->buf = self->data;
+    view->obj = Py_NewRef(obj);
+    view->len = count * self->itemsize;
+    view->readonly = self->readonly;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? self->format : nullptr;
+    view->ndim = self->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+void foreign_array_dealloc(PyObject* obj)
+{
+    auto* self = reinterpret_cast<ForeignArrayObject*>(obj);
+    if (self->managed != nullptr && self->managed->deleter != nullptr) {
+        self->managed->deleter(self->managed);
+    }
+    Py_XDECREF(self->owner);
+    PyTypeObject* type = Py_TYPE(obj);
+    type->tp_free(obj);
+    Py_DECREF(type);
+}
+
+ForeignArrayObject* foreign_array_new()
+{
+    if (foreign_array_type == nullptr) {
+        static PyType_Slot slots[] = {
+            {Py_bf_getbuffer, reinterpret_cast<void*>(foreign_array_getbuffer)},
+            {Py_tp_dealloc, reinterpret_cast<void*>(foreign_array_dealloc)},
+            {Py_tp_doc, const_cast<char*>("Buffer-protocol view of an __array_interface__ or DLPack array")},
+            {0, nullptr},
+        };
+        static PyType_Spec spec = {"justjit.ForeignArray", sizeof(ForeignArrayObject), 0, Py_TPFLAGS_DEFAULT, slots};
+        foreign_array_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+        if (foreign_array_type == nullptr) {
+            return nullptr;
+        }
+    }
+    auto* self = PyObject_New(ForeignArrayObject, foreign_array_type);
+    if (self == nullptr) {
+        return nullptr;
+    }
+    self->owner = nullptr;
+    self->managed = nullptr;
+    self->data = nullptr;
+    self->readonly = 0;
+    self->ndim = 0;
+    self->itemsize = 0;
+    std::memset(self->format, 0, sizeof(self->format));
+    return self;
+}
+
+// Struct format of `kind` items of `size` bytes (NumPy kind letters, and
+// 'E' for bfloat16, which has none), or false
+bool foreign_format(char kind, Py_ssize_t size, char* format)
+{
+    const char* code = nullptr;
+    switch (kind) {
+        case 'f': code = size == 4 ? "f" : size == 8 ? "d" : size == 2 ? "e" : nullptr; break;
+        case 'i': code = size == 1 ? "b" : size == 2 ? "h" : size == 4 ? "i" : size == 8 ? "q" : nullptr; break;
+        case 'u': code = size == 1 ? "B" : size == 2 ? "H" : size == 4 ? "I" : size == 8 ? "Q" : nullptr; break;
+        case 'b': code = size == 1 ? "?" : nullptr; break;
+        case 'c': code = size == 8 ? "Zf" : size == 16 ? "Zd" : nullptr; break;
+        case 'E': code = size == 2 ? "E" : nullptr; break;
+        default: break;
+    }
+    if (code == nullptr) {
+        return false;
+    }
+    std::strcpy(format, code);
+    return true;
+}
+
+PyObject* foreign_unsupported(PyObject* obj, const char* protocol, const char* detail)
+{
+    PyErr_Format(PyExc_TypeError, "cannot take a %s array through %s: %s", Py_TYPE(obj)->tp_name, protocol, detail);
+    return nullptr;
+}
+
+// __array_interface__ (version 3); the producer is held for the view's life
+PyObject* foreign_from_array_interface(PyObject* obj, PyObject* interface)
+{
+    if (!PyDict_Check(interface)) {
+        return foreign_unsupported(obj, "__array_interface__", "it is not a dict");
+    }
+    PyObject* shape = PyDict_GetItemString(interface, "shape");
+    PyObject* typestr = PyDict_GetItemString(interface, "typestr");
+    PyObject* data = PyDict_GetItemString(interface, "data");
+    PyObject* strides = PyDict_GetItemString(interface, "strides");
+    PyObject* mask = PyDict_GetItemString(interface, "mask");
+    if (shape == nullptr || !PyTuple_Check(shape) || typestr == nullptr || !PyUnicode_Check(typestr)) {
+        return foreign_unsupported(obj, "__array_interface__", "missing shape or typestr");
+    }
+    if (data == nullptr || !PyTuple_Check(data) || PyTuple_GET_SIZE(data) != 2) {
+        return foreign_unsupported(obj, "__array_interface__", "data is not a (pointer, read-only) pair");
+    }
+    if (mask != nullptr && mask != Py_None) {
+        return foreign_unsupported(obj, "__array_interface__", "masked arrays are not supported");
+    }
+    Py_ssize_t ndim = PyTuple_GET_SIZE(shape);
+    if (ndim > PyBUF_MAX_NDIM || (strides != nullptr && strides != Py_None &&
+                                  (!PyTuple_Check(strides) || PyTuple_GET_SIZE(strides) != ndim))) {
+        return foreign_unsupported(obj, "__array_interface__", "bad shape or strides");
+    }
+
+    // "<f8": byte order, kind, item size
+    const char* type = PyUnicode_AsUTF8(typestr);
+    if (type == nullptr) {
+        return nullptr;
+    }
+    long size = type[0] != '\0' && type[1] != '\0' ? std::strtol(type + 2, nullptr, 10) : 0;
+    bool native_order = type[0] == '|' || type[0] == '=' || type[0] == (PY_LITTLE_ENDIAN ? '<' : '>');
+    if (!(native_order || size == 1) || size <= 0) {
+        return foreign_unsupported(obj, "__array_interface__", "items are not in native byte order");
+    }
+
+    ForeignArrayObject* self = foreign_array_new();
+    if (self == nullptr) {
+        return nullptr;
+    }
+    self->owner = Py_NewRef(obj);
+    self->itemsize = size;
+    self->ndim = static_cast<int>(ndim);
+    PyObject* result = reinterpret_cast<PyObject*>(self);
+    if (!foreign_format(type[1], size, self->format)) {
+        Py_DECREF(result);
+        return foreign_unsupported(obj, "__array_interface__", "unsupported item type");
+    }
+    for (Py_ssize_t d = 0; d < ndim; ++d) {
+        self->shape[d] = PyLong_AsSsize_t(PyTuple_GET_ITEM(shape, d));
+    }
+    if (strides != nullptr && strides != Py_None) {
+        for (Py_ssize_t d = 0; d < ndim; ++d) {
+            self->strides[d] = PyLong_AsSsize_t(PyTuple_GET_ITEM(strides, d));
+        }
+    } else {
+        Py_ssize_t stride = size;
+        for (Py_ssize_t d = ndim - 1; d >= 0; --d) {
+            self->strides[d] = stride;
+            stride *= self->shape[d];
+        }
+    }
+    self->data = reinterpret_cast<char*>(PyLong_AsVoidPtr(PyTuple_GET_ITEM(data, 0)));
+    self->readonly = PyObject_IsTrue(PyTuple_GET_ITEM(data, 1));
+    if (PyErr_Occurred()) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+    return result;
+}
+
+// DLPack: one __dlpack__() capsule, renamed "used_dltensor" and deleted with the view
+PyObject* foreign_from_dlpack(PyObject* obj)
+{
+    // Ask where the tensor lives before taking it, so a device tensor is not consumed
+    PyObject* device = PyObject_CallMethod(obj, "__dlpack_device__", nullptr);
+    if (device == nullptr) {
+        return nullptr;
+    }
+    long device_type = PyTuple_Check(device) && PyTuple_GET_SIZE(device) == 2
+                           ? PyLong_AsLong(PyTuple_GET_ITEM(device, 0))
+                           : -1;
+    Py_DECREF(device);
+    if (PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (device_type != kDLCPU && device_type != kDLCUDAHost && device_type != kDLROCMHost) {
+        return foreign_unsupported(obj, "__dlpack__", "the tensor is in device memory; kernels take host arrays");
+    }
+
+    PyObject* capsule = PyObject_CallMethod(obj, "__dlpack__", nullptr);
+    if (capsule == nullptr) {
+        return nullptr;
+    }
+    auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, "dltensor"));
+    if (managed == nullptr) {
+        Py_DECREF(capsule);
+        return nullptr;
+    }
+    const DLTensor& tensor = managed->dl_tensor;
+    const char* problem = nullptr;
+    char kind = 0;
+    switch (tensor.dtype.code) {
+        case kDLInt: kind = 'i'; break;
+        case kDLUInt: kind = 'u'; break;
+        case kDLFloat: kind = 'f'; break;
+        case kDLComplex: kind = 'c'; break;
+        case kDLBool: kind = 'b'; break;
+        case kDLBfloat: kind = 'E'; break;
+        default: problem = "unsupported item type"; break;
+    }
+    if (tensor.dtype.lanes != 1 || tensor.dtype.bits % 8 != 0) {
+        problem = "vector or sub-byte item types are not supported";
+    } else if (tensor.ndim < 0 || tensor.ndim > PyBUF_MAX_NDIM) {
+        problem = "too many dimensions";
+    }
+    if (problem != nullptr) {
+        // Not renamed: the capsule's destructor still owns the tensor
+        Py_DECREF(capsule);
+        return foreign_unsupported(obj, "__dlpack__", problem);
+    }
+
+    ForeignArrayObject* self = foreign_array_new();
+    if (self == nullptr) {
+        Py_DECREF(capsule);
+        return nullptr;
+    }
+    PyObject* result = reinterpret_cast<PyObject*>(self);
+    Py_ssize_t size = tensor.dtype.bits / 8;
+    if (!foreign_format(kind, size, self->format)) {
+        Py_DECREF(capsule);
+        Py_DECREF(result);
+        return foreign_unsupported(obj, "__dlpack__", "unsupported item size");
+    }
+    // From here the view owns the tensor
+    PyCapsule_SetName(capsule, "used_dltensor");
+    self->owner = capsule;
+    self->managed = managed;
+    self->itemsize = size;
+    self->ndim = tensor.ndim;
+    self->data = static_cast<char*>(tensor.data) + tensor.byte_offset;
+    Py_ssize_t stride = size;
+    for (int d = tensor.ndim - 1; d >= 0; --d) {
+        self->shape[d] = static_cast<Py_ssize_t>(tensor.shape[d]);
+        self->strides[d] = tensor.strides != nullptr ? static_cast<Py_ssize_t>(tensor.strides[d]) * size : stride;
+        stride *= self->shape[d];
+    }
+    return result;
+}
+
+}  // namespace
+
+PyObject* jit_foreign_array(PyObject* obj)
+{
+    if (PyObject_HasAttrString(obj, "__cuda_array_interface__") &&
+        !PyObject_HasAttrString(obj, "__array_interface__")) {
+        return foreign_unsupported(obj, "__cuda_array_interface__",
+                                   "the array is in device memory; kernels take host arrays");
+    }
+    PyObject* interface = PyObject_GetAttrString(obj, "__array_interface__");
+    if (interface != nullptr) {
+        PyObject* result = foreign_from_array_interface(obj, interface);
+        Py_DECREF(interface);
+        return result;
+    }
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+        return nullptr;
+    }
+    PyErr_Clear();
+    if (PyObject_HasAttrString(obj, "__dlpack__")) {
+        return foreign_from_dlpack(obj);
+    }
+    return nullptr;
+}
+
+PyObject* jit_bfloat16_view(PyObject* obj)
+{
+    Py_buffer source;
+    if (jit_get_buffer(obj, &source, PyBUF_RECORDS_RO) < 0) {
+        return nullptr;
+    }
+    const char* format = source.format != nullptr ? source.format : "B";
+    if (*format == '@' || *format == '=' || (PY_LITTLE_ENDIAN && *format == '<')) {
+        format++;
+    }
+    if (source.itemsize != 2 || std::strchr("HheE", *format) == nullptr || format[1] != '\0') {
+        PyErr_Format(PyExc_TypeError, "bfloat16_view() needs a buffer of 2-byte items ('H', 'h', 'e'), not format '%s'",
+                     source.format != nullptr ? source.format : "B");
+        PyBuffer_Release(&source);
+        return nullptr;
+    }
+    ForeignArrayObject* self = foreign_array_new();
+    if (self == nullptr) {
+        PyBuffer_Release(&source);
+        return nullptr;
+    }
+    // A memoryview keeps the exporter's buffer exported, so it cannot resize
+    self->owner = PyMemoryView_FromObject(source.obj);
+    PyObject* result = reinterpret_cast<PyObject*>(self);
+    if (self->owner == nullptr) {
+        PyBuffer_Release(&source);
+        Py_DECREF(result);
+        return nullptr;
+    }
+    self->data = static_cast<char*>(source.buf);
+    self->readonly = source.readonly;
+    self->ndim = source.ndim;
+    self->itemsize = 2;
+    std::strcpy(self->format, "E");
+    for (int d = 0; d < source.ndim; ++d) {
+        self->shape[d] = source.shape[d];
+        self->strides[d] = source.strides[d];
+    }
+    PyBuffer_Release(&source);
+    return result;
+}
+
+int jit_get_buffer(PyObject* obj, Py_buffer* view, int flags)
+{
+    if (PyObject_CheckBuffer(obj)) {
+        return PyObject_GetBuffer(obj, view, flags);
+    }
+    PyObject* foreign = jit_foreign_array(obj);
+    if (foreign == nullptr) {
+        if (!PyErr_Occurred()) {
+            // Same error PyObject_GetBuffer gives
+            PyErr_Format(PyExc_TypeError, "a bytes-like object is required, not '%.100s'", Py_TYPE(obj)->tp_name);
+        }
+        view->obj = nullptr;
+        return -1;
+    }
+    int status = PyObject_GetBuffer(foreign, view, flags);
+    Py_DECREF(foreign);
+    return status;
+}
+
+}  // namespace justjit
@@ -0,0 +1,99 @@
+/**
+ * foreign_arrays.h - Arrays that do not export the buffer protocol
+ *
+ * Provides:
+ * - DLPack structs (DLDevice, DLDataType, DLTensor, DLManagedTensor), as
+ *   the DLPack 0.8 header defines them
+ * - jit_foreign_array: a buffer-protocol view of an object exposing
+ *   __array_interface__ or __dlpack__ (PyTorch CPU tensors, JAX arrays),
+ *   sharing its memory
+ * - jit_bfloat16_view: a uint16 buffer's memory read as bfloat16 items
+ * - jit_get_buffer: PyObject_GetBuffer that falls back to jit_foreign_array
+ *
+ * Array arguments of every array mode are taken through jit_get_buffer, so
+ * such objects are accepted wherever a NumPy array is. Device arrays
+ * (__cuda_array_interface__, DLPack on a GPU) are refused with TypeError.
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+
+#ifndef DLPACK_VERSION
+
+typedef enum {
+    kDLCPU = 1,
+    kDLCUDA = 2,
+    kDLCUDAHost = 3,
+    kDLOpenCL = 4,
+    kDLVulkan = 7,
+    kDLMetal = 8,
+    kDLVPI = 9,
+    kDLROCM = 10,
+    kDLROCMHost = 11,
+    kDLExtDev = 12,
+    kDLCUDAManaged = 13,
+    kDLOneAPI = 14,
+    kDLWebGPU = 15,
+    kDLHexagon = 16,
+} DLDeviceType;
+
+typedef struct {
+    DLDeviceType device_type;
+    int32_t device_id;
+} DLDevice;
+
+typedef enum {
+    kDLInt = 0U,
+    kDLUInt = 1U,
+    kDLFloat = 2U,
+    kDLOpaqueHandle = 3U,
+    kDLBfloat = 4U,
+    kDLComplex = 5U,
+    kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;  // In items; NULL for a compact row-major tensor
+    uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+
+#endif  // DLPACK_VERSION
+
+namespace justjit {
+
+// New reference to a buffer exporter over `obj`'s memory, taken from its
+// __array_interface__ or (consuming one capsule) its __dlpack__(). NULL with
+// an exception set if `obj` has one of them but it cannot be used, NULL
+// without one if `obj` has neither.
+PyObject* jit_foreign_array(PyObject* obj);
+
+// New view of the 2-byte items of `obj` (a uint16, int16 or float16 buffer,
+// or another jit_get_buffer source) as bfloat16: format 'E', which no
+// struct code spells, so the array modes read the bits as bfloat16
+PyObject* jit_bfloat16_view(PyObject* obj);
+
+// PyObject_GetBuffer, or, for an object without the buffer protocol, the
+// same on jit_foreign_array(obj); `view->obj` keeps the memory alive
+int jit_get_buffer(PyObject* obj, Py_buffer* view, int flags);
+
+}  // namespace justjit
@@ -11,11 +11,18 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/Target/TargetMachine.h>
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <map>
+#include <array>
+#include <mutex>
 #include <unordered_set>
 #include <atomic>
+#include <chrono>
+#include "compile_arena.h"
 
 namespace nb = nanobind;
 
@@ -44,23 +51,39 @@ namespace justjit
     // Signature: PyObject* step_func(int32_t* state, PyObject** locals, PyObject* sent_value)
     typedef PyObject* (*GeneratorStepFunc)(int32_t* state, PyObject** locals, PyObject* sent_value);
 
-    // JIT Generator object - a Python object that wraps a compiled generator
+    // Raw step of an int/float typed generator: stores each yielded value
+    // (an int64_t or a double) to *out and returns non-NULL; NULL once done
+    // (state -1) or failed (state -2). Runs without the GIL.
+    typedef void* (*RawGeneratorStep)(int32_t* state, PyObject** slots, void* out);
+
+    // JIT Generator object - a Python object that wraps a compiled generator.
+    // Variable-sized: the locals live inline after the header (tp_itemsize),
+    // so creating a generator is a single allocation.
     struct JITGeneratorObject {
-        PyObject_HEAD
+        PyObject_VAR_HEAD
         int32_t state;              // Current state (0=initial, >0=suspended at yield N, -1=done)
-        PyObject** locals;          // Array of local variables (preserved across yields)
-        Py_ssize_t num_locals;      // Number of local variable slots
+        PyObject** locals;          // Array of local variables (preserved across yields); points at slots
+        Py_ssize_t num_locals;      // Leading slots holding object references (the rest
+                                    // of the Py_SIZE slots are raw values in typed generators)
         GeneratorStepFunc step_func; // Pointer to the compiled step function
         PyObject* name;             // Generator name (for repr)
         PyObject* qualname;         // Qualified name
+        PyObject* delegate;         // JIT generator a `yield from` is suspended in, resumed
+                                    // without this generator's step (see JITYieldFrom)
+        PyObject* owner;            // JIT instance whose dylib holds step_func (may be NULL)
+        PyObject* slots[1];         // Inline locals storage (Py_SIZE items)
     };
 
     // Python type object for JIT generators (defined in jit_core.cpp)
     extern PyTypeObject JITGenerator_Type;
 
     // Helper functions for JIT generator
+    // object_locals < 0 means all num_locals slots hold objects; `owner` is
+    // kept alive until the generator is freed, so its code outlives the
+    // factory or wrapper that created it
     PyObject* JITGenerator_New(GeneratorStepFunc step_func, Py_ssize_t num_locals,
-                               PyObject* name, PyObject* qualname);
+                               PyObject* name, PyObject* qualname, Py_ssize_t object_locals = -1,
+                               PyObject* owner = NULL);
     PyObject* JITGenerator_Send(JITGeneratorObject* gen, PyObject* value);
 
     // =========================================================================
@@ -75,16 +98,19 @@ namespace justjit
     // Forward declaration of the JIT coroutine object
     struct JITCoroutineObject;
 
-    // JIT Coroutine object - wraps a compiled async function
+    // JIT Coroutine object - wraps a compiled async function (variable-sized
+    // like JITGeneratorObject)
     struct JITCoroutineObject {
-        PyObject_HEAD
+        PyObject_VAR_HEAD
         int32_t state;              // Current state (0=initial, >0=suspended at await, -1=done)
-        PyObject** locals;          // Array of local variables (preserved across awaits)
+        PyObject** locals;          // Array of local variables (preserved across awaits); points at slots
         Py_ssize_t num_locals;      // Number of local variable slots
         GeneratorStepFunc step_func; // Pointer to the compiled step function (same signature)
         PyObject* name;             // Coroutine name (for repr)
         PyObject* qualname;         // Qualified name
         PyObject* awaiting;         // Currently awaited object (for SEND delegation)
+        PyObject* owner;            // JIT instance whose dylib holds step_func (may be NULL)
+        PyObject* slots[1];         // Inline locals storage (num_locals items)
     };
 
     // Python type object for JIT coroutines (defined in jit_core.cpp)
@@ -92,15 +118,522 @@ namespace justjit
 
     // Helper functions for JIT coroutine
     PyObject* JITCoroutine_New(GeneratorStepFunc step_func, Py_ssize_t num_locals,
-                               PyObject* name, PyObject* qualname);
+                               PyObject* name, PyObject* qualname, PyObject* owner = NULL);
     PyObject* JITCoroutine_Send(JITCoroutineObject* coro, PyObject* value);
 
+    // PyIter_Send for the SEND opcode: JIT coroutines and generators are
+    // resumed by calling their step function, others go to PyIter_Send
+    PySendResult JITSend(PyObject* receiver, PyObject* value, PyObject** result);
+
+    // JITSend for the SEND of a step function with state `state`: a JIT
+    // generator that yields becomes the delegate of the generator running
+    // the step, so its next items skip that step's resume and suspend, and
+    // the result it finished with is taken back here
+    PySendResult JITYieldFrom(int32_t* state, PyObject* receiver, PyObject* value, PyObject** result);
+
+    // Resume the coroutines of list `coros` at the indices in `ready` until
+    // each returns (its result stored at its index of `results`), raises,
+    // or awaits something other than a bare yield. Returns a list of
+    // (index, awaited) pairs for the last kind; NULL with the error of a
+    // coroutine that raised, unless `return_exceptions` stores it instead.
+    PyObject* step_coroutines(PyObject* coros, PyObject* ready, PyObject* results, bool return_exceptions);
+
+    // =========================================================================
+    // JIT Async Generator Object
+    // =========================================================================
+    // An async generator runs on a JIT generator whose `yield` values are
+    // wrapped by JITAsyncGenWrap; anything else it yields comes from an
+    // `await` and is passed up to the event loop. __anext__(), asend(),
+    // athrow() and aclose() return native awaitables that step the inner
+    // generator and finish with the unwrapped value.
+    // =========================================================================
+
+    struct JITAsyncGeneratorObject {
+        PyObject_HEAD
+        PyObject* gen;              // Inner JITGeneratorObject (the compiled step function)
+        PyObject* name;             // Async generator name (for repr)
+        PyObject* qualname;         // Qualified name
+        bool closed;                // Finished, failed or closed: every __anext__ raises StopAsyncIteration
+        bool running;               // An awaitable is being iterated
+    };
+
+    // Python type object for JIT async generators (defined in jit_core.cpp)
+    extern PyTypeObject JITAsyncGenerator_Type;
+
+    // Takes a new reference to `gen`, a JITGeneratorObject
+    PyObject* JITAsyncGenerator_New(PyObject* gen, PyObject* name, PyObject* qualname);
+
+    // =========================================================================
+    // JIT Generator Factory
+    // =========================================================================
+    // The callable @jit returns for generator and async functions: a
+    // vectorcall entry that creates the generator (coroutine, async
+    // generator) object and binds the call's arguments straight into its
+    // locals.
+    // =========================================================================
+
+    enum class GeneratorFactoryKind : int
+    {
+        GENERATOR,      // JITGeneratorObject
+        COROUTINE,      // JITCoroutineObject
+        ASYNC_GENERATOR // JITAsyncGeneratorObject around a JITGeneratorObject
+    };
+
+    struct JITGeneratorFactoryObject {
+        PyObject_HEAD
+        vectorcallfunc vectorcall;  // Entry called by CPython's vectorcall protocol
+        GeneratorStepFunc step_func; // Compiled step function
+        Py_ssize_t num_locals;      // Local slots of each created object
+        Py_ssize_t object_locals;   // Leading slots holding references (-1: all)
+        Py_ssize_t param_count;     // Leading slots the arguments bind to
+        bool direct;                // Plain positional calls of param_count args skip binding
+        GeneratorFactoryKind kind;  // What a call creates
+        PyObject* func;             // Original Python function (binding, defaults)
+        PyObject* varnames;         // Parameter names for keyword binding
+        PyObject* name;             // Name of the created objects
+        PyObject* qualname;         // Qualified name of the created objects
+        PyObject* owner;            // JIT instance whose dylib holds the code
+        PyObject* dict;             // Instance __dict__ (wrapper attributes)
+    };
+
+    // Python type object for generator factories (defined in jit_core.cpp)
+    extern PyTypeObject JITGeneratorFactory_Type;
+
+    // `func` is the Python function whose parameters calls bind to; `owner`
+    // (may be NULL) is kept alive for the compiled code. Typed generators
+    // pass object_locals = param_count: only the bound arguments are objects.
+
+    PyObject* JITGeneratorFactory_New(GeneratorStepFunc step_func, Py_ssize_t num_locals, GeneratorFactoryKind kind,
+                                      PyObject* func, PyObject* name, PyObject* qualname, PyObject* owner,
+                                      Py_ssize_t object_locals = -1);
+
+    // =========================================================================
+    // JIT Native Function
+    // =========================================================================
+    // A vectorcall callable that enters a compiled symbol directly, unboxing
+    // arguments for its mode. The @jit decorator returns one of these when
+    // no Python-level dispatch (tiering, background compile) is needed.
+    // =========================================================================
+
+    // Most parameters a native entry dispatches. Up to JIT_NATIVE_DIRECT_PARAMS
+    // the symbol is called directly; wider entries go through a generated
+    // `<name>__argv(NativeArgSlot *argv)` trampoline.
+    constexpr int JIT_NATIVE_MAX_PARAMS = 16;
+    constexpr int JIT_NATIVE_DIRECT_PARAMS = 4;
+
+    // One argument of an argv trampoline; each slot is loaded with its own type
+    union NativeArgSlot
+    {
+        int64_t i64;
+        double f64;
+        void *ptr;
+        int32_t i32;
+        float f32;
+    };
+
+    // Array argument of an ndarray-mode kernel, passed by pointer. Strides
+    // are in bytes; C-contiguous specializations derive them from the shape.
+    constexpr int JIT_NDARRAY_MAX_DIMS = 4;
+    struct NDArrayArg
+    {
+        void *data;
+        int64_t shape[JIT_NDARRAY_MAX_DIMS];
+        int64_t strides[JIT_NDARRAY_MAX_DIMS];
+    };
+
+    // Calling convention of the compiled symbol behind a native entry
+    enum class NativeEntryKind : int
+    {
+        OBJECT, // PyObject* f(PyObject*...), new reference or NULL
+        INT,    // int64_t f(int64_t...)
+        UINT64, // uint64_t f(uint64_t...) (the same registers as INT)
+        FLOAT,  // double f(double...)
+        BOOL    // int64_t f(int64_t...) on 0/1
+    };
+
+    // Per-entry call counts (see justjit.counters). Plain increments: without
+    // a GIL several threads may lose a few.
+    struct NativeCallCounters {
+        uint64_t native_calls;      // Calls that ran the compiled code
+        uint64_t deopts;            // ... of which raised DeoptError (or overflowed) and reran in the fallback
+        uint64_t fallback_type;     // Arguments of a type the entry cannot unbox
+        uint64_t fallback_kwargs;   // Keywords with no parameter names to bind against
+        uint64_t fallback_arity;    // Other argument counts with nothing to bind against
+    };
+
+    // Call latencies of one function name (set_latency_histograms; defined
+    // in jit_core.cpp)
+    struct LatencyHistogram;
+
+    struct JITNativeFunctionObject {
+        PyObject_HEAD
+        vectorcallfunc vectorcall;  // Entry called by CPython's vectorcall protocol
+        uint64_t func_ptr;          // Compiled symbol
+        uint64_t argv_ptr;          // `<name>__argv` trampoline (wide entries only, else 0)
+        NativeEntryKind kind;       // How arguments and result are converted
+        int param_count;            // Parameters of the symbol (every argument slot in object mode)
+        PyObject* name;             // Function name (for repr and errors)
+        PyObject* fallback;         // Called for arguments the entry cannot take (may be NULL)
+        PyObject* owner;            // JIT instance whose dylib holds the code
+        PyObject* dict;             // Instance __dict__ (wrapper attributes)
+        PyObject* varnames;         // Parameter names for keyword binding (NULL: no binding)
+        PyObject* closure;          // Cells shared object code reads via jit_entry_cell (NULL: compiled in)
+        int direct_nargs;           // Positional count passed through unbound (-1: always bind)
+        uint64_t map_ptr;           // `<name>__map` batch loop (int/uint64/float modes, else 0)
+        uint64_t reduce_ptr;        // `<name>__reduce` fold (two-parameter int/uint64/float, else 0)
+        bool parallel;              // Split map/reduce across the parallel pool
+        bool nogil;                 // Release the GIL around typed calls
+        NativeCallCounters counters;
+        LatencyHistogram* latency;  // Where timed calls go (NULL until the first one; owned process-wide)
+    };
+
+    // Python type object for native entries (defined in jit_core.cpp)
+    extern PyTypeObject JITNativeFunction_Type;
+
+    PyObject* JITNativeFunction_New(uint64_t func_ptr, uint64_t argv_ptr, NativeEntryKind kind, int param_count,
+                                    PyObject* name, PyObject* fallback, PyObject* owner);
+
+    // justjit.pipeline(): run the typed generator `source` through the
+    // one-parameter int/float @jit functions in the tuple `stages`, a thread
+    // per stage, in batches of `batch` items with at most `depth` batches
+    // queued between two stages. Returns the fold by the two-parameter
+    // `reduce` (seeded with `initial` unless it is None), or an array.array
+    // of the results when `reduce` is None; NULL with an error set.
+    PyObject* run_generator_pipeline(PyObject* source, PyObject* stages, PyObject* reduce, PyObject* initial,
+                                     Py_ssize_t batch, Py_ssize_t depth);
+
+    // =========================================================================
+    // JIT Dispatcher
+    // =========================================================================
+    // The callable mode='auto' returns: one compiled variant per signature of
+    // exact positional argument types, picked by comparing type pointers.
+    // Signatures it has no variant for go to `miss` (Python), which compiles
+    // one and registers it; once the table is full they go to `generic`.
+    // =========================================================================
+
+    // Variants a dispatcher holds before every new signature goes to `generic`
+    constexpr int JIT_DISPATCH_MAX_VARIANTS = 8;
+
+    struct DispatchVariant {
+        Py_ssize_t nargs;                            // Positional arguments of the signature
+        PyTypeObject* types[JIT_NATIVE_MAX_PARAMS];  // Exact argument types (borrowed from `signature`)
+        PyObject* signature;                         // Tuple of the types
+        PyObject* entry;                             // Callable compiled for the signature
+    };
+
+    struct DispatchCounters {
+        uint64_t dispatch_misses;   // Calls handed to `miss`
+        uint64_t generic_calls;     // Calls handed to `generic`
+    };
+
+    struct JITDispatcherObject {
+        PyObject_HEAD
+        vectorcallfunc vectorcall;  // Entry called by CPython's vectorcall protocol
+        std::atomic<int> nvariants; // Published variants; slots below it never change
+        DispatchVariant variants[JIT_DISPATCH_MAX_VARIANTS];
+        PyObject* miss;             // Called with calls no variant takes
+        PyObject* generic;          // Takes every unmatched call once set (may be NULL)
+        PyObject* name;             // Function name (for repr)
+        PyObject* dict;             // Instance __dict__ (wrapper attributes)
+        DispatchCounters counters;
+    };
+
+    // Python type object for dispatchers (defined in jit_core.cpp)
+    extern PyTypeObject JITDispatcher_Type;
+
+    PyObject* JITDispatcher_New(PyObject* name, PyObject* miss);
+
+    // Back edges between eval-breaker polls of object-mode loops by default
+    constexpr int JIT_POLL_INTERVAL = 1024;
+
+    // Parallel loops: batch calls with parallel=True below this many items
+    // stay on the calling thread; larger ones are cut into JIT_PARALLEL_GRAIN
+    // chunks for the worker pool.
+    constexpr int64_t JIT_PARALLEL_MIN_ITEMS = 1 << 15;
+    constexpr int64_t JIT_PARALLEL_GRAIN = 1 << 13;
+
+    // prange loops: trips up to JIT_PRANGE_MIN_TRIP run as one chunk; longer
+    // ones use at most JIT_PRANGE_MAX_CHUNKS chunks (partial-result slots)
+    constexpr int64_t JIT_PRANGE_MIN_TRIP = 1024;
+    constexpr int64_t JIT_PRANGE_MAX_CHUNKS = 256;
+
+    // Loop body over [begin, end) of a parallel job
+    using ParallelBody = void (*)(void* ctx, int64_t begin, int64_t end);
+
+    // Run `body` over [0, n) in chunks of `grain` on the process-wide pool
+    // (JUSTJIT_NUM_THREADS threads, default one per allowed CPU) and the
+    // calling thread. On NUMA machines every node works on its own share of
+    // the range first (numa_topology.h). Call without the GIL; nested calls
+    // run serially.
+    void jit_parallel_for(ParallelBody body, void* ctx, int64_t n, int64_t grain);
+    int jit_parallel_threads();
+
+    // prange runs so far, and the chunks and distinct threads of the last one
+    struct PrangeStats
+    {
+        uint64_t runs = 0;
+        int64_t chunks = 0;
+        int threads = 0;
+    };
+    PrangeStats jit_prange_stats();
+
+    // Exception type compiled code raises for a construct it cannot execute
+    // (created on first use, by the module init; NULL with an exception set
+    // if that fails, which fails the import). A native entry answers it by calling its
+    // fallback; any other exception propagates with its traceback. It
+    // derives from BaseException so compiled `except Exception:` handlers
+    // never catch it.
+    PyObject* jit_deopt_error();
+
+    // After a DeoptError: if a failed speculative guard of the function at
+    // `func_ptr` captured its frame (jit_deopt_capture), continue the call
+    // from there in `entry`'s `_deopt_resume` and return true with its
+    // result (NULL with an error set if it failed); false if no guard did
+    bool resume_deopt_frame(PyObject* entry, uint64_t func_ptr, PyObject** result);
+
+    // Checked int mode: true if int code run on this thread since the last
+    // call overflowed i64 (its result is then meaningless and the call has
+    // to be rerun in the interpreter); clears the flag. jit_parallel_for
+    // hands its workers' overflows to the calling thread.
+    bool jit_take_int_overflow();
+
+    // Loop polls and native exceptions: true, with the exception set, if
+    // typed code run on this thread left early (through the overflow flag)
+    // because a signal handler raised during jit_poll_typed, or at an
+    // operation Python raises for (see jit_native_error); clears it. Check
+    // it once jit_take_int_overflow returned true.
+    bool jit_take_interrupt();
+
+    // Why typed code called jit_native_error, each code one exception
+    // CPython raises at that operation
+    enum NativeError : int64_t
+    {
+        NATIVE_INT_DIVISION = 1,     // int // 0, divmod(int, 0)
+        NATIVE_INT_MODULO = 2,       // int % 0
+        NATIVE_TRUE_DIVISION = 3,    // int / 0
+        NATIVE_FLOAT_DIVISION = 4,   // float / 0.0
+        NATIVE_FLOAT_FLOOR_DIVISION = 5,
+        NATIVE_FLOAT_MODULO = 6
+    };
+
+    // The NativeError code typed code run on this thread recorded (0 if
+    // none); clears it. Needs no GIL, for workers handing it to the caller.
+    int64_t jit_take_native_error();
+
+    // Exception type and message for `code`; false if it is no NativeError
+    bool jit_native_exception(int64_t code, PyObject *&type, const char *&message);
+
+    // Typed generator raw steps: the exception a raw step run on this
+    // thread failed with (type and message), if any; clears it
+    bool jit_take_generator_error(PyObject *&type, std::string &message);
+
+    // Typed containers: why an ndarray kernel stopped early on this thread
+    // (0 if it did not), with the missing key of a KeyError; clears it
+    enum TypedError : int64_t { TYPED_KEY_ERROR = 1, TYPED_MEMORY_ERROR = 2 };
+    int64_t jit_take_typed_error(int64_t &key);
+
+    // Bind a call to `func`'s parameters in local-slot order (positional,
+    // keyword-only, *args, **kwargs), applying defaults; raises TypeError
+    // like CPython on a mismatch. `out` receives `total` new references.
+    bool jit_bind_arguments(PyObject* func, PyObject* varnames, PyObject* const* args, Py_ssize_t nargs,
+                            PyObject* kwnames, PyObject** out, Py_ssize_t total);
+
+    // Python-facing form of jit_bind_arguments (used by generator factories)
+    nb::tuple bind_call_arguments(nb::handle func, nb::tuple args, nb::dict kwargs);
+
+    // Per-site inline cache for LOAD_GLOBAL. `value` is a borrowed reference
+    // that stays valid while `epoch` equals the global dict epoch: a dict
+    // watcher on the globals/builtins dicts bumps the epoch before any
+    // mutation, which invalidates every cache at once.
+    struct GlobalCacheEntry
+    {
+        PyObject *value;     // Resolved object (borrowed), valid when epoch matches
+        uint64_t epoch;      // Epoch at which value was resolved (0 = empty)
+        PyObject *globals;   // Borrowed; kept alive by the FunctionEnvironment
+        PyObject *builtins;  // Borrowed; kept alive by the FunctionEnvironment
+        PyObject *name;      // Borrowed; kept alive by the FunctionEnvironment
+        PyObject *attr;      // Fused `name.attr` site: the attribute (borrowed), else NULL
+        bool cacheable;      // False if the dicts could not be watched
+    };
+
+    // Per-site polymorphic inline cache for LOAD_ATTR, keyed by the exact type
+    // and its tp_version_tag. Any change to a type (or its MRO) assigns a new
+    // tag, so borrowed descriptors stay valid for as long as an entry matches.
+    enum AttrCacheKind : uint8_t
+    {
+        ATTR_CACHE_EMPTY = 0,
+        ATTR_CACHE_METHOD = 1,        // Plain function / method descriptor on the type
+        ATTR_CACHE_SLOT = 2,          // __slots__ member descriptor (Py_T_OBJECT_EX)
+        ATTR_CACHE_INSTANCE_DICT = 3  // No type attribute: value lives in the instance dict
+    };
+
+    struct AttrCacheEntry
+    {
+        PyTypeObject *type;    // Borrowed; compared by identity
+        unsigned int version;  // tp_version_tag at fill time
+        uint8_t kind;          // AttrCacheKind
+        PyObject *descr;       // Borrowed descriptor (METHOD)
+        Py_ssize_t offset;     // Member offset (SLOT)
+    };
+
+    constexpr int ATTR_CACHE_WAYS = 4;
+
+    struct AttrCache
+    {
+        AttrCacheEntry entries[ATTR_CACHE_WAYS];
+        uint32_t next;         // Round-robin replacement index
+    };
+
+    // Per-site cache for `with`: the context manager's exact type, its tag
+    // and the borrowed __enter__/__exit__ found on it. Only plain functions
+    // and method descriptors are cached, so either can be called with the
+    // manager prepended instead of binding a method first.
+    struct WithCache
+    {
+        PyTypeObject *type = nullptr;  // Borrowed; compared by identity
+        unsigned int version = 0;
+        PyObject *enter = nullptr;
+        PyObject *exit = nullptr;
+    };
+
+    // Per-site cache for IMPORT_NAME. An absolute import returns a module
+    // sys.modules holds, so the borrowed `module` stays valid while `epoch`
+    // equals the sys.modules epoch: a dict watcher on sys.modules bumps it
+    // before any change, which invalidates every import cache at once.
+    struct ImportCache
+    {
+        PyObject *module = nullptr;   // Import result (borrowed), valid when epoch matches
+        uint64_t epoch = 0;           // sys.modules epoch at fill time (0 = empty)
+        PyObject *name = nullptr;     // Borrowed; kept alive by the FunctionEnvironment
+        PyObject *globals = nullptr;  // Borrowed; kept alive by the FunctionEnvironment
+    };
+
+    // What a fused `for ... in d.<view>()` loop yields (jit_dict_loop_next)
+    enum DictLoopKind : int
+    {
+        DICT_LOOP_KEYS = 0,
+        DICT_LOOP_VALUES = 1,
+        DICT_LOOP_ITEMS = 2  // Key and value, as UNPACK_SEQUENCE 2 leaves them
+    };
+
+    // Per-site cache for MATCH_CLASS against a plain class (metaclass type).
+    // The class's tp_version_tag guards the borrowed __match_args__ tuple;
+    // the subject type and its tag remember the last type known to be a
+    // subclass. Each extracted attribute has its own AttrCache, so names
+    // resolve to slot offsets or instance-dict lookups once per type.
+    struct MatchClassCache
+    {
+        PyObject *cls = nullptr;             // Borrowed; compared by identity
+        unsigned int cls_version = 0;
+        PyObject *match_args = nullptr;      // Borrowed from the class (positional patterns only)
+        PyTypeObject *type = nullptr;        // Borrowed; last subject type that matched
+        unsigned int type_version = 0;
+        std::vector<AttrCache> attrs;        // Positional attributes, then keyword ones
+    };
+
+    // Everything one compile's code points at: the globals and builtins it
+    // looks names up in, the constants, names and closure cells it loads
+    // (strong references), and its inline caches. The code bakes these
+    // addresses in, so the environment lives exactly as long as the code:
+    // JITCore hands it to the function's CompiledUnit when the module is
+    // added, and releasing the function frees both. Functions from any
+    // number of modules can share one core without their globals mixing.
+    struct FunctionEnvironment
+    {
+        PyObject *globals = nullptr;
+        PyObject *builtins = nullptr;
+        std::vector<PyObject *> constants;
+        std::vector<PyObject *> names;
+        std::vector<PyObject *> closure_cells;
+        std::vector<std::unique_ptr<GlobalCacheEntry>> global_caches;
+        std::vector<std::unique_ptr<AttrCache>> attr_caches;
+        std::vector<std::unique_ptr<MatchClassCache>> match_class_caches;
+        std::vector<std::unique_ptr<WithCache>> with_caches;
+        std::vector<std::unique_ptr<ImportCache>> import_caches;
+
+        FunctionEnvironment() = default;
+        FunctionEnvironment(const FunctionEnvironment &) = delete;
+        FunctionEnvironment &operator=(const FunctionEnvironment &) = delete;
+        ~FunctionEnvironment(); // Needs the GIL
+    };
+
+    // Type feedback recorded by profiled object-mode code: one site per
+    // BINARY_OP / COMPARE_OP / BINARY_SUBSCR / LOAD_ATTR, with a bitmask of
+    // the operand types seen. A recompile reads the masks to decide which
+    // inline fast paths are worth emitting.
+    enum TypeKind : uint16_t
+    {
+        TYPE_KIND_INT = 1 << 0,
+        TYPE_KIND_FLOAT = 1 << 1,
+        TYPE_KIND_BOOL = 1 << 2,
+        TYPE_KIND_STR = 1 << 3,
+        TYPE_KIND_LIST = 1 << 4,
+        TYPE_KIND_TUPLE = 1 << 5,
+        TYPE_KIND_DICT = 1 << 6,
+        TYPE_KIND_NONE = 1 << 7,
+        TYPE_KIND_OTHER = 1 << 8,
+        TYPE_KIND_ANY = 0xFFFF  // No feedback: assume anything
+    };
+
+    struct TypeFeedbackSite
+    {
+        uint64_t count;     // Executions recorded
+        uint16_t kinds[2];  // TypeKind masks for operands 0 and 1
+        uint16_t opcode;
+    };
+
+    // Branch counters of a profiled object-mode function: calls, and per
+    // conditional jump (POP_JUMP_IF_*, FOR_ITER) by bytecode offset how
+    // often it jumped and how often it fell through
+    struct BranchProfile
+    {
+        uint64_t entries = 0;
+        std::map<int, std::array<uint64_t, 2>> branches;  // {taken, not taken}
+    };
+
     struct Instruction
     {
         uint16_t opcode;
-        uint16_t arg;
+        int32_t arg;    // Oparg with EXTENDED_ARG prefixes folded in (up to 31 bits)
         int32_t argval; // Actual target offset for jump instructions (can be negative for constants)
-        uint16_t offset;
+        int32_t offset; // Byte offset in co_code
+        int32_t line = 0; // Python source line (0 = unknown), for perf line tables
+    };
+
+    // Where a Python function comes from, for the perf line tables and map
+    struct SourceInfo
+    {
+        std::string qualname;
+        std::string filename;
+        int first_line = 0;
+    };
+
+    // Cost of one compile, as reported by justjit.stats()
+    struct CompileStats
+    {
+        std::string name;
+        std::string mode;
+        double ir_ms = 0;                     // Bytecode -> IR
+        double optimize_ms = 0;               // optimize_module (skipped on an object cache hit)
+        double codegen_ms = -1;               // IR -> machine code in the engine; -1 until materialized
+        uint64_t ir_instructions = 0;         // Module instructions before optimization
+        uint64_t optimized_instructions = 0;  // ... and after
+        uint64_t code_size = 0;               // Bytes in the module's text sections
+        bool cached = false;                  // Native code came from the on-disk object cache
+        int opt_level = 0;                    // Optimizer level the module was compiled at
+        std::string budget;                   // Compile budget decision: "", "size" or "deferred"
+    };
+
+    // One LLVM optimization remark (see JITCore::set_opt_remarks)
+    struct OptRemark
+    {
+        std::string kind;      // "missed", "passed" or "analysis"
+        std::string pass;      // Emitting pass, e.g. "loop-vectorize", "inline"
+        std::string name;      // Remark identifier within the pass
+        std::string message;
+        std::string function;  // LLVM function the remark is about
+        int line = 0;          // Python line, 0 when unknown
+        int offset = -1;       // Bytecode offset, -1 when unknown
     };
 
     // Exception table entry for try/except handling
@@ -125,8 +658,8 @@ namespace justjit
     {
         int start_offset;                      // Bytecode offset where block starts
         int end_offset;                        // Bytecode offset where block ends (exclusive)
-        std::vector<int> predecessors;         // Offsets of predecessor blocks
-        std::vector<int> successors;           // Offsets of successor blocks
+        ArenaVector<int> predecessors;         // Offsets of predecessor blocks
+        ArenaVector<int> successors;           // Offsets of successor blocks
         int stack_depth_at_entry;              // Expected stack depth when entering this block
         bool is_exception_handler;             // True if this is an exception handler block
         bool needs_phi_nodes;                  // True if multiple predecessors with different stacks
@@ -154,6 +687,8 @@ namespace justjit
     // =========================================================================
 
     class JITCore;  // Forward declaration
+    struct InlineCExport;
+    struct InlineCUnit;
 
     class InlineCCompiler
     {
@@ -167,13 +702,33 @@ namespace justjit
         // Compile C/C++ code string to LLVM Module
         // lang: "c" or "c++"
         // captured_vars: Python dict of variables to inject into C code
+        // opt_level: clang -O level (0-3)
+        // march: codegen CPU, "native" for the host, "" to follow the JIT's target
+        // flags: extra clang frontend flags (e.g. "-ffast-math")
+        // openmp: compile with -fopenmp and link the OpenMP runtime
+        // unit: named compilation unit to add the functions to, replacing
+        //       earlier definitions of the same names ("" for a one-off module)
+        // nogil: let functions that touch Python objects without calling the
+        //        C API release the GIL anyway (see inline_c_is_gil_free)
         // Returns: dict of new/modified variables to export back to Python
         nb::dict compile_and_execute(
             const std::string& code,
             const std::string& lang,
-            nb::dict captured_vars
+            nb::dict captured_vars,
+            int opt_level = 2,
+            const std::string& march = "",
+            const std::vector<std::string>& flags = {},
+            bool openmp = false,
+            const std::string& unit = "",
+            bool nogil = false
         );
 
+        // Names of the functions currently defined in a unit
+        std::vector<std::string> unit_functions(const std::string& unit) const;
+
+        // Free a unit's code; its callables must not be called afterwards
+        void remove_unit(const std::string& unit);
+
         // Get a Python callable wrapper for a C function
         // signature: "int(int,int)" or "double(double)" etc.
         nb::object get_c_callable(const std::string& name, const std::string& signature);
@@ -186,8 +741,36 @@ namespace justjit
         std::vector<std::string> include_paths_;
         std::string last_ir_;  // Store last compiled IR
 
-        // Generate C code that declares captured Python variables
-        std::string generate_variable_declarations(nb::dict captured_vars);
+        // Results of earlier compilations, keyed by the content hash of the
+        // full source, language, clang flags and codegen target
+        struct CachedCompile {
+            nb::dict result;
+            std::string ir;
+        };
+        std::unordered_map<std::string, CachedCompile> compile_cache_;
+
+        // Precompiled prelude per flag set; null marks a failed build
+        std::unordered_map<std::string, std::unique_ptr<llvm::MemoryBuffer>> prelude_pch_;
+
+        // Named compilation units (see add_to_unit)
+        std::unordered_map<std::string, std::unique_ptr<InlineCUnit>> units_;
+
+        // Split a compiled module into the unit's per-function trackers and
+        // return the inline_c() result for its exports
+        nb::dict add_to_unit(const std::string& unit, std::unique_ptr<llvm::Module> module,
+                             const std::vector<InlineCExport>& exports,
+                             std::shared_ptr<const std::string> bitcode);
+
+        // PCH for the fixed prelude under these clang flags, built (or loaded
+        // from the object cache directory) on first use; null if unavailable
+        const llvm::MemoryBuffer* prelude_pch(const std::string& prelude, const std::string& lang,
+                                              const std::vector<std::string>& args_storage);
+
+        // Generate C code that declares captured Python variables; sets
+        // *embeds_addresses when a declaration bakes in a process-local pointer
+        // and *embeds_objects when that pointer is a PyObject*
+        std::string generate_variable_declarations(nb::dict captured_vars, bool* embeds_addresses = nullptr,
+                                                   bool* embeds_objects = nullptr);
 
         // Extract new variables from compiled module
         nb::dict extract_exported_variables(llvm::Module* module);
@@ -205,36 +788,116 @@ namespace justjit
         void set_dump_ir(bool dump);
         bool get_dump_ir() const;
         std::string get_last_ir() const;
+        // Machine code of later compiles as assembly, headed by the target
+        // triple, CPU and features it was generated for
+        void set_dump_asm(bool dump);
+        bool get_dump_asm() const;
+        std::string get_last_asm() const;
+        // Free the code of compiled function `name` (with its trampolines and
+        // batch kernels) and the Python references and inline caches it
+        // holds; false if nothing is compiled under that name. Callables
+        // obtained for it must not be called afterwards.
+        bool release_function(const std::string &name);
+        nb::list get_compiled_names() const;
         nb::object get_callable(const std::string &name, int param_count);
         nb::object get_int_callable(const std::string &name, int param_count); // For integer-mode functions
-        bool compile_function(nb::list py_instructions, nb::list py_constants, nb::list py_names, nb::object py_globals_dict, nb::object py_builtins_dict, nb::list py_closure_cells, nb::list py_exception_table, const std::string &name, int param_count = 2, int total_locals = 3, int nlocals = 3);
-        bool compile_int_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Integer-only mode
-        bool compile_float_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float-only mode
+        // (opcode, arg, offset) of each instruction of `code`, CACHE units skipped
+        static nb::list decode_bytecode(nb::object code);
+        // The compile_* entry points take the function's code object as
+        // `py_instructions` (and `py_exception_table`) and decode it natively;
+        // a list of instruction (exception entry) dicts is also accepted.
+        // `py_osr_points`, a list of (bytecode offset, stack depth), compiles
+        // an entry that starts mid-function instead, for on-stack replacement
+        // at loop headers and to resume deoptimized calls:
+        // `PyObject*(PyObject** frame, int64_t point)` takes the nlocals fast
+        // locals, then that point's stack values (all owned, NULL for an
+        // unbound local), and starts at the offset of point `point`. Offsets
+        // must lie outside try and with blocks.
+        // `region_end` (with a single OSR point, at a loop header) compiles
+        // only the instructions from that header up to region_end: the
+        // code outside it is never lowered, so its opcodes do not matter.
+        // Leaving the region at offset X hands the locals to
+        // jit_deopt_capture as the frame at X and returns NULL with
+        // DeoptError set; the caller continues at X in the interpreter.
+        bool compile_function(nb::object py_instructions, nb::list py_constants, nb::list py_names, nb::object py_globals_dict, nb::object py_builtins_dict, nb::list py_closure_cells, nb::object py_exception_table, const std::string &name, int param_count = 2, int total_locals = 3, int nlocals = 3, nb::dict py_jit_callees = nb::dict(), nb::list py_osr_points = nb::list(), int region_end = -1);
+        // Whether compile_function can lower this opcode
+        static bool function_supports_opcode(int opcode);
+        // The loops of `code` a region compile can take, as (header, end)
+        // offsets: the range from a JUMP_BACKWARD target to just past the
+        // last jump back to it, entered only at the header, outside try and
+        // with blocks. In offset order, so inner loops follow their outer one.
+        static nb::list loop_regions(nb::object code);
+        // Callable of such an entry: takes a point index and the list of its
+        // frame values (`frame_sizes[point]` of them), `unbound` standing for
+        // a local without a value
+        nb::object get_osr_callable(const std::string &name, std::vector<int> frame_sizes, nb::object unbound);
+        bool compile_int_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, nb::list py_names = nb::list()); // Integer-only mode
+        bool compile_uint64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, nb::list py_names = nb::list()); // Wrapping unsigned 64-bit mode (hashing)
+        bool compile_float_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, nb::list py_names = nb::list()); // Float-only mode
         nb::object get_float_callable(const std::string &name, int param_count); // For float-mode functions
-        bool compile_bool_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Bool-only mode
+        bool compile_bool_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Bool-only mode
         nb::object get_bool_callable(const std::string &name, int param_count); // For bool-mode functions
-        bool compile_int32_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Int32 mode (C interop)
+        // Vectorcall entry for an object/int/float/bool symbol; None if unsupported
+        nb::object get_native_function(const std::string &name, int param_count, const std::string &mode,
+                                       nb::object fallback);
+        bool compile_int32_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, nb::list py_names = nb::list()); // Int32 mode (C interop)
         nb::object get_int32_callable(const std::string &name, int param_count); // For int32-mode functions
-        bool compile_float32_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float32 mode (SIMD/ML)
+        bool compile_float32_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, nb::list py_names = nb::list()); // Float32 mode (SIMD/ML)
         nb::object get_float32_callable(const std::string &name, int param_count); // For float32-mode functions
-        bool compile_complex128_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex128 mode (scientific)
+        bool compile_complex128_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex128 mode (scientific)
         nb::object get_complex128_callable(const std::string &name, int param_count); // For complex128-mode functions
-        bool compile_ptr_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Ptr mode (array access)
-        nb::object get_ptr_callable(const std::string &name, int param_count); // For ptr-mode functions
-        bool compile_vec4f_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec4f mode (SSE SIMD)
+        // (map, reduce, stream) batch callables over complex buffers; None if not emitted
+        nb::object get_complex_batch(const std::string &name, int param_count, const std::string &mode);
+        // (map, reduce) of an int/float function on the CUDA device (target='cuda';
+        // reduce None unless it takes two parameters); RuntimeError if it cannot run there
+        nb::object get_cuda_batch(const std::string &name, int param_count, const std::string &mode);
+        // Ptr mode (array access); `elem_kind` is the struct format of the
+        // array's items: d f q i h H b B
+        bool compile_ptr_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3, char elem_kind = 'd');
+        nb::object get_ptr_callable(const std::string &name, int param_count, char elem_kind = 'd'); // For ptr-mode functions
+        // Vector mode: <lanes x elem_kind> SIMD ('f' f32, 'd' f64, 'i' i32,
+        // 'q' i64; 2, 4, 8 or 16 lanes) with a `<name>__lanes` array loop
+        bool compile_vec_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count, int total_locals, char elem_kind, int lanes);
+        nb::object get_vec_callable(const std::string &name, int param_count, char elem_kind, int lanes);
+        // Lanes of `elem_kind` filling one vector register of the target
+        int native_vector_lanes(char elem_kind) const;
+        // Whether the target converts float16 in hardware (F16C, AArch64)
+        bool native_half_conversions() const;
+        bool compile_vec4f_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec4f mode (SSE SIMD)
         nb::object get_vec4f_callable(const std::string &name, int param_count); // For vec4f-mode functions
-        bool compile_vec8i_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec8i mode (AVX SIMD)
+        bool compile_vec8i_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec8i mode (AVX SIMD)
         nb::object get_vec8i_callable(const std::string &name, int param_count); // For vec8i-mode functions
-        bool compile_complex64_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex64 mode (single-precision)
+        bool compile_complex64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex64 mode (single-precision)
         nb::object get_complex64_callable(const std::string &name, int param_count); // For complex64-mode functions
-        bool compile_optional_f64_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Optional<f64> mode (nullable)
+        bool compile_optional_f64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Optional<f64> mode (nullable)
         nb::object get_optional_f64_callable(const std::string &name, int param_count); // For optional_f64-mode functions
+        // ndarray mode: one specialization per argument layout. `param_kinds`
+        // has a token per parameter: 'q' / 'd' for an int / float scalar, or
+        // layout ('C' contiguous, 'S' strided) + struct format char + ndim
+        // for an array, e.g. "Cd2Sf1q", or "{x:d,n:q}" for a jitclass
+        // record (fields 'd', 'f', 'q', 'i' or '?', laid out in order) and
+        // "[x:d,n:q]" for a RecordArray of them, one column per field.
+        bool compile_ndarray_function(nb::object py_instructions, nb::list py_constants, nb::list py_names,
+                                      const std::string &name, int param_count, int total_locals,
+                                      const std::string &param_kinds);
+        nb::object get_ndarray_callable(const std::string &name, const std::string &param_kinds);
+        // Parameters (bit per index) an ndarray-mode specialization stores into
+        uint32_t get_ndarray_written(const std::string &name) const;
         
         // Generator compilation - transforms generator function to state machine step function
-        bool compile_generator(nb::list py_instructions, nb::list py_constants, nb::list py_names, 
+        bool compile_generator(nb::object py_instructions, nb::list py_constants, nb::list py_names, 
                               nb::object py_globals_dict, nb::object py_builtins_dict, 
-                              nb::list py_closure_cells, nb::list py_exception_table,
+                              nb::list py_closure_cells, nb::object py_exception_table,
                               const std::string &name, int param_count, int total_locals, int nlocals);
+        // Whether compile_generator can lower this opcode
+        static bool generator_supports_opcode(int opcode);
+        
+        // Typed generator (mode "int" or "float"): plain positional parameters,
+        // numeric locals kept unboxed across yields, range() loops, `yield x`
+        // statements. Returns false when the body needs object mode.
+        bool compile_typed_generator(nb::object py_instructions, nb::list py_constants, nb::list py_names,
+                                     const std::string &name, int param_count, int nlocals, int stack_size,
+                                     const std::string &mode);
         
         // Get a generator factory callable (returns a new generator on each call)
         nb::object get_generator_callable(const std::string &name, int param_count, int total_locals,
@@ -242,6 +905,210 @@ namespace justjit
         
         uint64_t lookup_symbol(const std::string &name);
 
+        // Pass pipeline tuning: loop/SLP vectorization, inlining, and an
+        // unroll factor (0 = LLVM's choice, 1 = no unrolling, N = unroll by N)
+        void set_pipeline_options(bool vectorize, bool inline_functions, int unroll);
+
+        // Fast-math flags put on every FP instruction of later compiles, by
+        // LLVM name: nnan, ninf, nsz, arcp, contract, afn, reassoc ("fast" is
+        // all of them). Empty keeps strict IEEE semantics.
+        void set_fastmath(const std::vector<std::string> &flags);
+        std::vector<std::string> get_fastmath() const;
+
+        // Vector math library the loop vectorizer maps math calls to
+        // (sin, exp, ... over several lanes): "none", "libmvec", "svml",
+        // "sleef", "accelerate", or "auto" for the platform's usual one when
+        // it can be loaded. Throws if the named library cannot be loaded.
+        void set_vector_library(const std::string &library);
+        std::string get_vector_library() const;
+
+        // Codegen target for this core's functions. "native" (the default)
+        // resolves to the host CPU name / host feature set; features "cpu"
+        // means only what the CPU name itself implies.
+        void set_target(const std::string &cpu, const std::string &features);
+        std::string get_target_cpu() const;
+        std::string get_target_features() const;
+
+        // Whether code generated for `cpu` (an LLVM CPU name such as
+        // "x86-64-v3" or "neoverse-n1") runs on the host: false for names the
+        // host's target does not know or that imply an ISA feature it lacks
+        static bool host_supports_cpu(const std::string &cpu);
+
+        // Persistent object cache for typed-mode functions (process-wide).
+        // An empty path disables it; JUSTJIT_CACHE_DIR sets the initial value.
+        static void set_cache_dir(const std::string &path);
+        static std::string get_cache_dir();
+
+        // One dict per module compiled by any JITCore, in compile order (see
+        // CompileStats); clear_compile_stats drops the records so far
+        static nb::list get_compile_stats();
+        static void clear_compile_stats();
+
+        // Linux perf support (process-wide, fixed once the first JIT exists):
+        // "map" writes /tmp/perf-<pid>.map, "jitdump" emits jitdump records
+        // with Python line tables, "all" both, "" none. JUSTJIT_PERF sets the
+        // initial value.
+        static void set_perf_mode(const std::string &mode);
+        static std::string get_perf_mode();
+
+        // Register JIT'd objects with the GDB JIT interface, with Python line
+        // tables, for gdb/lldb backtraces (process-wide, fixed once the first
+        // JIT exists). JUSTJIT_GDB=1 sets the initial value.
+        static void set_gdb_support(bool enabled);
+        static bool get_gdb_support();
+
+        // PC tables (process-wide, fixed once the first JIT exists): the
+        // native code of every loaded function mapped to Python lines and
+        // bytecode offsets through its line table. JUSTJIT_PC_TABLES=1 sets
+        // the initial value. get_pc_table lists them; lookup_pc maps one PC.
+        static void set_pc_tables(bool enabled);
+        static bool get_pc_tables();
+        static nb::list get_pc_table();
+        static nb::object lookup_pc(uint64_t pc);
+
+        // Executable memory (process-wide, fixed once the first JIT exists):
+        // "slab" sub-allocates every module's code and data from shared
+        // slabs (JUSTJIT_CODE_SLAB_SIZE bytes, default 2 MB), "huge" also
+        // aligns them for transparent huge pages, "" leaves it to LLVM.
+        // JUSTJIT_CODE_MEMORY sets the initial value. The stats are None
+        // without slabs.
+        static void set_code_memory(const std::string &mode);
+        static std::string get_code_memory();
+        static nb::object get_code_memory_stats();
+
+        // Memory held by JIT state, process-wide and per compiled name: the
+        // code, read-only and writable data bytes of the loaded objects, the
+        // Python objects the code pins (constants, names, closure cells), the
+        // engine and JITDylib count, and the generator/coroutine objects
+        // alive with their locals' bytes
+        static nb::dict get_memory_info();
+
+        // Per-opcode trace points in later compiles (process-wide): each
+        // executed instruction appends (function, offset, opcode) to a
+        // lock-free ring; drain_trace returns and clears the events since the
+        // last drain. Off by default, leaving no trace code; JUSTJIT_TRACE=1
+        // sets the initial value.
+        static void set_trace(bool enabled);
+        static bool get_trace();
+        static nb::dict drain_trace();
+
+        // Latency histograms of native entry calls (process-wide): while on,
+        // each call through a native entry is timed with the CPU's timestamp
+        // counter into lock-free per-thread log-linear buckets per function
+        // name. read_latency_histograms returns the counts in ticks with the
+        // measured ticks per nanosecond; `reset` zeroes them. Off by default;
+        // JUSTJIT_LATENCY=1 sets the initial value.
+        static void set_latency_histograms(bool enabled);
+        static bool get_latency_histograms();
+        static nb::dict read_latency_histograms(bool reset);
+
+        // Sample the interrupted PC every `interval_us` of process CPU time
+        // (SIGPROF, Linux); stop returns the samples per function/line/offset
+        static void start_pc_sampling(int interval_us);
+        static nb::dict stop_pc_sampling();
+
+        // Python source of `name` for perf and debuggers: the line tables of
+        // its later compiles and its label in the perf map
+        void set_source_info(const std::string &name, const std::string &qualname,
+                             const std::string &filename, int first_line);
+
+        // Keep the optimization remarks (missed and passed vectorization,
+        // inlining, ...) of later compiles, mapped to bytecode offsets;
+        // get_opt_remarks returns those of the last compile of `name`
+        void set_opt_remarks(bool enabled);
+        bool get_opt_remarks_enabled() const;
+        nb::list get_opt_remarks(const std::string &name) const;
+
+        // Profiling tier: object-mode code compiled while profiling is on
+        // records operand types per site. get_type_feedback returns
+        // {offset: (opcode, count, kinds0, kinds1)} for a function, and
+        // set_type_feedback hands such a table to a later compile of `name`.
+        void set_profiling(bool enabled);
+        bool get_profiling() const;
+
+        // parallel=True: native entries created afterwards split map/reduce
+        // calls across the parallel pool
+        void set_parallel(bool enabled);
+        bool get_parallel() const;
+
+        // FOR_ITER offsets of `for i in prange(...)` loops in `name`; with
+        // parallel on, the next int/float compile runs them on the pool
+        void set_parallel_loops(const std::string &name, const std::vector<int> &offsets);
+        // ...and the offsets among them the last compile of `name` did
+        // outline; a loop outline_prange_loop cannot classify runs serially
+        std::vector<int> get_parallel_loops(const std::string &name) const;
+
+        // nogil=True: typed entries and callables created afterwards release
+        // the GIL around the native call, for symbols whose module was proven
+        // free of Python API use at compile time
+        void set_nogil(bool enabled);
+        bool get_nogil() const;
+
+        // checked=True (the default): int mode +, -, *, **, <<, unary minus
+        // and the divisions test for i64 overflow (and a zero divisor) and
+        // make the native entry rerun such calls in the interpreter;
+        // False keeps two's-complement wraparound
+        void set_overflow_checks(bool enabled);
+        bool get_overflow_checks() const;
+
+        // boundscheck= for later ndarray compiles: 0 trusts every index,
+        // 1 (the default) checks those not proven in range by an enclosing
+        // range(0, a.shape[d]) loop, 2 checks them all. A failed check makes
+        // the call raise IndexError
+        void set_bounds_checks(int level);
+        int get_bounds_checks() const;
+
+        // poll= for later compiles: loops call jit_poll_* every `interval`
+        // back edges, which lets threads waiting for the GIL run and (where
+        // the code can leave with an exception) runs signal handlers. 0
+        // turns polling off; a negative interval (the default) polls object
+        // code every JIT_POLL_INTERVAL back edges and typed code never,
+        // since a call in a typed loop keeps it from vectorizing
+        void set_poll_interval(int interval);
+        int get_poll_interval() const;
+
+        // static_args=: [(param index, int/float/bool value), ...] that later
+        // int, float, bool, int32, float32 and ndarray/mixed compiles fold in
+        // as IR constants (see bind_static_args). The parameters stay in the
+        // signature; the wrapper only calls this instance with those values.
+        void set_static_args(nb::list args);
+        nb::list get_static_args() const;
+
+        // Later object-mode compiles take their free variables' cells from
+        // the native entry that calls them (its fallback's __closure__)
+        // instead of baking them in, so one body serves every closure of
+        // the same code. Such functions are never called directly by
+        // other compiled code, which would bypass the entry
+        void set_entry_closures(bool enabled);
+        bool get_entry_closures() const;
+
+        // Compile budget decision recorded in the stats of this instance's
+        // modules: "size" (opt level lowered for max_bytecode_size) or
+        // "deferred" (max_compile_ms passed; finishing in the background).
+        // Atomic, since the wrapper sets "deferred" while a worker compiles
+        void set_budget_note(const std::string &note);
+        std::string get_budget_note() const;
+        nb::dict get_type_feedback(const std::string &name) const;
+        void set_type_feedback(const std::string &name, nb::dict feedback);
+
+        // Profiled code also counts calls and conditional jumps.
+        // get_branch_profile returns (entries, {offset: (taken, not_taken)})
+        // and set_branch_profile gives a later compile of `name` the counts
+        // as its function entry count and branch weights
+        nb::tuple get_branch_profile(const std::string &name) const;
+        void set_branch_profile(const std::string &name, nb::tuple profile);
+
+        // Speculation: later object-mode compiles with type feedback drop
+        // the generic path of sites that only saw one operand kind, guarding
+        // it with a deopt exit instead. get_deopt_sites lists a function's
+        // guards as (offset, stack depth), the points its resume entry
+        // needs; take_deopt_frame hands over the frame the last failed
+        // guard on this thread captured, as (offset, [locals..., stack...])
+        void set_speculation(bool enabled);
+        bool get_speculation() const;
+        nb::list get_deopt_sites(const std::string &name) const;
+        static nb::object take_deopt_frame(nb::object unbound);
+
         // Helper to declare Python C API functions in LLVM module
         void declare_python_api_functions(llvm::Module *module, llvm::IRBuilder<> *builder);
 
@@ -275,6 +1142,12 @@ namespace justjit
         llvm::Function *py_object_setattr_func = nullptr;
         llvm::Function *py_object_setitem_func = nullptr;
         llvm::Function *py_object_call_func = nullptr;
+        llvm::Function *py_object_vectorcall_func = nullptr;
+        llvm::Function *jit_load_global_slow_func = nullptr;  // PyObject* jit_load_global_slow(GlobalCacheEntry*)
+        llvm::Function *jit_load_attr_cached_func = nullptr;  // PyObject* jit_load_attr_cached(AttrCache*, obj, name)
+        llvm::Function *jit_load_method_cached_func = nullptr; // PyObject* jit_load_method_cached(AttrCache*, obj, name, PyObject** self)
+        llvm::Function *jit_dict_subscr_func = nullptr;        // PyObject* jit_dict_subscr(dict, str_key)
+        llvm::Function *jit_record_types_func = nullptr;       // void jit_record_types(TypeFeedbackSite*, a, b)
         llvm::Function *py_long_aslong_func = nullptr;
         llvm::Function *py_object_richcompare_bool_func = nullptr;
         llvm::Function *py_object_istrue_func = nullptr;
@@ -286,6 +1159,8 @@ namespace justjit
         llvm::Function *py_object_getiter_func = nullptr;
         llvm::Function *py_iter_next_func = nullptr;
         llvm::Function *py_dict_new_func = nullptr;
+        llvm::Function *py_dict_new_presized_func = nullptr;  // _PyDict_NewPresized(minused)
+        llvm::Function *jit_list_new_for_iter_func = nullptr; // comprehension list reserved from a length hint
         llvm::Function *py_dict_setitem_func = nullptr;
         llvm::Function *py_set_new_func = nullptr;
         llvm::Function *py_set_add_func = nullptr;
@@ -351,8 +1226,7 @@ namespace justjit
 
         // JIT helper functions
         llvm::Function *jit_call_with_kwargs_func = nullptr; // PyObject* jit_call_with_kwargs(...) for CALL_KW
-        llvm::Function *jit_debug_trace_func = nullptr;      // void jit_debug_trace(...) for debugging
-        llvm::Function *jit_debug_stack_func = nullptr;      // void jit_debug_stack(...) for debugging
+        llvm::Function *jit_call_function_ex_func = nullptr; // PyObject* jit_call_function_ex(...) for CALL_FUNCTION_EX
 
         // Async generator support functions
         llvm::Function *jit_get_aiter_func = nullptr;        // PyObject* JITGetAIter(PyObject*) for GET_AITER
@@ -363,28 +1237,172 @@ namespace justjit
 
     private:
         friend class InlineCCompiler;  // Allow access to jit for object loading
-        std::unique_ptr<llvm::orc::LLJIT> jit;
-        std::unique_ptr<llvm::LLVMContext> context;
+        llvm::orc::LLJIT *jit = nullptr;          // Process-wide engine (shared, not owned)
+        llvm::orc::JITDylib *dylib = nullptr;     // This core's symbols, removed on destruction
         int opt_level = 3;
         bool dump_ir = false;
+        bool dump_asm = false;
+        bool enable_vectorize = true;
+        bool enable_inline = true;
+        int unroll_count = 0;
+        llvm::FastMathFlags fastmath_flags;
+        std::string vector_library = "none";
+        std::string target_cpu = "native";
+        std::string target_features = "native";
+        std::unique_ptr<llvm::TargetMachine> target_machine;  // Optimizer cost model, built on demand
         std::string last_ir;
+        std::string last_asm;
+        void capture_asm(const llvm::Module &module);
+
+        // Environment of the compile in progress, started by
+        // begin_compile_stats and handed to the function's unit by add_module
+        std::unique_ptr<FunctionEnvironment> env;
+
+        // Type feedback: sites written by profiled code (std::map nodes keep
+        // their address), and tables supplied for upcoming compiles
+        bool profile_types = false;
+        bool parallel_batches = false;
+        std::unordered_map<std::string, std::map<int, TypeFeedbackSite>> type_feedback;
+        std::unordered_map<std::string, std::unordered_map<int, TypeFeedbackSite>> feedback_hints;
+        std::unordered_map<std::string, BranchProfile> branch_profiles;
+        std::unordered_map<std::string, BranchProfile> branch_hints;
+        bool speculate = false;
+        std::unordered_map<std::string, std::vector<std::pair<int, int>>> deopt_sites;
+        std::unordered_map<std::string, std::vector<int>> prange_hints;
+        std::unordered_map<std::string, std::vector<int>> parallel_loops;  // See get_parallel_loops
+        std::unordered_map<std::string, SourceInfo> source_hints;
+        bool collect_remarks = false;
+        std::unordered_map<std::string, std::vector<OptRemark>> opt_remarks;
+
+        // Source of `name` when this compile should carry line tables (perf,
+        // debuggers, optimization remarks)
+        const SourceInfo *line_table_source(const std::string &name);
+
+        // Body of compile_int_function and, `is_unsigned`, compile_uint64_function
+        bool compile_int64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count,
+                                    int total_locals, nb::list py_names, bool is_unsigned);
+
+        // Typed functions whose IR calls no Python API (see note_gil_free)
+        bool nogil_calls = false;
+        bool int_overflow_checks = true;
+        int bounds_checks = 1;
+        int poll_interval = -1;
+        std::unordered_set<std::string> gil_free_functions;
+        bool entry_closures = false;
+        std::unordered_set<std::string> entry_closure_functions;  // Compiled with entry_closures
 
-        // Store references to Python objects we've incref'd (for cleanup)
-        std::vector<PyObject *> stored_constants;
-        std::vector<PyObject *> stored_names;
+        struct StaticArg
+        {
+            int index;
+            bool is_float;
+            int64_t i;
+            double d;
+        };
+        std::vector<StaticArg> static_args;
+        // Replace the uses of each static parameter of `name` (and of its
+        // `__noalias` twin) with its constant, before the optimizer runs
+        void bind_static_args(llvm::Module &module, const std::string &name);
+        void note_gil_free(const llvm::Module &module, const std::string &name);
+        bool releases_gil(const std::string &name) const;
 
-        // Runtime globals/builtins dicts for LOAD_GLOBAL (Bug #4 fix)
-        PyObject *globals_dict_ptr = nullptr;
-        PyObject *builtins_dict_ptr = nullptr;
+        // Serializes compiles and the tables they fill. The GIL does not:
+        // compiles release it while optimizing, and 3.13t builds have none.
+        mutable std::recursive_mutex state_mutex;
+        std::unique_lock<std::recursive_mutex> lock_state() const;
+
+        // Stats of the compile in progress, handed to the registry by add_module
+        bool stats_active = false;
+        CompileStats pending_stats;
+        std::atomic<int> budget_note{0};  // Index into COMPILE_BUDGET_NOTES
+        std::chrono::steady_clock::time_point stats_start;
+        void begin_compile_stats(const std::string &name, const std::string &mode);
+
+        // Addresses the module being built names by symbol rather than as
+        // inttoptr constants: one external global per address, defined as
+        // an absolute symbol by add_module. The object code then holds
+        // relocations, not this process's addresses
+        struct ObjectRef
+        {
+            std::string symbol;
+            const void *address;
+        };
+        llvm::Module *object_ref_module = nullptr;
+        std::unordered_map<const void *, llvm::GlobalVariable *> object_ref_globals;
+        std::vector<ObjectRef> pending_object_refs;
+        llvm::Value *emit_object_ref(llvm::Module &module, const void *address);
 
         // Cache of already-compiled function names to prevent duplicate symbol errors
         std::unordered_set<std::string> compiled_functions;
 
+        // What one compiled name owns: a resource tracker covering every
+        // module added for it, and the environments its code points at
+        struct CompiledUnit
+        {
+            llvm::orc::ResourceTrackerSP tracker;
+            std::vector<std::unique_ptr<FunctionEnvironment>> environments;
+            uint64_t memory_id = 0; // Object bytes, counted by the compile layer
+        };
+        std::unordered_map<std::string, CompiledUnit> units;
+
+        // Bitcode of each int/float function's module as added, linked into
+        // typed callers as a private copy (see emit_jit_call)
+        std::unordered_map<std::string, std::shared_ptr<const std::string>> typed_bitcode;
+        void record_typed_bitcode(const llvm::Module &module, const std::string &name);
+
         // Cache of generator metadata (actual total_locals after simulation)
         std::unordered_map<std::string, int> generator_total_locals;
 
-        // Closure cells storage (for COPY_FREE_VARS / LOAD_DEREF)
-        std::vector<PyObject *> stored_closure_cells;
+
+        // ndarray-mode kernels by name: return kind ('v', 'b', 'q', 'd', or
+        // 't' for a tuple of the `ret_items` kinds), the parameters (bit per
+        // index) the kernel stores into, those it takes min()/max() of, which
+        // must not be empty, and whether a `<name>__noalias` twin exists for
+        // non-overlapping arguments. A str result is `ret_text` 'c' (a code
+        // point returned as 'q') or 's' (start and length of a slice of
+        // argument `ret_param`, returned as the tuple "qq"). `matmuls` holds
+        // the (out, a, b) parameters of each `out[:] = a @ b` (out -1 for a
+        // 1-D dot product), whose shapes and overlap the entry checks.
+        struct NdarrayKernelInfo
+        {
+            char ret_kind;
+            std::string ret_items;
+            uint32_t written;
+            uint32_t nonempty;
+            bool noalias;
+            char ret_text = 0;
+            int ret_param = -1;
+            std::vector<std::array<int, 3>> matmuls;
+        };
+        std::unordered_map<std::string, NdarrayKernelInfo> ndarray_kernels;
+
+        // Argument-array trampolines by name (`<name>__argv` -> address)
+        std::unordered_map<std::string, uint64_t> argv_trampolines;
+
+        // Build (once) `<name>__argv(NativeArgSlot *argv)`, which loads each
+        // slot and calls `name`. Kinds: 'q' i64, 'd' double, 'p' ptr, 'i' i32,
+        // 'f' float, 'v' void (return only). ret_kind 't' means `name`
+        // returns a struct of `ret_items` kinds; the trampoline returns void
+        // and stores field k into argv[k]. Returns 0 on failure.
+        uint64_t get_argv_trampoline(const std::string &name, char ret_kind, const std::string &param_kinds,
+                                     const std::string &ret_items = "");
+
+        // Emit `<name>__map` / `<name>__reduce` loops around a typed scalar
+        // kernel into its own module (backs JITNativeFunction.map/.reduce)
+        void emit_batch_kernels(llvm::Module &module, llvm::Function *scalar, const std::string &name);
+        // PTX of `name`'s CUDA map/reduce kernels for compute capability `sm`
+        // (major * 10 + minor), built from its typed_bitcode; empty with
+        // `error` set when the scalar kernel cannot run on the device
+        std::string emit_cuda_kernels(const std::string &name, int sm, std::string &error);
+
+        // Emit `<name>__lanes`, the whole-array loop around a vec-mode kernel
+        void emit_vec_lane_loop(llvm::Module &module, llvm::Function *kernel, llvm::FixedVectorType *vec_type, const std::string &name);
+
+        // Any-arity callables over an argv trampoline
+        nb::object create_scalar_argv_callable(uint64_t argv_ptr, int param_count, char kind, bool nogil = false);
+        nb::object create_ptr_argv_callable(uint64_t argv_ptr, int param_count, char elem_kind);
+        // Vec modes over whole arrays through `<name>__lanes`
+        template <typename T>
+        nb::object create_vec_array_callable(uint64_t lanes_ptr, int param_count, int lanes, bool nogil);
 
         nb::object create_callable_0(uint64_t func_ptr);
         nb::object create_callable_1(uint64_t func_ptr);
@@ -393,66 +1411,151 @@ namespace justjit
         nb::object create_callable_4(uint64_t func_ptr);
 
         // Integer-mode callable generators (native i64 -> i64 functions)
-        nb::object create_int_callable_0(uint64_t func_ptr);
-        nb::object create_int_callable_1(uint64_t func_ptr);
-        nb::object create_int_callable_2(uint64_t func_ptr);
-        nb::object create_int_callable_3(uint64_t func_ptr);
-        nb::object create_int_callable_4(uint64_t func_ptr);
+        nb::object create_int_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int_callable_2(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int_callable_3(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int_callable_4(uint64_t func_ptr, bool nogil = false);
 
         // Float-mode callable generators (native f64 -> f64 functions)
-        nb::object create_float_callable_0(uint64_t func_ptr);
-        nb::object create_float_callable_1(uint64_t func_ptr);
-        nb::object create_float_callable_2(uint64_t func_ptr);
-        nb::object create_float_callable_3(uint64_t func_ptr);
-        nb::object create_float_callable_4(uint64_t func_ptr);
+        nb::object create_float_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float_callable_2(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float_callable_3(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float_callable_4(uint64_t func_ptr, bool nogil = false);
 
         // Bool-mode callable generators (native i64 -> bool functions)
-        nb::object create_bool_callable_0(uint64_t func_ptr);
-        nb::object create_bool_callable_1(uint64_t func_ptr);
-        nb::object create_bool_callable_2(uint64_t func_ptr);
-        nb::object create_bool_callable_3(uint64_t func_ptr);
-        nb::object create_bool_callable_4(uint64_t func_ptr);
+        nb::object create_bool_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_bool_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_bool_callable_2(uint64_t func_ptr, bool nogil = false);
+        nb::object create_bool_callable_3(uint64_t func_ptr, bool nogil = false);
+        nb::object create_bool_callable_4(uint64_t func_ptr, bool nogil = false);
 
         // Int32-mode callable generators (native i32 functions)
-        nb::object create_int32_callable_0(uint64_t func_ptr);
-        nb::object create_int32_callable_1(uint64_t func_ptr);
-        nb::object create_int32_callable_2(uint64_t func_ptr);
-        nb::object create_int32_callable_3(uint64_t func_ptr);
-        nb::object create_int32_callable_4(uint64_t func_ptr);
+        nb::object create_int32_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int32_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int32_callable_2(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int32_callable_3(uint64_t func_ptr, bool nogil = false);
+        nb::object create_int32_callable_4(uint64_t func_ptr, bool nogil = false);
 
         // Float32-mode callable generators (native f32 functions)
-        nb::object create_float32_callable_0(uint64_t func_ptr);
-        nb::object create_float32_callable_1(uint64_t func_ptr);
-        nb::object create_float32_callable_2(uint64_t func_ptr);
-        nb::object create_float32_callable_3(uint64_t func_ptr);
-        nb::object create_float32_callable_4(uint64_t func_ptr);
+        nb::object create_float32_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float32_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float32_callable_2(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float32_callable_3(uint64_t func_ptr, bool nogil = false);
+        nb::object create_float32_callable_4(uint64_t func_ptr, bool nogil = false);
 
         // Complex128-mode callable generators (native {double,double} functions)
-        nb::object create_complex128_callable_0(uint64_t func_ptr);
-        nb::object create_complex128_callable_1(uint64_t func_ptr);
-        nb::object create_complex128_callable_2(uint64_t func_ptr);
+        nb::object create_complex128_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_complex128_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_complex128_callable_2(uint64_t func_ptr, bool nogil = false);
 
         // Ptr-mode callable generators (ptr + index operations)
-        nb::object create_ptr_callable_2(uint64_t func_ptr);
-        nb::object create_ptr_callable_3(uint64_t func_ptr);
-
-        // Vec4f-mode callable generators (<4 x float> SIMD)
-        nb::object create_vec4f_callable_2(uint64_t func_ptr);
-
-        // Vec8i-mode callable generators (<8 x i32> SIMD)
-        nb::object create_vec8i_callable_2(uint64_t func_ptr);
+        nb::object create_ptr_callable_2(uint64_t func_ptr, char elem_kind);
+        nb::object create_ptr_callable_3(uint64_t func_ptr, char elem_kind);
 
         // Complex64-mode callable generators ({float, float})
-        nb::object create_complex64_callable_0(uint64_t func_ptr);
-        nb::object create_complex64_callable_1(uint64_t func_ptr);
-        nb::object create_complex64_callable_2(uint64_t func_ptr);
+        nb::object create_complex64_callable_0(uint64_t func_ptr, bool nogil = false);
+        nb::object create_complex64_callable_1(uint64_t func_ptr, bool nogil = false);
+        nb::object create_complex64_callable_2(uint64_t func_ptr, bool nogil = false);
 
         // OptionalF64-mode callable generators ({bool, double})
         nb::object create_optional_f64_callable_0(uint64_t func_ptr);
         nb::object create_optional_f64_callable_1(uint64_t func_ptr);
         nb::object create_optional_f64_callable_2(uint64_t func_ptr);
 
-        void optimize_module(llvm::Module &module, llvm::Function *func);
+        // object_code selects the lean pipeline for object-mode (PyObject*)
+        // code; typed modes get the full default pipeline at opt_level
+        void optimize_module(llvm::Module &module, llvm::Function *func, bool object_code = false);
+        void optimize_module_timed(llvm::Module &module, llvm::Function *func, bool object_code = false);
+        void run_pipeline(llvm::Module &module, llvm::Function *func, bool object_code = false);
+
+        // Drop incref/decref pairs on values borrowed from object-mode locals
+        void elide_local_refcounts(llvm::Function *func,
+                                   const OffsetMap<llvm::AllocaInst *> &local_allocas);
+
+        llvm::TargetMachine *get_target_machine();
+
+        // Set data layout / triple and per-function target-cpu/target-features
+        void apply_target(llvm::Module &module);
+
+        // Object-mode fast paths: exact-type guard, compact-int decode, and
+        // inline +, -, *, / for float/compact-int operands. `seen` (TypeKind
+        // mask from type feedback) drops guards for kinds a site never saw. The number fast path
+        // branches to generic_block when no guard matches and leaves the
+        // builder there; fast results (boxed) are appended to `incoming`.
+        llvm::Value *emit_type_check(llvm::IRBuilder<> &builder, llvm::Value *obj, PyTypeObject *type);
+        std::pair<llvm::Value *, llvm::Value *> emit_compact_long_value(llvm::IRBuilder<> &builder, llvm::Value *obj);
+        bool emit_number_fast_path(llvm::IRBuilder<> &builder, int op, llvm::Value *lhs, llvm::Value *rhs,
+                                   llvm::BasicBlock *generic_block, llvm::BasicBlock *done_block,
+                                   std::vector<std::pair<llvm::Value *, llvm::BasicBlock *>> &incoming,
+                                   llvm::Value *store_slot = nullptr, uint16_t seen = TYPE_KIND_ANY);
+        // Builtin calls object mode lowers inline: len/abs/int/float on one
+        // argument, isinstance and two-argument min/max. classify_builtin
+        // recognises the builtins module's own objects (NONE for anything
+        // else, including a wrong arity). The fast path works like the number
+        // fast path; the caller guards that the callee is still `builtin`.
+        // `known_cls` is isinstance's class when it is a loaded builtin type
+        // (compared at run time before its subclass flag is trusted).
+        enum class InlineBuiltin { NONE, LEN, ABS, MIN, MAX, ISINSTANCE, INT, FLOAT };
+        static InlineBuiltin classify_builtin(PyObject *builtin, size_t nargs);
+        void emit_builtin_fast_path(llvm::IRBuilder<> &builder, InlineBuiltin kind, const std::vector<llvm::Value *> &args,
+                                    PyObject *known_cls, llvm::BasicBlock *generic_block, llvm::BasicBlock *done_block,
+                                    std::vector<std::pair<llvm::Value *, llvm::BasicBlock *>> &incoming);
+        // Box a float fast-path result, reusing lhs's box when it is unobservable
+        llvm::Value *emit_float_result(llvm::IRBuilder<> &builder, llvm::Value *value, llvm::Value *lhs, llvm::Value *store_slot);
+
+        // FOR_ITER next(): inline item fetch for exact list/tuple/range
+        // iterators with PyIter_Next as fallback; new reference or NULL
+        llvm::Value *emit_for_iter_next(llvm::IRBuilder<> &builder, llvm::Value *iterator);
+
+        // LOAD_DEREF: PyCell_Get(cell). When the slot always holds
+        // `known_cell` (a closure cell this code never rebinds), its contents
+        // at compile time become a constant guarded by one pointer compare
+        llvm::Value *emit_cell_get(llvm::IRBuilder<> &builder, llvm::Value *cell, PyObject *known_cell);
+
+        // UNPACK_SEQUENCE: reads exact tuples/lists of exactly `count` items
+        // straight from ob_item, iterating anything else. Fills `items` with
+        // new references (first item first) and returns `sequence`, or NULL
+        // with the interpreter's error (items are then NULL); borrows sequence
+        llvm::Value *emit_unpack_sequence(llvm::IRBuilder<> &builder, llvm::Value *sequence, int count,
+                                          std::vector<llvm::Value *> &items);
+
+        // Subscript fast paths. emit_sequence_index applies negative-index
+        // wrap-around and bounds-checks against Py_SIZE(seq). The get/set
+        // emitters inline list/tuple/bytearray[int] and exact dict access,
+        // calling PyObject_GetItem/SetItem otherwise; key may be unboxed i64.
+        llvm::Value *emit_sequence_index(llvm::IRBuilder<> &builder, llvm::Value *seq, llvm::Value *index,
+                                         llvm::BasicBlock *hit_block, llvm::BasicBlock *miss_block);
+        llvm::Value *emit_subscr_get(llvm::IRBuilder<> &builder, llvm::Value *container, llvm::Value *key,
+                                     uint16_t container_seen = TYPE_KIND_ANY);
+        llvm::Value *emit_subscr_set(llvm::IRBuilder<> &builder, llvm::Value *container, llvm::Value *key, llvm::Value *value);
+
+        // Rich comparison with PyObject_RichCompareBool's result contract
+        // (1/0/-1); compact ints and exact floats are compared inline
+        llvm::Value *emit_compare_bool(llvm::IRBuilder<> &builder, int op_code, llvm::Value *lhs, llvm::Value *rhs,
+                                       uint16_t seen = TYPE_KIND_ANY);
+
+        // LOAD_GLOBAL inline cache: emits epoch compare + load with a slow-path
+        // call, returning the borrowed object (NULL with NameError set). With
+        // `attr` it loads `name.attr` instead, returning a new reference: a
+        // module attribute is cached under the same epoch
+        // (jit_load_global_attr_slow)
+        llvm::Value *emit_cached_global_load(llvm::IRBuilder<> &builder, llvm::Function *func, PyObject *name,
+                                             PyObject *attr = nullptr);
+
+        // IMPORT_NAME through a per-site ImportCache: emits an epoch compare
+        // and a call of jit_import_name on a miss. Borrows `fromlist`;
+        // returns a new reference, or NULL with the import error set
+        llvm::Value *emit_import_name(llvm::IRBuilder<> &builder, llvm::Function *func, PyObject *name,
+                                      llvm::Value *fromlist, llvm::Value *level);
+
+        // Tag a typed-mode module with its object cache key; true on a cache hit
+        bool use_cached_object(llvm::Module &module);
+
+        // Add a finished module to this core's JITDylib in the shared engine,
+        // tracked under `owner` (default: the name being compiled)
+        llvm::Error add_module(llvm::orc::ThreadSafeModule tsm, const std::string &owner = std::string());
     };
 
 }
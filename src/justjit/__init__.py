@@ -1,7 +1,16 @@
 import os
 import sys
+import array
+import struct
+import collections
 import dis
+import inspect
+import math
 import types
+import ctypes
+import sysconfig
+import threading
+import weakref
 
 # Add DLL directories on Windows before importing the extension
 if sys.platform == "win32":
@@ -37,7 +46,7 @@ if sys.platform == "win32":
                 pass
 
 # Now import the C++ extension module
-from ._core import JIT, create_jit_generator, create_jit_coroutine
+from ._core import JIT, DeoptError, bind_arguments, create_jit_generator, create_jit_coroutine, create_generator_factory, create_dispatcher, set_cache_dir, get_cache_dir, stats, clear_stats, set_perf_mode, get_perf_mode, set_gdb_support, get_gdb_support, set_pc_tables, get_pc_tables, pc_table, lookup_pc, set_code_memory, get_code_memory, code_memory_stats, memory_info, _start_pc_sampling, _stop_pc_sampling, set_trace, get_trace, _drain_trace, set_latency_histograms, get_latency_histograms, _read_latency_histograms, host_supports_cpu, run_pipeline, step_coroutines, TypedList, TypedDict, ArrowColumn, foreign_array as _foreign_array, bfloat16_view, pooled_buffer as _pooled_buffer, buffer_pool_stats, cuda_status as _cuda_status, to_device
 
 # InlineCCompiler is only available if Clang support was compiled in
 try:
@@ -47,13 +56,17 @@ except ImportError:
     _HAS_CLANG = False
     InlineCCompiler = None
 
+from . import typed
+
 __version__ = "0.1.5"
-__all__ = ["JIT", "jit", "dump_ir", "create_jit_generator", "create_jit_coroutine", "InlineCCompiler", "inline_c", "dump_c_ir"]
+__all__ = ["JIT", "jit", "dump_ir", "dump_asm", "opt_remarks", "create_jit_generator", "create_jit_coroutine", "InlineCCompiler", "inline_c", "dump_c_ir", "remove_c_unit", "counters", "set_cache_dir", "get_cache_dir", "stats", "clear_stats", "set_perf_mode", "get_perf_mode", "set_gdb_support", "get_gdb_support", "set_pc_tables", "get_pc_tables", "pc_table", "lookup_pc", "set_code_memory", "get_code_memory", "code_memory_stats", "memory_info", "profile", "Profile", "set_trace", "get_trace", "trace_events", "trace_summary", "set_latency_histograms", "get_latency_histograms", "latency_histograms", "DeoptError", "prange", "local_array", "rotl", "rotr", "compile_all", "jit_module", "auto_jit", "auto_jit_disable", "aot", "load_aot", "select_target", "host_supports_cpu", "save_profile", "warmup", "zeros_like", "empty_like", "bfloat16_view", "buffer_pool_stats", "cuda_available", "to_device", "jitclass", "RecordArray", "ArrowColumn", "typed", "fuse", "pipeline", "gather"]
 
 # Python code flags
 _CO_GENERATOR = 0x20
 _CO_COROUTINE = 0x80
 _CO_ASYNC_GENERATOR = 0x200
+_CO_VARARGS = 0x04
+_CO_VARKEYWORDS = 0x08
 
 # Generator/coroutine opcodes that we cannot JIT compile
 # Note: These are opcodes we HAVE now implemented support for (used to detect generator mode)
@@ -90,19 +103,1091 @@ def _is_generator_or_coroutine(func):
     return bool(flags & (_CO_GENERATOR | _CO_COROUTINE | _CO_ASYNC_GENERATOR))
 
 
-def _has_unsupported_opcodes(func):
-    """Check if function contains opcodes we cannot JIT compile."""
-    for instr in dis.get_instructions(func):
-        if instr.opname in _GENERATOR_OPCODES:
-            return "generator"
-        if instr.opname in _EXCEPTION_OPCODES:
-            return "exception"
-        if instr.opname in _PATTERN_MATCHING_OPCODES:
-            return "pattern_matching"
-        # All CALL_INTRINSIC_1 args are now supported (1-11)
+# One decoded instruction; argval is only resolved for constants and globals
+_Instr = collections.namedtuple("_Instr", "opname opcode arg argval offset")
+
+_CONST_OPCODES = (dis.opmap["LOAD_CONST"], dis.opmap["RETURN_CONST"])
+_LOAD_GLOBAL = dis.opmap["LOAD_GLOBAL"]
+
+
+def _instructions(func):
+    """The instructions of ``func`` from the native decoder: a cheap subset of dis.get_instructions."""
+    code = func.__code__
+    instrs = []
+    for opcode, arg, offset in JIT.decode_bytecode(code):
+        argval = None
+        if opcode in _CONST_OPCODES:
+            argval = code.co_consts[arg]
+        elif opcode == _LOAD_GLOBAL:
+            argval = code.co_names[arg >> 1]
+        instrs.append(_Instr(dis.opname[opcode], opcode, arg, argval, offset))
+    return instrs
+
+
+def _bytecode_size(code):
+    """The instruction count of ``code`` that max_bytecode_size= budgets (jit() and auto_jit())."""
+    return len(JIT.decode_bytecode(code))
+
+
+def _has_unsupported_opcodes(instrs):
+    """Check if the decoded instructions contain opcodes we cannot JIT compile."""
+    opnames = {instr.opname for instr in instrs}
+    if opnames & _GENERATOR_OPCODES:
+        return "generator"
+    if opnames & _EXCEPTION_OPCODES:
+        return "exception"
+    if opnames & _PATTERN_MATCHING_OPCODES:
+        return "pattern_matching"
+    # All CALL_INTRINSIC_1 args are now supported (1-11)
+    return None
+
+
+# Modes JIT.get_native_function has a vectorcall entry for
+_NATIVE_ENTRY_MODES = ("object", "int", "uint64", "float", "bool")
+
+# Modes with a native (non-object) entry point; anything else compiles in object mode
+_TYPED_MODES = ("int", "uint64", "float", "bool", "int32", "float32", "complex128", "ptr", "vec4f", "vec8i",
+                "complex64", "optional_f64")
+
+# Vector modes are 'vec<lanes><kind>' (vec4f, vec8i, vec2d, ...) for these
+# element kinds, or 'vec<kind>' for the target's native width
+_VEC_KINDS = "fdiq"
+_VEC_LANES = ("2", "4", "8", "16")
+
+
+def _vec_mode(mode):
+    """(lanes, kind) of a vector mode name, lanes None for the native width; None otherwise."""
+    if not isinstance(mode, str) or len(mode) < 4 or not mode.startswith("vec") or mode[-1] not in _VEC_KINDS:
+        return None
+    lanes = mode[3:-1]
+    if lanes == "":
+        return None, mode[-1]
+    return (int(lanes), mode[-1]) if lanes in _VEC_LANES else None
+
+
+def _fastmath_flags(fastmath):
+    """LLVM fast-math flag names for a jit(fastmath=...) value.
+
+    True means every flag ('fast'), False/None none; a string is a comma or
+    space separated list ('contract,reassoc'), any other value an iterable of
+    names.
+    """
+    if fastmath is True:
+        return ["fast"]
+    if not fastmath:
+        return []
+    if isinstance(fastmath, str):
+        return fastmath.replace(",", " ").split()
+    return [str(flag) for flag in fastmath]
+
+
+def _math_global(func, name):
+    """'math' if global ``name`` of ``func`` is the math module, 'math.<fn>' if
+    it is one of its functions, else None."""
+    value = func.__globals__.get(name)
+    if value is math:
+        return "math"
+    if isinstance(value, types.BuiltinFunctionType) and getattr(value, "__module__", None) == "math":
+        return f"math.{value.__name__}"
+    return None
+
+
+def _inline_c_global(func, name):
+    """'c:<address>' if global ``name`` of ``func`` is a function compiled by
+    inline_c, else None."""
+    value = func.__globals__.get(name)
+    value_type = type(value)
+    if value_type.__name__ == "JITCallable" and value_type.__module__ == "justjit":
+        return f"c:{value.address}"
+    return None
+
+
+def _math_names(func, names):
+    """``names`` with math globals spelled as ``_math_global`` does, and
+    inline_c functions as ``_inline_c_global`` does.
+
+    The typed modes lower math.sqrt(x) and ``from math import sqrt`` calls to
+    LLVM intrinsics or libm without seeing the globals dict; this is how they
+    learn which globals are math. The float modes call inline_c functions
+    with all-floating-point signatures directly.
+    """
+    return [_math_global(func, name) or _inline_c_global(func, name) or name for name in names]
+
+
+# Functions whose mode='auto' inference is running on this thread; a @jit
+# callee among them (mutual recursion) is not called natively
+_auto_inference = threading.local()
+
+
+def _is_self_global(func, name):
+    """True if global ``name`` of ``func`` is ``func``'s own @jit wrapper.
+
+    An undefined name equal to a module-level function's own name counts:
+    with lazy=False the wrapper is bound to it only once @jit returns.
+    """
+    if name not in func.__globals__:
+        return name == func.__name__ == func.__qualname__
+    value = func.__globals__[name]
+    if isinstance(value, _LazyJITWrapper):
+        return value._func is func
+    return type(value).__module__ == "justjit" and getattr(value, "_original_func", None) is func
+
+
+def _jit_callee_supports(func, name, mode):
+    """True if global ``name`` of ``func`` is a @jit function an int, uint64
+    or float function in ``mode`` can call natively: ``func`` itself, or one
+    compiled in ``mode`` or with mode='auto' that type-checks in it. Nothing
+    is compiled."""
+    if mode not in ("int", "uint64", "float"):
+        return False
+    if _is_self_global(func, name):
+        return True
+    value = func.__globals__.get(name)
+    if isinstance(value, _LazyJITWrapper):
+        callee, declared = value._func, value._jit_mode
+    elif type(value).__module__ == "justjit" and getattr(value, "_original_func", None) is not None:
+        if type(value).__name__ == "JITDispatcher":
+            return mode in value._auto_modes
+        return value._mode == mode
+    else:
+        return False
+    if declared != "auto":
+        return declared == mode
+    active = getattr(_auto_inference, "active", None)
+    if active is None:
+        active = _auto_inference.active = set()
+    if callee in active or _is_generator_or_coroutine(callee):
+        return False
+    active.add(callee)
+    try:
+        return mode in _infer_auto_modes(callee, _instructions(callee))
+    finally:
+        active.discard(callee)
+
+
+def _native_callee(value, mode):
+    """Native ``mode`` entry of the @jit function ``value``, compiled now if
+    it is still pending; None when there is none (or, to avoid waiting on a
+    build in progress here or on another thread, not yet)."""
+    if isinstance(value, _LazyJITWrapper):
+        value = value._try_materialize()
+    if type(value).__module__ != "justjit":
+        return None
+    if type(value).__name__ == "JITDispatcher":
+        return value._native_variant(mode)
+    if type(value).__name__ == "JITNativeFunction" and getattr(value, "_mode", None) == mode:
+        return value
+    return None
+
+
+def _jit_global(func, name, mode, keep):
+    """'jit:self' if global ``name`` of ``func`` is ``func``'s own @jit
+    wrapper, 'jit:<address>' if it is another @jit function with a native
+    ``mode`` entry, else None.
+
+    The int and float modes call these directly instead of through Python.
+    Other callees' entries are appended to ``keep``: the caller's code may
+    call theirs by address, so it must not outlive them.
+    """
+    if not _jit_callee_supports(func, name, mode):
+        return None
+    if _is_self_global(func, name):
+        return "jit:self"
+    entry = _native_callee(func.__globals__.get(name), mode)
+    if entry is None:
+        return None
+    keep.append(entry)
+    return f"jit:{entry.address}"
+
+
+def _object_callees(func, instrs, keep):
+    """{name: entry} for the globals ``func`` calls that hold another @jit
+    function's object-mode native entry.
+
+    Object code calls such an entry's symbol directly while the global
+    still holds it, and through vectorcall otherwise. The entries are
+    appended to ``keep`` as for ``_jit_global``.
+    """
+    callees = {}
+    for instr in instrs:
+        name = instr.argval
+        if instr.opname != "LOAD_GLOBAL" or name in callees or _is_self_global(func, name):
+            continue
+        entry = _native_callee(func.__globals__.get(name), "object")
+        if entry is not None:
+            keep.append(entry)
+            callees[name] = entry
+    return callees
+
+
+def _typed_names(func, names, mode, instrs, keep):
+    """``names`` for an int, uint64, int32 or float compile: LOAD_GLOBALs of @jit
+    callees spelled as ``_jit_global`` does, local_array as
+    ``_local_array_global`` does, rotl/rotr as ``_bits_global`` does, and in
+    float mode the math and inline_c spellings of ``_math_names``."""
+    loaded = {instr.argval for instr in instrs if instr.opname == "LOAD_GLOBAL"}
+    spelled = []
+    for name in names:
+        value = _jit_global(func, name, mode, keep) if name in loaded else None
+        if value is None and name in loaded:
+            value = _local_array_global(func, name) or _bits_global(func, name)
+        if value is None and mode == "float":
+            value = _math_global(func, name) or _inline_c_global(func, name)
+        spelled.append(value or name)
+    return spelled
+
+
+# mode='auto': BINARY_OP args each typed backend computes exactly like Python.
+# //, %, / and ** are left out where the native result (truncating division,
+# fmod) would differ from the interpreter's. Complex / is left out too: the
+# native lowering neither raises on a zero divisor nor scales the operands
+# the way CPython's division does.
+_AUTO_BINARY_OPS = {
+    "int": {0, 1, 5, 7, 10, 12, 13, 18, 23},
+    "float": {0, 5, 10, 11},
+    "complex128": {0, 5, 10},
+}
+
+# Opcodes every typed backend handles (straight-line code and returns)
+_AUTO_COMMON_OPCODES = {"RESUME", "NOP", "LOAD_FAST", "LOAD_FAST_LOAD_FAST", "STORE_FAST",
+                        "LOAD_CONST", "RETURN_CONST", "RETURN_VALUE"}
+
+# Returned by _select_auto_mode for each exact argument type
+_AUTO_MODE_FOR_TYPE = {int: "int", float: "float", bool: "bool", complex: "complex128"}
+
+# Typed callables take at most this many parameters (complex128 entries: 2)
+_AUTO_MAX_PARAMS = 16
+_AUTO_MAX_COMPLEX_PARAMS = 2
+
+
+def _auto_const_fits(mode, value):
+    """Check that a constant is representable in ``mode`` without changing its value."""
+    if mode == "int":
+        return type(value) is int and -(2**63) <= value < 2**63
+    if mode == "float":
+        return type(value) in (int, float)
+    if mode == "complex128":
+        return type(value) in (int, float, complex)
+    return type(value) is bool
+
+
+def prange(*args):
+    """``range`` that marks a loop of an int/float function as parallel.
+
+    With ``@jit(parallel=True)`` the iterations of ``for i in prange(...)``
+    are split across the native thread pool. Locals used as ``x += v``,
+    ``x -= v``, ``x *= v`` or ``if v > x: x = v`` (any order or direction)
+    are reductions, combined per chunk; any other local the loop writes must
+    be assigned before it is read in each iteration and not used after the
+    loop. Loops that do not fit run serially, as does everything without
+    ``parallel=True``.
+    """
+    return range(*args)
+
+
+_LOCAL_ARRAY_DTYPES = {None: 0, "i64": 0, "int64": 0, "q": 0, "f64": 0.0, "float64": 0.0, "d": 0.0}
+
+
+def local_array(size, dtype=None):
+    """Fixed-size scratch array for an int/float function: a list of ``size`` zeros.
+
+    ``buf = local_array(16)`` (or ``justjit.local_array(16, 'f64')``), with
+    a constant size and dtype, lowers to a stack array in int and float
+    mode, as do list displays of numeric constants (``[1, 2, 4, 8]``) and
+    ``[c] * n``. ``buf[i]`` and ``buf[i] = v`` index it natively; anything
+    else done with it fails the compile. ``dtype`` is 'i64' (int mode, the
+    default there) or 'f64' (float mode).
+    """
+    if dtype not in _LOCAL_ARRAY_DTYPES:
+        raise ValueError(f"local_array() dtype must be 'i64' or 'f64', not {dtype!r}")
+    return [_LOCAL_ARRAY_DTYPES[dtype]] * size
+
+
+def rotl(x, r, bits=64):
+    """``x`` rotated left by ``r`` as a ``bits``-bit unsigned integer (64 or 32).
+
+    Gives the low ``bits`` bits of ``x`` with the top ``r % bits`` moved to
+    the bottom, as a non-negative int. In int, uint64 and int32 mode, with
+    ``bits`` a constant, the call is one rotate instruction. An int-mode
+    result of 2**63 or more does not fit and reruns the call in the
+    interpreter; int32 code takes only bits=32 and reads the result as a
+    signed int32, like its other results.
+    """
+    mask = (1 << bits) - 1
+    r %= bits
+    x &= mask
+    return ((x << r) | (x >> (bits - r))) & mask
+
+
+def rotr(x, r, bits=64):
+    """``x`` rotated right by ``r`` as a ``bits``-bit unsigned integer; see rotl."""
+    return rotl(x, -r, bits)
+
+
+def _bits_global(func, name):
+    """'justjit.rotl' / 'justjit.rotr' if global ``name`` of ``func`` is rotl or rotr, else None."""
+    value = func.__globals__.get(name)
+    if value is rotl:
+        return "justjit.rotl"
+    if value is rotr:
+        return "justjit.rotr"
+    return None
+
+
+def _local_array_global(func, name):
+    """'justjit.local_array' if global ``name`` of ``func`` is local_array,
+    'justjit' if it is this module (for ``justjit.local_array(...)``), else None."""
+    value = func.__globals__.get(name)
+    if value is local_array:
+        return "justjit.local_array"
+    if value is sys.modules[__name__]:
+        return "justjit"
     return None
 
 
+# uint64 mode: what _uint64_range_problems knows about a stack or local value.
+# ("E", lo, hi) is an int Python computes in lo..hi (within 0..2**64-1),
+# so the native value is the same; ("C",) is an int only congruent to the
+# native value mod 2**64; ("K",) the constant 2**64 itself; ("W", lo, hi)
+# a product kept whole for the >> after it (lo None: not exact); ("S", exact,
+# local) a local array and whether its elements are exact; ("R", hi) a range
+# (or enumerate(range), "P") over 0..hi; ("M", name) a callable; ("O",) none
+# of these.
+_UINT64_MAX = 2**64 - 1
+_UINT64_ANY = ("E", 0, _UINT64_MAX)
+_UINT64_WRAPPED = ("C",)
+_UINT64_OTHER = ("O",)
+
+
+def _uint64_exact(lo, hi):
+    return ("E", lo, hi) if hi <= _UINT64_MAX else _UINT64_WRAPPED
+
+
+def _uint64_join(old, new, widen):
+    """The value at a join of ``old`` and ``new``; at a loop header
+    ``widen`` is the sorted bounds that grown bounds round out to (the
+    code's constants, 2**64 - 2 and 2**64 - 1), so loops settle."""
+    if old == new:
+        return old
+    if old[0] == "O":
+        return new
+    if new[0] == "O":
+        return old
+    if old[0] == new[0] == "E":
+        lo, hi = min(old[1], new[1]), max(old[2], new[2])
+        if widen:
+            lo = old[1] if lo == old[1] else max(t for t in widen if t <= lo)
+            hi = old[2] if hi == old[2] else min(t for t in widen if t >= hi)
+        return ("E", lo, hi)
+    if old[0] == new[0] == "S":
+        return ("S", old[1] and new[1], old[2] if old[2] == new[2] else None)
+    if old[0] in "ECK" and new[0] in "ECK":
+        return _UINT64_WRAPPED
+    return _UINT64_OTHER
+
+
+def _uint64_range_problems(func):
+    """Where a uint64-mode ``func`` uses a value Python may compute outside
+    0..2**64-1: a list of messages, empty when there is none.
+
+    Native uint64 code wraps every result mod 2**64, which is right for
+    +, -, *, <<, ~ and the rest exactly when the value is only ever used
+    congruently: masked with ``& (2**64 - 1)`` or ``% 2**64``, or fed to
+    more such operators. Returned, compared, tested, divided, shifted right,
+    indexed with or passed on, the wrapped value would differ from the one
+    the interpreter computes on fallback calls, so those uses need a value
+    whose range (tracked from the constants and operators) stays in bounds.
+    Opcodes the uint64 backend does not take end the walk: the compile
+    fails on them anyway.
+    """
+    instrs = list(dis.get_instructions(func))
+    if not instrs:
+        return []
+    index = {instr.offset: k for k, instr in enumerate(instrs)}
+    headers = {instr.argval for instr in instrs if instr.opname.startswith("JUMP_BACKWARD")}
+    code = func.__code__
+    thresholds = {0, _UINT64_MAX - 1, _UINT64_MAX}
+    for value in code.co_consts:
+        if type(value) is int and 0 < value <= _UINT64_MAX:
+            thresholds |= {value - 1, value}
+    thresholds = sorted(thresholds)
+    problems = []
+
+    def problem(instr, what):
+        line = instr.positions.lineno if instr.positions else None
+        message = f"line {line}: {what}" if line is not None else what
+        if message not in problems:
+            problems.append(message)
+
+    def need(instr, value, what):
+        if value[0] != "E":
+            problem(instr, f"{what} may be outside 0..2**64-1")
+
+    def global_value(name):
+        if _jit_callee_supports(func, name, "uint64"):
+            return ("M", "callee")
+        spelled = _local_array_global(func, name) or _bits_global(func, name)
+        if spelled:
+            return ("M", spelled)
+        if name in ("range", "enumerate") and name not in func.__globals__:
+            return ("M", name)
+        return _UINT64_WRAPPED
+
+    def constant(value):
+        if type(value) in (int, bool):
+            if 0 <= value <= _UINT64_MAX:
+                return ("E", int(value), int(value))
+            return ("K",) if value == 2**64 else _UINT64_WRAPPED
+        if type(value) is tuple:
+            return ("S", all(type(v) in (int, bool) and 0 <= v <= _UINT64_MAX for v in value), None)
+        return _UINT64_OTHER
+
+    def binary(k, op, a, b):
+        instr = instrs[k]
+        base = op - 13 if op >= 13 else op
+        if base == 6 and b[0] == "K" and a[0] in "ECK":
+            return a if a[0] == "E" else _UINT64_ANY  # % 2**64
+        if a[0] == "S" and base == 5:
+            return a  # [c] * n
+        a = _UINT64_WRAPPED if a[0] == "K" else a
+        b = _UINT64_WRAPPED if b[0] == "K" else b
+        if a[0] not in "ECW" or b[0] not in "EC":
+            problem(instr, f"{instr.argrepr} on a value that is not an int")
+            return _UINT64_WRAPPED
+        both = a[0] == b[0] == "E"
+        if base == 0:
+            return _uint64_exact(a[1] + b[1], a[2] + b[2]) if both else _UINT64_WRAPPED
+        if base == 10:
+            return ("E", a[1] - b[2], a[2] - b[1]) if both and a[1] >= b[2] else _UINT64_WRAPPED
+        if base == 5:
+            following = instrs[k + 1:k + 3]
+            if (len(following) == 2 and following[0].opname in ("LOAD_CONST", "LOAD_FAST")
+                    and following[1].opname == "BINARY_OP" and following[1].arg == 9):
+                return ("W", a[1] * b[1], a[2] * b[2]) if both else ("W", None, None)
+            return _uint64_exact(a[1] * b[1], a[2] * b[2]) if both else _UINT64_WRAPPED
+        if base == 1:
+            bounds = [v[2] for v in (a, b) if v[0] == "E"]
+            return ("E", 0, min(bounds)) if bounds else _UINT64_WRAPPED
+        if base in (7, 12):
+            if not both:
+                return _UINT64_WRAPPED
+            hi = (1 << max(a[2], b[2]).bit_length()) - 1
+            return ("E", max(a[1], b[1]) if base == 7 else 0, hi)
+        if base == 3:
+            need(instr, b, "a shift count")
+            if a[0] != "E" or b[0] != "E":
+                return _UINT64_WRAPPED
+            if a[2] == 0:
+                return ("E", 0, 0)
+            return _uint64_exact(a[1] << b[1], a[2] << b[2]) if b[2] < 64 else _UINT64_WRAPPED
+        if base == 9:
+            need(instr, b, "a shift count")
+            if a[0] == "W" and a[1] is not None or a[0] == "E":
+                return ("E", a[1] >> min(b[2], 128), min(a[2] >> b[1], _UINT64_MAX)) if b[0] == "E" else _UINT64_ANY
+            problem(instr, "a value shifted right may be outside 0..2**64-1")
+            return _UINT64_ANY
+        if base == 2:
+            need(instr, a, "a divided value")
+            need(instr, b, "a divisor")
+            return ("E", 0, a[2] // max(b[1], 1)) if both else _UINT64_ANY
+        if base == 6:
+            if b[0] == "E" and b[1] == b[2] and b[1] & (b[1] - 1) == 0 and b[1]:
+                return ("E", 0, b[1] - 1)  # % 2**k keeps the congruent bits
+            need(instr, a, "a divided value")
+            need(instr, b, "a divisor")
+            return ("E", 0, min(a[2], max(b[2] - 1, 0))) if both else _UINT64_ANY
+        if base == 8:
+            need(instr, b, "an exponent")
+            if a[0] != "E" or b[0] != "E":
+                return _UINT64_WRAPPED
+            if a[2] <= 1:
+                return ("E", 0, 1) if a[1] == 0 else ("E", 1, 1)
+            return _uint64_exact(a[1] ** b[1], a[2] ** b[2]) if b[2] < 64 else _UINT64_WRAPPED
+        problem(instr, f"{instr.argrepr} gives a float" if base == 11 else f"{instr.argrepr} is not supported")
+        return _UINT64_WRAPPED
+
+    def call(instr, callee, receiver, args):
+        kind = callee[1] if callee[0] == "M" else None
+        if kind in ("range", "enumerate"):
+            if kind == "enumerate":
+                return ("P", args[0][1]) if len(args) == 1 and args[0][0] == "R" else _UINT64_OTHER
+            for arg in args:
+                need(instr, arg, "a range() bound")
+            return ("R", max((arg[2] for arg in args if arg[0] == "E"), default=_UINT64_MAX))
+        if kind == "justjit.local_array":
+            return ("S", True, None)
+        if kind in ("justjit.rotl", "justjit.rotr"):
+            if len(args) == 3:
+                need(instr, args[2], "a rotate width")
+                if args[2][0] == "E" and args[2][2] == 32:
+                    return ("E", 0, 2**32 - 1)
+            return _UINT64_ANY
+        if kind in ("bit_count", "bit_length"):
+            need(instr, receiver, f"the {kind}() operand")
+            return ("E", 0, 64)
+        if kind == "callee":
+            for arg in args:
+                need(instr, arg, "an argument")
+            return _UINT64_ANY
+        return _UINT64_WRAPPED
+
+    def narrowed(local, k, taken):
+        """``local`` where the comparison at ``k`` (of locals, or a local and
+        a constant) came out ``taken``; None when it cannot."""
+        if k < 1 or instrs[k].opname != "COMPARE_OP":
+            return local
+        first, second = instrs[k - 2] if k >= 2 else None, instrs[k - 1]
+        if second.opname == "LOAD_FAST_LOAD_FAST":
+            slots = [second.arg >> 4, second.arg & 15]
+        elif first is not None and first.opname == "LOAD_FAST" and second.opname in ("LOAD_FAST", "LOAD_CONST"):
+            slots = [first.arg, second.arg if second.opname == "LOAD_FAST" else None]
+        else:
+            return local
+        x = local[slots[0]]
+        y = local[slots[1]] if slots[1] is not None else constant(second.argval)
+        if x[0] != "E" or y[0] != "E":
+            return local
+        op = dis.cmp_op[instrs[k].arg >> 5]
+        if not taken:
+            op = {"<": ">=", "<=": ">", ">": "<=", ">=": "<"}.get(op)
+        bounds = {"<": ((x[1], y[2] - 1), (x[1] + 1, y[2])), "<=": ((x[1], y[2]), (x[1], y[2])),
+                  ">": ((y[1] + 1, x[2]), (y[1], x[2] - 1)), ">=": ((y[1], x[2]), (y[1], x[2]))}.get(op)
+        if bounds is None:
+            return local
+        local = list(local)
+        for slot, value, (lo, hi) in zip(slots, (x, y), bounds):
+            lo, hi = max(lo, value[1]), min(hi, value[2])
+            if lo > hi:
+                return None
+            if slot is not None:
+                local[slot] = ("E", lo, hi)
+        return local
+
+    start = ([], [_UINT64_ANY] * code.co_argcount + [_UINT64_OTHER] * (code.co_nlocals - code.co_argcount))
+    states = {0: start}
+    pending = [0]
+    while pending:
+        k = pending.pop()
+        stack, local = states[k]
+        stack, local = list(stack), list(local)
+        instr = instrs[k]
+        name, arg = instr.opname, instr.arg
+        successors = [k + 1]
+
+        def pop(n=1):
+            values = stack[len(stack) - n:] if n else []
+            del stack[len(stack) - n:]
+            return values
+
+        if name in ("RESUME", "NOP", "CACHE", "EXTENDED_ARG"):
+            pass
+        elif name in ("LOAD_FAST", "LOAD_FAST_CHECK"):
+            stack.append(local[arg])
+        elif name == "LOAD_FAST_LOAD_FAST":
+            stack += [local[arg >> 4], local[arg & 15]]
+        elif name == "STORE_FAST":
+            value = stack.pop()
+            local[arg] = ("S", value[1], arg) if value[0] == "S" else value
+        elif name == "STORE_FAST_STORE_FAST":
+            for slot in (arg >> 4, arg & 15):
+                value = stack.pop()
+                local[slot] = ("S", value[1], slot) if value[0] == "S" else value
+        elif name == "LOAD_CONST":
+            stack.append(constant(instr.argval))
+        elif name == "LOAD_GLOBAL":
+            stack.append(global_value(instr.argval))
+            if arg & 1:
+                stack.append(_UINT64_OTHER)
+        elif name == "PUSH_NULL":
+            stack.append(_UINT64_OTHER)
+        elif name == "LOAD_ATTR":
+            owner = stack.pop()
+            attr = instr.argval
+            if owner == ("M", "justjit") and attr in ("rotl", "rotr", "local_array"):
+                stack.append(("M", "justjit." + attr))
+                if arg & 1:
+                    stack.append(_UINT64_OTHER)
+            elif arg & 1 and attr in ("bit_count", "bit_length"):
+                stack += [("M", attr), owner]
+            else:
+                stack.append(_UINT64_WRAPPED)
+                if arg & 1:
+                    stack.append(_UINT64_OTHER)
+        elif name == "CALL":
+            args = pop(arg)
+            callee, receiver = pop(2)
+            stack.append(call(instr, callee, receiver, args))
+        elif name == "BINARY_OP":
+            b, = pop()
+            a, = pop()
+            stack.append(binary(k, arg, a, b))
+        elif name == "UNARY_NEGATIVE":
+            value = stack.pop()
+            stack.append(value if value == ("E", 0, 0) else _UINT64_WRAPPED)
+        elif name == "UNARY_INVERT":
+            stack.pop()
+            stack.append(_UINT64_WRAPPED)
+        elif name == "COMPARE_OP":
+            for value in pop(2):
+                need(instr, value, "a compared value")
+            stack.append(("E", 0, 1))
+        elif name == "TO_BOOL":
+            need(instr, stack.pop(), "a tested value")
+            stack.append(("E", 0, 1))
+        elif name in ("POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE"):
+            need(instr, stack.pop(), "a tested value")
+            jumps = name == "POP_JUMP_IF_TRUE"
+            successors = [(j, (stack, narrowed(local, k - 1, taken)))
+                          for j, taken in ((k + 1, not jumps), (index[instr.argval], jumps))]
+        elif name in ("JUMP_FORWARD", "JUMP_BACKWARD", "JUMP_BACKWARD_NO_INTERRUPT"):
+            successors = [index[instr.argval]]
+        elif name == "RETURN_VALUE":
+            need(instr, stack.pop(), "the returned value")
+            successors = []
+        elif name == "RETURN_CONST":
+            need(instr, constant(instr.argval), "the returned value")
+            successors = []
+        elif name == "BUILD_LIST":
+            items = pop(arg)
+            stack.append(("S", all(item[0] == "E" for item in items), None))
+        elif name == "LIST_EXTEND":
+            items = stack.pop()
+            array = stack.pop()
+            stack.append(("S", array[0] == items[0] == "S" and array[1] and items[1], None))
+        elif name == "BINARY_SUBSCR":
+            key, array = stack.pop(), stack.pop()
+            need(instr, key, "an index")
+            stack.append(_UINT64_ANY if array[0] == "S" and array[1] else _UINT64_WRAPPED)
+        elif name == "STORE_SUBSCR":
+            key, array, value = pop(3)[::-1]
+            need(instr, key, "an index")
+            if array[0] == "S" and array[2] is not None and value[0] != "E":
+                local[array[2]] = ("S", False, array[2])
+        elif name == "GET_ITER":
+            value = stack.pop()
+            stack.append(value if value[0] in "RP" else _UINT64_OTHER)
+        elif name == "FOR_ITER":
+            iterator = stack[-1]
+            exhausted = (list(stack) + [_UINT64_OTHER], list(local))
+            target = index[instr.argval]
+            if iterator[0] == "P":
+                stack.append(("P", iterator[1]))
+            else:
+                stack.append(("E", 0, iterator[1]) if iterator[0] == "R" else _UINT64_WRAPPED)
+            successors = [k + 1, (target, exhausted)]
+        elif name == "UNPACK_SEQUENCE":
+            value = stack.pop()
+            item = ("E", 0, value[1]) if value[0] == "P" else _UINT64_WRAPPED
+            stack += [item] * arg
+        elif name in ("END_FOR", "POP_TOP"):
+            stack.pop()
+        elif name == "COPY":
+            stack.append(stack[-arg])
+        elif name == "SWAP":
+            stack[-1], stack[-arg] = stack[-arg], stack[-1]
+        else:
+            return problems  # The compile rejects it
+
+        for successor in successors:
+            state = (stack, local)
+            if isinstance(successor, tuple):
+                successor, state = successor
+            if successor >= len(instrs) or state[1] is None:
+                continue
+            old = states.get(successor)
+            if old is None:
+                states[successor] = (list(state[0]), list(state[1]))
+                pending.append(successor)
+                continue
+            if len(old[0]) != len(state[0]):
+                return problems  # Not code the uint64 backend generates
+            widen = thresholds if instrs[successor].offset in headers else None
+            joined = ([_uint64_join(a, b, widen) for a, b in zip(old[0], state[0])],
+                      [_uint64_join(a, b, widen) for a, b in zip(old[1], state[1])])
+            if joined != old:
+                states[successor] = joined
+                pending.append(successor)
+    return problems
+
+
+def _array_view(value):
+    """memoryview of a buffer, or of an __array_interface__ / DLPack array's memory.
+
+    Raises TypeError for anything else, including device (CUDA) arrays.
+    """
+    try:
+        return memoryview(value)
+    except TypeError:
+        foreign = _foreign_array(value)
+        if foreign is None:
+            raise
+    return memoryview(foreign)
+
+
+def zeros_like(a, dtype=None):
+    """Zero-filled C-contiguous array with the shape and element format of ``a``.
+
+    ``a`` is any buffer-protocol array (NumPy array, ``array.array``,
+    ``memoryview``); ``dtype`` is a struct format character ('d', 'f', 'q',
+    'i', ...) that replaces its element format. A NumPy array gives a NumPy
+    array, an ``array.array`` (or a list or tuple of floats or ints) an
+    ``array.array``, anything else a writable ``memoryview`` of the same
+    shape. ndarray-mode kernels write their
+    results into such outputs (see the ``out`` parameter convention there).
+
+    NumPy arrays and memoryviews are backed by the JIT's pool of 64-byte
+    aligned buffers: once the result is released, its memory serves the
+    next allocation of that size class.
+    """
+    return _alloc_like(a, dtype, "zeros_like")
+
+
+def empty_like(a, dtype=None):
+    """Like ``zeros_like``, but the memory is left uninitialized (except for ``array.array``)."""
+    return _alloc_like(a, dtype, "empty_like")
+
+
+def _alloc_like(a, dtype, numpy_factory):
+    zero = numpy_factory == "zeros_like"
+    numpy = sys.modules.get("numpy")
+    if numpy is not None and isinstance(a, numpy.ndarray):
+        dt = numpy.dtype(dtype) if dtype is not None else a.dtype
+        if dt.hasobject:
+            return getattr(numpy, numpy_factory)(a, dtype=dtype)
+        memory = _pooled_buffer("B", 1, (a.size * dt.itemsize,), zero)
+        return numpy.frombuffer(memory, dtype=dt).reshape(a.shape)
+    if type(a) in (list, tuple):
+        fmt = dtype or _sequence_item_format(a)
+        if fmt is None:
+            raise TypeError(f"{numpy_factory}() needs a list of floats or ints, or a dtype")
+        return array.array(fmt, bytes(len(a) * struct.calcsize(fmt)))
+    with _array_view(a) as view:
+        fmt = dtype or _item_format(view)
+        shape = view.shape
+    if isinstance(a, array.array):
+        count = 1
+        for extent in shape:
+            count *= extent
+        return array.array(fmt, bytes(count * struct.calcsize(fmt)))
+    # 'E' (bfloat16, see bfloat16_view) is no struct format
+    itemsize = 2 if fmt == "E" else struct.calcsize(fmt)
+    return memoryview(_pooled_buffer(fmt, itemsize, shape, zero))
+
+
+# jitclass field annotation -> struct format of the field
+_JITCLASS_FIELDS = {
+    float: "d", int: "q", bool: "?",
+    "float": "d", "float64": "d", "f64": "d", "float32": "f", "f32": "f",
+    "int": "q", "int64": "q", "i64": "q", "int32": "i", "i32": "i", "bool": "?",
+}
+_JITCLASS_CTYPES = {"d": ctypes.c_double, "f": ctypes.c_float, "q": ctypes.c_int64, "i": ctypes.c_int32,
+                    "?": ctypes.c_bool}
+
+
+def jitclass(cls=None, **options):
+    """Class decorator: instances hold their annotated fields as one C struct.
+
+    ``x: float`` (or int, bool, 'float32', 'int32') declares a field; a
+    class attribute of the same name is its default. The class becomes a
+    ``ctypes.Structure`` with those fields, so ``p.x`` from Python reads the
+    struct, and an ndarray-mode kernel taking the instance compiles ``p.x``
+    and ``p.x = v`` to a load and a store at the field's offset. The other
+    methods are wrapped with ``jit(mode='ndarray', **options)``: a method
+    whose body the kernel builder lowers runs natively, any other stays
+    Python.
+    """
+    import warnings
+
+    if cls is None:
+        return lambda c: jitclass(c, **options)
+    if cls.__bases__ != (object,):
+        raise TypeError(f"jitclass {cls.__name__} cannot have base classes")
+    fields = []
+    for name, annotation in cls.__dict__.get("__annotations__", {}).items():
+        fmt = _JITCLASS_FIELDS.get(annotation)
+        if fmt is None:
+            raise TypeError(f"jitclass field {cls.__name__}.{name} has unsupported type {annotation!r}")
+        fields.append((name, fmt))
+    if not fields:
+        raise TypeError(f"jitclass {cls.__name__} declares no fields")
+
+    namespace = {k: v for k, v in cls.__dict__.items() if k not in ("__dict__", "__weakref__")}
+    defaults = {name: namespace.pop(name) for name, _ in fields if name in namespace}
+    namespace["_fields_"] = [(name, _JITCLASS_CTYPES[fmt]) for name, fmt in fields]
+    # ndarray-mode signature token of an instance (see JIT.compile_ndarray)
+    namespace["_jit_record"] = "{" + ",".join(f"{name}:{fmt}" for name, fmt in fields) + "}"
+    namespace["_jit_fields"] = tuple(fields)
+    if defaults and "__init__" not in namespace:
+        order = [name for name, _ in fields]
+
+        def __init__(self, *args, **kwargs):
+            given = set(order[:len(args)]) | kwargs.keys()
+            ctypes.Structure.__init__(self, *args, **{k: v for k, v in defaults.items() if k not in given}, **kwargs)
+
+        namespace["__init__"] = __init__
+    with warnings.catch_warnings():
+        # A method the ndarray mode cannot take simply stays interpreted
+        warnings.simplefilter("ignore", RuntimeWarning)
+        for key, value in list(namespace.items()):
+            if isinstance(value, types.FunctionType) and not key.startswith("__"):
+                namespace[key] = jit(mode="ndarray", lazy=False, **options)(value)
+    record = type(ctypes.Structure)(cls.__name__, (ctypes.Structure,), namespace)
+    record.__qualname__ = cls.__qualname__
+    return record
+
+
+# array.array type code of a RecordArray column: bools are one byte each
+_COLUMN_CODES = {"d": "d", "f": "f", "q": "q", "i": "i", "?": "B"}
+
+
+class RecordArray:
+    """Struct-of-arrays collection of jitclass records.
+
+    ``RecordArray[Tick](n)`` holds ``n`` zeroed records, ``RecordArray[Tick](ticks)``
+    copies an iterable of them; each field lives in its own contiguous
+    ``array.array`` (``column(name)``). In an ndarray-mode kernel,
+    ``arr[i].price`` and ``arr[i].price = v`` index the field's column, unit
+    stride, so loops over the records vectorize; ``arr.size`` is the
+    length. From Python, ``arr[i]`` is a copy of the record and
+    ``arr[i] = rec`` writes one back.
+    """
+
+    _record = None
+    _jit_record = None
+    _specialized = {}
+
+    def __class_getitem__(cls, record):
+        fields = getattr(record, "_jit_fields", None)
+        if fields is None:
+            raise TypeError(f"RecordArray[...] takes a jitclass, not {record!r}")
+        specialized = cls._specialized.get(record)
+        if specialized is None:
+            specialized = type(f"RecordArray[{record.__name__}]", (cls,), {
+                "_record": record,
+                "_jit_record": "[" + ",".join(f"{name}:{fmt}" for name, fmt in fields) + "]",
+                "__slots__": (),
+            })
+            cls._specialized[record] = specialized
+        return specialized
+
+    __slots__ = ("_columns", "_names")
+
+    def __init__(self, records=0):
+        if self._record is None:
+            raise TypeError("use RecordArray[<jitclass>](...) to create a record array")
+        fields = self._record._jit_fields
+        self._names = {name: k for k, (name, _) in enumerate(fields)}
+        if isinstance(records, int):
+            self._columns = tuple(array.array(_COLUMN_CODES[fmt], bytes(records * struct.calcsize(_COLUMN_CODES[fmt])))
+                                  for _, fmt in fields)
+        else:
+            self._columns = tuple(array.array(_COLUMN_CODES[fmt]) for _, fmt in fields)
+            self.extend(records)
+
+    def __len__(self):
+        return len(self._columns[0])
+
+    @property
+    def size(self):
+        return len(self._columns[0])
+
+    def column(self, name):
+        """The ``array.array`` holding field ``name`` of every record."""
+        return self._columns[self._names[name]]
+
+    def _make(self, values):
+        # Bypasses a user __init__ whose signature is not the fields'
+        record = self._record.__new__(self._record)
+        for (name, fmt), value in zip(self._record._jit_fields, values):
+            setattr(record, name, bool(value) if fmt == "?" else value)
+        return record
+
+    def __getitem__(self, index):
+        return self._make(column[index] for column in self._columns)
+
+    def __setitem__(self, index, record):
+        for column, (name, _) in zip(self._columns, self._record._jit_fields):
+            column[index] = getattr(record, name)
+
+    def __iter__(self):
+        for values in zip(*self._columns):
+            yield self._make(values)
+
+    def append(self, record):
+        for column, (name, _) in zip(self._columns, self._record._jit_fields):
+            column.append(getattr(record, name))
+
+    def extend(self, records):
+        for record in records:
+            self.append(record)
+
+    def __repr__(self):
+        return f"<{type(self).__name__} of {len(self)}>"
+
+
+def _is_native_range_global(func, name):
+    """True if LOAD_GLOBAL ``name`` in ``func`` is the builtin range or
+    enumerate, or justjit.prange."""
+    if name in ("range", "enumerate"):
+        return name not in func.__globals__
+    return name == "prange" and func.__globals__.get("prange") is prange
+
+
+def _is_prange_load(func, instrs, idx):
+    """True if instrs[idx] loads justjit.prange for a call: the global
+    ``prange``, or ``justjit.prange`` (LOAD_GLOBAL then LOAD_ATTR) through
+    whatever global name the module is bound to."""
+    instr = instrs[idx]
+    if instr.opname != "LOAD_GLOBAL":
+        return False
+    if instr.argval == "prange":
+        return func.__globals__.get("prange") is prange
+    return (idx + 1 < len(instrs) and instrs[idx + 1].opname == "LOAD_ATTR"
+            and instrs[idx + 1].argval == "prange"
+            and func.__globals__.get(instr.argval) is sys.modules[__name__])
+
+
+def _prange_loop_offsets(func, instrs):
+    """FOR_ITER offsets of the ``for ... in prange(...)`` loops of ``func``."""
+    offsets = []
+    for idx, instr in enumerate(instrs):
+        if instr.opname != "FOR_ITER" or idx < 3:
+            continue
+        call, get_iter = instrs[idx - 2], instrs[idx - 1]
+        if get_iter.opname != "GET_ITER" or call.opname != "CALL":
+            continue
+        # prange(...) or justjit.prange(...)
+        for load in (idx - 3 - call.arg, idx - 4 - call.arg):
+            if load >= 0 and _is_prange_load(func, instrs, load):
+                offsets.append(instr.offset)
+                break
+    return offsets
+
+
+def _warn_serial_pranges(target, func, offsets):
+    """Warn about the prange loops at ``offsets`` the compile into ``target`` left serial."""
+    serial = set(offsets) - set(target.get_parallel_loops(func.__name__))
+    if serial:
+        import warnings
+
+        lines = sorted({
+            instr.positions.lineno for instr in dis.get_instructions(func)
+            if instr.offset in serial and instr.positions and instr.positions.lineno
+        })
+        warnings.warn(
+            f"justjit: prange loop(s) of {func.__qualname__} at line(s) {lines} run serially: "
+            "the loop body does not fit the parallel forms (see justjit.prange)",
+            RuntimeWarning,
+            stacklevel=2,
+        )
+
+
+def _auto_mode_supports(func, mode, instrs):
+    """Check that every instruction of ``func`` keeps Python semantics in ``mode``."""
+    callables = []  # LOAD_GLOBALs not yet called: True for range()/enumerate()
+    for idx, instr in enumerate(instrs):
+        name = instr.opname
+        following = instrs[idx + 1].opname if idx + 1 < len(instrs) else None
+        if name in ("LOAD_CONST", "RETURN_CONST"):
+            if not _auto_const_fits(mode, instr.argval):
+                return False
+        elif name in _AUTO_COMMON_OPCODES:
+            continue
+        elif name == "BINARY_OP":
+            if instr.arg not in _AUTO_BINARY_OPS.get(mode, ()):
+                return False
+        elif name in ("POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE", "JUMP_FORWARD", "JUMP_BACKWARD", "POP_TOP"):
+            if mode == "complex128":
+                return False
+        elif name == "COMPARE_OP":
+            # A native compare yields 0/1, not a bool: only a branch may consume it
+            if mode == "complex128":
+                return False
+            if mode != "bool" and following not in ("POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE"):
+                return False
+        elif name == "UNARY_NEGATIVE":
+            if mode not in ("int", "float"):
+                return False
+        elif name in ("COPY", "TO_BOOL", "UNARY_NOT"):
+            if mode != "bool":
+                return False
+        elif name == "LOAD_GLOBAL":
+            # `for i in range(...)` (or prange, or enumerate(range(...)))
+            # lowers natively in int mode; int and float functions call @jit
+            # functions of their mode
+            if _jit_callee_supports(func, instr.argval, mode):
+                callables.append(False)
+            elif mode == "int" and (_is_native_range_global(func, instr.argval)
+                                    or _is_prange_load(func, instrs, idx)):
+                callables.append(True)
+            else:
+                return False
+        elif name == "LOAD_ATTR":
+            # The prange of justjit.prange(...)
+            if mode != "int" or idx == 0 or not _is_prange_load(func, instrs, idx - 1):
+                return False
+        elif name == "PUSH_NULL":
+            if mode not in ("int", "float"):
+                return False
+        elif name in ("FOR_ITER", "END_FOR"):
+            if mode != "int":
+                return False
+        elif name == "UNPACK_SEQUENCE":
+            # `for i, x in enumerate(range(...))`
+            if mode != "int" or instr.arg != 2 or instrs[idx - 1].opname != "FOR_ITER":
+                return False
+        elif name == "STORE_FAST_STORE_FAST":
+            if mode not in ("int", "float"):
+                return False
+        elif name == "CALL":
+            if not callables:
+                return False
+            # range() is only iterated, directly or through enumerate()
+            if callables.pop() and following != "GET_ITER" and not (callables and callables[-1]):
+                return False
+        elif name == "GET_ITER":
+            if mode != "int" or idx == 0 or instrs[idx - 1].opname != "CALL":
+                return False
+        else:
+            return False
+    return True
+
+
+def _infer_auto_modes(func, instrs):
+    """Typed modes in which ``func`` type-checks, for mode='auto' (in preference order)."""
+    code = func.__code__
+    if (code.co_flags & (0x04 | 0x08) or code.co_kwonlyargcount or code.co_freevars
+            or code.co_cellvars or code.co_argcount > _AUTO_MAX_PARAMS):
+        return ()
+    modes = ("int", "float", "complex128", "bool")
+    if code.co_argcount > _AUTO_MAX_COMPLEX_PARAMS:
+        modes = ("int", "float", "bool")
+    return tuple(m for m in modes if _auto_mode_supports(func, m, instrs))
+
+
+def _param_slot_count(code):
+    """Number of argument slots in ``code``'s locals: positional, keyword-only, *args, **kwargs."""
+    count = code.co_argcount + code.co_kwonlyargcount
+    if code.co_flags & inspect.CO_VARARGS:
+        count += 1
+    if code.co_flags & inspect.CO_VARKEYWORDS:
+        count += 1
+    return count
+
+
+def _select_auto_mode(auto_modes, args, kwargs):
+    """Pick the mode for mode='auto' from the first call's argument types."""
+    if not auto_modes or kwargs:
+        return "object"
+    if not args:
+        return auto_modes[0]
+    arg_types = {type(a) for a in args}
+    if len(arg_types) != 1:
+        return "object"
+    mode = _AUTO_MODE_FOR_TYPE.get(arg_types.pop())
+    return mode if mode in auto_modes else "object"
+
+
 def jit(
     func=None,
     *,
@@ -110,8 +1195,23 @@ def jit(
     vectorize=True,
     inline=True,
     parallel=False,
-    lazy=False,
+    lazy=None,
     mode="auto",
+    background=False,
+    tier_up_threshold=None,
+    target_cpu="native",
+    target_features="native",
+    target="cpu",
+    unroll=0,
+    nogil=False,
+    fastmath=False,
+    vector_library="none",
+    checked=True,
+    static_args=None,
+    boundscheck=None,
+    poll=None,
+    max_bytecode_size=None,
+    max_compile_ms=None,
 ):
     """
     JIT compile a Python function for aggressive performance optimization.
@@ -119,12 +1219,96 @@ def jit(
     Args:
         func: The function to compile (when used without parentheses)
         opt_level: LLVM optimization level (0-3, default 3 for maximum performance)
-        vectorize: Enable loop vectorization (default True)
+        vectorize: Enable loop and SLP vectorization (default True)
         inline: Enable function inlining (default True)
-        parallel: Enable parallelization (default False)
-        lazy: Delay compilation until first call (default False)
+        parallel: Split ``map``/``reduce`` batch calls of int and float
+                  functions, and their ``for ... in prange(...)`` loops,
+                  across a native thread pool with the GIL released
+                  (default False)
+        lazy: Defer all decoration-time work (bytecode decoding, opcode
+              screening, JIT setup and any eager compile) until the first
+              call or compile_all(). None (the default) means True unless
+              the JUSTJIT_LAZY environment variable is "0"
         mode: Compilation mode - 'auto', 'object', or 'int' (default 'auto')
               'int' mode generates native integer code with no Python object overhead
+              'uint64' is int mode with C uint64_t arithmetic (wrapping,
+              unsigned //, %, >> and compares) for hashing and PRNG kernels;
+              values that could wrap must be masked (& 0xFFFFFFFFFFFFFFFF
+              or % 2**64) before they are returned, compared or divided,
+              else compiling it raises TypeError
+              'auto' picks int/float/bool/complex128 when the bytecode type-checks
+              and the first call's arguments all share that type, else object
+              'ndarray' compiles loops over buffers (a[i, j], a.shape) once per
+              argument dtype/ndim/layout; division by zero does not raise
+              (int // and % give 0, / gives inf or nan) and int ** needs a
+              constant exponent
+              'mixed' gives each local its own type (bool, int64 or float64,
+              widened as Python's rules require), compiled once per
+              combination of bool/int/float argument types
+              'vec<N><kind>' (vec4f, vec8i, vec2d, vec16i, ...) runs elementwise
+              code over whole arrays as <N x kind> vectors, kind one of f (float32),
+              d (float64), i (int32), q (int64); 'vecf' etc. use the target's
+              native vector width
+        background: Compile on a worker thread; calls run the original function
+                    until the native code is ready (default False)
+        tier_up_threshold: If set, compile at O0 first and recompile at opt_level
+                    in the background after this many calls (default None)
+        target_cpu: LLVM CPU name to generate code for (default 'native', the
+                    host, or JUSTJIT_TARGET_CPU / the CPU load_aot selected)
+        target_features: LLVM feature string such as '+avx2,+fma'
+                    (default 'native', the host's features)
+        target: Where ``map``/``reduce`` batch calls of int and float
+                functions run: 'cpu', or 'cuda' to lower the scalar kernel
+                to PTX and run calls on a device array, or over at least
+                JUSTJIT_CUDA_MIN_ITEMS host items, on CUDA device 0; other
+                calls, and every call without a usable device, stay on the
+                host (default 'cpu')
+        unroll: Loop unroll factor: 0 lets LLVM decide, 1 disables unrolling,
+                N > 1 unrolls every loop by N (default 0)
+        nogil: Release the GIL while typed-mode code (int, uint64, float, bool,
+               int32, float32, complex) runs, when its IR provably makes no Python
+               API calls; other threads run meanwhile (default False)
+        fastmath: Fast-math flags for every floating-point instruction:
+                  True for all of them, or a set/comma-separated string of
+                  nnan, ninf, nsz, arcp, contract, afn, reassoc. 'reassoc'
+                  lets float reductions vectorize (and ndarray-mode ``sum``
+                  drops its compensated summation), 'contract' forms FMAs;
+                  results may differ from Python's (default False)
+        vector_library: Vector math library that vectorized loops call for
+                  math.sin, math.exp, ...: 'none', 'libmvec', 'svml', 'sleef',
+                  'accelerate', or 'auto' for the platform's usual one
+                  (default 'none'; the vector variants may be a few ulp off)
+        checked: Test int mode arithmetic for results that do not fit in 64
+                 bits (and zero divisors); such calls rerun in the
+                 interpreter, returning the same int Python would. False
+                 gives wrapping i64 arithmetic, which vectorizes more
+                 (default True)
+        static_args: Names of parameters (window sizes, orders, flags) to
+                 compile a variant per distinct value of: the int, float or
+                 bool value is folded in as a constant, so loops over it
+                 unroll. The 16 most recently used variants are kept
+                 (default None)
+        boundscheck: ndarray mode index checking: an index outside its
+                 dimension raises IndexError. None checks the indices a
+                 ``for i in range(a.shape[d])`` loop does not already keep
+                 in range, True checks every one, False none, trusting the
+                 caller (default None)
+        poll: Back edges between eval-breaker polls in compiled loops. A
+                 poll lets threads waiting for the GIL run and runs signal
+                 handlers, so Ctrl-C interrupts a long loop (int, float and
+                 ndarray code raise the handler's exception; other typed
+                 modes only hand over the GIL). None polls object mode
+                 every 1024 back edges and typed code never, since a poll
+                 keeps a loop from vectorizing; 0 never polls (default None)
+        max_bytecode_size: Compile budget by size. A function of more
+                 bytecode instructions is compiled at opt_level 0, without
+                 tiering up (default None: no limit)
+        max_compile_ms: Compile budget by time. A call (or lazy=False
+                 decoration) that has to compile waits at most this long;
+                 past it the compile finishes in the background while
+                 calls run in the interpreter. With mode='auto' the first
+                 call then picks one mode for all later calls (default
+                 None: wait for the compile)
 
     Example:
         @jit
@@ -139,244 +1323,559 @@ def jit(
 
         def decorator(f):
             return _create_jit_wrapper(
-                f, opt_level, vectorize, inline, parallel, lazy, mode
+                f, opt_level, vectorize, inline, parallel, lazy, mode, background,
+                tier_up_threshold, target_cpu, target_features, unroll, nogil, fastmath,
+                vector_library, checked, static_args, boundscheck=boundscheck, poll=poll,
+                max_bytecode_size=max_bytecode_size, max_compile_ms=max_compile_ms, target=target,
             )
 
         return decorator
-    return _create_jit_wrapper(func, opt_level, vectorize, inline, parallel, lazy, mode)
+    return _create_jit_wrapper(
+        func, opt_level, vectorize, inline, parallel, lazy, mode, background, tier_up_threshold,
+        target_cpu, target_features, unroll, nogil, fastmath, vector_library, checked, static_args,
+        boundscheck=boundscheck, poll=poll, max_bytecode_size=max_bytecode_size,
+        max_compile_ms=max_compile_ms, target=target,
+    )
 
 
-def _extract_bytecode(func):
-    """Extract bytecode instructions from a Python function."""
-    # Opcodes that use argval as a jump target (offset)
-    JUMP_OPCODES = {
-        "POP_JUMP_IF_FALSE",
-        "POP_JUMP_IF_TRUE",
-        "JUMP_FORWARD",
-        "JUMP_BACKWARD",
-        "POP_JUMP_IF_NONE",
-        "POP_JUMP_IF_NOT_NONE",
-        "FOR_ITER",
-        "JUMP_BACKWARD_NO_INTERRUPT",
-        "SEND",  # SEND jumps to target when sub-iterator returns
-    }
+# jit(target=...): where batch calls of int and float functions run
+_DEVICE_TARGETS = ("cpu", "cuda")
 
-    instructions = []
-    for instr in dis.get_instructions(func):
-        # Skip CACHE instructions - they're just placeholders for the adaptive interpreter
-        if instr.opname == "CACHE":
-            continue
+# target='cuda': host batch calls over fewer items stay on the host, where
+# the loop costs less than copying the operands over and back
+_CUDA_MIN_ITEMS = int(os.environ.get("JUSTJIT_CUDA_MIN_ITEMS", "65536"))
 
-        # Handle argval - we only care about integer values for jump targets
-        # For non-jump instructions, argval can be the constant VALUE which may overflow int32
-        argval = 0
-        if instr.opname in JUMP_OPCODES:
-            # For jumps, argval is the target offset - pass it
-            if hasattr(instr, "argval") and isinstance(instr.argval, int):
-                argval = instr.argval
-        # For all other opcodes (LOAD_CONST, RETURN_CONST, etc), argval stays 0
-        # We use instr.arg as the index into constants/names/locals
-
-        instructions.append(
-            {
-                "opcode": instr.opcode,
-                "arg": instr.arg if instr.arg is not None else 0,
-                "argval": argval,
-                "offset": instr.offset,
-            }
-        )
-    return instructions
+# Optimization level of the baseline tier used by tier_up_threshold
+_TIER0_OPT_LEVEL = 0
 
+# Failed speculative guards after which the hot tier is recompiled without
+# speculation
+_DEOPT_LIMIT = 100
 
-def _extract_constants(func):
-    """Extract constant values from code object."""
-    # Pass all constants as-is, let C++ side handle them
-    return list(func.__code__.co_consts)
+# static_args=: compiled variants kept per function (least recently used go first)
+_STATIC_VARIANT_LIMIT = 16
 
+# boundscheck= -> JIT.set_bounds_checks level
+_BOUNDS_CHECK_LEVELS = {False: 0, None: 1, True: 2}
 
-def _extract_names(func):
-    """Extract names from code object (for LOAD_ATTR, LOAD_GLOBAL, etc)."""
-    return list(func.__code__.co_names)
 
+def _poll_interval(poll):
+    """poll= -> JIT.set_poll_interval interval (-1: each mode's default)."""
+    if poll is None:
+        return -1
+    if isinstance(poll, bool) or not isinstance(poll, int) or poll < 0:
+        raise ValueError(f"poll must be None or a back edge count >= 0, got {poll!r}")
+    return poll
 
-def _extract_globals(func):
-    """Extract globals dictionary for runtime lookup.
 
-    Returns the function's __globals__ dict directly so that
-    global variable lookups happen at runtime, not compile time.
-    This ensures changes to globals after JIT compilation are visible.
-    """
-    return func.__globals__
+def _check_device(target):
+    """Validate jit()'s target= option."""
+    if not isinstance(target, str) or target not in _DEVICE_TARGETS:
+        raise ValueError(f"target must be 'cpu' or 'cuda', got {target!r}")
+    return target
 
 
-def _extract_builtins(func):
-    """Extract builtins dict for fallback lookup."""
-    import builtins
+def cuda_available():
+    """True if jit(target='cuda') batch calls can run on CUDA device 0.
 
-    return builtins.__dict__
+    justjit loads the CUDA driver at run time; without it, or without a
+    device, target='cuda' functions run every batch call on the host.
+    """
+    return _cuda_status() is None
 
 
-def _extract_closure(func):
-    """Extract closure cells from a function.
+def _on_device(obj):
+    """True for an array in GPU memory (one exposing __cuda_array_interface__)."""
+    return hasattr(obj, "__cuda_array_interface__")
 
-    Returns a list of cell objects (or empty list if no closure).
-    Closure cells contain values captured from enclosing scopes.
+
+def _offload_batches(native, target, name, param_count, mode):
+    """Send ``native``'s map()/reduce() calls to the CUDA device (target='cuda').
+
+    Calls with a device operand, or over at least _CUDA_MIN_ITEMS host items,
+    run there; smaller ones keep the host loops. The PTX is built and loaded
+    on the first such call. If that fails, host operands stay on the host
+    and a device operand raises RuntimeError saying why.
     """
-    if func.__closure__ is not None:
-        return list(func.__closure__)
-    return []
+    host_map = native.map
+    host_reduce = native.reduce
+    kernels = []  # [(map, reduce)] once loaded, or [why the device cannot run them]
 
+    def _device(operands, call):
+        on_device = any(_on_device(op) for op in operands)
+        if not on_device:
+            sizes = [len(op) for op in operands if hasattr(op, "__len__")]
+            if max(sizes, default=0) < _CUDA_MIN_ITEMS:
+                return None
+        if not kernels:
+            try:
+                kernels.append(target.get_cuda_batch(name, param_count, mode))
+            except RuntimeError as e:
+                kernels.append(str(e))
+        if isinstance(kernels[0], str):
+            if on_device:
+                raise RuntimeError(f"{name}.{call}() got a device array, but {kernels[0]}")
+            return None
+        return kernels[0]
 
-def _parse_exception_table(func):
-    """Parse Python 3.11+ exception table from code object.
+    def _cuda_map(*operands, out=None):
+        device = _device(operands + (out,), "map")
+        if device is None:
+            return host_map(*operands, out=out)
+        return device[0](*operands, out=out)
 
-    Returns a list of dicts with keys:
-    - start: start offset of protected range
-    - end: end offset of protected range
-    - target: handler offset (PUSH_EXC_INFO location)
-    - depth: stack depth to unwind to
-    - lasti: whether to push last instruction offset
-    """
-    table = func.__code__.co_exceptiontable
-    if not table:
-        return []
+    def _cuda_reduce(array, initial=None):
+        device = _device((array,), "reduce") if param_count == 2 else None
+        if device is None:
+            return host_reduce(array, initial=initial)
+        # The device folds runs of consecutive items; their partials are
+        # folded in order here
+        return host_reduce(device[1](array), initial=initial)
 
-    def read_varint(data, pos):
-        """Read a variable-length integer from exception table.
-        
-        Python 3.11+ uses a big-endian varint format:
-        - Bit 6 (0x40) is the continuation flag
-        - Bits 0-5 (0x3F) are the value bits
-        - Values are built from high bits to low bits
-        """
-        b = data[pos]
-        pos += 1
-        val = b & 0x3F
-        while b & 0x40:
-            val <<= 6
-            b = data[pos]
-            pos += 1
-            val |= b & 0x3F
-        return val, pos
-
-    entries = []
-    i = 0
-    while i < len(table):
-        start, i = read_varint(table, i)
-        length, i = read_varint(table, i)
-        target, i = read_varint(table, i)
-        depth_lasti, i = read_varint(table, i)
-        depth = depth_lasti >> 1
-        lasti = bool(depth_lasti & 1)
-
-        entries.append(
-            {
-                "start": start * 2,  # Convert to byte offset
-                "end": (start + length) * 2,
-                "target": target * 2,
-                "depth": depth,
-                "lasti": lasti,
-            }
-        )
+    native.map = _cuda_map
+    native.reduce = _cuda_reduce
 
-    return entries
 
+def _check_budget(max_bytecode_size, max_compile_ms):
+    """Validate the max_bytecode_size= and max_compile_ms= compile budgets."""
+    if max_bytecode_size is not None and (
+        isinstance(max_bytecode_size, bool) or not isinstance(max_bytecode_size, int) or max_bytecode_size < 0
+    ):
+        raise ValueError(f"max_bytecode_size must be None or an instruction count >= 0, got {max_bytecode_size!r}")
+    if max_compile_ms is not None and (
+        isinstance(max_compile_ms, bool) or not isinstance(max_compile_ms, (int, float)) or max_compile_ms < 0
+    ):
+        raise ValueError(f"max_compile_ms must be None or a duration >= 0, got {max_compile_ms!r}")
 
-def _is_simple_generator(func):
-    """Check if a generator only uses opcodes the JIT generator compiler supports.
-    
-    The generator compiler supports most common opcodes. This function returns
-    False for opcodes that are NOT yet implemented in compile_generator.
-    """
-    # Opcodes supported by the generator compiler
-    # These opcodes are actually implemented in JITCore::compile_generator()
-    supported_opcodes = {
-        # Control flow
-        "RESUME", "RETURN_GENERATOR", "NOP", "CACHE",
-        # Load/store
-        "LOAD_CONST", "LOAD_FAST", "LOAD_FAST_CHECK", "STORE_FAST",
-        "LOAD_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST",  # Python 3.13 combined opcodes
-        "STORE_FAST_LOAD_FAST", "LOAD_FAST_AND_CLEAR",   # Python 3.13 combined opcodes
-        "LOAD_LOCALS",  # Python 3.13 annotation scope
-        "LOAD_FROM_DICT_OR_DEREF", "LOAD_FROM_DICT_OR_GLOBALS",  # Python 3.13 annotation scope
-        # Global/builtin access
-        "LOAD_GLOBAL", "LOAD_ATTR", "PUSH_NULL",
-        "STORE_GLOBAL", "STORE_ATTR",
-        "CALL", "CALL_KW", "CALL_FUNCTION_EX",
-        "CALL_INTRINSIC_2",  # Two-arg intrinsics (type params, etc.)
-        # Generator specific
-        "YIELD_VALUE", "RETURN_VALUE", "RETURN_CONST",
-        # Stack manipulation
-        "POP_TOP", "COPY", "SWAP",
-        # Arithmetic
-        "BINARY_OP",
-        # Comparison and boolean
-        "COMPARE_OP", "CONTAINS_OP", "IS_OP", "TO_BOOL",
-        # Unary operations
-        "UNARY_NEGATIVE", "UNARY_NOT", "UNARY_INVERT",
-        # Looping support
-        "GET_ITER", "FOR_ITER", "END_FOR",
-        "JUMP_BACKWARD", "JUMP_FORWARD", "JUMP_BACKWARD_NO_INTERRUPT",
-        "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE",
-        "POP_JUMP_IF_NONE", "POP_JUMP_IF_NOT_NONE",
-        # Collections
-        "BUILD_LIST", "BUILD_TUPLE", "BUILD_CONST_KEY_MAP",
-        "BUILD_MAP", "BUILD_SET",
-        "LIST_APPEND", "SET_ADD", "MAP_ADD",
-        "LIST_EXTEND", "SET_UPDATE", "DICT_UPDATE", "DICT_MERGE",
-        # Subscript and slicing
-        "BINARY_SUBSCR", "STORE_SUBSCR", "DELETE_SUBSCR",
-        "BUILD_SLICE", "BINARY_SLICE", "STORE_SLICE",
-        # Unpacking
-        "UNPACK_SEQUENCE", "UNPACK_EX",
-        # Exception handling (supported via exception table)
-        "CALL_INTRINSIC_1", "RERAISE", "PUSH_EXC_INFO", "POP_EXCEPT",
-        "CHECK_EXC_MATCH", "CHECK_EG_MATCH",  # except* exception group matching
-        "RAISE_VARARGS",  # raise, raise exc, raise exc from cause
-        # Closures
-        "LOAD_DEREF", "STORE_DEREF", "LOAD_CLOSURE",
-        "COPY_FREE_VARS", "MAKE_CELL",
-        # Import
-        "IMPORT_NAME", "IMPORT_FROM",
-        # Function creation
-        "MAKE_FUNCTION", "SET_FUNCTION_ATTRIBUTE",
-        # Class support
-        "SETUP_ANNOTATIONS", "EXIT_INIT_CHECK",
-        # Async with
-        "BEFORE_ASYNC_WITH",
-    }
-    
-    # Note: All opcodes that appear in actual bytecode are now supported!
-    # - LOAD_METHOD is a pseudo-instruction (emitted as LOAD_ATTR with flag)
-    # - RAISE_VARARGS is implemented (line 6513 in jit_core.cpp)
-    # - LOAD_FAST_AND_CLEAR is implemented (line 1973, 8644 in jit_core.cpp)
-    
-    # Allow all opcodes - we have full coverage
+# What lazy=None means: decorating only records the function
+_LAZY_DEFAULT = os.environ.get("JUSTJIT_LAZY", "1") != "0"
+
+# CPU that target_cpu='native' compiles generate code for instead of the
+# host's (JUSTJIT_TARGET_CPU, or the one load_aot selects); None is the host
+_fleet_target = os.environ.get("JUSTJIT_TARGET_CPU") or None
+
+
+def _resolve_target(target_cpu, target_features):
+    """The (cpu, features) a JIT instance is set to for these jit() options."""
+    if target_cpu == "native" and target_features == "native" and _fleet_target:
+        return _fleet_target, "cpu"
+    return target_cpu, target_features
+
+
+_compile_executor = None
+
+
+def _get_compile_executor():
+    """Return the process-wide single-thread executor used for background compiles."""
+    global _compile_executor
+    if _compile_executor is None:
+        from concurrent.futures import ThreadPoolExecutor
+
+        _compile_executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="justjit-compile")
+    return _compile_executor
+
+
+# ============================================================================
+# On-stack replacement
+# ============================================================================
+# An interpreted call of a background=True function (one made while its
+# compile is pending) whose loop takes this many backward jumps to the same
+# header gets an OSR entry compiled for that header; the next backward jump
+# hands the frame's locals to it and the loop finishes in native code.
+# JUSTJIT_OSR_THRESHOLD sets it; 0 turns OSR off.
+_OSR_THRESHOLD = int(os.environ.get("JUSTJIT_OSR_THRESHOLD", "1000"))
+
+# Stands for a local without a value in the list an OSR entry takes
+_OSR_UNBOUND = object()
+
+# code object -> _OSRSites of every function OSR watches
+_osr_watched = {}
+_osr_tool = None
+_osr_lock = threading.Lock()
+
+
+class _OSRExit(BaseException):
+    """Unwinds an interpreted frame whose loop finished in its OSR entry; carries its result."""
+
+    def __init__(self, value):
+        super().__init__()
+        self.value = value
+
+
+class _OSRSites:
+    """OSR state of one function: backward jumps seen and compiled entries, per loop header."""
+
+    def __init__(self, headers, compile_entry):
+        self.headers = headers  # Loop headers outside try/with blocks
+        self.compile_entry = compile_entry  # header -> callable or None
+        self.counts = collections.Counter()
+        self.entries = {}  # header -> callable, None if it did not compile
+        self.pending = set()
+        self.tails = {}  # (exit offset, unbound locals) -> _region_tail function
+
+    def build(self, header):
+        try:
+            entry = self.compile_entry(header)
+        except Exception:
+            entry = None
+        self.entries[header] = entry
+
+
+def _osr_headers(code):
+    """Targets of the JUMP_BACKWARDs of ``code`` that neither the jump nor the target is in a try/with of."""
+    protected = [(e.start, e.end) for e in dis.Bytecode(code).exception_entries]
+
+    def covered(offset):
+        return any(start <= offset < end for start, end in protected)
+
+    return frozenset(
+        ins.argval for ins in dis.get_instructions(code)
+        if ins.opname == "JUMP_BACKWARD" and not covered(ins.offset) and not covered(ins.argval)
+    )
+
+
+def _osr_watch(func, compile_entry):
+    """Watch the backward jumps of ``func``'s interpreted calls; False if OSR cannot apply."""
+    code = func.__code__
+    if code in _osr_watched:
+        return True
+    if _OSR_THRESHOLD <= 0 or _is_generator_or_coroutine(func) or code.co_cellvars or code.co_freevars:
+        return False
+    headers = _osr_headers(code)
+    if not headers:
+        return False
+    with _osr_lock:
+        if not _monitoring_tool():
+            return False
+        _osr_watched[code] = _OSRSites(headers, compile_entry)
+        sys.monitoring.set_local_events(_osr_tool, code, sys.monitoring.events.JUMP)
     return True
 
 
-def _create_generator_wrapper(func, opt_level):
-    """Create a JIT-compiled wrapper for a generator function.
-    
-    This compiles the generator into a state machine and returns a factory
-    function that creates JIT generator objects when called.
-    """
+def _monitoring_tool():
+    """The sys.monitoring tool id of OSR and auto_jit, False if another optimizer holds it. Call with _osr_lock held."""
+    global _osr_tool
+    monitoring = sys.monitoring
+    if _osr_tool is None:
+        try:
+            monitoring.use_tool_id(monitoring.OPTIMIZER_ID, "justjit")
+        except ValueError:  # Another optimizer holds the tool id
+            _osr_tool = False
+        else:
+            monitoring.register_callback(monitoring.OPTIMIZER_ID, monitoring.events.JUMP, _osr_jump)
+            _osr_tool = monitoring.OPTIMIZER_ID
+    return _osr_tool
+
+
+def _osr_run(func, args, kwargs, counters):
+    """Call ``func`` interpreted; a loop that gets hot finishes in its OSR entry.
+
+    A region entry leaves its loop with the rest of the call instead, a
+    _RegionTail run here in turn, so a loop re-entered from an outer one
+    does not nest frames.
+    """
+    while True:
+        try:
+            return func(*args, **kwargs)
+        except _OSRExit as done:
+            counters["osr_entries"] += 1
+            result = done.value
+        if not isinstance(result, _RegionTail):
+            return result
+        func, args, kwargs = result.func, result.args, {}
+
+
+def _osr_jump(code, src, dest):
+    """sys.monitoring JUMP callback: count backward jumps, enter OSR entries once compiled."""
+    sites = _osr_watched.get(code)
+    if sites is None or dest >= src or dest not in sites.headers:
+        return sys.monitoring.DISABLE
+    frame = sys._getframe(1)
+    if frame.f_back is None or frame.f_back.f_code is not _osr_run.__code__:
+        return None  # Not a call the wrapper can take the result of
+    if dest not in sites.entries:
+        sites.counts[dest] += 1
+        if sites.counts[dest] >= _OSR_THRESHOLD and dest not in sites.pending:
+            sites.pending.add(dest)
+            _get_compile_executor().submit(sites.build, dest)
+        return None
+    entry = sites.entries[dest]
+    if entry is None:
+        return sys.monitoring.DISABLE
+    local_values = frame.f_locals
+    # Raised at the jump, like any exception of the loop's native run
+    raise _OSRExit(entry([local_values.get(n, _OSR_UNBOUND) for n in code.co_varnames]))
+
+
+# ============================================================================
+# Loop regions
+# ============================================================================
+# A region entry (JIT.compile with region_end) runs one loop natively and
+# leaves it with DeoptError, the locals saved as the frame at the exit. The
+# interpreter cannot be resumed mid-code object, so the rest of the call
+# runs in a tail: a copy of the code object whose locals are all positional
+# arguments and whose first instruction jumps to the exit offset.
+
+_RESUME = dis.opmap["RESUME"]
+_NOP = dis.opmap["NOP"]
+_EXTENDED_ARG = dis.opmap["EXTENDED_ARG"]
+_JUMP_FORWARD = dis.opmap["JUMP_FORWARD"]
+_JUMP_BACKWARD = dis.opmap["JUMP_BACKWARD"]
+_DELETE_FAST = dis.opmap["DELETE_FAST"]
+_JUMP_BACKWARD_CACHES = dis._inline_cache_entries.get("JUMP_BACKWARD", 0)
+
+
+class _RegionTail:
+    """The rest of a call whose region entry left its loop: ``func(*args)`` finishes it."""
+
+    __slots__ = ("func", "args")
+
+    def __init__(self, func, args):
+        self.func = func
+        self.args = args
+
+
+def _with_arg(opcode, arg, caches=0):
+    """Bytes of one instruction, with its EXTENDED_ARG prefixes and inline caches."""
+    out = bytearray()
+    for shift in (24, 16, 8):
+        if arg >> shift:
+            out += bytes((_EXTENDED_ARG, (arg >> shift) & 0xFF))
+    out += bytes((opcode, arg & 0xFF))
+    return bytes(out) + bytes(2 * caches)
+
+
+def _jump_backward(start, target):
+    """A JUMP_BACKWARD at ``start`` to ``target``, sized for its own EXTENDED_ARGs."""
+    for units in (1, 2, 3, 4):
+        end = start + 2 * (units + _JUMP_BACKWARD_CACHES)
+        jump = _with_arg(_JUMP_BACKWARD, (end - target) // 2, _JUMP_BACKWARD_CACHES)
+        if len(jump) == end - start:
+            return jump
+    raise ValueError("jump out of range")
+
+
+def _region_tail(func, offset, unbound):
+    """A function finishing a call of ``func`` from ``offset``, or None if its code cannot be patched.
+
+    It takes every local positionally (None for those in ``unbound``).
+    After RESUME, its code jumps to a block appended past the end, which
+    deletes the unbound locals and jumps back to ``offset``. The bytes
+    overwritten run only at the start of a call, before the first jump
+    target; NOPs fill them up to the next instruction.
+    """
+    code = func.__code__
+    raw = code.co_code
+    if not raw or raw[0] != _RESUME or code.co_cellvars or code.co_freevars:
+        return None
+    instrs = list(dis.get_instructions(code))
+    entries = dis.Bytecode(code).exception_entries
+    first_target = min(
+        [ins.argval for ins in instrs if ins.opcode in dis.hasjump] +
+        [e.start for e in entries] + [e.target for e in entries],
+        default=len(raw),
+    )
+    tail = len(raw)
+    for units in (1, 2, 3, 4):
+        after = 2 + 2 * units
+        head = _with_arg(_JUMP_FORWARD, (tail - after) // 2)
+        if len(head) == 2 * units:
+            break
+    pad_to = next((ins.offset for ins in instrs if ins.offset >= after), tail)
+    if pad_to > first_target or offset < pad_to:
+        return None
+
+    trampoline = bytearray()
+    for index in unbound:
+        trampoline += _with_arg(_DELETE_FAST, index)
+    trampoline += _jump_backward(tail + len(trampoline), offset)
+    body = bytearray(raw)
+    body[2:after] = head
+    for pos in range(after, pad_to, 2):
+        body[pos:pos + 2] = bytes((_NOP, 0))
+    body += trampoline
+    # The appended instructions have no source location
+    linetable = bytearray(code.co_linetable)
+    units = len(trampoline) // 2
+    while units:
+        linetable.append(0xF8 | (min(units, 8) - 1))
+        units -= min(units, 8)
+    tail_code = code.replace(
+        co_code=bytes(body), co_linetable=bytes(linetable), co_argcount=code.co_nlocals,
+        co_posonlyargcount=0, co_kwonlyargcount=0,
+        co_flags=code.co_flags & ~(_CO_VARARGS | _CO_VARKEYWORDS),
+    )
+    return types.FunctionType(tail_code, func.__globals__, func.__name__)
+
+
+def _region_entry(func, entry):
+    """The OSR-style entry of the region entry ``entry`` of ``func``: takes the frame's locals.
+
+    It returns the call's result when the loop returns, else a _RegionTail
+    for the rest of the call. Tails are watched like ``func``, so a loop
+    they reach again enters its native code at once.
+    """
+    code = func.__code__
+
+    def run(values):
+        try:
+            return entry(0, values)
+        except DeoptError:
+            frame = JIT.take_deopt_frame(_OSR_UNBOUND)
+            if frame is None:
+                raise
+        offset, values = frame
+        unbound = tuple(i for i, value in enumerate(values) if value is _OSR_UNBOUND)
+        sites = _osr_watched[code]
+        tail = sites.tails.get((offset, unbound))
+        if tail is None:
+            tail = sites.tails[(offset, unbound)] = _region_tail(func, offset, unbound)
+            with _osr_lock:
+                _osr_watched[tail.__code__] = sites
+                sys.monitoring.set_local_events(_osr_tool, tail.__code__, sys.monitoring.events.JUMP)
+        return _RegionTail(tail, [None if value is _OSR_UNBOUND else value for value in values])
+
+    return run
+
+
+def _extract_bytecode(func):
+    """What the compile entry points take for the instructions: the code object.
+
+    The C++ side decodes ``co_code`` (skipping inline caches and folding
+    EXTENDED_ARG, as ``dis`` does) and ``co_exceptiontable`` itself, so no
+    Python object is built per instruction.
+    """
+    return func.__code__
+
+
+def _note_source(jit_instance, func):
+    """Tell ``jit_instance`` where ``func`` is defined, for perf, gdb and PC tables."""
+    if get_perf_mode() or get_gdb_support() or get_pc_tables():
+        code = func.__code__
+        jit_instance.set_source_info(func.__name__, func.__qualname__, code.co_filename, code.co_firstlineno)
+
+
+def _extract_constants(func):
+    """Extract constant values from code object."""
+    # Pass all constants as-is, let C++ side handle them
+    return list(func.__code__.co_consts)
+
+
+def _extract_names(func):
+    """Extract names from code object (for LOAD_ATTR, LOAD_GLOBAL, etc)."""
+    return list(func.__code__.co_names)
+
+
+def _extract_globals(func):
+    """Extract globals dictionary for runtime lookup.
+
+    Returns the function's __globals__ dict directly so that
+    global variable lookups happen at runtime, not compile time.
+    This ensures changes to globals after JIT compilation are visible.
+    """
+    return func.__globals__
+
+
+def _extract_builtins(func):
+    """Extract builtins dict for fallback lookup."""
+    import builtins
+
+    return builtins.__dict__
+
+
+def _extract_closure(func):
+    """Extract closure cells from a function.
+
+    Returns a list of cell objects (or empty list if no closure).
+    Closure cells contain values captured from enclosing scopes.
+    """
+    if func.__closure__ is not None:
+        return list(func.__closure__)
+    return []
+
+
+def _unsupported_generator_opcodes(instrs):
+    """Names of the opcodes in a generator/coroutine that compile_generator cannot lower."""
+    return sorted({instr.opname for instr in instrs if not JIT.generator_supports_opcode(instr.opcode)})
+
+
+# Generator modes whose locals stay unboxed across yields
+_TYPED_GENERATOR_MODES = ("int", "float")
+
+
+def _create_typed_generator_wrapper(func, opt_level, mode):
+    """Compile an int/float-mode generator with raw 64-bit local slots, or return None.
+
+    Only the bound arguments are objects (unboxed on the first step); yielded
+    and returned values are boxed at the Python boundary.
+    """
+    import functools
+
+    code = func.__code__
+    if code.co_flags & (_CO_VARARGS | _CO_VARKEYWORDS) or code.co_kwonlyargcount or code.co_cellvars or code.co_freevars:
+        return None
+
+    jit_instance = JIT()
+    jit_instance.set_opt_level(opt_level)
+    _note_source(jit_instance, func)
+    param_count = code.co_argcount
+    if not jit_instance.compile_typed_generator(
+        _extract_bytecode(func), _extract_constants(func), _extract_names(func), func.__name__,
+        param_count, code.co_nlocals, code.co_stacksize, mode,
+    ):
+        return None
+
+    gen_info = jit_instance.get_generator_callable(func.__name__, param_count, 0, func.__name__, func.__qualname__)
+    if gen_info is None:
+        return None
+
+    generator_factory = create_generator_factory(
+        gen_info["step_func_addr"], gen_info["num_locals"], func, gen_info["name"], gen_info["qualname"],
+        "generator", jit_instance, param_count,
+    )
+    functools.update_wrapper(generator_factory, func)
+    generator_factory._jit_instance = jit_instance
+    generator_factory._original_func = func
+    generator_factory._instructions = _extract_bytecode(func)
+    generator_factory._mode = mode
+    generator_factory._is_jit_generator = True
+    return generator_factory
+
+
+def _create_generator_wrapper(func, opt_level, mode, instrs):
+    """Create a JIT-compiled wrapper for a generator function.
+    
+    This compiles the generator into a state machine and returns a factory
+    function that creates JIT generator objects when called. With mode
+    'int' or 'float' the typed step function is tried first.
+    """
     import functools
     import warnings
+
+    if mode in _TYPED_GENERATOR_MODES:
+        typed = _create_typed_generator_wrapper(func, opt_level, mode)
+        if typed is not None:
+            return typed
+        warnings.warn(
+            f"Generator '{func.__name__}' cannot be compiled in mode='{mode}'. "
+            f"Using an object-mode generator.",
+            RuntimeWarning,
+            stacklevel=2,
+        )
     
-    # Check if this generator is simple enough for JIT compilation
-    if not _is_simple_generator(func):
-        # Complex generator - fall back to Python for safety
+    unsupported = _unsupported_generator_opcodes(instrs)
+    if unsupported:
         warnings.warn(
-            f"Generator '{func.__name__}' uses opcodes not yet supported by JIT. "
-            f"Using Python implementation (no performance impact for generators).",
+            f"Generator '{func.__name__}' uses opcodes not yet supported by JIT "
+            f"({', '.join(unsupported)}). Using Python implementation.",
             RuntimeWarning,
-            stacklevel=4,
+            stacklevel=2,
         )
         return func
     
     jit_instance = JIT()
     jit_instance.set_opt_level(opt_level)
+    _note_source(jit_instance, func)
     
     instructions = _extract_bytecode(func)
     constants = _extract_constants(func)
@@ -384,7 +1883,7 @@ def _create_generator_wrapper(func, opt_level):
     globals_dict = _extract_globals(func)
     builtins_dict = _extract_builtins(func)
     closure_cells = _extract_closure(func)
-    exception_table = _parse_exception_table(func)
+    exception_table = func.__code__  # co_exceptiontable, decoded natively
     
     param_count = func.__code__.co_argcount
     nlocals = func.__code__.co_nlocals
@@ -392,11 +1891,10 @@ def _create_generator_wrapper(func, opt_level):
     num_freevars = len(func.__code__.co_freevars)
     base_locals = nlocals + num_cellvars + num_freevars
     
-    # For generators, we need extra slots for stack persistence across yields
-    # The stack may have values that need to survive the yield/resume boundary
-    # We allocate co_stacksize additional slots after the regular locals
-    max_stack_depth = func.__code__.co_stacksize
-    total_locals = base_locals + max_stack_depth
+    # Stack values live across a yield are spilled to slots after the
+    # localsplus; compile_generator sizes that region itself and reports the
+    # final slot count through get_generator_callable.
+    total_locals = base_locals
     
     # Compile the generator to a step function
     success = jit_instance.compile_generator(
@@ -418,7 +1916,7 @@ def _create_generator_wrapper(func, opt_level):
             f"Failed to JIT compile generator '{func.__name__}'. "
             f"Falling back to Python implementation.",
             RuntimeWarning,
-            stacklevel=4,
+            stacklevel=2,
         )
         return func
     
@@ -439,30 +1937,13 @@ def _create_generator_wrapper(func, opt_level):
     gen_name = gen_info["name"]
     gen_qualname = gen_info["qualname"]
     
-    @functools.wraps(func)
-    def generator_factory(*args, **kwargs):
-        """Factory function that creates a new JIT generator each time it's called."""
-        if kwargs:
-            # For simplicity, don't support kwargs in generators yet
-            # Fall back to original
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a new JIT generator
-        gen = create_jit_generator(step_func_addr, num_locals, gen_name, gen_qualname)
-        
-        # Store arguments in the generator's locals array
-        # The generator's step function expects args at indices 0..param_count-1
-        for i, arg in enumerate(args):
-            gen._set_local(i, arg)
-        
-        return gen
-    
+    # Native factory: each call allocates the generator with its locals
+    # inline and binds keywords, defaults, *args and **kwargs like CPython,
+    # straight into the local slots the step function expects
+    generator_factory = create_generator_factory(
+        step_func_addr, num_locals, func, gen_name, gen_qualname, "generator", jit_instance
+    )
+    functools.update_wrapper(generator_factory, func)
     generator_factory._jit_instance = jit_instance
     generator_factory._original_func = func
     generator_factory._instructions = instructions
@@ -472,63 +1953,6 @@ def _create_generator_wrapper(func, opt_level):
     return generator_factory
 
 
-def _is_simple_coroutine(func):
-    """Check if an async function uses only supported opcodes.
-    
-    Currently supported async opcodes:
-    - GET_AWAITABLE: Get awaitable from object
-    - SEND: Core await mechanism  
-    - END_SEND: Cleanup after send
-    - All regular generator opcodes (RESUME, YIELD_VALUE, etc.)
-    """
-    # Async functions can use the same opcodes as generators plus async-specific ones
-    async_supported = {
-        "GET_AWAITABLE", "SEND", "END_SEND",
-        # Coroutine entry/exit
-        "RETURN_GENERATOR", "RETURN_VALUE", "RETURN_CONST",
-        # Resume points
-        "RESUME", "YIELD_VALUE",
-        # Exception handling (required for coroutines - we'll handle at runtime)
-        "CALL_INTRINSIC_1", "CALL_INTRINSIC_2", "RERAISE", "PUSH_EXC_INFO", "POP_EXCEPT",
-        "CHECK_EXC_MATCH", "CHECK_EG_MATCH",  # except* exception group matching
-        "RAISE_VARARGS",  # raise, raise exc, raise exc from cause
-        # Local/global access
-        "LOAD_FAST", "STORE_FAST", "LOAD_CONST", "LOAD_GLOBAL",
-        "STORE_GLOBAL", "LOAD_ATTR", "STORE_ATTR", "LOAD_NAME",
-        "LOAD_LOCALS", "LOAD_FROM_DICT_OR_DEREF", "LOAD_FROM_DICT_OR_GLOBALS",  # Python 3.13
-        # Python 3.13 combined opcodes
-        "LOAD_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST", "LOAD_FAST_CHECK",
-        "LOAD_FAST_AND_CLEAR", "STORE_FAST_LOAD_FAST",
-        # Operations
-        "BINARY_OP", "COMPARE_OP", "UNARY_NEGATIVE", "UNARY_NOT",
-        "UNARY_INVERT", "BUILD_LIST", "BUILD_TUPLE", "BUILD_SET",
-        "BUILD_MAP", "BUILD_STRING", "BUILD_CONST_KEY_MAP",
-        "LIST_APPEND", "SET_ADD", "MAP_ADD", "LIST_EXTEND", 
-        "SET_UPDATE", "DICT_MERGE", "DICT_UPDATE", 
-        "CALL", "CALL_FUNCTION_EX", "CALL_KW", "PUSH_NULL",
-        "POP_TOP", "COPY", "SWAP", "NOP", "CACHE",
-        # Control flow
-        "JUMP_BACKWARD", "JUMP_FORWARD", "JUMP_BACKWARD_NO_INTERRUPT",
-        "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE",
-        "POP_JUMP_IF_NONE", "POP_JUMP_IF_NOT_NONE",
-        # Coroutine exception handling
-        "CLEANUP_THROW",
-        # Subscript
-        "BINARY_SUBSCR", "STORE_SUBSCR", "DELETE_SUBSCR",
-        # Iteration
-        "GET_ITER", "FOR_ITER", "END_FOR",
-        # Closures
-        "LOAD_DEREF", "STORE_DEREF", "COPY_FREE_VARS", "MAKE_CELL",
-        # Async with
-        "BEFORE_ASYNC_WITH",
-        # Class support
-        "SETUP_ANNOTATIONS", "EXIT_INIT_CHECK",
-    }
-    
-    # Note: All opcodes are now supported - full Python 3.13 coverage
-    return True
-
-
 def _create_coroutine_wrapper(func, opt_level):
     """Create a JIT-compiled wrapper for an async function (coroutine).
     
@@ -538,19 +1962,19 @@ def _create_coroutine_wrapper(func, opt_level):
     import functools
     import warnings
     
-    # Check if this coroutine is simple enough for JIT compilation
-    if not _is_simple_coroutine(func):
-        # Complex coroutine - fall back to Python for safety
+    unsupported = _unsupported_generator_opcodes(_instructions(func))
+    if unsupported:
         warnings.warn(
-            f"Async function '{func.__name__}' uses opcodes not yet supported by JIT. "
-            f"Using Python implementation.",
+            f"Async function '{func.__name__}' uses opcodes not yet supported by JIT "
+            f"({', '.join(unsupported)}). Using Python implementation.",
             RuntimeWarning,
-            stacklevel=4,
+            stacklevel=2,
         )
         return func
     
     jit_instance = JIT()
     jit_instance.set_opt_level(opt_level)
+    _note_source(jit_instance, func)
     
     instructions = _extract_bytecode(func)
     constants = _extract_constants(func)
@@ -558,7 +1982,7 @@ def _create_coroutine_wrapper(func, opt_level):
     globals_dict = _extract_globals(func)
     builtins_dict = _extract_builtins(func)
     closure_cells = _extract_closure(func)
-    exception_table = _parse_exception_table(func)
+    exception_table = func.__code__  # co_exceptiontable, decoded natively
     
     param_count = func.__code__.co_argcount
     nlocals = func.__code__.co_nlocals
@@ -566,9 +1990,8 @@ def _create_coroutine_wrapper(func, opt_level):
     num_freevars = len(func.__code__.co_freevars)
     base_locals = nlocals + num_cellvars + num_freevars
     
-    # For coroutines, we need extra slots for stack persistence across awaits
-    max_stack_depth = func.__code__.co_stacksize
-    total_locals = base_locals + max_stack_depth
+    # Spill slots for stack values live across awaits are added by compile_generator
+    total_locals = base_locals
     
     # Compile the coroutine to a step function (same as generator)
     success = jit_instance.compile_generator(
@@ -590,7 +2013,7 @@ def _create_coroutine_wrapper(func, opt_level):
             f"Failed to JIT compile async function '{func.__name__}'. "
             f"Falling back to Python implementation.",
             RuntimeWarning,
-            stacklevel=4,
+            stacklevel=2,
         )
         return func
     
@@ -611,28 +2034,11 @@ def _create_coroutine_wrapper(func, opt_level):
     coro_name = coro_info["name"]
     coro_qualname = coro_info["qualname"]
     
-    @functools.wraps(func)
-    def coroutine_factory(*args, **kwargs):
-        """Factory function that creates a new JIT coroutine each time it's called."""
-        if kwargs:
-            # For simplicity, don't support kwargs in coroutines yet
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a new JIT coroutine
-        coro = create_jit_coroutine(step_func_addr, num_locals, coro_name, coro_qualname)
-        
-        # Store arguments in the coroutine's locals array
-        for i, arg in enumerate(args):
-            coro._set_local(i, arg)
-        
-        return coro
-    
+    # Native factory, as for generators
+    coroutine_factory = create_generator_factory(
+        step_func_addr, num_locals, func, coro_name, coro_qualname, "coroutine", jit_instance
+    )
+    functools.update_wrapper(coroutine_factory, func)
     coroutine_factory._jit_instance = jit_instance
     coroutine_factory._original_func = func
     coroutine_factory._instructions = instructions
@@ -662,9 +2068,20 @@ def _create_async_generator_wrapper(func, opt_level):
     import functools
     import warnings
     
+    unsupported = _unsupported_generator_opcodes(_instructions(func))
+    if unsupported:
+        warnings.warn(
+            f"Async generator '{func.__name__}' uses opcodes not yet supported by JIT "
+            f"({', '.join(unsupported)}). Using Python implementation.",
+            RuntimeWarning,
+            stacklevel=2,
+        )
+        return func
+
     # Compile using the generator compilation path
     jit_instance = JIT()
     jit_instance.set_opt_level(opt_level)
+    _note_source(jit_instance, func)
     
     instructions = _extract_bytecode(func)
     constants = _extract_constants(func)
@@ -672,15 +2089,15 @@ def _create_async_generator_wrapper(func, opt_level):
     globals_dict = _extract_globals(func)
     builtins_dict = _extract_builtins(func)
     closure_cells = _extract_closure(func)
-    exception_table = _parse_exception_table(func)
+    exception_table = func.__code__  # co_exceptiontable, decoded natively
     
     param_count = func.__code__.co_argcount
     nlocals = func.__code__.co_nlocals
     num_cellvars = len(func.__code__.co_cellvars)
     num_freevars = len(func.__code__.co_freevars)
     base_locals = nlocals + num_cellvars + num_freevars
-    stack_size = func.__code__.co_stacksize
-    total_locals = base_locals + stack_size + 10
+    # Spill slots for stack values live across yields/awaits are added by compile_generator
+    total_locals = base_locals
     
     # Compile the async generator to a step function
     success = jit_instance.compile_generator(
@@ -702,7 +2119,7 @@ def _create_async_generator_wrapper(func, opt_level):
             f"Failed to JIT compile async generator '{func.__name__}'. "
             f"Using Python implementation.",
             RuntimeWarning,
-            stacklevel=4,
+            stacklevel=2,
         )
         return func
     
@@ -723,30 +2140,12 @@ def _create_async_generator_wrapper(func, opt_level):
     gen_name = gen_info["name"]
     gen_qualname = gen_info["qualname"]
     
-    @functools.wraps(func)
-    def async_generator_factory(*args, **kwargs):
-        """Factory function that creates a new async generator each time it's called."""
-        if kwargs:
-            # Fall back for kwargs (complex case)
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a JIT generator as the underlying implementation
-        # The async generator protocol is handled by wrapping this
-        gen = create_jit_generator(step_func_addr, num_locals, gen_name, gen_qualname)
-        
-        # Store arguments in the generator's locals array
-        for i, arg in enumerate(args):
-            gen._set_local(i, arg)
-        
-        # Wrap in an async generator adapter
-        return _AsyncGeneratorAdapter(gen, gen_name, gen_qualname)
-    
+    # Native factory: a JITAsyncGenerator around a JIT generator whose
+    # yields are wrapped, with native __anext__/asend/athrow/aclose awaitables
+    async_generator_factory = create_generator_factory(
+        step_func_addr, num_locals, func, gen_name, gen_qualname, "async_generator", jit_instance
+    )
+    functools.update_wrapper(async_generator_factory, func)
     async_generator_factory._jit_instance = jit_instance
     async_generator_factory._original_func = func
     async_generator_factory._instructions = instructions
@@ -756,318 +2155,2269 @@ def _create_async_generator_wrapper(func, opt_level):
     return async_generator_factory
 
 
-class _AsyncGeneratorAdapter:
-    """Adapter that wraps a JIT generator to implement the async generator protocol.
-    
-    This provides the asynchronous iteration interface (__aiter__, __anext__, etc.)
-    on top of a synchronous JIT-compiled generator.
+class _LazyJITWrapper:
+    """
+    Compile-on-first-call stub for ``@jit(lazy=True)`` (the default).
+
+    Decoration only records the function; bytecode decoding, opcode
+    screening and JIT instance creation happen when the stub is first called
+    (or one of the wrapper attributes is read), after which every call is
+    forwarded to the real wrapper. A module-level function's global name is
+    then rebound to the real wrapper, so calls through it skip the stub.
+    """
+
+    def __init__(self, func, build, mode):
+        self._func = func
+        self._build = build
+        self._jit_mode = mode
+        self._target = None
+        self._lock = threading.Lock()
+        self.__name__ = func.__name__
+        self.__qualname__ = func.__qualname__
+        self.__doc__ = func.__doc__
+        self.__wrapped__ = func
+
+    def _materialize(self):
+        target = self._target
+        if target is None:
+            with self._lock:
+                target = self._build_locked()
+        return target
+
+    def _try_materialize(self):
+        """Like _materialize, but None while this or another thread is building."""
+        target = self._target
+        if target is None:
+            if not self._lock.acquire(blocking=False):
+                return None
+            try:
+                target = self._build_locked()
+            finally:
+                self._lock.release()
+        return target
+
+    def _build_locked(self):
+        target = self._target
+        if target is None:
+            target = self._build()
+            self._target = target
+            func = self._func
+            if func.__qualname__ == func.__name__ and func.__globals__.get(func.__name__) is self:
+                func.__globals__[func.__name__] = target
+        return target
+
+    def __call__(self, *args, **kwargs):
+        target = self._target
+        if target is None:
+            target = self._materialize()
+        return target(*args, **kwargs)
+
+    def _warmup(self):
+        """Build the real wrapper and compile it if it can be; see compile_all."""
+        pending = self._target is None
+        warmup = getattr(self._materialize(), "_warmup", None)
+        return (warmup() if warmup is not None else False) or pending
+
+    def __get__(self, obj, objtype=None):
+        if obj is None:
+            return self
+        return types.MethodType(self, obj)
+
+    def __getattr__(self, attr):
+        # Only reached for attributes not set in __init__ (_jit_instance, _mode, ...)
+        if attr.startswith("__"):
+            raise AttributeError(attr)
+        return getattr(self._materialize(), attr)
+
+    def __repr__(self):
+        state = "compiled" if self._target is not None else "pending"
+        return f"<lazy jit function {self.__qualname__} ({state})>"
+
+
+# mode='ndarray': element formats a kernel can load and store, and the
+# builtins it lowers (prange runs serially here)
+_NDARRAY_DTYPES = frozenset("dfeEqihHbB")
+_NDARRAY_MAX_DIMS = 4
+_NDARRAY_BUILTINS = ("range", "prange", "abs", "min", "max", "sum", "int", "float", "len", "ord")
+
+
+def _item_format(view):
+    """Native-order struct format of ``view``'s items ('l' as 'q' or 'i')."""
+    fmt = view.format
+    if fmt[:1] in ("@", "=") or (fmt[:1] == "<" and sys.byteorder == "little"):
+        fmt = fmt[1:]
+    if fmt == "l":
+        fmt = "q" if view.itemsize == 8 else "i"
+    return fmt
+
+
+def _ndarray_param_kind(value):
+    """Signature token of one ndarray-mode argument (see JIT.compile_ndarray), or None."""
+    if type(value) is bool:
+        return "?"
+    if type(value) is int:
+        return "q"
+    if type(value) is float:
+        return "d"
+    if type(value) is str:
+        return "U"
+    record = getattr(type(value), "_jit_record", None)
+    if record is not None:
+        return record
+    if type(value) is TypedList:
+        return "L" + value.kind
+    if type(value) is TypedDict:
+        return "M" + value.value_kind
+    if type(value) in (list, tuple):
+        fmt = _sequence_item_format(value)
+        return None if fmt is None else "C" + fmt + "1"
+    try:
+        view = _array_view(value)
+    except TypeError:
+        return None
+    with view:
+        fmt = _item_format(view)
+        if fmt not in _NDARRAY_DTYPES or not 1 <= view.ndim <= _NDARRAY_MAX_DIMS:
+            return None
+        return ("C" if view.c_contiguous else "S") + fmt + str(view.ndim)
+
+
+def _sequence_item_format(seq):
+    """'d' for a list or tuple of floats, 'q' of int64 ints, else None.
+
+    ndarray kernels read such a sequence as a 1-D array: the call unboxes
+    its items natively into scratch memory. An empty one is float64.
+    """
+    if all(type(item) is float for item in seq):
+        return "d"
+    if all(type(item) is int and -(2**63) <= item < 2**63 for item in seq):
+        return "q"
+    return None
+
+
+def _ptr_elem_kind(value):
+    """Element format mode='ptr' compiles for array argument ``value``, or None."""
+    if type(value) is int:
+        return "d"  # a raw address is float64 data
+    try:
+        view = _array_view(value)
+    except TypeError:
+        return None
+    with view:
+        fmt = _item_format(view)
+    return fmt if fmt in _NDARRAY_DTYPES else None
+
+
+def _arrow_column(value):
+    """``value`` as an ArrowColumn when it exports a primitive Arrow array, else ``value``."""
+    if type(value) is ArrowColumn or not hasattr(type(value), "__arrow_c_array__"):
+        return value
+    try:
+        return ArrowColumn.from_arrow(value)
+    except TypeError:
+        return value
+
+
+def _create_ndarray_wrapper(func, jit_instance, instrs, instructions, constants, names, param_count, total_locals,
+                            mode="ndarray"):
+    """Wrapper for mode='ndarray': one native specialization per argument layout.
+
+    The first call with a new combination of dtypes, dimensions and layouts
+    compiles ``<name>__nd<k>`` for it. Arguments no specialization can take
+    (other types, keywords, a read-only array the kernel writes) run ``func``.
+    mode='mixed' is the same with bool, int and float arguments only: one
+    ``<name>__mx<k>`` per combination of their types.
+
+    When the kernel stores into its last parameter, a call may leave that
+    argument out (or pass it by keyword): it is allocated with ``zeros_like``
+    of the first array argument and returned when the kernel returns None.
+
+    Arrow arrays (anything with ``__arrow_c_array__``) are taken as
+    ArrowColumns: the kernel runs over their values buffers, a missing
+    output is an ArrowColumn, and the output's rows become null wherever
+    an input column's are.
+    """
+    import functools
+    import warnings
+
+    for instr in instrs:
+        if instr.opname != "LOAD_GLOBAL":
+            continue
+        name = instr.argval
+        if name in ("range", "prange"):
+            native = _is_native_range_global(func, name)
+        elif _math_global(func, name) is not None:
+            native = True  # math.<fn>(...) calls lower natively
+        else:
+            native = name in _NDARRAY_BUILTINS and name not in func.__globals__
+        if not native:
+            warnings.warn(
+                f"Function '{func.__name__}' uses global '{name}', which mode='{mode}' cannot "
+                f"compile. The @jit decorator has no effect on this function.",
+                RuntimeWarning,
+                stacklevel=4,
+            )
+            return func
+
+    math_names = _math_names(func, names)
+    out_name = func.__code__.co_varnames[param_count - 1] if param_count else None
+
+    # Signature -> callable, or None when that layout failed to compile
+    specializations = {}
+    # Signature -> bit mask of the parameters that specialization stores into
+    written = {}
+    lock = threading.Lock()
+    last = [None]
+
+    def _specialize(args):
+        kinds = [_ndarray_param_kind(a) for a in args]
+        if None in kinds or (mode == "mixed" and any(k not in ("?", "q", "d") for k in kinds)):
+            return None
+        signature = "".join(kinds)
+        entry = specializations.get(signature)
+        if entry is None and signature not in specializations:
+            with lock:
+                if signature not in specializations:
+                    suffix = "mx" if mode == "mixed" else "nd"
+                    name = f"{func.__name__}__{suffix}{len(specializations)}"
+                    entry = None
+                    if jit_instance.compile_ndarray(instructions, constants, math_names, name,
+                                                    param_count, total_locals, signature):
+                        entry = jit_instance.get_ndarray_callable(name, signature)
+                        written[signature] = jit_instance.get_ndarray_written(name)
+                        wrapper._ndarray_signature = signature
+                    specializations[signature] = entry
+                entry = specializations[signature]
+        return entry
+
+    missing = object()
+
+    def _call_allocating(args):
+        """Run with the last (output) argument allocated, or ``missing``."""
+        template = next((a for a in args if (_ndarray_param_kind(a) or "")[:1] in ("C", "S")), None)
+        if template is None:
+            return missing
+        out = zeros_like(template)
+        full = args + (out,)
+        entry = _specialize(full)
+        if entry is None:
+            return missing
+        signature = "".join(_ndarray_param_kind(a) for a in full)
+        if not (written.get(signature, 0) >> (param_count - 1)) & 1:
+            return missing
+        try:
+            result = entry(*full)
+        except TypeError:
+            return missing
+        return out if result is None else result
+
+    def _call_arrow(args):
+        """Run on Arrow arguments: their values buffers, nulls ANDed into the output."""
+        args = tuple(_arrow_column(a) for a in args)
+        if len(args) == param_count - 1:
+            template = next((a for a in args if type(a) is ArrowColumn), None)
+            if template is None:
+                return _call(args, {})
+            args = args + (ArrowColumn(template.format, len(template)),)
+        out = args[-1] if len(args) == param_count else None
+        result = _call(args, {})
+        if type(out) is ArrowColumn and out.writable:
+            out.propagate_validity(args[:-1])
+        return out if result is None and out is not None else result
+
+    @functools.wraps(func)
+    def wrapper(*args, **kwargs):
+        if not kwargs:
+            for a in args:
+                if hasattr(type(a), "__arrow_c_array__"):
+                    return _call_arrow(args)
+        return _call(args, kwargs)
+
+    def _call(args, kwargs):
+        if len(kwargs) == 1 and out_name in kwargs and len(args) == param_count - 1:
+            args = args + (kwargs.pop(out_name),)
+        if not kwargs and len(args) == param_count - 1:
+            result = _call_allocating(args)
+            if result is not missing:
+                return result
+        if not kwargs and len(args) == param_count:
+            entry = last[0]
+            if entry is not None:
+                try:
+                    return entry(*args)
+                except TypeError:
+                    pass
+            entry = _specialize(args)
+            if entry is not None:
+                last[0] = entry
+                try:
+                    return entry(*args)
+                except TypeError:
+                    pass
+        return func(*args, **kwargs)
+
+    wrapper._jit_instance = jit_instance
+    wrapper._original_func = func
+    wrapper._instructions = instructions
+    wrapper._mode = mode
+    wrapper._ndarray_signature = None
+    wrapper._ndarray_specializations = specializations
+    return wrapper
+
+
+def _create_static_dispatcher(func, static_args, build):
+    """Wrapper for static_args=: one compiled variant per distinct value of those parameters.
+
+    ``build(static_values=...)`` compiles a variant with the values folded
+    in. Values are told apart by type too (1, 1.0 and True are three
+    variants); anything but an int64, float or bool runs ``func``.
+    """
+    import functools
+
+    code = func.__code__
+    if isinstance(static_args, str):
+        static_args = (static_args,)
+    positional = code.co_varnames[:code.co_argcount]
+    indices = []
+    for name in static_args:
+        if name not in positional:
+            raise ValueError(f"static_args: '{name}' is not a positional parameter of '{func.__name__}'")
+        indices.append(positional.index(name))
+    signature = inspect.signature(func)
+    variants = collections.OrderedDict()
+    lock = threading.Lock()
+
+    def _static(value):
+        if type(value) is int:
+            return -(2**63) <= value < 2**63
+        return type(value) in (float, bool)
+
+    def _variant_for(values):
+        """The variant for these static values, built if needed."""
+        # float.hex keeps -0.0 apart from 0.0 and makes NaNs one key
+        key = tuple((type(v), v.hex() if type(v) is float else v) for v in values)
+        with lock:
+            variant = variants.get(key)
+            if variant is not None:
+                variants.move_to_end(key)
+        if variant is None:
+            built = build(static_values=tuple(zip(indices, values)))
+            with lock:
+                variant = variants.setdefault(key, built)
+                variants.move_to_end(key)
+                while len(variants) > _STATIC_VARIANT_LIMIT:
+                    variants.popitem(last=False)
+        return variant
+
+    @functools.wraps(func)
+    def dispatcher(*args, **kwargs):
+        if kwargs or len(args) != code.co_argcount:
+            try:
+                bound = signature.bind(*args, **kwargs)
+            except TypeError:
+                return func(*args, **kwargs)
+            bound.apply_defaults()
+            values = tuple(bound.arguments[positional[i]] for i in indices)
+        else:
+            values = tuple(args[i] for i in indices)
+        if not all(_static(v) for v in values):
+            return func(*args, **kwargs)
+        return _variant_for(values)(*args, **kwargs)
+
+    def _warm_static(values):
+        """Build the variant for ``values`` ahead of its first call (see warmup)."""
+        values = tuple(values)
+        if len(values) == len(indices) and all(_static(v) for v in values):
+            _variant_for(values)
+            return True
+        return False
+
+    dispatcher._original_func = func
+    dispatcher._static_args = tuple(static_args)
+    dispatcher._warm_static = _warm_static
+    dispatcher.static_variants = variants
+    return dispatcher
+
+
+# Object-mode bodies compiled once per process for every function with the
+# same code, constants and globals (see _shared_body_key): key -> (JIT
+# instance, symbol, callees its code calls), or None while the only closure
+# of that code seen so far has its cells compiled in
+_SHARED_BODIES = {}
+_SHARED_BODIES_LOCK = threading.Lock()
+
+
+def _const_key(value):
+    """``value`` as part of a _shared_body_key: constants with equal keys are interchangeable.
+
+    Keys carry the type (1, 1.0 and True compare equal), and floats go by
+    repr so that 0.0 and -0.0 (and NaNs) stay apart.
+    """
+    if type(value) is tuple:
+        return (tuple, tuple(_const_key(item) for item in value))
+    if type(value) is frozenset:
+        return (frozenset, frozenset(_const_key(item) for item in value))
+    if type(value) in (float, complex):
+        return (type(value), repr(value))
+    return (type(value), value)
+
+
+def _shared_body_key(func, options):
+    """Key under which ``func``'s object-mode body can serve other functions.
+
+    Functions share a body when their code and constants match and they
+    run against the same globals; defaults and closure cells stay theirs,
+    bound by each function's own native entry. ``options`` are the compile
+    options that shape the code.
+    """
+    code = func.__code__
+    return (
+        code.co_code, _const_key(code.co_consts), code.co_names, code.co_varnames,
+        code.co_cellvars, code.co_freevars, code.co_exceptiontable, code.co_name,
+        code.co_argcount, code.co_posonlyargcount, code.co_kwonlyargcount, code.co_flags,
+        id(func.__globals__), options,
+    )
+
+
+def _shared_object_body(key, func, param_count, target):
+    """Native entry for ``func`` on the body already compiled under ``key``, or None to compile.
+
+    A closure's first compile bakes its cells in, as usual. The second
+    closure of the same code compiles ``target`` with entry closures
+    instead (see JIT.set_entry_closures), and every later one shares that.
+    """
+    with _SHARED_BODIES_LOCK:
+        body = _SHARED_BODIES.get(key, _SHARED_BODIES)
+        if body is _SHARED_BODIES:
+            if func.__code__.co_freevars:
+                _SHARED_BODIES[key] = None
+            return None
+        if body is None:
+            target.set_entry_closures(True)
+            return None
+    owner, name, _ = body
+    return owner.get_native_function(name, param_count, "object", func)
+
+
+def _share_object_body(key, func, target, keep):
+    """Offer the body just compiled into ``target`` to later functions with the same ``key``.
+
+    The offer lasts as long as ``func``: the registry never keeps a JIT
+    instance alive on its own.
+    """
+    if func.__code__.co_freevars and not target.get_entry_closures():
+        return  # Its cells are compiled in
+    body = (target, func.__name__, keep)
+    with _SHARED_BODIES_LOCK:
+        _SHARED_BODIES[key] = body
+    weakref.finalize(func, _forget_object_body, key, body)
+
+
+def _forget_object_body(key, body):
+    with _SHARED_BODIES_LOCK:
+        if _SHARED_BODIES.get(key) is body:
+            del _SHARED_BODIES[key]
+
+
+def _create_jit_wrapper(
+    func, opt_level, vectorize, inline, parallel, lazy, mode="auto", background=False,
+    tier_up_threshold=None, target_cpu="native", target_features="native", unroll=0,
+    nogil=False, fastmath=False, vector_library="none", checked=True, static_args=None,
+    static_values=(), boundscheck=None, poll=None, max_bytecode_size=None, max_compile_ms=None,
+    target="cpu",
+):
+    """Create a JIT-compiled wrapper for the given function.
+
+    ``static_values`` holds the (param index, value) pairs of one
+    static_args variant (see _create_static_dispatcher).
+    """
+    import warnings
+    import functools
+
+    _check_budget(max_bytecode_size, max_compile_ms)
+    device = _check_device(target)
+    if static_args:
+        return _create_static_dispatcher(
+            func, static_args,
+            functools.partial(
+                _create_jit_wrapper, func, opt_level, vectorize, inline, parallel,
+                False, mode, background, tier_up_threshold, target_cpu, target_features,
+                unroll, nogil, fastmath, vector_library, checked, boundscheck=boundscheck,
+                poll=poll, max_bytecode_size=max_bytecode_size, max_compile_ms=max_compile_ms,
+                target=device,
+            ),
+        )
+    if lazy is None:
+        lazy = _LAZY_DEFAULT
+    if lazy:
+        return _LazyJITWrapper(
+            func,
+            functools.partial(
+                _create_jit_wrapper, func, opt_level, vectorize, inline, parallel,
+                False, mode, background, tier_up_threshold, target_cpu, target_features,
+                unroll, nogil, fastmath, vector_library, checked, boundscheck=boundscheck,
+                poll=poll, max_bytecode_size=max_bytecode_size, max_compile_ms=max_compile_ms,
+                target=device,
+            ),
+            mode,
+        )
+
+    # Check if this is a generator function
+    is_generator = _is_generator_or_coroutine(func)
+    
+    # Handle coroutines (async def functions)
+    flags = func.__code__.co_flags
+    if flags & _CO_COROUTINE:
+        # Regular coroutine (async def without yield)
+        return _create_coroutine_wrapper(func, opt_level)
+    
+    # Async generators (async def with yield) - now supported
+    if flags & _CO_ASYNC_GENERATOR:
+        return _create_async_generator_wrapper(func, opt_level)
+
+    # Decode the bytecode once; the screening and mode passes below share it
+    instrs = _instructions(func)
+
+    # Check bytecode for unsupported opcodes
+    unsupported = _has_unsupported_opcodes(instrs)
+    if unsupported == "exception":
+        # Bug #3 Fix: Detect exception handling and skip JIT compilation
+        warnings.warn(
+            f"Function '{func.__name__}' uses unsupported exception constructs. "
+            f"The @jit decorator has no effect on this function.",
+            RuntimeWarning,
+            stacklevel=3,
+        )
+        return func
+    if unsupported == "intrinsic":
+        # Block functions using unsupported intrinsics (import *, type annotations)
+        warnings.warn(
+            f"Function '{func.__name__}' uses unsupported intrinsic operations "
+            f"(import * or type annotations). The @jit decorator has no effect.",
+            RuntimeWarning,
+            stacklevel=3,
+        )
+        return func
+    if unsupported == "pattern_matching":
+        # Structural pattern matching has complex control flow
+        warnings.warn(
+            f"Function '{func.__name__}' uses structural pattern matching "
+            f"(match/case with class/mapping/sequence patterns). "
+            f"The @jit decorator has no effect. Literal matching works fine.",
+            RuntimeWarning,
+            stacklevel=3,
+        )
+        return func
+    
+    if mode == "uint64":
+        # Native results wrap mod 2**64; code must not let that show
+        problems = _uint64_range_problems(func)
+        if problems:
+            raise TypeError(
+                f"uint64 function '{func.__name__}' uses values the interpreter computes outside "
+                f"0..2**64-1 ({'; '.join(problems)}); mask them with & 0xFFFFFFFFFFFFFFFF or % 2**64"
+            )
+
+    # Size budget: the baseline optimizer only, and no tier-up that would
+    # rerun the full pipeline later (stats report budget='size')
+    over_size = max_bytecode_size is not None and _bytecode_size(func.__code__) > max_bytecode_size
+    if over_size:
+        opt_level = min(opt_level, _TIER0_OPT_LEVEL)
+
+    # For generators, compile using the generator compilation path
+    if is_generator:
+        return _create_generator_wrapper(func, opt_level, mode, instrs)
+
+    # Tiered compilation: the first compile is a cheap baseline; the function
+    # is recompiled at opt_level once it has been called tier_up_threshold times
+    tiered = tier_up_threshold is not None and opt_level > _TIER0_OPT_LEVEL
+    # Object code another function already compiled for the same body is
+    # reused (see _shared_body_key); tiered functions profile their own
+    body_key = None if tiered else _shared_body_key(func, (
+        opt_level, vectorize, inline, unroll, parallel, nogil, checked, tuple(_fastmath_flags(fastmath)),
+        vector_library, boundscheck, _poll_interval(poll), _resolve_target(target_cpu, target_features),
+    ))
+
+    jit_instance = JIT()
+    jit_instance.set_opt_level(_TIER0_OPT_LEVEL if tiered else opt_level)
+    jit_instance.set_target(*_resolve_target(target_cpu, target_features))
+    jit_instance.set_pipeline_options(vectorize, inline, unroll)
+    jit_instance.set_parallel(parallel)
+    jit_instance.set_nogil(nogil)
+    jit_instance.set_overflow_checks(checked)
+    jit_instance.set_fastmath(_fastmath_flags(fastmath))
+    jit_instance.set_vector_library(vector_library)
+    jit_instance.set_static_args(list(static_values))
+    jit_instance.set_bounds_checks(_BOUNDS_CHECK_LEVELS[boundscheck])
+    jit_instance.set_poll_interval(_poll_interval(poll))
+    jit_instance.set_budget_note("size" if over_size else "")
+
+    instructions = _extract_bytecode(func)
+    constants = _extract_constants(func)
+    names = _extract_names(func)
+    math_names = _math_names(func, names)  # typed modes: math.<fn> calls
+    globals_dict = _extract_globals(func)  # Now returns the dict itself
+    builtins_dict = _extract_builtins(func)  # For fallback lookup
+    closure_cells = _extract_closure(func)
+    exception_table = func.__code__  # Bug #3 Fix: co_exceptiontable, decoded natively
+    param_count = func.__code__.co_argcount
+    # Object mode takes every argument slot (keyword-only, *args, **kwargs);
+    # the native entry binds keywords and defaults into them.
+    object_param_count = _param_slot_count(func.__code__)
+    # prange() loops the typed backends may run on the thread pool
+    prange_offsets = _prange_loop_offsets(func, instrs) if parallel else []
+
+    # Calculate local slot layout:
+    # - nlocals: number of local variables (co_nlocals)
+    # - cellvars: variables captured by nested functions (co_cellvars)
+    # - freevars: variables from enclosing scope (co_freevars)
+    # - total_locals: nlocals + len(cellvars) + len(freevars)
+    nlocals = func.__code__.co_nlocals
+    num_cellvars = len(func.__code__.co_cellvars)
+    num_freevars = len(func.__code__.co_freevars)
+    total_locals = nlocals + num_cellvars + num_freevars
+
+    if mode in ("ndarray", "mixed"):
+        # Specializations follow the argument layouts, compiled on first use
+        return _create_ndarray_wrapper(func, jit_instance, instrs, instructions, constants, names,
+                                       param_count, total_locals, mode)
+
+    # Determine compilation mode. 'auto' stays object mode unless the static
+    # pass admits a typed mode; the first call's argument types then decide.
+    auto_modes = _infer_auto_modes(func, instrs) if mode == "auto" else ()
+    auto_pending = bool(auto_modes)
+    vec_mode = _vec_mode(mode)
+    if vec_mode is not None and vec_mode[0] is None:
+        # 'vecf' etc.: as many lanes as fill a vector register of the target
+        mode = f"vec{jit_instance.native_vector_lanes(vec_mode[1])}{vec_mode[1]}"
+    selected_mode = mode if mode in _TYPED_MODES or vec_mode is not None else "object"
+    # Exact argument types the auto-selected typed entry was chosen for
+    auto_arg_types = None
+
+    # The baseline tier records operand types for the hot tier (object mode only)
+    if tiered:
+        jit_instance.set_profiling(True)
+
+    def _compile(target):
+        """Compile into ``target`` for the selected mode; returns the native callable or None."""
+        nonlocal selected_mode, auto_arg_types
+        # Native entries rerun deopted calls in ``func`` themselves
+        fallback = func if selected_mode in _NATIVE_ENTRY_MODES else None
+        native = _compile_as(target, selected_mode, fallback)
+        if native is None and mode == "auto" and selected_mode != "object":
+            # The typed backend rejected the function (e.g. a range() form it
+            # cannot lower). A failed typed compile adds nothing to the dylib,
+            # so object mode can take the same name.
+            selected_mode = wrapper._mode = "object"
+            auto_arg_types = None
+            native = _compile_as(target, "object", func)
+        return native
+
+    # Counts behind justjit.counters(); native entries keep their own call
+    # counts, merged in from native_entries
+    counters = dict.fromkeys(_WRAPPER_COUNTERS, 0)
+    native_entries = []
+    # Native entries of the @jit functions our int, float or object code
+    # calls by address: they must outlive it
+    jit_callees = []
+    # Complex modes: (map, reduce) batch callables, by mode
+    batch_entries = {}
+
+    def _compile_as(target, m, fallback=None):
+        """Compile into ``target`` in mode ``m``; returns the native callable or None.
+
+        With ``fallback`` only a vectorcall native entry is returned; it hands
+        arguments it cannot take to ``fallback``.
+        """
+        counters["compile_attempts"] += 1
+        native = None
+        try:
+            native = _compile_mode(target, m, fallback)
+        finally:
+            if native is None:
+                counters["compile_failures"] += 1
+        if hasattr(type(native), "counters"):
+            native_entries.append(native)
+        return native
+
+    def _compile_mode(target, m, fallback):
+        """Body of ``_compile_as``."""
+        _note_source(target, func)
+        if m in ("int", "float") and prange_offsets:
+            target.set_parallel_loops(func.__name__, prange_offsets)
+        if m == "int":
+            # Integer mode - pure native i64 operations
+            success = target.compile_int(
+                instructions, constants, func.__name__, param_count, total_locals,
+                _typed_names(func, names, m, instrs, jit_callees),
+            )
+            if not success:
+                return None
+            if prange_offsets:
+                _warn_serial_pranges(target, func, prange_offsets)
+            native = target.get_native_function(func.__name__, param_count, "int", fallback)
+            if native is not None and device == "cuda":
+                _offload_batches(native, target, func.__name__, param_count, m)
+            if native is not None or fallback is not None:
+                return native
+            return target.get_int_callable(func.__name__, param_count)
+        elif m == "uint64":
+            # uint64 mode - i64 registers, wrapping unsigned operations
+            success = target.compile_uint64(
+                instructions, constants, func.__name__, param_count, total_locals,
+                _typed_names(func, names, m, instrs, jit_callees),
+            )
+            if not success:
+                return None
+            return target.get_native_function(func.__name__, param_count, "uint64", fallback)
+        elif m == "float":
+            # Float mode - pure native f64 operations
+            success = target.compile_float(
+                instructions, constants, func.__name__, param_count, total_locals,
+                _typed_names(func, names, m, instrs, jit_callees),
+            )
+            if not success:
+                return None
+            if prange_offsets:
+                _warn_serial_pranges(target, func, prange_offsets)
+            native = target.get_native_function(func.__name__, param_count, "float", fallback)
+            if native is not None and device == "cuda":
+                _offload_batches(native, target, func.__name__, param_count, m)
+            if native is not None or fallback is not None:
+                return native
+            return target.get_float_callable(func.__name__, param_count)
+        elif m == "bool":
+            # Bool mode - pure native boolean operations
+            success = target.compile_bool(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            native = target.get_native_function(func.__name__, param_count, "bool", fallback)
+            if native is not None or fallback is not None:
+                return native
+            return target.get_bool_callable(func.__name__, param_count)
+        elif m == "int32":
+            # Int32 mode - 32-bit integer for C interop
+            success = target.compile_int32(
+                instructions, constants, func.__name__, param_count, total_locals,
+                _typed_names(func, names, m, instrs, jit_callees),
+            )
+            if not success:
+                return None
+            return target.get_int32_callable(func.__name__, param_count)
+        elif m == "float32":
+            # Float32 mode - 32-bit float for SIMD/ML
+            success = target.compile_float32(
+                instructions, constants, func.__name__, param_count, total_locals, math_names
+            )
+            if not success:
+                return None
+            return target.get_float32_callable(func.__name__, param_count)
+        elif m == "complex128":
+            # Complex128 mode - native {double,double} struct for complex numbers
+            success = target.compile_complex128(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            batch_entries[m] = target.get_complex_batch(func.__name__, param_count, m)
+            return target.get_complex128_callable(func.__name__, param_count)
+        elif m == "ptr":
+            # Ptr mode - array element access via GEP, one symbol per element format
+            name = func.__name__ if ptr_elem_kind == "d" else f"{func.__name__}__ptr_{ptr_elem_kind}"
+            success = target.compile_ptr(
+                instructions, constants, name, param_count, total_locals, ptr_elem_kind
+            )
+            if not success:
+                return None
+            return target.get_ptr_callable(name, param_count, ptr_elem_kind)
+        elif _vec_mode(m) is not None:
+            # Vector mode - <lanes x kind> SIMD, run over whole arrays (vec4f, vec8i, ...)
+            lanes, kind = _vec_mode(m)
+            success = target.compile_vec(
+                instructions, constants, func.__name__, param_count, total_locals, kind, lanes
+            )
+            if not success:
+                return None
+            return target.get_vec_callable(func.__name__, param_count, kind, lanes)
+        elif m == "complex64":
+            # Complex64 mode - single-precision complex {float, float}
+            success = target.compile_complex64(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            batch_entries[m] = target.get_complex_batch(func.__name__, param_count, m)
+            return target.get_complex64_callable(func.__name__, param_count)
+        elif m == "optional_f64":
+            # Optional<f64> mode - nullable float64 {i1, f64}
+            success = target.compile_optional_f64(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return target.get_optional_f64_callable(func.__name__, param_count)
+        else:
+            # Object mode - handles Python objects with closure support
+            shared = body_key is not None and fallback is not None and target is jit_instance
+            if shared:
+                native = _shared_object_body(body_key, func, object_param_count, target)
+                if native is not None:
+                    return native
+            # Bug #4 Fix: Pass globals_dict and builtins_dict for runtime lookup
+            # Bug #3 Fix: Pass exception_table for try/except handling
+            success = target.compile(
+                instructions,
+                constants,
+                names,
+                globals_dict,
+                builtins_dict,
+                closure_cells,
+                exception_table,
+                func.__name__,
+                object_param_count,
+                total_locals,
+                nlocals,
+                _object_callees(func, instrs, jit_callees),
+            )
+            if not success:
+                return None
+            native = target.get_native_function(func.__name__, object_param_count, "object", fallback)
+            if shared and native is not None:
+                _share_object_body(body_key, func, target, jit_callees)
+            if native is not None or fallback is not None:
+                return native
+            return target.get_callable(func.__name__, object_param_count)
+
+    # mode='ptr': the element format the next compile targets, and the
+    # callable compiled for each format seen so far
+    ptr_elem_kind = "d"
+    ptr_entries = {}
+
+    def _ptr_entry(args):
+        """Ptr-mode callable for the element format of ``args[0]``, compiled on first use."""
+        nonlocal ptr_elem_kind
+        kind = _ptr_elem_kind(args[0]) if args else None
+        if kind is None:
+            return None
+        with transition_lock:
+            if kind not in ptr_entries:
+                ptr_elem_kind = kind
+                try:
+                    ptr_entries[kind] = _compile_as(jit_instance, "ptr")
+                except Exception:
+                    ptr_entries[kind] = None
+            return ptr_entries[kind]
+
+    compiled_ptr = None
+    compile_pending = False
+    # A background (or warmup) compile failed: calls stay interpreted instead
+    # of waiting on, or resubmitting, a compile that cannot succeed
+    compile_failed = False
+    # Guards the one-shot transitions below: without a GIL (3.13t) two
+    # threads can both see a pending flag still set
+    transition_lock = threading.Lock()
+    call_count = 0
+    tier_pending = tiered
+    # Every tier's JIT instance stays alive: a thread may still be executing
+    # the previous tier's code when the next one is swapped in
+    tier_instances = [jit_instance]
+
+    def _compile_failed():
+        """Record that the pending compile failed (_compile_as counted it)."""
+        nonlocal compile_pending, compile_failed
+        with transition_lock:
+            compile_failed = True
+            compile_pending = False
+
+    def _background_compile():
+        nonlocal compiled_ptr
+        try:
+            native = _compile(jit_instance)
+        except Exception:
+            native = None
+        if native is None:
+            _compile_failed()
+            return
+        # Single reference assignment: callers see either None or the
+        # finished callable, never a partially initialized one.
+        compiled_ptr = native
+
+    def _compile_within_budget():
+        """Compile on the worker, waiting at most max_compile_ms for it.
+
+        The worker publishes compiled_ptr itself. Past the budget the
+        compile is left running, compile_pending is set and calls take
+        the background path until it finishes.
+        """
+        nonlocal compile_pending
+        from concurrent.futures import TimeoutError as FutureTimeout
+
+        compile_pending = True
+        future = _get_compile_executor().submit(_background_compile)
+        try:
+            future.result(timeout=max_compile_ms / 1e3)
+        except FutureTimeout:
+            jit_instance.set_budget_note("deferred")
+            counters["budget_deferrals"] += 1
+            return
+        compile_pending = False
+
+    def _configured_jit():
+        """A new JIT instance with this function's options, at ``opt_level``."""
+        target = JIT()
+        target.set_opt_level(opt_level)
+        target.set_target(*_resolve_target(target_cpu, target_features))
+        target.set_pipeline_options(vectorize, inline, unroll)
+        target.set_parallel(parallel)
+        target.set_nogil(nogil)
+        target.set_overflow_checks(checked)
+        target.set_fastmath(_fastmath_flags(fastmath))
+        target.set_vector_library(vector_library)
+        target.set_static_args(list(static_values))
+        target.set_bounds_checks(_BOUNDS_CHECK_LEVELS[boundscheck])
+        target.set_poll_interval(_poll_interval(poll))
+        target.set_budget_note("size" if over_size else "")
+        return target
+
+    def _tier_up(speculate=True):
+        nonlocal compiled_ptr
+        hot_instance = _configured_jit()
+        # Specialize the hot tier on the operand types the baseline observed
+        if jit_instance.get_profiling():
+            hot_instance.set_type_feedback(func.__name__, jit_instance.get_type_feedback(func.__name__))
+            # ...and lay out and inline by the branch counts it saw
+            hot_instance.set_branch_profile(func.__name__, jit_instance.get_branch_profile(func.__name__))
+            # Sites that only saw one kind keep no generic path: a failed
+            # guard continues the call in the resume entry
+            hot_instance.set_speculation(speculate)
+        try:
+            native = _compile(hot_instance)
+        except Exception:
+            return
+        if native is None:
+            return
+        if hot_instance.get_deopt_sites(func.__name__):
+            resume = _resume_entry(hot_instance.get_deopt_sites(func.__name__))
+            if resume is None:
+                # A guard whose frame the generic code cannot restart from
+                return _tier_up(speculate=False)
+            native._deopt_resume = resume
+        tier_instances.append(hot_instance)
+        compiled_ptr = native
+
+    # Whether interpreted calls go through _osr_run; None until the first
+    osr_watched = None
+
+    # Loop header -> end of each loop a region compile can take; None until needed
+    loop_regions = None
+
+    def _compile_points(name, points, region_end=-1):
+        """Entry starting at ``points``, [(offset, stack depth), ...], in its own JIT instance, or None."""
+        counters["compile_attempts"] += 1
+        target = _configured_jit()
+        success = target.compile(
+            instructions, constants, names, globals_dict, builtins_dict, closure_cells,
+            exception_table, name, object_param_count, total_locals, nlocals,
+            _object_callees(func, instrs, jit_callees), osr_points=list(points), region_end=region_end,
+        )
+        if not success:
+            counters["compile_failures"] += 1
+            return None
+        tier_instances.append(target)
+        return target.get_osr_callable(name, [nlocals + depth for _, depth in points], _OSR_UNBOUND)
+
+    def _compile_osr(header):
+        """OSR entry of the loop at ``header``: takes the frame's locals, or None.
+
+        When the function does not compile from ``header`` on, the loop
+        alone may; see _compile_region.
+        """
+        entry = _compile_points(f"{func.__name__}__osr{header}", [(header, 0)])
+        if entry is None:
+            return _compile_region(header)
+        return functools.partial(entry, 0)
+
+    def _compile_region(header):
+        """Entry running only the loop at ``header`` (see _region_entry), or None."""
+        nonlocal loop_regions
+        if loop_regions is None:
+            loop_regions = dict(JIT.loop_regions(func.__code__))
+        end = loop_regions.get(header)
+        if end is None or _region_tail(func, header, ()) is None:
+            return None
+        entry = _compile_points(f"{func.__name__}__region{header}", [(header, 0)], end)
+        return None if entry is None else _region_entry(func, entry)
+
+    def _resume_entry(sites):
+        """Continues a call from the frame a failed guard at one of ``sites`` captured, or None.
+
+        Generic object code, compiled with one entry point per guard; after
+        _DEOPT_LIMIT failed guards the hot tier is rebuilt without speculation.
+        """
+        entry = _compile_points(f"{func.__name__}__resume", sites)
+        if entry is None:
+            return None
+        points = {offset: point for point, (offset, _) in enumerate(sites)}
+        failed = 0
+
+        def resume():
+            nonlocal failed
+            failed += 1
+            if failed == _DEOPT_LIMIT:
+                _get_compile_executor().submit(_tier_up, False)
+            offset, values = JIT.take_deopt_frame(_OSR_UNBOUND)
+            return entry(points[offset], values)
+
+        return resume
+
+    generic_ptr = None
+
+    def _generic_call(args, kwargs):
+        """Run a call whose argument types differ from the ones mode='auto' specialized on."""
+        nonlocal generic_ptr
+        if generic_ptr is None:
+            generic_instance = _configured_jit()
+            native = _compile_as(generic_instance, "object", func)
+            tier_instances.append(generic_instance)
+            generic_ptr = native if native is not None else func
+        return generic_ptr(*args, **kwargs)
+
+    def _warmup():
+        """Compile now unless already done or the first call must pick the mode."""
+        nonlocal compiled_ptr, compile_pending
+        if auto_pending or compiled_ptr is not None:
+            return False
+        if background:
+            with transition_lock:
+                if compile_pending:
+                    return False
+                compile_pending = True
+        try:
+            native = _compile(jit_instance)
+        except Exception:
+            native = None
+        if native is None:
+            if background:
+                _compile_failed()
+            return False
+        compiled_ptr = native
+        return True
+
+    def wrapper(*args, **kwargs):
+        nonlocal compiled_ptr, compile_pending, call_count, tier_pending
+        nonlocal auto_pending, selected_mode, auto_arg_types, osr_watched
+
+        selecting = False
+        if auto_pending:
+            with transition_lock:
+                selecting = auto_pending
+                if selecting:
+                    selected_mode = wrapper._mode = _select_auto_mode(auto_modes, args, kwargs)
+                    if selected_mode != "object":
+                        auto_arg_types = tuple(type(a) for a in args)
+                    auto_pending = False
+        if not selecting and auto_arg_types is not None and (
+            kwargs or tuple(type(a) for a in args) != auto_arg_types
+        ):
+            counters["generic_calls"] += 1
+            return _generic_call(args, kwargs)
+
+        if compiled_ptr is None:
+            if (background or compile_pending) and not compile_failed:
+                # Keep running the interpreter until the worker publishes
+                # the native callable (background=, or past max_compile_ms)
+                if not compile_pending:
+                    with transition_lock:
+                        submit = not compile_pending
+                        compile_pending = True
+                    if submit:
+                        _get_compile_executor().submit(_background_compile)
+                counters["fallback_pending"] += 1
+                if osr_watched is None:
+                    osr_watched = selected_mode == "object" and _osr_watch(func, _compile_osr)
+                if osr_watched:
+                    return _osr_run(func, args, kwargs, counters)
+                return func(*args, **kwargs)
+
+            if compile_failed:
+                # Failed on the worker; not retried on every call
+                pass
+            elif selected_mode == "ptr":
+                # Ptr mode specializes on the first call's element format
+                compiled_ptr = _ptr_entry(args)
+            elif max_compile_ms is None:
+                compiled_ptr = _compile(jit_instance)
+            else:
+                _compile_within_budget()
+                if compiled_ptr is None and compile_pending:
+                    counters["fallback_pending"] += 1
+                    return func(*args, **kwargs)
+            if compiled_ptr is None:
+                counters["fallback_compile_failure"] += 1
+                # Its hot loops may still compile on their own
+                if osr_watched is None:
+                    osr_watched = selected_mode == "object" and _osr_watch(func, _compile_osr)
+                if osr_watched:
+                    return _osr_run(func, args, kwargs, counters)
+                return func(*args, **kwargs)
+
+        if tier_pending:
+            call_count += 1
+            if call_count >= tier_up_threshold:
+                with transition_lock:
+                    submit = tier_pending
+                    tier_pending = False
+                if submit:
+                    _get_compile_executor().submit(_tier_up)
+
+        if selected_mode in _NATIVE_ENTRY_MODES:
+            # Deopts are rerun in ``func`` by the entry; genuine exceptions
+            # propagate from the single native run
+            return compiled_ptr(*args, **kwargs)
+        counters["native_calls"] += 1
+        try:
+            return compiled_ptr(*args, **kwargs)
+        except TypeError:
+            # The remaining typed helpers only raise for arguments they
+            # cannot convert; their compiled code never calls into Python
+            if selected_mode == "ptr" and not kwargs:
+                # Another element format: switch to (or compile) its entry
+                entry = _ptr_entry(args)
+                if entry is not None and entry is not compiled_ptr:
+                    compiled_ptr = entry
+                    try:
+                        return entry(*args)
+                    except TypeError:
+                        pass
+            counters["fallback_exception"] += 1
+            return func(*args, **kwargs)
+
+    # mode='auto' dispatcher: one variant per mode the argument types select,
+    # each in its own JIT instance (the first in jit_instance); signatures
+    # sharing a mode share its variant
+    variant_entries = {}
+    dispatch_signatures = set()
+
+    def _variant(m):
+        """Callable for mode ``m``, compiled on first use; object mode if ``m`` cannot compile."""
+        if m in variant_entries:
+            return variant_entries[m]
+        if variant_entries:
+            target = _configured_jit()
+            tier_instances.append(target)
+        else:
+            target = jit_instance
+            dispatcher._mode = m
+        try:
+            entry = _compile_as(target, m, func if m in _NATIVE_ENTRY_MODES else None)
+        except Exception:
+            entry = None
+        if entry is None and m != "object":
+            # A failed typed compile adds nothing to the dylib: object mode
+            # can reuse the instance
+            entry = _variant("object")
+        variant_entries[m] = entry if entry is not None else func
+        return variant_entries[m]
+
+    def _native_variant(m):
+        """Native entry of the mode ``m`` variant, for other @jit functions to
+        call directly; None if ``m`` is not a mode the static pass admitted,
+        its compile fell back to object mode, or a miss is being handled."""
+        if m not in auto_modes or not transition_lock.acquire(blocking=False):
+            return None
+        try:
+            entry = _variant(m)
+        finally:
+            transition_lock.release()
+        return None if entry is func or entry is variant_entries.get("object") else entry
+
+    def _warm_mode(m):
+        """Compile the mode ``m`` variant before a call needs it (see warmup)."""
+        if m not in auto_modes and m != "object":
+            return False
+        with transition_lock:
+            _variant(m)
+        return True
+
+    def _dispatch_miss(*args, **kwargs):
+        """Run a call no dispatcher variant takes and register a variant for its signature."""
+        with transition_lock:
+            if kwargs:
+                entry = _variant("object")
+            else:
+                entry = _variant(_select_auto_mode(auto_modes, args, kwargs))
+                signature = tuple(type(a) for a in args)
+                if signature not in dispatch_signatures:
+                    dispatch_signatures.add(signature)
+                    if not dispatcher.add_variant(signature, entry):
+                        # Table full: object mode takes every other signature
+                        dispatcher.set_generic(_variant("object"))
+        return entry(*args, **kwargs)
+
+    # A budgeted compile can be left to finish in the background, which the
+    # dispatcher's synchronous per-signature compiles cannot
+    if auto_pending and not (tiered or background) and max_compile_ms is None:
+        dispatcher = create_dispatcher(func.__name__, _dispatch_miss)
+        dispatcher.__name__ = func.__name__
+        dispatcher.__qualname__ = func.__qualname__
+        dispatcher.__module__ = func.__module__
+        dispatcher.__doc__ = func.__doc__
+        dispatcher._jit_instance = jit_instance
+        dispatcher._tier_instances = tier_instances
+        dispatcher._jit_callees = jit_callees
+        dispatcher._original_func = func
+        dispatcher._instructions = instructions
+        dispatcher._mode = "auto"
+        dispatcher._auto_modes = auto_modes
+        dispatcher._native_variant = _native_variant
+        dispatcher._variant_modes = lambda: list(variant_entries)
+        dispatcher._warm_mode = _warm_mode
+        dispatcher._counters = counters
+        dispatcher._native_entries = native_entries
+        native_entries.append(dispatcher)
+        return dispatcher
+
+    # Nothing left to decide per call: compile now and hand out the native
+    # entry itself, so calls skip this wrapper entirely
+    if not (tiered or background or auto_pending) and selected_mode in _NATIVE_ENTRY_MODES:
+        try:
+            if max_compile_ms is None:
+                entry = _compile_as(jit_instance, selected_mode, fallback=func)
+            else:
+                # Past the budget the wrapper below waits for the worker
+                _compile_within_budget()
+                entry = compiled_ptr
+        except Exception:
+            entry = None
+        if entry is not None:
+            entry.__name__ = func.__name__
+            entry.__qualname__ = func.__qualname__
+            entry.__module__ = func.__module__
+            entry.__doc__ = func.__doc__
+            entry._jit_instance = jit_instance
+            entry._tier_instances = tier_instances
+            entry._jit_callees = jit_callees
+            entry._original_func = func
+            entry._instructions = instructions
+            entry._mode = selected_mode
+            entry._counters = counters
+            entry._native_entries = native_entries
+            return entry
+
+    def _complex_batch(index, args, kwargs):
+        """Run batch callable ``index`` (0: map, 1: reduce, 2: stream), compiling first if needed."""
+        if compiled_ptr is None:
+            _warmup()
+        entries = batch_entries.get(selected_mode)
+        call = ("map", "reduce", "stream")[index]
+        if entries is None:
+            raise TypeError(f"{func.__name__}.{call}() needs a compiled {selected_mode} function")
+        if entries[index] is None:
+            raise TypeError(f"{func.__name__}.reduce() needs a two-parameter {selected_mode} function")
+        return entries[index](*args, **kwargs)
+
+    if selected_mode in ("complex128", "complex64"):
+        # The batch calls native int and float entries have, over complex buffers
+        def _batch_map(*operands, out=None):
+            return _complex_batch(0, operands, {"out": out})
+
+        def _batch_reduce(array, initial=None):
+            return _complex_batch(1, (array,), {"initial": initial})
+
+        def _batch_stream(source, chunk=0, *, initial=None, out=None):
+            return _complex_batch(2, (source, chunk), {"initial": initial, "out": out})
+
+        wrapper.map = _batch_map
+        wrapper.reduce = _batch_reduce
+        wrapper.stream = _batch_stream
+
+    wrapper.__name__ = func.__name__
+    wrapper.__doc__ = func.__doc__
+    wrapper._jit_instance = jit_instance
+    wrapper._tier_instances = tier_instances
+    wrapper._jit_callees = jit_callees
+    wrapper._original_func = func
+    wrapper._instructions = instructions
+    wrapper._mode = "auto" if auto_pending else selected_mode
+    wrapper._warmup = _warmup
+    wrapper._counters = counters
+    wrapper._native_entries = native_entries
+    return wrapper
+
+
+# Wrapper-side keys of justjit.counters(); native entries add native_calls,
+# deopts, fallback_type, fallback_kwargs and fallback_arity
+_WRAPPER_COUNTERS = (
+    "native_calls",
+    "compile_attempts",
+    "compile_failures",
+    "fallback_compile_failure",
+    "fallback_pending",
+    "fallback_exception",
+    "generic_calls",
+    "osr_entries",
+    "budget_deferrals",
+)
+
+
+def counters(func):
+    """
+    Call and compile counters of a ``@jit`` function, as a dict of ints.
+
+    Keys:
+        native_calls: calls that ran compiled code
+        deopts: native calls that gave up and reran in the interpreter
+        compile_attempts, compile_failures: compiles of any tier or
+            specialization, and those that produced no code
+        fallback_compile_failure: calls interpreted because compiling failed
+        fallback_pending: calls interpreted while a background compile runs
+        fallback_exception: calls rerun in the interpreter after the typed
+            callable rejected their arguments
+        fallback_type: calls whose argument types the native entry cannot take
+        fallback_kwargs, fallback_arity: calls with keywords or an argument
+            count the native entry cannot bind
+        dispatch_misses: mode='auto' calls no compiled variant's signature
+            matched (each new signature, and every call with keywords)
+        generic_calls: mode='auto' calls run by the object-mode variant
+            because the signature table was full (with tiering or background
+            compiles: calls whose argument types differ from the specialized
+            ones)
+        osr_entries: interpreted calls whose loop finished in native code
+            through an on-stack replacement entry
+        budget_deferrals: compiles that outlasted max_compile_ms and
+            were left to finish in the background
+
+    The counts are plain increments: with several threads and no GIL a few
+    may be lost.
+
+    Example:
+        for name, value in justjit.counters(kernel).items():
+            gauge.labels(function="kernel", counter=name).set(value)
+    """
+    own = getattr(func, "_counters", None)
+    if own is None:
+        raise TypeError(f"{func!r} is not a @jit function")
+    result = dict(own)
+    for entry in getattr(func, "_native_entries", ()):
+        for key, value in entry.counters.items():
+            result[key] = result.get(key, 0) + value
+    return result
+
+
+class Profile:
+    """
+    Samples taken by :func:`profile`.
+
+    Attributes:
+        samples: SIGPROF samples taken (one per ``interval`` of CPU time)
+        outside: samples whose PC was not in JIT'd code (interpreter,
+            C API and runtime helpers, other threads)
+        dropped: samples beyond the sample buffer
+        interval: seconds of CPU time per sample
+        lines: one dict per (function, line, offset) hit, most samples
+            first, with ``function``, ``symbol``, ``filename``, ``line``,
+            ``offset`` and ``samples``
+    """
+
+    def __init__(self):
+        self.samples = 0
+        self.outside = 0
+        self.dropped = 0
+        self.interval = 0.0
+        self.lines = []
+
+    def _fill(self, result):
+        self.samples = result["samples"]
+        self.outside = result["outside"]
+        self.dropped = result["dropped"]
+        self.interval = result["interval_us"] / 1e6
+        self.lines = result["lines"]
+
+    def by_line(self):
+        """Samples per (filename, line, function), bytecode offsets merged."""
+        totals = {}
+        for entry in self.lines:
+            key = (entry["filename"], entry["line"], entry["function"])
+            totals[key] = totals.get(key, 0) + entry["samples"]
+        return dict(sorted(totals.items(), key=lambda item: -item[1]))
+
+    def print(self, limit=20, file=None):
+        """Print the hottest lines, with their share of all samples."""
+        file = file if file is not None else sys.stdout
+        total = max(self.samples, 1)
+        inside = self.samples - self.outside
+        print(f"{self.samples} samples, {inside} in JIT'd code ({inside / total:.1%})", file=file)
+        for (filename, line, function), count in list(self.by_line().items())[:limit]:
+            print(f"{count / total:7.1%} {count:8d}  {function} ({filename}:{line})", file=file)
+
+
+class profile:
+    """
+    Sample where JIT'd code spends its time, per Python line.
+
+    A context manager: while it is active, the process's CPU time is sampled
+    every ``interval`` seconds (SIGPROF, Linux x86-64 and AArch64), and each
+    sampled native PC inside JIT'd code is mapped back to its function,
+    line and bytecode offset through the PC tables. cProfile and
+    line_profiler cannot see these lines, since no Python frame runs them.
+
+    PC tables must be on before the first JIT is created:
+    ``justjit.set_pc_tables(True)`` or ``JUSTJIT_PC_TABLES=1``. Time spent in
+    C API calls and runtime helpers that JIT'd code calls counts as
+    ``outside``.
+
+    Example:
+        with justjit.profile() as prof:
+            simulate()
+        prof.print()
+    """
+
+    def __init__(self, interval=0.001):
+        self.interval = interval
+        self.result = Profile()
+
+    def __enter__(self):
+        if not get_pc_tables():
+            raise RuntimeError("justjit.profile() needs PC tables: call justjit.set_pc_tables(True) "
+                               "(or set JUSTJIT_PC_TABLES=1) before the first JIT is created")
+        _start_pc_sampling(max(int(self.interval * 1e6), 1))
+        return self.result
+
+    def __exit__(self, *exc):
+        self.result._fill(_stop_pc_sampling())
+        return False
+
+
+def _opname(opcode):
+    return dis.opname[opcode] if opcode < len(dis.opname) else f"<{opcode}>"
+
+
+def trace_events():
+    """
+    Take the per-opcode trace events recorded since the last call.
+
+    Functions compiled while :func:`set_trace` is on record one event per
+    executed bytecode instruction in a process-wide ring of 2**20 events.
+
+    Returns:
+        (events, lost): ``events`` is a list of ``(function, offset, opname)``
+        tuples in execution order (as claimed across threads); ``lost`` counts
+        events overwritten before this call could read them.
+    """
+    result = _drain_trace()
+    return [(name, offset, _opname(opcode)) for name, offset, opcode in result["events"]], result["lost"]
+
+
+def trace_summary():
+    """
+    Drain the trace and count events per ``(function, opname)``, most first.
+
+    Returns:
+        dict mapping ``(function, opname)`` to the number of executions.
+    """
+    result = _drain_trace()
+    counts = {}
+    for name, _, opcode in result["events"]:
+        key = (name, opcode)
+        counts[key] = counts.get(key, 0) + 1
+    ordered = sorted(counts.items(), key=lambda item: -item[1])
+    return {(name, _opname(opcode)): count for (name, opcode), count in ordered}
+
+
+def latency_histograms(reset=False):
+    """
+    Native call latencies per function, from :func:`set_latency_histograms`.
+
+    While latency timing is on (``justjit.set_latency_histograms(True)`` or
+    ``JUSTJIT_LATENCY=1``), every call through a native entry reads the
+    CPU's timestamp counter (rdtsc, cntvct_el0) before and after the
+    compiled code and adds the difference to a log-linear histogram of its
+    function: buckets are at most 1/16 of their value wide. Argument
+    unboxing, interpreter fallbacks and object-mode calls made directly
+    between JIT'd functions are not timed.
+
+    Args:
+        reset: zero the histograms after reading them
+
+    Returns:
+        dict mapping each function name with timed calls to a dict with
+        ``count``, ``mean_ns``, ``max_ns``, ``p50_ns``, ``p90_ns``,
+        ``p99_ns``, ``p999_ns`` and ``buckets``, a list of
+        ``(lower_bound_ns, count)`` pairs. Percentiles are bucket lower
+        bounds.
+
+    Example:
+        justjit.set_latency_histograms(True)
+        serve()
+        worst = max(justjit.latency_histograms().items(), key=lambda kv: kv[1]["p99_ns"])
+    """
+    raw = _read_latency_histograms(reset)
+    scale = 1.0 / raw["ticks_per_ns"]
+    result = {}
+    for name, hist in raw["functions"].items():
+        count = hist["count"]
+        summary = {"count": count, "mean_ns": hist["sum"] * scale / count, "max_ns": hist["max"] * scale}
+        for key, fraction in (("p50_ns", 0.5), ("p90_ns", 0.9), ("p99_ns", 0.99), ("p999_ns", 0.999)):
+            rank = math.ceil(fraction * count)
+            seen = 0
+            for low, n in hist["buckets"]:
+                seen += n
+                if seen >= rank:
+                    break
+            summary[key] = low * scale
+        summary["buckets"] = [(low * scale, n) for low, n in hist["buckets"]]
+        result[name] = summary
+    return result
+
+
+def _is_pending_jit(obj):
+    """True for ``@jit`` wrappers that compile on first use (see compile_all)."""
+    if isinstance(obj, _LazyJITWrapper):
+        return True
+    return isinstance(obj, types.FunctionType) and callable(getattr(obj, "_warmup", None))
+
+
+def compile_all(module, threads=None):
+    """
+    Compile the pending ``@jit`` functions of a module now, in parallel.
+
+    Picks up every function whose compile would otherwise wait for its first
+    call: lazy (the default) and ``background=True`` functions, and typed modes
+    that have no native entry. ``mode='auto'`` functions whose mode still
+    depends on the first call's argument types are skipped. Compiles run on a
+    pool of worker threads. LLVM optimization and code generation release
+    the GIL, so one function's IR can be built while others are optimized.
+
+    Args:
+        module: A module, or an iterable of decorated functions
+        threads: Number of worker threads (default: one per CPU)
+
+    Returns:
+        int: Number of functions compiled
+
+    Example:
+        import mykernels
+        justjit.compile_all(mykernels)  # warm up at import, not on first call
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    candidates = vars(module).values() if isinstance(module, types.ModuleType) else module
+    pending = []
+    seen = set()
+    for obj in candidates:
+        if id(obj) not in seen and _is_pending_jit(obj):
+            seen.add(id(obj))
+            pending.append(obj)
+    if not pending:
+        return 0
+
+    workers = min(threads or os.cpu_count() or 1, len(pending))
+    with ThreadPoolExecutor(max_workers=workers, thread_name_prefix="justjit-compile-all") as pool:
+        return sum(pool.map(lambda f: bool(f._warmup()), pending))
+
+
+def _call_levels(funcs):
+    """Group ``funcs`` (name -> function) so each group only calls earlier
+    groups or itself: callees first, mutually recursive ones together."""
+    calls = {}
+    for name, func in funcs.items():
+        loaded = {instr.argval for instr in dis.get_instructions(func) if instr.opname == "LOAD_GLOBAL"}
+        calls[name] = (loaded & funcs.keys()) - {name}
+    levels = []
+    done = set()
+    while len(done) < len(funcs):
+        level = [name for name in funcs if name not in done and calls[name] <= done]
+        if not level:
+            # A cycle: take what is left of it in one group
+            level = [name for name in funcs if name not in done]
+        levels.append(level)
+        done.update(level)
+    return levels
+
+
+def jit_module(module, *, exclude=(), compile=True, threads=None, **options):
+    """
+    ``@jit`` every plain function defined in a module, and compile them
+    callees first.
+
+    Each module-level function whose ``__module__`` is ``module`` (not
+    classes, builtins, imported or already decorated functions, nor names
+    in ``exclude``) is replaced in the module by ``jit(func, **options)``.
+    With ``compile=True`` they are then compiled in call-graph order, each
+    level in parallel as compile_all does: a function is compiled after
+    the module functions it calls, so int, float and object callers link
+    their callees' code in and LLVM can inline across them.
+
+    Args:
+        module: The module whose functions to compile
+        exclude: Names to leave alone
+        compile: Compile now (default True) rather than on first call
+        threads: Worker threads per level (default: one per CPU)
+        **options: Keyword arguments for jit (mode, opt_level, ...)
+
+    Returns:
+        list: Names of the functions that were decorated
+
+    Example:
+        import kernels
+        justjit.jit_module(kernels, fastmath=True)
+    """
+    funcs = {}
+    for name, value in list(vars(module).items()):
+        if (isinstance(value, types.FunctionType) and value.__module__ == module.__name__
+                and value.__name__ == name and name not in exclude and not hasattr(value, "__wrapped__")):
+            funcs[name] = value
+    for name, func in funcs.items():
+        setattr(module, name, jit(func, **options))
+    if compile:
+        for level in _call_levels(funcs):
+            compile_all([getattr(module, name) for name in level], threads=threads)
+    return list(funcs)
+
+
+# ============================================================================
+# Auto-JIT
+# ============================================================================
+# auto_jit() counts Python function starts with a sys.monitoring PY_START
+# callback, under the tool id OSR uses. A function that reaches the
+# threshold is compiled on the background worker; the name it was looked
+# up by (a module global or class attribute) is then rebound to the
+# compiled function, so later calls through it run native code. Code that
+# will never be compiled disables its event at once, and hot code once it
+# has been handed over, so the rest of the program stops paying for the
+# callback.
+
+_AUTO_JIT_ALWAYS_DENIED = ("justjit",)
+# The standard library (its functions run inside justjit's own compiles too)
+_AUTO_JIT_SKIPPED_FILES = tuple(
+    {os.path.join(path, "") for path in (sysconfig.get_paths()["stdlib"], sysconfig.get_paths()["platstdlib"])}
+) + ("<frozen ",)
+_auto_state = None
+
+
+class _AutoJIT:
+    """Settings and progress of one auto_jit() session."""
+
+    def __init__(self, threshold, denylist, max_bytecode_size, options):
+        self.threshold = threshold
+        self.denylist = _AUTO_JIT_ALWAYS_DENIED + tuple(denylist)
+        self.max_bytecode_size = max_bytecode_size
+        self.options = options
+        self.counts = {}  # code -> calls seen so far
+        self.compiled = []  # "module.qualname" of every function rebound
+
+    def eligible(self, code, module):
+        """Whether calls of ``code``, defined in ``module``, are worth counting."""
+        if code.co_flags & (_CO_GENERATOR | _CO_COROUTINE | _CO_ASYNC_GENERATOR) or code.co_freevars:
+            return False
+        # Lambdas, comprehensions, nested functions and module bodies have no name to rebind
+        if "<" in code.co_qualname:
+            return False
+        if self.max_bytecode_size is not None and _bytecode_size(code) > self.max_bytecode_size:
+            return False
+        if not isinstance(module, str) or code.co_filename.startswith(_AUTO_JIT_SKIPPED_FILES):
+            return False
+        return not any(module == denied or module.startswith(denied + ".") for denied in self.denylist)
+
+
+def _auto_owner(globals_, code):
+    """(namespace, name, function) a call of ``code`` was looked up through, or None.
+
+    The namespace is the function's module globals for a module-level
+    function, or the class (reached from those globals by ``co_qualname``)
+    for a method defined in it.
+    """
+    parts = code.co_qualname.split(".")
+    if len(parts) == 1:
+        owner = globals_
+        func = globals_.get(parts[0])
+    else:
+        owner = globals_.get(parts[0])
+        for part in parts[1:-1]:
+            owner = vars(owner).get(part) if isinstance(owner, type) else None
+        if not isinstance(owner, type):
+            return None
+        func = vars(owner).get(parts[-1])
+    if not isinstance(func, types.FunctionType) or func.__code__ is not code or hasattr(func, "__wrapped__"):
+        return None
+    return owner, parts[-1], func
+
+
+def _auto_start(code, offset):
+    """sys.monitoring PY_START callback: count calls, hand hot functions to the worker."""
+    state = _auto_state
+    if state is None:
+        return sys.monitoring.DISABLE
+    seen = state.counts.get(code, 0) + 1
+    if seen == 1 and not state.eligible(code, sys._getframe(1).f_globals.get("__name__")):
+        return sys.monitoring.DISABLE
+    if seen < state.threshold:
+        state.counts[code] = seen
+        return None
+    del state.counts[code]
+    target = _auto_owner(sys._getframe(1).f_globals, code)
+    if target is not None:
+        _get_compile_executor().submit(_auto_compile, state, *target)
+    return sys.monitoring.DISABLE
+
+
+def _auto_compile(state, owner, name, func):
+    """Compile ``func`` and rebind ``owner``'s ``name`` to it if it still holds ``func``."""
+    try:
+        compiled = jit(func, **state.options)
+    except Exception:
+        return
+    if compiled is func or _auto_state is not state:
+        return
+    current = owner.get(name) if isinstance(owner, dict) else vars(owner).get(name)
+    if current is not func:
+        return
+    # Recorded first: whoever sees the new binding also finds it in the report
+    state.compiled.append(f"{func.__module__}.{func.__qualname__}")
+    if isinstance(owner, dict):
+        owner[name] = compiled
+    else:
+        setattr(owner, name, compiled)
+
+
+def auto_jit(threshold=1000, *, denylist=(), max_bytecode_size=2000, **options):
+    """
+    Compile hot functions process-wide, without decorating them.
+
+    Every Python function start is counted through ``sys.monitoring``. A
+    module-level function or a method defined directly in a class that is
+    called ``threshold`` times is compiled with ``jit(func, **options)`` on
+    the background worker. Its module global or class attribute is then
+    rebound to the compiled function. Calls that look the function up
+    again afterwards run the native code; references taken before that (a
+    callback stored elsewhere, ``from m import f`` in another module) keep
+    calling the original.
+
+    Generators, coroutines, closures, lambdas and nested functions are not
+    compiled, and neither are the standard library or a function that was
+    already decorated. Each of
+    them, and each function compiled, stops reporting calls, so only code
+    still being counted pays for the callback.
+
+    Args:
+        threshold: Calls before a function is compiled
+        denylist: Module names (with their submodules) whose functions are
+                  never compiled; justjit itself is always excluded
+        max_bytecode_size: Functions with more instructions than this are
+                           skipped (``None`` for no limit)
+        **options: Keyword arguments for jit (mode, opt_level, ...);
+                   ``lazy`` defaults to False, so the compile happens on
+                   the worker
+
+    Raises:
+        RuntimeError: another tool holds ``sys.monitoring.OPTIMIZER_ID``
+
+    Example:
+        justjit.auto_jit(threshold=500, denylist=("tests",))
+        run_service()
+        print(justjit.auto_jit_disable())
+    """
+    global _auto_state
+    if threshold < 1:
+        raise ValueError("threshold must be at least 1")
+    if max_bytecode_size is not None and max_bytecode_size < 1:
+        raise ValueError("max_bytecode_size must be a positive instruction count or None")
+    if isinstance(denylist, str):
+        denylist = (denylist,)
+    options.setdefault("lazy", False)
+    monitoring = sys.monitoring
+    with _osr_lock:
+        tool = _monitoring_tool()
+        if not tool:
+            raise RuntimeError("auto_jit: sys.monitoring.OPTIMIZER_ID is in use by another tool")
+        _auto_state = _AutoJIT(threshold, denylist, max_bytecode_size, options)
+        monitoring.register_callback(tool, monitoring.events.PY_START, _auto_start)
+        # Code disabled by an earlier session is counted again
+        monitoring.restart_events()
+        monitoring.set_events(tool, monitoring.get_events(tool) | monitoring.events.PY_START)
+
+
+def auto_jit_disable():
+    """
+    Stop auto_jit: calls are no longer counted and nothing more is compiled.
+
+    Functions already rebound stay compiled.
+
+    Returns:
+        list: ``module.qualname`` of the functions auto_jit compiled
+    """
+    global _auto_state
+    monitoring = sys.monitoring
+    with _osr_lock:
+        state = _auto_state
+        _auto_state = None
+        if _osr_tool:
+            monitoring.set_events(_osr_tool, monitoring.get_events(_osr_tool) & ~monitoring.events.PY_START)
+            monitoring.register_callback(_osr_tool, monitoring.events.PY_START, None)
+    return list(state.compiled) if state is not None else []
+
+
+def fuse(*stages, mode=None, **options):
+    """
+    Compose @jit scalar functions into one: ``fuse(h, g, f)(x)`` is
+    ``f(g(h(x)))``.
+
+    The composition is compiled as an int or float function whose callees
+    are the stages, so their code is linked in and inlined, and its
+    ``map``, ``reduce`` and ``stream`` batch calls run every stage in one
+    loop: ``fuse(h, g, f).map(x)`` reads ``x`` once and writes one result,
+    with no temporary per stage.
+
+    Args:
+        *stages: @jit functions, first applied first; the first may take
+            several parameters, the others take one
+        mode: 'int' or 'float' (default: the one every stage compiles in)
+        **options: Other keyword arguments for jit (parallel, fastmath, ...)
+
+    Returns:
+        The fused function, as jit returns it (with map, reduce and stream)
+
+    Example:
+        scale_shift = justjit.fuse(scale, shift, clip)
+        out = scale_shift.map(x)
+    """
+    if not stages:
+        raise TypeError("fuse() needs at least one stage")
+    originals = []
+    for k, stage in enumerate(stages):
+        original = stage._func if isinstance(stage, _LazyJITWrapper) else getattr(stage, "_original_func", None)
+        if original is None:
+            raise TypeError(f"fuse() stages must be @jit functions, not {stage!r}")
+        if k > 0 and original.__code__.co_argcount != 1:
+            raise TypeError(f"fuse(): stage {original.__name__} after the first must take one parameter")
+        originals.append(original)
+
+    params = list(originals[0].__code__.co_varnames[:originals[0].__code__.co_argcount])
+    call = ", ".join(params)
+    for k in range(len(stages)):
+        call = f"_stage{k}({call})"
+    name = "_".join(f.__name__ for f in originals) + "_fused"
+    namespace = {f"_stage{k}": stage for k, stage in enumerate(stages)}
+    exec(f"def {name}({', '.join(params)}):\n    return {call}\n", namespace)
+    fused = namespace[name]
+    fused.__qualname__ = f"fuse({', '.join(f.__name__ for f in originals)})"
+
+    candidates = [mode] if mode is not None else ["float", "int"]
+    for m in candidates:
+        if all(_jit_callee_supports(fused, f"_stage{k}", m) for k in range(len(stages))):
+            return jit(fused, mode=m, **options)
+    raise TypeError("fuse() stages must all compile in one int or float mode")
+
+
+def _pipeline_entry(stage):
+    """The native int (else float) entry of the @jit function ``stage``, or
+    ``stage`` itself for run_pipeline to reject."""
+    for mode in ("int", "float"):
+        entry = _native_callee(stage, mode)
+        if entry is not None:
+            return entry
+    return stage
+
+
+def pipeline(source, *stages, reduce=None, initial=None, batch=1024, depth=4):
+    """
+    Run a typed @jit generator through a chain of @jit functions, each on
+    a thread of its own: ``pipeline(gen, f, g, reduce=add)`` is
+    ``functools.reduce(add, (g(f(x)) for x in gen))``.
+
+    The generator fills batches of ``batch`` values on one thread, every
+    stage maps whole batches with its ``map`` loop on the next and hands
+    them on through a bounded lock-free queue, and the calling thread folds
+    them with ``reduce``'s ``reduce`` loop. None of it holds the GIL. The
+    stages run concurrently, so a pipeline of cheap generator steps and
+    costly stages keeps several cores busy.
+
+    Args:
+        source: A generator made by an int or float mode @jit generator
+            function (it is consumed)
+        *stages: One-parameter int or float @jit functions, first applied
+            first; ints may flow into float stages, not the reverse
+        reduce: Two-parameter int or float @jit function folding the
+            results (default: collect them)
+        initial: First accumulator value (default: the first result)
+        batch: Values per batch
+        depth: Batches queued between two stages at most
+
+    Returns:
+        The folded value, or an array.array ('q' or 'd') of the results
+
+    Example:
+        total = justjit.pipeline(squares(n), scale, reduce=add, initial=0)
+    """
+    entries = tuple(_pipeline_entry(stage) for stage in stages)
+    if reduce is not None:
+        reduce = _pipeline_entry(reduce)
+    return run_pipeline(source, entries, reduce, initial, batch, depth)
+
+
+async def gather(*coros, return_exceptions=False):
+    """
+    ``asyncio.gather`` for many coroutines, resumed in one native loop.
+
+    Each coroutine is stepped directly, round-robin, and a bare yield
+    (``await asyncio.sleep(0)``) keeps it in the loop, so CPU-bound
+    coroutines never go through the event loop. Only a coroutine waiting
+    on a future comes back to Python: this awaits the pending futures and
+    resumes the coroutines whose future is done. @jit coroutines resume
+    without a Python call; others work too, through their send().
+
+    Args:
+        *coros: Coroutine objects (not yet started)
+        return_exceptions: Store an exception a coroutine raises as its
+            result instead of raising it. Otherwise the exception is
+            raised and the coroutines still pending are closed, as they
+            are when the gather is cancelled
+
+    Returns:
+        The results, in the order of ``coros``
+    """
+    import asyncio
+
+    coros = list(coros)
+    results = [None] * len(coros)
+    ready = range(len(coros))
+    waiting = {}
+    finished = False
+    try:
+        while True:
+            for index, future in step_coroutines(coros, ready, results, return_exceptions):
+                # What asyncio.Task does with a future its coroutine yields
+                if getattr(future, "_asyncio_future_blocking", None) is None:
+                    raise RuntimeError(f"gather(): coroutine {index} yielded {future!r}, not a future")
+                future._asyncio_future_blocking = False
+                waiting[index] = future
+            if not waiting:
+                finished = True
+                return results
+            done, _ = await asyncio.wait(set(waiting.values()), return_when=asyncio.FIRST_COMPLETED)
+            ready = [index for index, future in waiting.items() if future in done]
+            for index in ready:
+                del waiting[index]
+    finally:
+        if not finished:
+            # A coroutine raised or the gather was cancelled: close the
+            # others, running their finally blocks (close() is a no-op for
+            # those already done, and keeps unstarted ones from warning)
+            for coro in coros:
+                coro.close()
+
+
+AOT_MANIFEST = "justjit-aot.json"
+
+
+def _aot_target():
+    """What an ahead-of-time build must match to be reused (see aot)."""
+    import platform
+    return {
+        "justjit": __version__,
+        "python": sys.version.split()[0],
+        "machine": platform.machine(),
+        "platform": sys.platform,
+    }
+
+
+def select_target(cpus):
+    """
+    The most capable of ``cpus`` that this machine can run code for.
+
+    Args:
+        cpus: LLVM CPU names, least capable first, such as
+              ``["x86-64-v2", "x86-64-v3", "x86-64-v4"]``
+
+    Returns:
+        str: The last name in ``cpus`` that host_supports_cpu accepts, or
+        None if none of them runs here
+    """
+    for cpu in reversed(list(cpus)):
+        if host_supports_cpu(cpu):
+            return cpu
+    return None
+
+
+def _aot_targets(module_name, output, threads, targets):
+    """Build ``module_name`` into ``output`` once per CPU in ``targets``."""
+    import json
+    import subprocess
+
+    # Each target needs fresh compiles, so each is built by its own
+    # interpreter; the object cache key covers the CPU, so they share output
+    env = dict(os.environ)
+    env["PYTHONPATH"] = os.pathsep.join(p or os.getcwd() for p in sys.path)
+    functions = set()
+    for cpu in targets:
+        env["JUSTJIT_TARGET_CPU"] = cpu
+        cmd = [sys.executable, "-m", "justjit", "aot", module_name, "-o", output]
+        if threads:
+            cmd += ["--threads", str(threads)]
+        proc = subprocess.run(cmd, env=env, capture_output=True, text=True)
+        if proc.returncode != 0:
+            raise RuntimeError(f"justjit: aot build of {module_name} for {cpu} failed:\n{proc.stderr.strip()}")
+        with open(os.path.join(output, AOT_MANIFEST)) as f:
+            functions.update((e["name"], e["mode"]) for e in json.load(f)["functions"])
+    return sorted(functions)
+
+
+def aot(module, output, threads=None, targets=None):
     """
-    
-    def __init__(self, inner_gen, name, qualname):
-        self._inner = inner_gen
-        self._name = name
-        self._qualname = qualname
-        self._closed = False
-    
-    def __aiter__(self):
-        return self
-    
-    async def __anext__(self):
-        if self._closed:
-            raise StopAsyncIteration
-        
-        try:
-            # Get next value from inner generator
-            value = self._inner.send(None)
-            return value
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def asend(self, value):
-        if self._closed:
-            raise StopAsyncIteration
-        
-        try:
-            result = self._inner.send(value)
-            return result
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def athrow(self, exc_type, exc_val=None, exc_tb=None):
-        if self._closed:
-            raise StopAsyncIteration
-        
-        try:
-            if exc_val is None:
-                exc_val = exc_type()
-            return self._inner.throw(exc_type, exc_val, exc_tb)
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def aclose(self):
-        if not self._closed:
-            try:
-                self._inner.close()
-            except Exception:
-                pass
-            self._closed = True
-    
-    def __repr__(self):
-        return f"<async_gen_jit {self._qualname} at {id(self):#x}>"
+    Compile a module's ``@jit`` functions into a directory, ahead of time.
 
+    The build step behind ``python -m justjit aot``: ``output`` becomes the
+    object cache (see set_cache_dir), ``module`` is imported and compile_all
+    runs, so the native object of every typed-mode function is written
+    there. A manifest, ``justjit-aot.json``, records what was built and for
+    which interpreter and machine. A process that calls load_aot on the
+    directory (or sets ``JUSTJIT_CACHE_DIR`` to it) then loads those objects
+    instead of optimizing and generating code.
 
-def _create_jit_wrapper(
-    func, opt_level, vectorize, inline, parallel, lazy, mode="auto"
-):
-    """Create a JIT-compiled wrapper for the given function."""
-    import warnings
-    import functools
+    Without ``targets`` the code is for the building machine's CPU (or
+    ``JUSTJIT_TARGET_CPU``) and another CPU model recompiles it. With
+    ``targets``, every function is built once per listed CPU, and load_aot
+    picks the most capable one the machine it runs on supports, so one
+    directory serves a fleet of mixed CPUs of one architecture.
 
-    # Check if this is a generator function
-    is_generator = _is_generator_or_coroutine(func)
-    
-    # Handle coroutines (async def functions)
-    flags = func.__code__.co_flags
-    if flags & _CO_COROUTINE:
-        # Regular coroutine (async def without yield)
-        return _create_coroutine_wrapper(func, opt_level)
-    
-    # Async generators (async def with yield) - now supported
-    if flags & _CO_ASYNC_GENERATOR:
-        return _create_async_generator_wrapper(func, opt_level)
+    Object-mode functions and generators embed addresses of live Python
+    objects and are still compiled at run time.
 
-    # Check bytecode for unsupported opcodes
-    unsupported = _has_unsupported_opcodes(func)
-    if unsupported == "exception":
-        # Bug #3 Fix: Detect exception handling and skip JIT compilation
-        warnings.warn(
-            f"Function '{func.__name__}' uses unsupported exception constructs. "
-            f"The @jit decorator has no effect on this function.",
-            RuntimeWarning,
-            stacklevel=3,
-        )
-        return func
-    if unsupported == "intrinsic":
-        # Block functions using unsupported intrinsics (import *, type annotations)
-        warnings.warn(
-            f"Function '{func.__name__}' uses unsupported intrinsic operations "
-            f"(import * or type annotations). The @jit decorator has no effect.",
-            RuntimeWarning,
-            stacklevel=3,
-        )
-        return func
-    if unsupported == "pattern_matching":
-        # Structural pattern matching has complex control flow
-        warnings.warn(
-            f"Function '{func.__name__}' uses structural pattern matching "
-            f"(match/case with class/mapping/sequence patterns). "
-            f"The @jit decorator has no effect. Literal matching works fine.",
-            RuntimeWarning,
-            stacklevel=3,
-        )
-        return func
-    
-    # For generators, compile using the generator compilation path
-    if is_generator:
-        return _create_generator_wrapper(func, opt_level)
+    Args:
+        module: A module, or the dotted name of one to import
+        output: Directory for the objects and the manifest (created if missing)
+        threads: Worker threads for compile_all (default: one per CPU)
+        targets: LLVM CPU names to build for, least capable first, such as
+                 ``["x86-64-v2", "x86-64-v3", "x86-64-v4"]`` (default None)
 
-    jit_instance = JIT()
-    jit_instance.set_opt_level(opt_level)
+    Returns:
+        dict: The manifest that was written
+    """
+    import importlib
+    import json
 
-    instructions = _extract_bytecode(func)
-    constants = _extract_constants(func)
-    names = _extract_names(func)
-    globals_dict = _extract_globals(func)  # Now returns the dict itself
-    builtins_dict = _extract_builtins(func)  # For fallback lookup
-    closure_cells = _extract_closure(func)
-    exception_table = _parse_exception_table(func)  # Bug #3 Fix: Exception handling
-    param_count = func.__code__.co_argcount
+    if targets:
+        module_name = module if isinstance(module, str) else module.__name__
+        os.makedirs(output, exist_ok=True)
+        built = _aot_targets(module_name, os.path.abspath(output), threads, list(targets))
+        manifest = dict(_aot_target())
+        manifest["module"] = module_name
+        manifest["targets"] = list(targets)
+        manifest["functions"] = [{"name": name, "mode": mode} for name, mode in built]
+        manifest["objects"] = sorted(name for name in os.listdir(output) if name.endswith(".o"))
+        path = os.path.join(output, AOT_MANIFEST)
+        with open(path + ".tmp", "w") as f:
+            json.dump(manifest, f, indent=2)
+        os.replace(path + ".tmp", path)
+        return manifest
 
-    # Calculate local slot layout:
-    # - nlocals: number of local variables (co_nlocals)
-    # - cellvars: variables captured by nested functions (co_cellvars)
-    # - freevars: variables from enclosing scope (co_freevars)
-    # - total_locals: nlocals + len(cellvars) + len(freevars)
-    nlocals = func.__code__.co_nlocals
-    num_cellvars = len(func.__code__.co_cellvars)
-    num_freevars = len(func.__code__.co_freevars)
-    total_locals = nlocals + num_cellvars + num_freevars
+    previous = get_cache_dir()
+    set_cache_dir(os.path.abspath(output))
+    try:
+        first = len(stats())
+        if isinstance(module, str):
+            module = importlib.import_module(module)
+        compile_all(module, threads=threads)
+        records = stats()[first:]
+    finally:
+        set_cache_dir(previous)
 
-    # Determine compilation mode
-    use_int_mode = mode == "int"
-    use_float_mode = mode == "float"
-    use_bool_mode = mode == "bool"
-    use_int32_mode = mode == "int32"
-    use_float32_mode = mode == "float32"
-    use_complex128_mode = mode == "complex128"
-    use_ptr_mode = mode == "ptr"
-    use_vec4f_mode = mode == "vec4f"
-    use_vec8i_mode = mode == "vec8i"
-    use_complex64_mode = mode == "complex64"
-    use_optional_f64_mode = mode == "optional_f64"
+    # Only typed-mode code reaches the object cache
+    built = sorted({(r["name"], r["mode"]) for r in records
+                    if r["mode"] != "object" and not r["mode"].endswith(("generator", "coroutine"))})
+    manifest = dict(_aot_target())
+    manifest["module"] = module.__name__
+    if _fleet_target:
+        manifest["targets"] = [_fleet_target]
+    manifest["functions"] = [{"name": name, "mode": mode} for name, mode in built]
+    manifest["objects"] = sorted(name for name in os.listdir(output) if name.endswith(".o"))
+    path = os.path.join(output, AOT_MANIFEST)
+    with open(path + ".tmp", "w") as f:
+        json.dump(manifest, f, indent=2)
+    os.replace(path + ".tmp", path)
+    return manifest
 
-    compiled_ptr = None
 
-    def wrapper(*args, **kwargs):
-        nonlocal compiled_ptr
+def load_aot(path):
+    """
+    Use a directory built by aot as the object cache.
 
-        if compiled_ptr is None:
-            if use_int_mode:
-                # Integer mode - pure native i64 operations
-                success = jit_instance.compile_int(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_int_callable(func.__name__, param_count)
-            elif use_float_mode:
-                # Float mode - pure native f64 operations
-                success = jit_instance.compile_float(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_float_callable(func.__name__, param_count)
-            elif use_bool_mode:
-                # Bool mode - pure native boolean operations
-                success = jit_instance.compile_bool(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_bool_callable(func.__name__, param_count)
-            elif use_int32_mode:
-                # Int32 mode - 32-bit integer for C interop
-                success = jit_instance.compile_int32(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_int32_callable(func.__name__, param_count)
-            elif use_float32_mode:
-                # Float32 mode - 32-bit float for SIMD/ML
-                success = jit_instance.compile_float32(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_float32_callable(func.__name__, param_count)
-            elif use_complex128_mode:
-                # Complex128 mode - native {double,double} struct for complex numbers
-                success = jit_instance.compile_complex128(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_complex128_callable(func.__name__, param_count)
-            elif use_ptr_mode:
-                # Ptr mode - array element access via GEP
-                success = jit_instance.compile_ptr(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_ptr_callable(func.__name__, param_count)
-            elif use_vec4f_mode:
-                # Vec4f mode - SSE SIMD <4 x float>
-                success = jit_instance.compile_vec4f(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_vec4f_callable(func.__name__, param_count)
-            elif use_vec8i_mode:
-                # Vec8i mode - AVX SIMD <8 x i32>
-                success = jit_instance.compile_vec8i(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_vec8i_callable(func.__name__, param_count)
-            elif use_complex64_mode:
-                # Complex64 mode - single-precision complex {float, float}
-                success = jit_instance.compile_complex64(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_complex64_callable(func.__name__, param_count)
-            elif use_optional_f64_mode:
-                # Optional<f64> mode - nullable float64 {i1, f64}
-                success = jit_instance.compile_optional_f64(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_optional_f64_callable(func.__name__, param_count)
-            else:
-                # Object mode - handles Python objects with closure support
-                # Bug #4 Fix: Pass globals_dict and builtins_dict for runtime lookup
-                # Bug #3 Fix: Pass exception_table for try/except handling
-                success = jit_instance.compile(
-                    instructions,
-                    constants,
-                    names,
-                    globals_dict,
-                    builtins_dict,
-                    closure_cells,
-                    exception_table,
-                    func.__name__,
-                    param_count,
-                    total_locals,
-                    nlocals,
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_callable(func.__name__, param_count)
+    The manifest must come from the same justjit version, Python version
+    and platform as this process; otherwise the objects could not be used
+    and RuntimeError is raised (the object cache key also covers the host
+    CPU and the LLVM version, so a mismatch there only costs a compile).
 
-            if compiled_ptr is None:
-                return func(*args, **kwargs)
+    A directory built with ``targets`` also selects, once, the most capable
+    of them this CPU supports (see select_target): later compiles with
+    ``target_cpu='native'`` generate code for it, so they find its objects.
 
-        try:
-            return compiled_ptr(*args, **kwargs)
-        except Exception:
-            return func(*args, **kwargs)
+    Args:
+        path: Directory written by aot
 
-    wrapper.__name__ = func.__name__
-    wrapper.__doc__ = func.__doc__
-    wrapper._jit_instance = jit_instance
-    wrapper._original_func = func
-    wrapper._instructions = instructions
-    wrapper._mode = "int" if use_int_mode else ("float" if use_float_mode else ("bool" if use_bool_mode else ("int32" if use_int32_mode else ("float32" if use_float32_mode else ("complex128" if use_complex128_mode else ("ptr" if use_ptr_mode else ("vec4f" if use_vec4f_mode else ("vec8i" if use_vec8i_mode else ("complex64" if use_complex64_mode else ("optional_f64" if use_optional_f64_mode else "object"))))))))))
-    return wrapper
+    Returns:
+        dict: Its manifest, with the selected CPU under ``"target"`` when it
+        lists targets
+    """
+    import json
 
+    global _fleet_target
 
-def dump_ir(func):
+    with open(os.path.join(path, AOT_MANIFEST)) as f:
+        manifest = json.load(f)
+    expected = _aot_target()
+    mismatched = [key for key, value in expected.items() if manifest.get(key) != value]
+    if mismatched:
+        details = ", ".join(f"{key} {manifest.get(key)!r} != {expected[key]!r}" for key in mismatched)
+        raise RuntimeError(f"justjit: {path} was built for another target ({details})")
+    if manifest.get("targets"):
+        selected = select_target(manifest["targets"])
+        if selected is None:
+            raise RuntimeError(f"justjit: this CPU supports none of the targets {path} was built for "
+                               f"({', '.join(manifest['targets'])})")
+        _fleet_target = selected
+        manifest["target"] = selected
+    set_cache_dir(os.path.abspath(path))
+    return manifest
+
+
+PROFILE_VERSION = 1
+
+
+def _native_calls(func):
+    """native_calls of a @jit function, 0 for anything counters() rejects."""
+    try:
+        return counters(func)["native_calls"]
+    except TypeError:
+        return 0
+
+
+def _profile_entry(obj):
+    """What warmup needs to rebuild ``obj``'s compiled code, or None if it has none."""
+    if isinstance(obj, _LazyJITWrapper):
+        obj = obj._target
+        if obj is None:
+            return None
+    if callable(getattr(obj, "_warm_static", None)):
+        values = [[float.fromhex(v) if t is float else v for t, v in key] for key in list(obj.static_variants)]
+        if not values:
+            return None
+        calls = sum(_native_calls(variant) for variant in list(obj.static_variants.values()))
+        return {"mode": "static", "calls": calls, "static_values": values}
+    own = getattr(obj, "_counters", None)
+    if own is None:
+        return None
+    if callable(getattr(obj, "_warm_mode", None)):
+        modes = obj._variant_modes()
+        if not modes:
+            return None
+        return {"mode": "auto", "calls": _native_calls(obj), "modes": modes}
+    if own.get("compile_attempts", 0) == 0 and _native_calls(obj) == 0:
+        return None
+    return {"mode": obj._mode, "calls": _native_calls(obj)}
+
+
+def save_profile(path):
     """
-    Dump the LLVM IR for a JIT-compiled function.
-    
+    Record which ``@jit`` functions this process compiled, for warmup.
+
+    Covers the module-level functions of every imported module: for each
+    one with compiled code, its module and name, its mode, how many calls
+    ran natively, and the variants it built (the modes a ``mode='auto'``
+    function was compiled in, the values of each ``static_args`` variant).
+    The file is JSON, hottest function first.
+
     Args:
-        func: A JIT-compiled function (decorated with @jit)
-        
+        path: File to write
+
     Returns:
-        str: The LLVM IR as a string, or None if function wasn't JIT compiled
-        
-    Example:
-        @jit
-        def add(a, b):
-            return a + b
-        
-        add(1, 2)  # Trigger compilation
-        print(dump_ir(add))
+        int: Number of functions recorded
     """
-    if not hasattr(func, '_jit_instance'):
-        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
-    
+    import json
+
+    functions = []
+    for module_name, module in list(sys.modules.items()):
+        if module is None:
+            continue
+        for name, obj in list(vars(module).items()):
+            # The decorated function, read without building a lazy stub
+            try:
+                origin = obj._func if isinstance(obj, _LazyJITWrapper) else getattr(obj, "_original_func", None)
+            except Exception:  # Proxies and other objects with their own __getattr__
+                continue
+            if not isinstance(origin, types.FunctionType) or origin.__module__ != module_name or origin.__name__ != name:
+                continue
+            entry = _profile_entry(obj)
+            if entry is not None:
+                functions.append({"module": module_name, "name": name, **entry})
+    functions.sort(key=lambda e: -e["calls"])
+    with open(path + ".tmp", "w") as f:
+        json.dump({"version": PROFILE_VERSION, "functions": functions}, f, indent=2)
+    os.replace(path + ".tmp", path)
+    return len(functions)
+
+
+def _warm_entry(entry):
+    """Compile what one save_profile entry describes; True if anything was built."""
+    import importlib
+
+    try:
+        obj = getattr(importlib.import_module(entry["module"]), entry["name"])
+    except (ImportError, AttributeError):
+        return False
+    if isinstance(obj, _LazyJITWrapper):
+        obj = obj._materialize()
+    try:
+        if entry["mode"] == "static" and callable(getattr(obj, "_warm_static", None)):
+            return any([obj._warm_static(values) for values in entry["static_values"]])
+        if entry["mode"] == "auto" and callable(getattr(obj, "_warm_mode", None)):
+            return any([obj._warm_mode(m) for m in entry["modes"]])
+        warm = getattr(obj, "_warmup", None)
+        # Native entries compiled when the wrapper was built
+        return bool(warm()) if callable(warm) else hasattr(obj, "_counters")
+    except Exception:
+        return False
+
+
+def warmup(path, threads=None):
+    """
+    Compile, at startup, what a previous process recorded with save_profile.
+
+    The functions are imported by module and name and compiled on a pool of
+    worker threads, hottest first: each mode an auto function was compiled
+    in, each static_args variant, and everything else as compile_all would.
+    Together with an object cache directory (set_cache_dir, load_aot),
+    typed-mode code is then loaded rather than optimized again. Entries
+    whose module or function no longer exists are skipped.
+
+    Args:
+        path: File written by save_profile
+        threads: Number of worker threads (default: one per CPU)
+
+    Returns:
+        int: Number of functions warmed up
+    """
+    import json
+    from concurrent.futures import ThreadPoolExecutor
+
+    with open(path) as f:
+        profile = json.load(f)
+    if profile.get("version") != PROFILE_VERSION:
+        raise ValueError(f"justjit: {path} is not a version {PROFILE_VERSION} profile")
+    entries = profile["functions"]
+    if not entries:
+        return 0
+    workers = min(threads or os.cpu_count() or 1, len(entries))
+    with ThreadPoolExecutor(max_workers=workers, thread_name_prefix="justjit-warmup") as pool:
+        return sum(pool.map(_warm_entry, entries))
+
+
+def _recompile(func, new_name):
+    """Compile ``func`` again, in its current mode, under ``new_name``."""
     jit_instance = func._jit_instance
     original_func = func._original_func
     
-    # Enable IR dump and recompile
-    jit_instance.set_dump_ir(True)
-    
     # Get compilation parameters
     instructions = func._instructions
     constants = _extract_constants(original_func)
@@ -1075,7 +4425,7 @@ def dump_ir(func):
     globals_dict = _extract_globals(original_func)
     builtins_dict = _extract_builtins(original_func)
     closure_cells = _extract_closure(original_func)
-    exception_table = _parse_exception_table(original_func)
+    exception_table = original_func.__code__
     
     code = original_func.__code__
     param_count = code.co_argcount
@@ -1084,52 +4434,71 @@ def dump_ir(func):
     num_freevars = len(code.co_freevars)
     total_locals = nlocals + num_cellvars + num_freevars
     
-    # Compile with a unique name to capture IR
-    ir_name = f"{original_func.__name__}_ir_dump"
-    
-    if func._mode == "int":
+    if getattr(func, "_is_jit_generator", False) and func._mode in _TYPED_GENERATOR_MODES:
+        jit_instance.compile_typed_generator(
+            instructions, constants, names, new_name, param_count, nlocals, code.co_stacksize, func._mode
+        )
+    elif func._mode in ("generator", "coroutine", "async_generator"):
+        jit_instance.compile_generator(
+            instructions, constants, names, globals_dict, builtins_dict, closure_cells,
+            exception_table, new_name, param_count, total_locals, nlocals,
+        )
+    elif func._mode == "int":
         jit_instance.compile_int(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals,
+            _typed_names(original_func, names, "int", _instructions(original_func), func._jit_callees),
+        )
+    elif func._mode == "uint64":
+        jit_instance.compile_uint64(
+            instructions, constants, new_name, param_count, total_locals,
+            _typed_names(original_func, names, "uint64", _instructions(original_func), func._jit_callees),
         )
     elif func._mode == "float":
         jit_instance.compile_float(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals,
+            _typed_names(original_func, names, "float", _instructions(original_func), func._jit_callees),
         )
     elif func._mode == "bool":
         jit_instance.compile_bool(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals
         )
     elif func._mode == "int32":
         jit_instance.compile_int32(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals,
+            _typed_names(original_func, names, "int32", _instructions(original_func), func._jit_callees),
         )
     elif func._mode == "float32":
         jit_instance.compile_float32(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals,
+            _math_names(original_func, names),
         )
     elif func._mode == "complex128":
         jit_instance.compile_complex128(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals
         )
     elif func._mode == "ptr":
         jit_instance.compile_ptr(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals
         )
-    elif func._mode == "vec4f":
-        jit_instance.compile_vec4f(
-            instructions, constants, ir_name, param_count, total_locals
-        )
-    elif func._mode == "vec8i":
-        jit_instance.compile_vec8i(
-            instructions, constants, ir_name, param_count, total_locals
+    elif _vec_mode(func._mode) is not None:
+        lanes, kind = _vec_mode(func._mode)
+        jit_instance.compile_vec(
+            instructions, constants, new_name, param_count, total_locals, kind, lanes
         )
     elif func._mode == "complex64":
         jit_instance.compile_complex64(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals
         )
     elif func._mode == "optional_f64":
         jit_instance.compile_optional_f64(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, new_name, param_count, total_locals
+        )
+    elif func._mode in ("ndarray", "mixed"):
+        if func._ndarray_signature is None:
+            raise ValueError(f"{func._mode}-mode functions are compiled per argument layout; call it first.")
+        jit_instance.compile_ndarray(
+            instructions, constants, _math_names(original_func, names), new_name, param_count, total_locals,
+            func._ndarray_signature,
         )
     else:
         jit_instance.compile(
@@ -1140,16 +4509,120 @@ def dump_ir(func):
             builtins_dict,
             closure_cells,
             exception_table,
-            ir_name,
-            param_count,
+            new_name,
+            _param_slot_count(code),
             total_locals,
             nlocals,
         )
     
-    ir = jit_instance.get_last_ir()
-    jit_instance.set_dump_ir(False)
+
+
+def dump_ir(func):
+    """
+    Dump the LLVM IR for a JIT-compiled function.
+    
+    Args:
+        func: A JIT-compiled function (decorated with @jit)
+        
+    Returns:
+        str: The LLVM IR as a string, or None if function wasn't JIT compiled
+        
+    Example:
+        @jit
+        def add(a, b):
+            return a + b
+        
+        add(1, 2)  # Trigger compilation
+        print(dump_ir(add))
+    """
+    if not hasattr(func, '_jit_instance'):
+        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
+    
+    jit_instance = func._jit_instance
+    
+    # Enable IR dump and recompile under a unique name to capture IR
+    ir_name = f"{func._original_func.__name__}_ir_dump"
+    jit_instance.set_dump_ir(True)
+    try:
+        _recompile(func, ir_name)
+    finally:
+        jit_instance.set_dump_ir(False)
+        jit_instance.release_function(ir_name)
     
-    return ir
+    return jit_instance.get_last_ir()
+
+
+
+def dump_asm(func):
+    """
+    Dump the native assembly for a JIT-compiled function.
+
+    Recompiles ``func`` in its current mode and returns the machine code the
+    engine generates for it, as assembly. The first lines name the target
+    triple, CPU and features the code was generated for, so the instruction
+    selection (AVX2, FMA, ...) can be checked against the machine.
+
+    Args:
+        func: A JIT-compiled function (decorated with @jit)
+
+    Returns:
+        str: The assembly text
+
+    Example:
+        asm = dump_asm(dot)
+        print("vfmadd" in asm)
+    """
+    if not hasattr(func, '_jit_instance'):
+        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
+
+    jit_instance = func._jit_instance
+    asm_name = f"{func._original_func.__name__}_asm_dump"
+    jit_instance.set_dump_asm(True)
+    try:
+        _recompile(func, asm_name)
+    finally:
+        jit_instance.set_dump_asm(False)
+        jit_instance.release_function(asm_name)
+
+    return jit_instance.get_last_asm()
+
+def opt_remarks(func):
+    """
+    Optimization remarks for a JIT-compiled function.
+
+    Recompiles ``func`` with LLVM's remarks on and returns what the
+    optimizer did and did not do: loops it vectorized or could not
+    vectorize (and why), calls it inlined or kept, and so on.
+
+    Args:
+        func: A JIT-compiled function (decorated with @jit)
+
+    Returns:
+        list[dict]: One dict per remark with ``kind`` ("missed", "passed"
+        or "analysis"), ``pass``, ``name``, ``message``, ``function``, the
+        Python ``line`` (0 when unknown) and the bytecode ``offset`` (None
+        when unknown), matching ``dis`` offsets of the original function.
+
+    Example:
+        for r in opt_remarks(total):
+            if r["kind"] == "missed":
+                print(r["offset"], r["pass"], r["message"])
+    """
+    if not hasattr(func, '_jit_instance'):
+        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
+
+    jit_instance = func._jit_instance
+    original_func = func._original_func
+    code = original_func.__code__
+    remarks_name = f"{original_func.__name__}_remarks"
+    jit_instance.set_source_info(remarks_name, original_func.__qualname__, code.co_filename, code.co_firstlineno)
+    jit_instance.set_opt_remarks(True)
+    try:
+        _recompile(func, remarks_name)
+        return jit_instance.get_opt_remarks(remarks_name)
+    finally:
+        jit_instance.set_opt_remarks(False)
+        jit_instance.release_function(remarks_name)
 
 
 # ============================================================================
@@ -1178,7 +4651,19 @@ def dump_c_ir():
     return None
 
 
-def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=False):
+def remove_c_unit(unit):
+    """
+    Free the code of an ``inline_c`` compilation unit.
+
+    Callables from the unit must not be called afterwards. Does nothing if
+    the unit does not exist.
+    """
+    if _global_c_compiler is not None:
+        _global_c_compiler.remove_unit(unit)
+
+
+def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=False,
+             opt_level=2, march=None, flags=None, openmp=False, unit=None, nogil=False):
     """
     Compile C/C++ code at runtime and return callable functions.
     
@@ -1190,6 +4675,20 @@ def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=Fal
         lang: "c" or "c++" (default: "c")
         captured_vars: dict of Python variables to inject into C code
         include_paths: list of additional include directories
+        opt_level: clang optimization level, 0-3 (default: 2)
+        march: CPU to generate code for, e.g. "skylake-avx512", or "native"
+            for the host; by default the JIT's target (see JIT.set_target)
+        flags: list of extra clang frontend flags, e.g. ["-ffast-math"]
+        openmp: compile with -fopenmp so ``#pragma omp`` loops run in
+            parallel; needs the LLVM OpenMP runtime (libomp)
+        unit: name of a compilation unit to add the functions to. A function
+            already in the unit is replaced, and callables returned for it
+            earlier call the new code; unchanged functions are kept as is.
+        nogil: release the GIL around calls to functions that read captured
+            objects or use Python.h macros. Such code is otherwise assumed to
+            need the GIL; pass True only if it never touches a Python object
+            another thread could change. Functions that call the Python C API
+            or jit_* helpers keep the GIL regardless.
         
     Returns:
         dict containing:
@@ -1284,7 +4783,8 @@ def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=Fal
     if dump_ir and _global_jit_for_c:
         _global_jit_for_c.set_dump_ir(True)
     
-    result = _global_c_compiler.compile(code, lang, captured_vars)
+    result = _global_c_compiler.compile(code, lang, captured_vars, opt_level,
+                                        march or "", list(flags or ()), openmp, unit or "", nogil)
     
     # Capture IR if requested
     if dump_ir and _global_jit_for_c:
@@ -0,0 +1,42 @@
+"""
+Command line entry point: ``python -m justjit`` (or ``justjit``).
+
+Subcommands:
+    aot MODULE -o DIR [--target CPU ...]
+                        compile MODULE's @jit functions into DIR (see justjit.aot)
+"""
+
+import argparse
+import os
+import sys
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="justjit", description="JustJIT command line tools")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    aot_parser = commands.add_parser("aot", help="compile a module's @jit functions ahead of time")
+    aot_parser.add_argument("module", help="dotted name of the module to import")
+    aot_parser.add_argument("-o", "--output", default="justjit-aot", help="output directory (default: justjit-aot)")
+    aot_parser.add_argument("--threads", type=int, help="compile threads (default: one per CPU)")
+    aot_parser.add_argument("--target", action="append", default=[], metavar="CPU",
+                            help="build for this LLVM CPU, e.g. x86-64-v3 (repeatable, least capable first; "
+                                 "default: this machine's CPU)")
+    aot_parser.add_argument("--path", action="append", default=[],
+                            help="prepend a directory to sys.path before importing (repeatable)")
+    args = parser.parse_args(argv)
+
+    import justjit
+
+    if args.command == "aot":
+        sys.path[:0] = [os.path.abspath(p) for p in args.path] or [os.getcwd()]
+        manifest = justjit.aot(args.module, args.output, threads=args.threads, targets=args.target or None)
+        for entry in manifest["functions"]:
+            print(f"  {entry['name']:<32} {entry['mode']}")
+        targets = f" for {', '.join(manifest['targets'])}" if manifest.get("targets") else ""
+        print(f"{len(manifest['functions'])} functions, {len(manifest['objects'])} objects in {args.output}{targets}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,103 @@
+"""
+Typed containers for mode='ndarray' kernels.
+
+``List[int64]`` and ``Dict[int64, float64]`` make lists and dicts whose
+items live unboxed in C++ storage (a growable vector, an open-addressing
+hash table). A kernel taking one indexes, appends to and looks up in it
+natively, with no Python objects; Python code sees ints and floats, made
+when an item is read::
+
+    from justjit.typed import List, Dict, int64, float64
+
+    @justjit.jit(mode="ndarray")
+    def histogram(xs, counts):
+        for i in range(len(xs)):
+            k = xs[i] // 10
+            counts[k] = counts.get(k, 0.0) + 1.0
+
+    counts = Dict[int64, float64]()
+    histogram(List[int64]([3, 14, 15, 92]), counts)
+
+Keys are int64; items and values are int64 or float64.
+"""
+
+from ._core import TypedList, TypedDict
+
+__all__ = ["List", "Dict", "int64", "float64", "TypedList", "TypedDict"]
+
+# Item types, as their struct format codes
+int64 = "q"
+float64 = "d"
+
+_KINDS = {int64: "q", float64: "d", int: "q", float: "d"}
+
+
+def _kind(item_type, what):
+    kind = _KINDS.get(item_type)
+    if kind is None:
+        raise TypeError(f"{what} must be int64 or float64, not {item_type!r}")
+    return kind
+
+
+class _ListType:
+    """``List[<item type>]``: calling it makes a TypedList."""
+
+    def __init__(self, kind):
+        self.kind = kind
+
+    def __call__(self, items=()):
+        out = TypedList(self.kind)
+        for item in items:
+            out.append(item)
+        return out
+
+    def __instancecheck__(self, obj):
+        return isinstance(obj, TypedList) and obj.kind == self.kind
+
+    def __repr__(self):
+        return f"List[{'int64' if self.kind == 'q' else 'float64'}]"
+
+
+class _DictType:
+    """``Dict[int64, <value type>]``: calling it makes a TypedDict."""
+
+    def __init__(self, value_kind):
+        self.value_kind = value_kind
+
+    def __call__(self, entries=()):
+        out = TypedDict(self.value_kind)
+        if hasattr(entries, "items"):
+            entries = entries.items()
+        for key, value in entries:
+            out[key] = value
+        return out
+
+    def __instancecheck__(self, obj):
+        return isinstance(obj, TypedDict) and obj.value_kind == self.value_kind
+
+    def __repr__(self):
+        return f"Dict[int64, {'int64' if self.value_kind == 'q' else 'float64'}]"
+
+
+class List:
+    """``List[int64]`` / ``List[float64]``; see the module docstring."""
+
+    def __new__(cls, *args, **kwargs):
+        raise TypeError("use List[int64](...) or List[float64](...)")
+
+    def __class_getitem__(cls, item_type):
+        return _ListType(_kind(item_type, "List items"))
+
+
+class Dict:
+    """``Dict[int64, int64]`` / ``Dict[int64, float64]``; see the module docstring."""
+
+    def __new__(cls, *args, **kwargs):
+        raise TypeError("use Dict[int64, float64](...) or Dict[int64, int64](...)")
+
+    def __class_getitem__(cls, types):
+        if not isinstance(types, tuple) or len(types) != 2:
+            raise TypeError("Dict takes a key and a value type")
+        if _kind(types[0], "Dict keys") != "q":
+            raise TypeError("Dict keys must be int64")
+        return _DictType(_kind(types[1], "Dict values"))
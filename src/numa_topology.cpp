@@ -0,0 +1,248 @@
+/**
+ * numa_topology.cpp - Detecting NUMA nodes and pinning threads
+ *
+ * On Linux the nodes are /sys/devices/system/node/node<N>/cpulist, each
+ * narrowed to the CPUs sched_getaffinity allows (a container's cpuset, a
+ * taskset); nodes left without CPUs are dropped. Elsewhere, or when sysfs
+ * has no node directories, all CPUs form one node.
+ */
+
+#include "numa_topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace justjit {
+
+namespace {
+
+std::mutex topology_mutex;
+NumaTopology* topology = nullptr;  // Never destroyed: pool workers outlive exit
+bool topology_read = false;        // Fixed from then on
+
+// CPUs this process may run on, in increasing order
+std::vector<int> allowed_cpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    constexpr int kMaxCpus = 8192;
+    cpu_set_t* set = CPU_ALLOC(kMaxCpus);
+    size_t size = CPU_ALLOC_SIZE(kMaxCpus);
+    if (set != nullptr && sched_getaffinity(0, size, set) == 0) {
+        for (int cpu = 0; cpu < kMaxCpus; cpu++) {
+            if (CPU_ISSET_S(cpu, size, set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (set != nullptr) {
+        CPU_FREE(set);
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < count; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+// The sysfs nodes, narrowed to `allowed`, in node order
+std::vector<std::vector<int>> sysfs_nodes(const std::vector<int>& allowed)
+{
+    std::vector<std::pair<int, std::vector<int>>> found;
+#ifdef __linux__
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir != nullptr) {
+        while (dirent* entry = readdir(dir)) {
+            int id;
+            char rest;
+            if (std::sscanf(entry->d_name, "node%d%c", &id, &rest) != 1) {
+                continue;
+            }
+            std::ifstream file(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string line;
+            std::vector<int> cpus;
+            if (!std::getline(file, line) || !parse_cpu_list(line, cpus)) {
+                continue;
+            }
+            std::vector<int> usable;
+            std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(), std::back_inserter(usable));
+            if (!usable.empty()) {
+                found.emplace_back(id, std::move(usable));
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(found.begin(), found.end());
+    std::vector<std::vector<int>> nodes;
+    for (auto& node : found) {
+        nodes.push_back(std::move(node.second));
+    }
+    return nodes;
+}
+
+NumaTopology detect_topology()
+{
+    std::vector<int> allowed = allowed_cpus();
+    NumaTopology detected;
+    if (const char* env = std::getenv("JUSTJIT_NUMA_NODES")) {
+        std::string spec(env);
+        if (spec != "off") {
+            std::stringstream parts(spec);
+            std::string part;
+            while (std::getline(parts, part, ';')) {
+                std::vector<int> cpus;
+                if (parse_cpu_list(part, cpus) && !cpus.empty()) {
+                    detected.nodes.push_back(std::move(cpus));
+                }
+            }
+        }
+    }
+    else {
+        detected.nodes = sysfs_nodes(allowed);
+    }
+    if (detected.nodes.empty()) {
+        detected.nodes.push_back(std::move(allowed));
+    }
+    return detected;
+}
+
+}  // namespace
+
+size_t NumaTopology::cpu_count() const
+{
+    size_t count = 0;
+    for (const auto& node : nodes) {
+        count += node.size();
+    }
+    return count;
+}
+
+size_t NumaTopology::node_of(int cpu) const
+{
+    for (size_t k = 0; k < nodes.size(); k++) {
+        if (std::binary_search(nodes[k].begin(), nodes[k].end(), cpu)) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+bool parse_cpu_list(const std::string& text, std::vector<int>& cpus)
+{
+    std::stringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace((unsigned char)c); }),
+                    range.end());
+        if (range.empty()) {
+            continue;
+        }
+        int first;
+        int last;
+        char dash;
+        char rest;
+        std::stringstream bounds(range);
+        if (!(bounds >> first) || first < 0) {
+            return false;
+        }
+        last = first;
+        if (bounds >> dash) {
+            if (dash != '-' || !(bounds >> last) || last < first) {
+                return false;
+            }
+        }
+        if (bounds >> rest) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+const NumaTopology& jit_numa_topology()
+{
+    std::lock_guard<std::mutex> lock(topology_mutex);
+    if (topology == nullptr) {
+        topology = new NumaTopology(detect_topology());
+    }
+    topology_read = true;
+    return *topology;
+}
+
+bool jit_set_numa_topology(NumaTopology replacement)
+{
+    for (auto& node : replacement.nodes) {
+        if (node.empty()) {
+            return false;
+        }
+        std::sort(node.begin(), node.end());
+        node.erase(std::unique(node.begin(), node.end()), node.end());
+    }
+    if (replacement.nodes.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(topology_mutex);
+    if (topology_read) {
+        return false;
+    }
+    delete topology;
+    topology = new NumaTopology(std::move(replacement));
+    return true;
+}
+
+bool jit_pin_thread(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    if (cpus.empty()) {
+        return false;
+    }
+    int max_cpu = *std::max_element(cpus.begin(), cpus.end());
+    cpu_set_t* set = CPU_ALLOC(max_cpu + 1);
+    if (set == nullptr) {
+        return false;
+    }
+    size_t size = CPU_ALLOC_SIZE(max_cpu + 1);
+    CPU_ZERO_S(size, set);
+    for (int cpu : cpus) {
+        CPU_SET_S(cpu, size, set);
+    }
+    bool pinned = pthread_setaffinity_np(pthread_self(), size, set) == 0;
+    CPU_FREE(set);
+    return pinned;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+int jit_current_cpu()
+{
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+}  // namespace justjit
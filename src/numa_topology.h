@@ -0,0 +1,60 @@
+/**
+ * numa_topology.h - NUMA nodes of the CPUs the parallel pool runs on
+ *
+ * Provides:
+ * - NumaTopology: per node, the CPUs of this process's affinity mask on it
+ * - jit_numa_topology: the topology the parallel pool is built for, read
+ *   once from sysfs (Linux) or from JUSTJIT_NUMA_NODES
+ * - jit_set_numa_topology: an explicit topology, before the pool starts
+ * - jit_pin_thread / jit_current_cpu: thread placement
+ * - jit_first_touch_zero: zero memory the way parallel jobs partition it
+ *
+ * The pool (jit_core.cpp) pins each worker to the CPUs of one node and
+ * gives every node a contiguous share of each job's range, in proportion
+ * to its threads. Items a node first touched in one parallel call (pages
+ * land on the node of the thread that first writes them) are the ones it
+ * works on in the next call over the same range.
+ *
+ * JUSTJIT_NUMA_NODES overrides the detected nodes, for containers whose
+ * sysfs does not match their cpuset: CPU lists separated by ';', such as
+ * "0-15,32-47;16-31,48-63", or "off" for one node without pinning.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace justjit {
+
+struct NumaTopology {
+    std::vector<std::vector<int>> nodes;  // CPU numbers of each node, none empty
+
+    size_t cpu_count() const;
+    // Index into `nodes` of the node holding `cpu`, or 0
+    size_t node_of(int cpu) const;
+};
+
+// Parsed "0-3,8,10-11" into `cpus`; false if malformed
+bool parse_cpu_list(const std::string& text, std::vector<int>& cpus);
+
+// The topology, detected on first use; after that it no longer changes
+const NumaTopology& jit_numa_topology();
+
+// Use `topology` instead of the detected one; false once jit_numa_topology
+// has been read (the pool exists) or if a node is empty
+bool jit_set_numa_topology(NumaTopology topology);
+
+// Restrict the calling thread to `cpus`; false where unsupported
+bool jit_pin_thread(const std::vector<int>& cpus);
+
+// CPU the calling thread runs on, or -1 if unknown
+int jit_current_cpu();
+
+// memset(data, 0, bytes) on the parallel pool, each node zeroing the bytes
+// of the 8-byte items a parallel job over them would give it (defined with
+// the pool in jit_core.cpp)
+void jit_first_touch_zero(void* data, size_t bytes);
+
+}  // namespace justjit
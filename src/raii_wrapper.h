@@ -5,7 +5,8 @@
  * - ScopeGuard: Generic cleanup on scope exit
  * - GILGuard/GILRelease: Python GIL management
  * - PyObjectPtr: Python object lifetime management
- * - NumpyBuffer: Zero-copy NumPy array access
+ * - NumpyBuffer: Zero-copy NumPy array access (any buffer, __array_interface__
+ *   or DLPack array; see foreign_arrays.h)
  * - Type converters: Python <-> C type conversion
  */
 
@@ -13,6 +14,7 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include "foreign_arrays.h"
 #include <utility>
 #include <functional>
 #include <type_traits>
@@ -165,7 +167,7 @@ public:
     
     explicit NumpyBuffer(PyObject* arr) noexcept : valid_(false) {
         view_.obj = nullptr;
-        if (PyObject_GetBuffer(arr, &view_, PyBUF_STRIDES | PyBUF_FORMAT) == 0) {
+        if (jit_get_buffer(arr, &view_, PyBUF_STRIDES | PyBUF_FORMAT) == 0) {
             valid_ = true;
         }
     }
@@ -208,6 +210,7 @@ public:
     Py_ssize_t* strides() const noexcept { return view_.strides; }
     const char* format() const noexcept { return view_.format; }
     bool readonly() const noexcept { return view_.readonly != 0; }
+    bool contiguous() const noexcept { return PyBuffer_IsContiguous(&view_, 'C') != 0; }
     
     // Typed access
     template<typename T>
@@ -0,0 +1,99 @@
+/**
+ * spsc_queue.h - Bounded lock-free single-producer single-consumer ring
+ *
+ * Provides:
+ * - SpscQueue<T>: fixed-capacity FIFO between exactly two threads
+ *
+ * One thread pushes and one thread pops; neither takes a lock. The head
+ * and tail counters sit on their own cache lines so the two sides do not
+ * share one, and each side keeps a cached copy of the other's counter,
+ * reloading it only when the ring looks full (or empty). push and pop
+ * never block; the *_wait variants spin, yielding the thread between
+ * attempts, and are what run_generator_pipeline connects its stages with.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace justjit {
+
+// ============================================================================
+// SpscQueue - Power-of-two ring of T, moved in and out
+// ============================================================================
+template <typename T>
+class SpscQueue {
+public:
+    // Rounds `capacity` up to a power of two (at least 2)
+    explicit SpscQueue(size_t capacity) {
+        size_t slots = 2;
+        while (slots < capacity) {
+            slots *= 2;
+        }
+        mask_ = slots - 1;
+        items_.reset(new T[slots]);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side: false if the ring is full (`item` is left as it was)
+    bool push(T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) {
+                return false;
+            }
+        }
+        items_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: false if the ring is empty
+    bool pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        item = std::move(items_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push_wait(T& item) {
+        while (!push(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void pop_wait(T& item) {
+        while (!pop(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    std::unique_ptr<T[]> items_;
+    size_t mask_ = 0;
+
+    // Consumer-owned: its position, and the producer's as it last saw it
+    alignas(kLine) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+
+    // Producer-owned
+    alignas(kLine) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+};
+
+} // namespace justjit
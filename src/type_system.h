@@ -26,6 +26,7 @@ enum class JITType : uint8_t
     VEC8I = 10,   // <8 x i32> (AVX SIMD)
     COMPLEX64 = 11, // {float, float} (single-precision complex)
     OPTIONAL_F64 = 12, // {i1, f64} (nullable float64)
+    VEC = 13,     // <N x T> (width-generic SIMD; VEC4F / VEC8I are two of its shapes)
 };
 
 // Convert JITType to LLVM Type
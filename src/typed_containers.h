@@ -0,0 +1,197 @@
+/**
+ * typed_containers.h - Growable containers of unboxed int64/float64 values
+ *
+ * Provides:
+ * - TypedList: contiguous vector of 8-byte items
+ * - TypedDict: open-addressing hash map from int64 keys to 8-byte values
+ *
+ * Both are plain C structs that compiled ndarray-mode kernels read and
+ * write in place (see NdarrayKernelBuilder): items, keys and values are
+ * raw 8-byte slots holding an int64 or the bits of a double, as `kind`
+ * says. Growing goes through the member functions, which never touch
+ * Python, so kernels may run them with the GIL released. They report a
+ * failed allocation by returning false / -1.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace justjit {
+
+// ============================================================================
+// TypedList - Contiguous int64 / float64 items
+// ============================================================================
+struct TypedList {
+    int64_t size = 0;
+    int64_t capacity = 0;
+    uint64_t* data = nullptr;
+    char kind = 'q';  // 'q' int64, 'd' float64
+
+    TypedList() = default;
+    explicit TypedList(char kind) : kind(kind) {}
+    TypedList(const TypedList&) = delete;
+    TypedList& operator=(const TypedList&) = delete;
+    ~TypedList() { std::free(data); }
+
+    bool reserve(int64_t wanted) {
+        if (wanted <= capacity) {
+            return true;
+        }
+        int64_t grown = capacity < 8 ? 8 : capacity * 2;
+        if (grown < wanted) {
+            grown = wanted;
+        }
+        void* moved = std::realloc(data, static_cast<size_t>(grown) * sizeof(uint64_t));
+        if (moved == nullptr) {
+            return false;
+        }
+        data = static_cast<uint64_t*>(moved);
+        capacity = grown;
+        return true;
+    }
+
+    bool append(uint64_t bits) {
+        if (size == capacity && !reserve(size + 1)) {
+            return false;
+        }
+        data[size++] = bits;
+        return true;
+    }
+};
+
+// ============================================================================
+// TypedDict - int64 keys, linear probing over a power-of-two table
+// ============================================================================
+struct TypedDict {
+    int64_t size = 0;
+    int64_t capacity = 0;  // Slots; 0 or a power of two
+    int64_t* keys = nullptr;
+    uint64_t* values = nullptr;
+    uint8_t* used = nullptr;
+    char value_kind = 'd';  // 'q' int64, 'd' float64
+
+    TypedDict() = default;
+    explicit TypedDict(char value_kind) : value_kind(value_kind) {}
+    TypedDict(const TypedDict&) = delete;
+    TypedDict& operator=(const TypedDict&) = delete;
+    ~TypedDict() { release(); }
+
+    // Slot holding `key`, or -1
+    int64_t find(int64_t key) const {
+        if (capacity == 0) {
+            return -1;
+        }
+        uint64_t mask = static_cast<uint64_t>(capacity) - 1;
+        for (uint64_t slot = hash(key) & mask;; slot = (slot + 1) & mask) {
+            if (!used[slot]) {
+                return -1;
+            }
+            if (keys[slot] == key) {
+                return static_cast<int64_t>(slot);
+            }
+        }
+    }
+
+    // Slot of `key`, added with a zero value if missing; -1 if the table
+    // could not grow
+    int64_t insert(int64_t key) {
+        if ((size + 1) * 4 > capacity * 3 && !rehash(capacity < 8 ? 8 : capacity * 2)) {
+            return -1;
+        }
+        uint64_t mask = static_cast<uint64_t>(capacity) - 1;
+        uint64_t slot = hash(key) & mask;
+        while (used[slot] && keys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (!used[slot]) {
+            used[slot] = 1;
+            keys[slot] = key;
+            values[slot] = 0;
+            ++size;
+        }
+        return static_cast<int64_t>(slot);
+    }
+
+    // Removes `key`; false if it was missing. Later entries of its probe
+    // run move up, so lookups need no tombstones.
+    bool erase(int64_t key) {
+        int64_t found = find(key);
+        if (found < 0) {
+            return false;
+        }
+        uint64_t mask = static_cast<uint64_t>(capacity) - 1;
+        uint64_t hole = static_cast<uint64_t>(found);
+        used[hole] = 0;
+        --size;
+        for (uint64_t slot = (hole + 1) & mask; used[slot]; slot = (slot + 1) & mask) {
+            uint64_t home = hash(keys[slot]) & mask;
+            // Move the entry into the hole unless its home lies after the
+            // hole (cyclically) up to the entry itself
+            bool stays = hole <= slot ? (hole < home && home <= slot) : (hole < home || home <= slot);
+            if (!stays) {
+                keys[hole] = keys[slot];
+                values[hole] = values[slot];
+                used[hole] = 1;
+                used[slot] = 0;
+                hole = slot;
+            }
+        }
+        return true;
+    }
+
+private:
+    // splitmix64 finalizer: consecutive keys spread over the table
+    static uint64_t hash(int64_t key) {
+        uint64_t x = static_cast<uint64_t>(key);
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    bool rehash(int64_t slots) {
+        auto* new_keys = static_cast<int64_t*>(std::malloc(static_cast<size_t>(slots) * sizeof(int64_t)));
+        auto* new_values = static_cast<uint64_t*>(std::malloc(static_cast<size_t>(slots) * sizeof(uint64_t)));
+        auto* new_used = static_cast<uint8_t*>(std::calloc(static_cast<size_t>(slots), 1));
+        if (new_keys == nullptr || new_values == nullptr || new_used == nullptr) {
+            std::free(new_keys);
+            std::free(new_values);
+            std::free(new_used);
+            return false;
+        }
+        uint64_t mask = static_cast<uint64_t>(slots) - 1;
+        for (int64_t old = 0; old < capacity; ++old) {
+            if (!used[old]) {
+                continue;
+            }
+            uint64_t slot = hash(keys[old]) & mask;
+            while (new_used[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            new_used[slot] = 1;
+            new_keys[slot] = keys[old];
+            new_values[slot] = values[old];
+        }
+        release();
+        keys = new_keys;
+        values = new_values;
+        used = new_used;
+        capacity = slots;
+        return true;
+    }
+
+    void release() {
+        std::free(keys);
+        std::free(values);
+        std::free(used);
+        keys = nullptr;
+        values = nullptr;
+        used = nullptr;
+    }
+};
+
+} // namespace justjit
@@ -38,6 +38,13 @@ def main():
             failed += 1
             return False
 
+    def raised(fn, *args):
+        try:
+            fn(*args)
+        except Exception as e:
+            return type(e).__name__
+        return None
+
     print("=" * 70)
     print("JustJIT CI Test Suite - Comprehensive")
     print("=" * 70)
@@ -73,6 +80,21 @@ def main():
     check("int add", int_add(3, 5), 8)
     check("int double", int_double(7), 14)
 
+    # Results beyond 64 bits rerun in the interpreter (checked=True)
+    @jit(mode='int')
+    def int_mul(a, b):
+        return a * b
+
+    check("int overflow gives big int", int_mul(2**40, 2**40), 2**80)
+    check("int overflow counted as deopt", justjit.counters(int_mul)["deopts"], 1)
+    check("int overflow near the limit", int_mul(3, 3**39), 3**40)
+
+    @jit(mode='int', checked=False)
+    def int_mul_wrapping(a, b):
+        return a * b
+
+    check("unchecked int wraps", int_mul_wrapping(2**32, 2**32), 0)
+
     # float mode (f64)
     @jit(mode='float')
     def float_mul(a, b):
@@ -210,6 +232,173 @@ def main():
         print("  [FAIL] float mode IR not generated")
         failed += 1
 
+    asm = justjit.dump_asm(float_mul)
+    check("dump_asm names the target", asm.startswith("; target: ") and "; features: " in asm, True)
+    check("dump_asm emits the function", "float_mul_asm_dump" in asm, True)
+
+    # Inspection compiles are released right away, so dumps can repeat
+    names = float_mul._jit_instance.get_compiled_names()
+    check("inspection compiles released", ("float_mul" in names, "float_mul_asm_dump" in names), (True, False))
+    check("dump_ir repeats", "define" in (dump_ir(float_mul) or ""), True)
+    check("release unknown name", float_mul._jit_instance.release_function("float_mul_ir_dump"), False)
+
+    # Code objects are decoded natively, as dis does (caches skipped)
+    import dis
+
+    def decode_sample(n):
+        total = 0
+        for i in range(n):
+            try:
+                total += i
+            except ValueError:
+                pass
+        return total
+
+    check("decode_bytecode matches dis", justjit.JIT.decode_bytecode(decode_sample.__code__),
+          [(i.opcode, i.arg or 0, i.offset) for i in dis.get_instructions(decode_sample)])
+
+    def dict_add(a, b):
+        return a + b
+
+    legacy = justjit.JIT()
+    legacy.compile_int([{"opcode": i.opcode, "arg": i.arg or 0, "argval": 0, "offset": i.offset}
+                        for i in dis.get_instructions(dict_add)], [None], "dict_add", 2, 2)
+    check("instruction dicts still compile", legacy.get_int_callable("dict_add", 2)(2, 3), 5)
+
+    # Offsets and args are 32-bit: bytecode past 64 KiB, constants past EXTENDED_ARG
+    big_src = ("def big_branches(x):\n    t = 0\n"
+               + "".join(f"    if x > {i}:\n        t = t + 1\n" for i in range(3000))
+               + "    return t\n")
+    big_ns = {}
+    exec(big_src, big_ns)
+    check("large function exceeds 64 KiB", len(big_ns["big_branches"].__code__.co_code) > 65536, True)
+    big_branches = jit(mode="int")(big_ns["big_branches"])
+    check("large function compiles", "big_branches" in big_branches._jit_instance.get_compiled_names(), True)
+    check("large function result", big_branches(1500), 1500)
+
+    # memory_info: loaded bytes and pinned objects per compiled name
+    @jit(mode="object")
+    def memory_probe(a):
+        return a + 12345
+
+    memory_probe(1)
+    info = justjit.memory_info()
+    probe = [f for f in info["functions"] if f["name"] == "memory_probe"]
+    check("memory_info lists function", len(probe) == 1 and probe[0]["code_bytes"] > 0, True)
+    check("memory_info pinned constants", probe[0]["constants"] >= 1 if probe else False, True)
+    check("memory_info engine and totals",
+          (info["lljit_instances"], info["jit_dylibs"] >= 1, info["code_bytes"] >= sum(f["code_bytes"] for f in probe)),
+          (1, True, True))
+
+    # Optimization remarks come back as dicts with a bytecode offset
+    remarks = justjit.opt_remarks(float_mul)
+    check("opt_remarks returns list", isinstance(remarks, list), True)
+    check("opt_remarks entries",
+          all({"kind", "pass", "message", "offset"} <= set(r) for r in remarks), True)
+
+    # Compile statistics: int_add was compiled and called in Test 2
+    records = [r for r in justjit.stats() if r["name"] == "int_add" and r["mode"] == "int"]
+    check("stats record for int_add", len(records) > 0, True)
+    if records:
+        r = records[0]
+        check("stats IR counted", r["ir_instructions"] > 0 and r["optimized_instructions"] > 0, True)
+        check("stats codegen measured", r["codegen_ms"] is not None and r["code_size"] > 0, True)
+    justjit.clear_stats()
+    check("stats cleared", justjit.stats(), [])
+
+    # Call counters: int_add is a native entry (one compile at decoration)
+    before = justjit.counters(int_add)
+    int_add(1, 2)
+    check("counters type fallback result", int_add(1.5, 2), 3.5)
+    after = justjit.counters(int_add)
+    check("counters native call", after["native_calls"] - before["native_calls"], 1)
+    check("counters type fallback", after["fallback_type"] - before["fallback_type"], 1)
+    check("counters compile attempts", (after["compile_attempts"], after["compile_failures"]), (1, 0))
+
+    # Perf mode is fixed once a JIT exists; re-setting the same one is allowed
+    perf_mode = justjit.get_perf_mode()
+    justjit.set_perf_mode(perf_mode)
+    try:
+        justjit.set_perf_mode("map" if perf_mode != "map" else "")
+        print("  [FAIL] perf mode changed after the first JIT")
+        failed += 1
+    except RuntimeError:
+        print("  [OK] perf mode fixed after first JIT")
+        passed += 1
+    gdb_support = justjit.get_gdb_support()
+    try:
+        justjit.set_gdb_support(not gdb_support)
+        print("  [FAIL] gdb support changed after the first JIT")
+        failed += 1
+    except RuntimeError:
+        print("  [OK] gdb support fixed after first JIT")
+        passed += 1
+    pc_tables = justjit.get_pc_tables()
+    try:
+        justjit.set_pc_tables(not pc_tables)
+        print("  [FAIL] PC tables changed after the first JIT")
+        failed += 1
+    except RuntimeError:
+        print("  [OK] PC tables fixed after first JIT")
+        passed += 1
+    check("lookup_pc outside JIT'd code", justjit.lookup_pc(0), None)
+    code_memory = justjit.get_code_memory()
+    try:
+        justjit.set_code_memory("slab" if code_memory != "slab" else "")
+        print("  [FAIL] code memory changed after the first JIT")
+        failed += 1
+    except RuntimeError:
+        print("  [OK] code memory fixed after first JIT")
+        passed += 1
+    memory = justjit.code_memory_stats()
+    check("code memory stats", memory is None if not code_memory else memory["code_bytes"] > 0, True)
+
+    # Opcode trace points exist only in code compiled with tracing on
+    justjit.trace_events()
+    justjit.set_trace(True)
+
+    @jit(mode="int")
+    def traced_add(a, b):
+        return a + b
+
+    check("traced function result", traced_add(2, 3), 5)
+    justjit.set_trace(False)
+    events, lost = justjit.trace_events()
+    check("trace records BINARY_OP", any(e[0] == "traced_add" and e[2] == "BINARY_OP" for e in events), True)
+    check("trace drained", justjit.trace_events()[0], [])
+
+    # Latency timing covers calls made while it is on
+    justjit.set_latency_histograms(True)
+
+    @jit(mode="int")
+    def timed_add(a, b):
+        return a + b
+
+    for i in range(100):
+        timed_add(i, 1)
+    justjit.set_latency_histograms(False)
+    timed = {name: h for name, h in justjit.latency_histograms(reset=True).items() if "timed_add" in name}
+    check("latency histogram counts calls", sum(h["count"] for h in timed.values()), 100)
+    check("latency percentiles ordered",
+          all(h["p50_ns"] <= h["p99_ns"] <= h["max_ns"] + 1 for h in timed.values()), True)
+    check("latency histograms reset", any("timed_add" in name for name in justjit.latency_histograms()), False)
+    if not pc_tables:
+        try:
+            with justjit.profile():
+                pass
+            print("  [FAIL] profile() ran without PC tables")
+            failed += 1
+        except RuntimeError:
+            print("  [OK] profile() needs PC tables")
+            passed += 1
+    try:
+        justjit.set_perf_mode("flamegraph")
+        print("  [FAIL] unknown perf mode accepted")
+        failed += 1
+    except ValueError:
+        print("  [OK] unknown perf mode rejected")
+        passed += 1
+
     # =========================================================================
     # Test 6: inline_c
     # =========================================================================
@@ -248,6 +437,100 @@ def main():
         step3 = float32_half(step2)  # 108
         check("JIT->C->JIT chain", step3, 108.0)
 
+        # Mixed int/float/pointer signature beyond four parameters
+        mixed_funcs = inline_c('''
+            double c_mixed6(long long a, double b, int c, float d, long long e, double f) {
+                return a + b + c + d + e + f;
+            }
+            long long c_ptr_or_zero(void* p, int tag) { return p ? tag : -tag; }
+        ''')
+        check("C mixed 6 params", mixed_funcs['c_mixed6'](1, 2.5, 3, 0.5, 5, 6.0), 18.0)
+        check("C null pointer arg", mixed_funcs['c_ptr_or_zero'](None, 7), -7)
+
+        # Buffers are passed to pointer parameters without copying
+        import array
+        buf_funcs = inline_c('''
+            void c_scale(double* xs, long long n, double k) { for (long long i = 0; i < n; i++) xs[i] *= k; }
+            long long c_isum(const int* xs, long long n) { long long t = 0; for (long long i = 0; i < n; i++) t += xs[i]; return t; }
+        ''')
+        xs = array.array('d', [1.0, 2.0, 3.0])
+        buf_funcs['c_scale'](xs, len(xs), 2.0)
+        check("C buffer arg in place", list(xs), [2.0, 4.0, 6.0])
+        ints = memoryview(array.array('i', [1, 2, 3])).toreadonly()
+        check("C const buffer arg", buf_funcs['c_isum'](ints, 3), 6)
+        try:
+            buf_funcs['c_scale'](array.array('f', [1.0]), 1, 2.0)
+            check("C buffer dtype check", False, True)
+        except TypeError:
+            check("C buffer dtype check", True, True)
+
+        # Float-mode code calls inline C functions natively
+        globals()['c_lerp'] = inline_c('''
+            double c_lerp(double a, double b, double t) { return a + (b - a) * t; }
+        ''')['c_lerp']
+
+        @jit(mode='float')
+        def lerp_sum(a, b):
+            total = 0.0
+            for i in range(4):
+                total = total + c_lerp(a, b, i * 0.25)
+            return total
+
+        check("JIT calls C directly", lerp_sum(0.0, 8.0), 12.0)
+
+        # Identical source is served from the compile cache
+        cached_src = 'long long c_cached(long long x) { return x * 3; }'
+        first = inline_c(cached_src)
+        second = inline_c(cached_src)
+        check("C compile cache hit", second['c_cached'](7), 21)
+        check("C compile cache same callable", second['c_cached'] is first['c_cached'], True)
+
+        # Per-snippet optimization level, target and flags
+        tuned = inline_c(cached_src, opt_level=3, march='native', flags=['-ffast-math'])
+        check("C tuned compile", tuned['c_cached'](7), 21)
+        check("C tuned compile not shared", tuned['c_cached'] is first['c_cached'], False)
+        check("C opt_level 0", inline_c(cached_src, opt_level=0)['c_cached'](2), 6)
+
+        # Pure C releases the GIL; code calling jit_* helpers keeps it
+        check("C pure releases GIL", first['c_cached'].releases_gil, True)
+        gil_funcs = inline_c('''
+            long long c_list_len(void* lst) { return jit_list_size(lst); }
+        ''')
+        check("C helper keeps GIL", gil_funcs['c_list_len'].releases_gil, False)
+        # A captured object is reachable without any call; nogil=True vouches for it
+        obj_src = 'long long c_obj_len(long long x) { return x + c_obj_list_len; }'
+        obj_funcs = inline_c(obj_src, captured_vars={'c_obj_list': [1, 2, 3]})
+        check("C captured object keeps GIL", obj_funcs['c_obj_len'].releases_gil, False)
+        opted = inline_c(obj_src, captured_vars={'c_obj_list': [1, 2, 3]}, nogil=True)
+        check("C nogil opt-in", (opted['c_obj_len'](1), opted['c_obj_len'].releases_gil), (4, True))
+
+        # Compilation units replace single functions and relink their callers
+        from justjit import remove_c_unit
+        unit_v1 = inline_c('''
+            long long c_unit_base(long long x) { return x + 1; }
+            long long c_unit_twice(long long x) { return 2 * c_unit_base(x); }
+        ''', unit='ci_unit')
+        check("C unit call", unit_v1['c_unit_twice'](3), 8)
+        unit_v2 = inline_c('long long c_unit_base(long long x) { return x + 10; }', unit='ci_unit')
+        check("C unit replaced", unit_v2['c_unit_base'](3), 13)
+        check("C unit old callable follows", unit_v1['c_unit_base'](3), 13)
+        check("C unit caller relinked", unit_v1['c_unit_twice'](3), 26)
+        remove_c_unit('ci_unit')
+
+        # OpenMP kernels, when the runtime is installed
+        try:
+            omp_funcs = inline_c('''
+                double c_omp_sum(const double* xs, long long n) {
+                    double total = 0.0;
+                    #pragma omp parallel for reduction(+:total)
+                    for (long long i = 0; i < n; i++) total += xs[i];
+                    return total;
+                }
+            ''', openmp=True)
+            check("C OpenMP reduction", omp_funcs['c_omp_sum'](array.array('d', range(1000)), 1000), 499500.0)
+        except RuntimeError as e:
+            print(f"  [SKIP] OpenMP runtime not available: {e}")
+
     except RuntimeError as e:
         print(f"  [SKIP] inline_c not available: {e}")
     except Exception as e:
@@ -368,6 +651,165 @@ def main():
 
         total = sum(countdown(5))
         check("generator sum", total, 15)
+        check("generator keyword call", list(countdown(n=2)), [2, 1])
+
+        @jit
+        def gen_missing_global():
+            yield 1
+            yield undefined_generator_global  # noqa: F821
+
+        @jit
+        def gen_missing_global_caught():
+            try:
+                yield undefined_generator_global  # noqa: F821
+            except NameError:
+                yield "caught"
+
+        missing = gen_missing_global()
+        check("generator before NameError", next(missing), 1)
+        try:
+            next(missing)
+            check("generator LOAD_GLOBAL NameError", False, True)
+        except NameError:
+            check("generator LOAD_GLOBAL NameError", True, True)
+        check("generator NameError caught", list(gen_missing_global_caught()), ["caught"])
+
+        @jit
+        def sum_countdown(n):
+            total = 0
+            for x in countdown(n):
+                total = total + x
+            return total
+
+        check("JIT loop over JIT generator", sum_countdown(6), 21)
+
+        @jit(mode="int")
+        def int_squares(n):
+            for i in range(n):
+                yield i * i
+
+        check("typed int generator", list(int_squares(5)), [0, 1, 4, 9, 16])
+
+        @jit(mode="float")
+        def halvings(x, n):
+            while n > 0:
+                yield x
+                x = x / 2
+                n -= 1
+
+        check("typed float generator", list(halvings(4.0, 3)), [4.0, 2.0, 1.0])
+
+        @jit
+        def three_steps(x):
+            yield x
+            yield x + 1
+            yield x + 2
+
+        check("multi-yield generator", list(three_steps(1)), [1, 2, 3])
+        step_ir = dump_ir(three_steps)
+        check("generator resume dispatch is a switch", step_ir is not None and "switch i32" in step_ir, True)
+
+        @jit
+        def describe(items):
+            for x in items:
+                match x:
+                    case [a, b]:
+                        yield f"pair {a}-{b}"
+                    case {"k": v}:
+                        yield f"key {v!r}"
+                    case _:
+                        yield f"{x:>3}"
+
+        check("generator match and f-strings", list(describe([[1, 2], {"k": "z"}, 7])),
+              ["pair 1-2", "key 'z'", "  7"])
+
+        @jit
+        def checked_range(n):
+            if n < 0:
+                raise ValueError("negative")
+            yield from range(n)
+
+        check("generator yield from", list(checked_range(3)), [0, 1, 2])
+        try:
+            list(checked_range(-1))
+            check("generator raise", None, "ValueError")
+        except ValueError as e:
+            check("generator raise", str(e), "negative")
+        check("generator factory metadata", (countdown.__name__, countdown.__wrapped__.__name__),
+              ("countdown", "countdown"))
+
+        import asyncio
+
+        @jit
+        async def async_squares(n):
+            for i in range(n):
+                yield i * i
+
+        async def collect_squares():
+            return [x async for x in async_squares(4)]
+
+        check("async generator", asyncio.run(collect_squares()), [0, 1, 4, 9])
+
+        @jit
+        async def inner_coro(x):
+            await asyncio.sleep(0)
+            return x + 1
+
+        @jit
+        async def outer_coro(x):
+            y = await inner_coro(x)
+            return await inner_coro(y)
+
+        check("awaiting a JIT coroutine", asyncio.run(outer_coro(1)), 3)
+
+        @jit
+        async def await_future(fut):
+            return await fut
+
+        async def resolve_future():
+            fut = asyncio.get_running_loop().create_future()
+            task = asyncio.create_task(await_future(fut))
+            await asyncio.sleep(0)
+            fut.set_result(41)
+            return await task
+
+        check("awaiting an asyncio future", asyncio.run(resolve_future()), 41)
+
+        # Generators and coroutines keep their compiled code alive: the
+        # wrapper (and its JIT instance) may go first
+        import gc
+
+        def orphan_generator(mode):
+            @jit(mode=mode)
+            def numbers(n):
+                i = 0
+                while i < n:
+                    yield i
+                    i += 1
+            return numbers(4)
+
+        def orphan_coroutine():
+            @jit
+            async def plus_one(x):
+                return x + 1
+            return plus_one(1)
+
+        orphans = [orphan_generator("object"), orphan_generator("int")]
+        orphan_coro = orphan_coroutine()
+        gc.collect()
+        check("generator outlives its wrapper", list(orphans[0]), [0, 1, 2, 3])
+        check("typed generator outlives its wrapper", list(orphans[1]), [0, 1, 2, 3])
+        try:
+            orphan_coro.send(None)
+            check("coroutine outlives its wrapper", None, "StopIteration")
+        except StopIteration as stop:
+            check("coroutine outlives its wrapper", stop.value, 2)
+        # A recycled generator object runs code its new factory keeps alive
+        del orphans
+        gc.collect()
+        recycled = orphan_generator("object")
+        gc.collect()
+        check("recycled generator outlives its wrapper", list(recycled), [0, 1, 2, 3])
 
     except Exception as e:
         print(f"  [FAIL] Generator error: {e}")
@@ -404,6 +846,3919 @@ def main():
         print(f"  [FAIL] Pipeline error: {e}")
         failed += 1
 
+    # =========================================================================
+    # Test 11: Shared engine and background compilation
+    # =========================================================================
+    print("\n--- Test 11: Shared Engine / Background Compile ---")
+    try:
+        # Two JIT instances compiling the same symbol name must not collide
+        def make_scaled():
+            @jit(mode='int')
+            def scaled(x):
+                return x * 3
+            return scaled
+
+        first, second = make_scaled(), make_scaled()
+        check("shared engine first", first(5), 15)
+        check("shared engine second", second(7), 21)
+
+        @jit(mode='int', background=True)
+        def bg_add(a, b):
+            return a + b
+
+        check("background first call (interpreter)", bg_add(2, 3), 5)
+        # The compile worker is a single thread: a no-op task finishing means
+        # the queued compile has finished too
+        justjit._get_compile_executor().submit(lambda: None).result()
+        check("background later call", bg_add(20, 22), 42)
+        # The first call ran interpreted while pending, the second natively
+        bg_counts = justjit.counters(bg_add)
+        check("background counters",
+              (bg_counts["fallback_pending"], bg_counts["native_calls"], bg_counts["compile_attempts"]), (1, 1, 1))
+
+    except Exception as e:
+        print(f"  [FAIL] Engine error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 12: mode='auto' inference
+    # =========================================================================
+    print("\n--- Test 12: Auto Mode Inference ---")
+    try:
+        @jit
+        def auto_sum_squares(n):
+            total = 0
+            for i in range(n):
+                total += i * i
+            return total
+
+        check("auto int kernel", auto_sum_squares(10), 285)
+        check("auto int kernel mode", auto_sum_squares._mode, "int")
+
+        @jit
+        def auto_axpy(a, x, y):
+            return a * x + y
+
+        check_close("auto float kernel", auto_axpy(2.0, 3.0, 0.5), 6.5)
+        check("auto float kernel mode", auto_axpy._mode, "float")
+        # Other argument types still get Python's result
+        check("auto float kernel, int args", auto_axpy(2, 3, 4), 10)
+        check("auto float kernel, str args", auto_axpy(2, "ab", "c"), "ababc")
+        # One variant per signature; repeated signatures dispatch in C
+        check("auto variants", [tuple(t.__name__ for t in sig) for sig, _ in auto_axpy.variants],
+              [("float", "float", "float"), ("int", "int", "int"), ("int", "str", "str")])
+        check("auto int variant is native", type(auto_axpy.variants[1][1]).__name__, "JITNativeFunction")
+        misses = justjit.counters(auto_axpy)["dispatch_misses"]
+        check("auto int variant again", auto_axpy(5, 6, 7), 37)
+        check("auto repeat signature no miss", justjit.counters(auto_axpy)["dispatch_misses"], misses)
+
+        @jit
+        def auto_halve(a):
+            return a / 2
+
+        check("auto int true-div stays object", auto_halve(3), 1.5)
+        check("auto int true-div mode", auto_halve._mode, "object")
+
+        @jit
+        def auto_cdiv(a, b):
+            return a / b
+
+        check("auto complex true-div", auto_cdiv(1 + 2j, 2j), (1 + 2j) / 2j)
+        check("auto complex true-div stays object", auto_cdiv._mode, "object")
+        try:
+            auto_cdiv(1 + 2j, 0j)
+            print("  [FAIL] auto complex division by 0j did not raise")
+            failed += 1
+        except ZeroDivisionError:
+            print("  [OK] auto complex division by 0j raises")
+            passed += 1
+
+        # Wider than the fixed-arity helpers: goes through the argv trampoline
+        @jit(mode='int')
+        def int_sum6(a, b, c, d, e, f):
+            return a + b + c + d + e + f
+
+        @jit(mode='float')
+        def float_dot3(ax, ay, az, bx, by, bz):
+            return ax * bx + ay * by + az * bz
+
+        check("int 6 params", int_sum6(1, 2, 3, 4, 5, 6), 21)
+        check_close("float 6 params", float_dot3(1.0, 2.0, 3.0, 4.0, 5.0, 6.0), 32.0)
+
+    except Exception as e:
+        print(f"  [FAIL] Auto mode error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 13: Keyword and default arguments
+    # =========================================================================
+    print("\n--- Test 13: Keyword and Default Arguments ---")
+    try:
+        @jit(mode='int')
+        def int_scale(x, factor=3):
+            return x * factor
+
+        @jit
+        def obj_format(name, *rest, sep=", ", **extra):
+            return sep.join([name] + list(rest)) + str(sorted(extra))
+
+        check("int default applied", int_scale(7), 21)
+        check("int keyword argument", int_scale(x=2, factor=5), 10)
+        check("object keyword-only default", obj_format("a", "b"), "a, b[]")
+        check("object *args, **kwargs", obj_format("a", "b", sep="-", z=1), "a-b['z']")
+        try:
+            int_scale(1, bogus=2)
+            check("unexpected keyword raises", False, True)
+        except TypeError:
+            check("unexpected keyword raises", True, True)
+
+        @jit
+        def gen_range(n, step=1):
+            i = 0
+            while i < n:
+                yield i
+                i += step
+
+        check("generator keyword argument", list(gen_range(6, step=2)), [0, 2, 4])
+
+    except Exception as e:
+        print(f"  [FAIL] Argument binding error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 14: Exceptions propagate from the native run
+    # =========================================================================
+    print("\n--- Test 14: Exception Propagation ---")
+    try:
+        calls = []
+
+        @jit
+        def checked_div(a, b):
+            calls.append(a)
+            return a // b
+
+        check("deopt-free call", checked_div(9, 3), 3)
+        calls.clear()
+        try:
+            checked_div(1, 0)
+            check("ZeroDivisionError raised", False, True)
+        except ZeroDivisionError:
+            check("ZeroDivisionError raised", True, True)
+        # Previously the failed native run was retried in the interpreter
+        check("side effect ran once", len(calls), 1)
+        check("DeoptError is not an Exception", issubclass(justjit.DeoptError, Exception), False)
+
+        # A raising __bool__ is an error, not False, fused into a branch or not
+        class BadBool:
+            def __bool__(self):
+                raise ValueError("no truth value")
+
+        @jit
+        def branch_on(x):
+            if x:
+                return 1
+            return 0
+
+        @jit
+        def negate(x):
+            return not x
+
+        @jit
+        def branch_caught(x):
+            try:
+                if x:
+                    return 1
+                return 0
+            except ValueError:
+                return -1
+
+        for name, fn in (("fused TO_BOOL", branch_on), ("TO_BOOL", negate)):
+            try:
+                fn(BadBool())
+                check(f"{name} raises from __bool__", False, True)
+            except ValueError:
+                check(f"{name} raises from __bool__", True, True)
+        check("fused TO_BOOL error caught", branch_caught(BadBool()), -1)
+
+        # A value raising mid-build unwinds the pairs already on the stack
+        @jit
+        def const_key_map(x):
+            try:
+                return {"a": [x], "b": 1 // x}
+            except ZeroDivisionError:
+                return None
+
+        check("const key map", const_key_map(1), {"a": [1], "b": 1})
+        check("const key map value raises", const_key_map(0), None)
+
+    except Exception as e:
+        print(f"  [FAIL] Exception propagation error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 15: Batch map/reduce
+    # =========================================================================
+    print("\n--- Test 15: Batch Map/Reduce ---")
+    try:
+        import array
+
+        @jit(mode='float')
+        def fma_kernel(a, x, y):
+            return a * x + y
+
+        @jit(mode='int')
+        def int_add(a, b):
+            return a + b
+
+        xs = array.array('d', [1.0, 2.0, 3.0, 4.0])
+        ys = array.array('d', [10.0, 20.0, 30.0, 40.0])
+        check("float map with broadcast", list(fma_kernel.map(2.0, xs, ys)), [12.0, 24.0, 36.0, 48.0])
+        strided = memoryview(xs)[::2]
+        check("float map strided", list(fma_kernel.map(1.0, strided, strided)), [2.0, 6.0])
+
+        ints = array.array('q', range(1, 101))
+        out = array.array('q', [0] * 100)
+        int_add.map(ints, ints, out=out)
+        check("int map into out", out[99], 200)
+        check("int reduce", int_add.reduce(ints), 5050)
+        check("int reduce initial", int_add.reduce(ints, initial=-50), 5000)
+
+
+        @jit(mode='float', parallel=True)
+        def par_scale(x, y):
+            return x * 2.0 + y
+
+        @jit(mode='int', parallel=True)
+        def par_add(a, b):
+            return a + b
+
+        big = array.array('d', [float(i % 97) for i in range(200_000)])
+        serial = list(fma_kernel.map(2.0, big, 0.0))
+        check("parallel map matches serial", list(par_scale.map(big, 0.0)) == serial, True)
+        big_ints = array.array('q', range(200_001))
+        check("parallel reduce", par_add.reduce(big_ints), 200_000 * 200_001 // 2)
+    except Exception as e:
+        print(f"  [FAIL] Batch map/reduce error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 16: prange parallel loops
+    # =========================================================================
+    print("\n--- Test 16: prange Parallel Loops ---")
+    try:
+        # Written at module level the way user code is: justjit is a global
+        # there, where inside main() it would be a closure cell
+        namespace = {"justjit": justjit}
+        exec(
+            "def sum_mod(n, k):\n"
+            "    total = 0\n"
+            "    for i in justjit.prange(n):\n"
+            "        total += i % k\n"
+            "    return total\n"
+            "def max_spread(n):\n"
+            "    best = -1\n"
+            "    for i in justjit.prange(n):\n"
+            "        x = (i * 7919) % 100003\n"
+            "        if x > best:\n"
+            "            best = x\n"
+            "    return best\n"
+            "def first_square_over(n, limit):\n"
+            "    for i in justjit.prange(n):\n"
+            "        if i * i > limit:\n"
+            "            return i\n"
+            "    return -1\n"
+            "def float_sum(n):\n"
+            "    total = 0.0\n"
+            "    for i in justjit.prange(n):\n"
+            "        total += i * 0.5\n"
+            "    return total\n"
+            "def break_sum(n):\n"
+            "    total = 0\n"
+            "    for i in justjit.prange(n):\n"
+            "        if i > 10:\n"
+            "            break\n"
+            "        total += i\n"
+            "    return total\n",
+            namespace,
+        )
+        sum_mod = namespace["sum_mod"]
+        max_spread = namespace["max_spread"]
+        first_square_over = namespace["first_square_over"]
+        float_sum = namespace["float_sum"]
+        break_sum = namespace["break_sum"]
+
+        par_sum = jit(mode='int', parallel=True)(sum_mod)
+        par_max = jit(mode='int', parallel=True)(max_spread)
+        par_first = jit(mode='int', parallel=True)(first_square_over)
+        par_fsum = jit(mode='float', parallel=True)(float_sum)
+
+        check("prange sum reduction", par_sum(100_000, 7), sum_mod(100_000, 7))
+        check("prange empty range", par_sum(0, 7), 0)
+        check("prange max reduction", par_max(50_000), max_spread(50_000))
+        check("prange return picks first iteration", par_first(1_000_000, 10_000_000), first_square_over(1_000_000, 10_000_000))
+        check("prange return not taken", par_first(100, 10**9), -1)
+        check_close("prange float sum", par_fsum(20_000.0), float_sum(20_000))
+        check("prange is range outside jit", list(justjit.prange(2, 5)), [2, 3, 4])
+
+        # The work is really split: chunks, and threads when the pool has them
+        from justjit import _core
+        par_sum(5_000_000, 7)
+        split = _core._prange_stats()
+        check("prange split into chunks", split["chunks"] > 1, True)
+        if _core.parallel_threads() > 1:
+            check("prange ran on several threads", split["threads"] > 1, True)
+
+        check("justjit.prange parallelized", len(par_sum._jit_instance.get_parallel_loops("sum_mod")), 1)
+
+        # A loop the outliner cannot take runs serially, with a warning
+        import warnings
+
+        with warnings.catch_warnings(record=True) as caught:
+            warnings.simplefilter("always")
+            par_break = jit(mode='int', parallel=True, lazy=False)(break_sum)
+            check("serial prange result", par_break(100), break_sum(100))
+        check("serial prange warned", any("run serially" in str(w.message) for w in caught), True)
+    except Exception as e:
+        print(f"  [FAIL] prange error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 17: nogil typed functions
+    # =========================================================================
+    print("\n--- Test 17: nogil ---")
+    try:
+        import threading
+
+        @jit(mode='int', nogil=True)
+        def spin(n):
+            total = 0
+            for i in range(n):
+                total += i % 3
+            return total
+
+        @jit(mode='float32', nogil=True)
+        def half(x):
+            return x * 0.5
+
+        results = [None] * 4
+
+        def worker(slot):
+            results[slot] = spin(200_000)
+
+        threads = [threading.Thread(target=worker, args=(i,)) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        expected = sum(i % 3 for i in range(200_000))
+        check("nogil int results from threads", results, [expected] * 4)
+        check_close("nogil float32", half(3.0), 1.5)
+        check("nogil flag", spin._jit_instance.get_nogil(), True)
+
+        # The GIL is really released: this thread keeps running Python while
+        # a long kernel runs in another (with the GIL held it could not run
+        # at all between the kernel's start and end)
+        import time
+
+        @jit(mode='int', nogil=True)
+        def churn(n):
+            total = 0
+            for i in range(n):
+                total = (total * 31 + i) % 1000003
+            return total
+
+        churn(10)  # Compile before timing
+        span = [0.0, 0.0]
+
+        def long_kernel():
+            span[0] = time.perf_counter()
+            churn(20_000_000)
+            span[1] = time.perf_counter()
+
+        kernel = threading.Thread(target=long_kernel)
+        ticks = []
+        kernel.start()
+        while kernel.is_alive():
+            ticks.append(time.perf_counter())
+        kernel.join()
+        during = sum(1 for t in ticks if span[0] < t < span[1])
+        check("nogil kernel lets other threads run", during > 0, True)
+    except Exception as e:
+        print(f"  [FAIL] nogil error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 18: Concurrent first calls
+    # =========================================================================
+    print("\n--- Test 18: Concurrent Compiles ---")
+    try:
+        import threading
+
+        @jit
+        def poly(x):
+            return x * x + 3 * x + 1
+
+        @jit(lazy=True)
+        def pick(items, i):
+            return items[i] + items[-1]
+
+        @jit(background=True)
+        def scale(x):
+            return x * 2
+
+        barrier = threading.Barrier(8)
+        results = [None] * 8
+
+        def worker(slot):
+            barrier.wait()
+            results[slot] = (poly(slot), pick([slot, 1, 2], 0), scale(slot))
+
+        threads = [threading.Thread(target=worker, args=(i,)) for i in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        expected = [(i * i + 3 * i + 1, i + 2, i * 2) for i in range(8)]
+        check("first calls from 8 threads", results, expected)
+    except Exception as e:
+        print(f"  [FAIL] concurrent compile error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 19: compile_all
+    # =========================================================================
+    print("\n--- Test 19: compile_all ---")
+    try:
+        import types
+        from justjit import compile_all
+
+        @jit(lazy=True)
+        def lazy_sq(x):
+            return x * x
+
+        @jit(mode='int', background=True)
+        def bg_inc(n):
+            return n + 1
+
+        @jit(mode='int32', lazy=True)
+        def lazy_neg(n):
+            return -n
+
+        kernels = types.ModuleType("kernels")
+        kernels.lazy_sq = lazy_sq
+        kernels.bg_inc = bg_inc
+        kernels.lazy_neg = lazy_neg
+        kernels.helper = len
+
+        check("compile_all count", compile_all(kernels, threads=3), 3)
+        check("compile_all again", compile_all([lazy_sq, bg_inc, lazy_neg]), 0)
+        check("compiled lazy", lazy_sq(7), 49)
+        check("compiled background", bg_inc(41), 42)
+        check("compiled int32", lazy_neg(5), -5)
+
+        # A failed compile, in compile_all or on the worker, leaves the
+        # function interpreted and counted instead of pending forever
+        @jit(mode='int', background=True)
+        def warm_broken(n):
+            return len(str(n))
+
+        @jit(mode='int', background=True)
+        def bg_broken(n):
+            return len(str(n))
+
+        check("compile_all failed compile", compile_all([warm_broken]), 0)
+        check("failed warmup runs interpreted", warm_broken(40), 2)
+        check("failed background first call", bg_broken(4), 1)
+        justjit._get_compile_executor().submit(lambda: None).result()
+        check("failed background later calls", (bg_broken(500), bg_broken(5)), (3, 1))
+        counted = ("compile_attempts", "compile_failures", "fallback_pending", "fallback_compile_failure")
+        check("failed warmup counters", [justjit.counters(warm_broken)[k] for k in counted], [1, 1, 0, 1])
+        check("failed background counters", [justjit.counters(bg_broken)[k] for k in counted], [1, 1, 1, 2])
+
+        # Decoration is lazy by default; the first call rebinds a
+        # module-level name to the built wrapper
+        @jit
+        def default_lazy(x):
+            return x + 1
+
+        check("decoration lazy by default", repr(default_lazy).startswith("<lazy jit function"), True)
+        check("default lazy result", default_lazy(1), 2)
+        lazy_mod = types.ModuleType("lazy_mod")
+        exec("from justjit import jit\n\n@jit\ndef rebound(x):\n    return x * 2\n", lazy_mod.__dict__)
+        stub = lazy_mod.rebound
+        check("stub call", stub(4), 8)
+        check("module name rebound", (lazy_mod.rebound is not stub, lazy_mod.rebound(5)), (True, 10))
+    except Exception as e:
+        print(f"  [FAIL] compile_all error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 20: ptr mode buffer arguments
+    # =========================================================================
+    print("\n--- Test 20: ptr Buffers ---")
+    try:
+        import array
+        import struct
+
+        @jit(mode='ptr')
+        def buf_get(arr, i):
+            return arr[i]
+
+        values = array.array('d', [1.5, 2.5, 3.5])
+        check("ptr array.array", buf_get(values, 1), 2.5)
+        check("ptr memoryview", buf_get(memoryview(values), 2), 3.5)
+        check("ptr bytes as float64", buf_get(memoryview(bytearray(struct.pack('2d', 4.0, 8.0))).cast('d'), 1), 8.0)
+        # The entry rejects the view and the wrapper reruns the call in Python
+        strided_fallbacks = justjit.counters(buf_get)["fallback_exception"]
+        check("ptr strided view falls back", buf_get(memoryview(values)[::2], 1), 3.5)
+        check("ptr strided view rejected by the entry",
+              justjit.counters(buf_get)["fallback_exception"], strided_fallbacks + 1)
+
+        # One specialization per element format, picked from the buffer
+        check("ptr uint8", buf_get(bytearray(b'\x04\xfa'), 1), 250.0)
+        check("ptr int16", buf_get(array.array('h', [7, -9]), 1), -9.0)
+        check("ptr int32", buf_get(array.array('i', [1, 2]), 1), 2.0)
+        check("ptr int64", buf_get(array.array('q', [1, 2 ** 40]), 1), float(2 ** 40))
+        check("ptr float32", buf_get(array.array('f', [0.5, 0.25]), 0), 0.5)
+        check("ptr float64 again", buf_get(values, 0), 1.5)
+        raw = justjit.JIT()
+        raw.compile_ptr(justjit._extract_bytecode(buf_get._original_func), [None], "raw_get_i", 2, 2, 'i')
+        raw_get = raw.get_ptr_callable("raw_get_i", 2, 'i')
+        try:
+            raw_get(array.array('d', [1.0]), 0)
+            check("ptr entry rejects other formats", False, True)
+        except TypeError:
+            check("ptr entry rejects other formats", True, True)
+        # Rejections are only visible at the entry itself: the @jit wrapper
+        # answers a TypeError by running the call in Python
+        try:
+            raw_get(memoryview(array.array('i', [1, 2, 3]))[::2], 0)
+            check("ptr entry rejects strided views", False, True)
+        except TypeError:
+            check("ptr entry rejects strided views", True, True)
+    except Exception as e:
+        print(f"  [FAIL] ptr buffer error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 21: ndarray mode
+    # =========================================================================
+    print("\n--- Test 21: ndarray Mode ---")
+    try:
+        import array
+
+        @jit(mode='ndarray')
+        def nd_total(a):
+            h, w = a.shape
+            t = 0.0
+            for i in range(h):
+                for j in range(w):
+                    t += a[i, j]
+            return t
+
+        @jit(mode='ndarray')
+        def nd_scale(src, dst, k):
+            for i in range(src.shape[0]):
+                for j in range(src.shape[1]):
+                    dst[i, j] = src[i, j] * k
+
+        @jit(mode='ndarray')
+        def nd_sum1(a):
+            t = 0
+            for i in range(a.size):
+                t += a[i]
+            return t
+
+        def grid(code, values, shape):
+            return memoryview(array.array(code, values)).cast('B').cast(code, shape)
+
+        src = grid('d', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0], [2, 3])
+        dst = grid('d', [0.0] * 6, [2, 3])
+        check("ndarray 2-D sum", nd_total(src), 21.0)
+        check("ndarray 2-D store", nd_scale(src, dst, 2.0), None)
+        check("ndarray stored values", dst.tolist(), [[2.0, 4.0, 6.0], [8.0, 10.0, 12.0]])
+        check("ndarray int32 2-D", nd_total(grid('i', range(6), [3, 2])), 15.0)
+        ints = array.array('q', range(10))
+        check("ndarray int64 1-D", nd_sum1(ints), 45)
+        check("ndarray strided view", nd_sum1(memoryview(ints)[::3]), 18)
+        check("ndarray specializations", len(nd_sum1._ndarray_specializations), 2)
+
+        @jit(mode='ndarray')
+        def nd_first(a):
+            return a[0] * 2
+
+        check("ndarray first call", nd_first(array.array('h', [-4, 5])), -8)
+        check("ndarray fallback", nd_first([1, 2, 3]), 2)
+
+        # int ** stays exact past 2**53; a variable exponent runs as Python
+        @jit(mode='ndarray')
+        def nd_cube(a):
+            return a[0] ** 3
+
+        @jit(mode='ndarray')
+        def nd_pow(a, n):
+            return a[0] ** n
+
+        check("ndarray int ** exact", nd_cube(array.array('q', [2**20 + 1])), (2**20 + 1) ** 3)
+        check("ndarray int ** variable exponent", nd_pow(array.array('q', [3]), 39), 3 ** 39)
+
+        @jit(mode='ndarray')
+        def nd_divs(a, b):
+            return a[0] // b, a[0] % b, a[0] / b
+
+        check("ndarray division by zero", nd_divs(array.array('q', [7]), 0), (0, 0, float('inf')))
+    except Exception as e:
+        print(f"  [FAIL] ndarray mode error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 22: vec4f / vec8i over whole arrays
+    # =========================================================================
+    print("\n--- Test 22: Vector Modes Over Arrays ---")
+    try:
+        import array
+
+        @jit(mode='vec4f')
+        def v_madd(a, b):
+            return a * b + a
+
+        @jit(mode='vec8i')
+        def v_isub(a, b):
+            return a - b
+
+        xs = array.array('f', range(12))
+        twos = array.array('f', [2.0] * 12)
+        ys = v_madd(xs, twos)
+        check("vec4f result type", type(ys), array.array)
+        check("vec4f 12 items", ys.tolist(), [3.0 * i for i in range(12)])
+        check("vec4f into out", v_madd(xs, twos, out=twos) is twos, True)
+        check("vec4f in place", twos.tolist(), ys.tolist())
+        check("vec4f one vector", list(v_madd(array.array('f', [1, 2, 3, 4]), array.array('f', [1, 1, 1, 1]))),
+              [2.0, 4.0, 6.0, 8.0])
+        ints = array.array('i', range(16))
+        check("vec8i 16 items", v_isub(ints, array.array('i', [1] * 16)).tolist(), [i - 1 for i in range(16)])
+        try:
+            v_isub(array.array('i', range(12)), array.array('i', range(12)))
+            check("vec8i rejects ragged length", False, True)
+        except ValueError:
+            check("vec8i rejects ragged length", True, True)
+
+        @jit(mode='vec2d')
+        def v_axpy(x, y):
+            return 2.5 * x + y
+
+        check("vec2d with constant", v_axpy(array.array('d', [1, 2, 3, 4]), array.array('d', [1] * 4)).tolist(),
+              [3.5, 6.0, 8.5, 11.0])
+
+        @jit(mode='vecq')
+        def v_acc(a, b):
+            a += b
+            return a
+
+        lanes = int(v_acc._mode[3:-1])
+        check("vecq native width", lanes in (2, 4, 8), True)
+        big = array.array('q', [2**40] * (lanes * 3))
+        check("vecq int64 lanes", v_acc(big, big).tolist(), [2**41] * (lanes * 3))
+    except Exception as e:
+        print(f"  [FAIL] vector mode error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 23: Array reductions and fastmath
+    # =========================================================================
+    print("\n--- Test 23: Array Reductions ---")
+    try:
+        import array
+
+        @jit(mode='ndarray')
+        def r_sum(a):
+            return sum(a)
+
+        @jit(mode='ndarray')
+        def r_range(a):
+            return max(a) - min(a)
+
+        @jit(mode='ndarray', fastmath=True)
+        def r_dot(a, b):
+            t = 0.0
+            for i in range(a.shape[0]):
+                t += a[i] * b[i]
+            return t
+
+        vals = array.array('d', [1e16, 1.0, -1e16, 0.5])
+        check("sum matches Python", r_sum(vals), sum(vals))
+        check("sum int64", r_sum(array.array('q', range(10))), 45)
+        check("max - min", r_range(array.array('i', [3, -9, 12, 4])), 21)
+        check("max - min strided", r_range(memoryview(array.array('d', [5, 0, -1, 0, 2]))[::2]), 6.0)
+        xs = array.array('d', range(100))
+        check_close("fastmath dot", r_dot(xs, xs), float(sum(i * i for i in range(100))))
+        try:
+            r_range(array.array('d'))
+            check("min of empty raises", False, True)
+        except ValueError:
+            check("min of empty raises", True, True)
+    except Exception as e:
+        print(f"  [FAIL] array reduction error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 24: Fast-math flags in float modes
+    # =========================================================================
+    print("\n--- Test 24: Fast-math Flags ---")
+    try:
+        @jit(mode='float', fastmath={'contract', 'nsz'})
+        def fm_madd(a, b, c):
+            return a * b + c
+
+        @jit(mode='float32', fastmath=True)
+        def fm_scale(x, y):
+            return x / y
+
+        check_close("contract madd", fm_madd(1.5, 2.0, 0.25), 3.25)
+        check_close("float32 fast division", fm_scale(3.0, 4.0), 0.75)
+        check("flag names", sorted(fm_madd._jit_instance.get_fastmath()), ['contract', 'nsz'])
+        try:
+            jit(mode='float', fastmath='nnan,fastest')(lambda x: x)
+            check("unknown flag rejected", False, True)
+        except ValueError:
+            check("unknown flag rejected", True, True)
+    except Exception as e:
+        print(f"  [FAIL] fast-math error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 25: math functions in typed modes
+    # =========================================================================
+    print("\n--- Test 25: math Functions ---")
+    try:
+        import array
+        import math
+        from math import hypot as norm2
+
+        @jit(mode='float')
+        def m_polar(x, y):
+            return norm2(x, y) + math.atan2(y, x) * 180.0 / math.pi
+
+        @jit(mode='float32')
+        def m_root(x):
+            return math.sqrt(x)
+
+        @jit(mode='ndarray', vector_library='auto')
+        def m_wave(a, out):
+            for i in range(a.shape[0]):
+                out[i] = math.sin(a[i]) * math.exp(-a[i])
+
+        @jit(mode='ndarray')
+        def m_bucket(x):
+            return math.floor(x) % 4
+
+        check_close("float hypot/atan2", m_polar(3.0, 4.0), 5.0 + math.degrees(math.atan2(4.0, 3.0)))
+        check_close("float32 sqrt", m_root(2.25), 1.5)
+        xs = array.array('d', [i * 0.25 for i in range(17)])
+        ys = array.array('d', [0.0] * 17)
+        m_wave(xs, ys)
+        check_close("ndarray sin*exp", ys[9], math.sin(2.25) * math.exp(-2.25), 1e-12)
+        check("ndarray floor is int", m_bucket(9.5), 1)
+        check("vector library resolved", m_wave._jit_instance.get_vector_library() in ("none", "libmvec", "sleef", "accelerate"), True)
+    except Exception as e:
+        print(f"  [FAIL] math function error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 26: Output arrays
+    # =========================================================================
+    print("\n--- Test 26: Output Arrays ---")
+    try:
+        import array
+        from justjit import zeros_like
+
+        grid = memoryview(bytearray(48)).cast('d', [2, 3])
+        like = zeros_like(grid)
+        check("zeros_like 2-D", (like.shape, like.format, like.readonly), ((2, 3), 'd', False))
+        check("zeros_like dtype", zeros_like(array.array('i', [1, 2]), 'd').tolist(), [0.0, 0.0])
+
+        @jit(mode='ndarray')
+        def o_scale(a, out):
+            for i in range(a.shape[0]):
+                out[i] = a[i] * 3
+
+        @jit(mode='ndarray')
+        def o_peek(a, b):
+            return a[0] + b[0]
+
+        src = array.array('f', [1, 2, 4])
+        res = o_scale(src)
+        check("allocated output", (type(res), res.tolist()), (array.array, [3.0, 6.0, 12.0]))
+        dst = array.array('f', [0.0] * 3)
+        check("output by keyword", o_scale(src, out=dst) is None and dst.tolist(), [3.0, 6.0, 12.0])
+        try:
+            o_peek(src)
+            check("read-only parameter not allocated", False, True)
+        except TypeError:
+            check("read-only parameter not allocated", True, True)
+
+        @jit(mode='ndarray')
+        def o_shift(a, out):
+            for i in range(1, a.shape[0]):
+                out[i] = a[i - 1] + 1.0
+
+        buf = array.array('d', [0.0] * 4)
+        o_shift(buf, buf)
+        check("overlapping arguments", buf.tolist(), [0.0, 1.0, 2.0, 3.0])
+        fresh = array.array('d', [0.0] * 4)
+        o_shift(array.array('d', [0.0] * 4), fresh)
+        check("disjoint arguments", fresh.tolist(), [0.0, 1.0, 1.0, 1.0])
+    except Exception as e:
+        print(f"  [FAIL] output array error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 27: Calls between @jit functions
+    # =========================================================================
+    print("\n--- Test 27: Calls Between @jit Functions ---")
+    try:
+        import types
+
+        # Module level, as the callees are globals of their callers
+        calls_mod = types.ModuleType("calls_mod")
+        exec(
+            "import math\n"
+            "from justjit import jit\n\n"
+            "@jit(mode='int')\n"
+            "def fib(n):\n"
+            "    if n < 2:\n"
+            "        return n\n"
+            "    return fib(n - 1) + fib(n - 2)\n\n"
+            "@jit(mode='float')\n"
+            "def sq(x):\n"
+            "    return x * x\n\n"
+            "@jit(mode='float')\n"
+            "def norm(x, y):\n"
+            "    return math.sqrt(sq(x) + sq(y))\n\n"
+            "@jit\n"
+            "def fib_sum(n):\n"
+            "    total = 0\n"
+            "    for i in range(n):\n"
+            "        total = total + fib(i)\n"
+            "    return total\n\n"
+            "@jit(mode='object')\n"
+            "def scale(v, k):\n"
+            "    return v * k\n\n"
+            "@jit(mode='object')\n"
+            "def scaled_sum(items, k):\n"
+            "    total = 0\n"
+            "    for v in items:\n"
+            "        total += scale(v, k)\n"
+            "    return total\n",
+            calls_mod.__dict__,
+        )
+        check("int self-recursion", calls_mod.fib(25), 75025)
+        check("int self-recursion native", type(calls_mod.fib).__name__, "JITNativeFunction")
+        check_close("float calls float", calls_mod.norm(3.0, 4.0), 5.0)
+        check("auto calls int", calls_mod.fib_sum(10), 88)
+        check("auto caller mode", calls_mod.fib_sum._mode, "int")
+        check("object calls object", calls_mod.scaled_sum([1, 2.5, 3], 2), 13.0)
+        try:
+            calls_mod.scaled_sum(["a"], 2.5)
+            print("  [FAIL] object callee error did not propagate")
+            failed += 1
+        except TypeError:
+            print("  [OK] object callee error propagates through the caller")
+            passed += 1
+        calls_mod.scale = lambda v, k: v - k  # Rebound: the caller goes through Python
+        check("object call after rebinding the callee", calls_mod.scaled_sum([1, 2, 3], 1), 3)
+    except Exception as e:
+        print(f"  [FAIL] @jit call error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 28: Mixed mode (per-local bool/int/float types)
+    # =========================================================================
+    print("\n--- Test 28: Mixed Mode ---")
+
+    try:
+        import array
+
+        @jit(mode='mixed')
+        def mx_mean(n, x, strict):
+            total = 0
+            count = 0
+            for i in range(n):
+                v = i * x
+                if v > 1.0 or not strict:
+                    total += v
+                    count += 1
+            return total / count if count else 0.0
+
+        @jit(mode='mixed')
+        def mx_flags(a, b):
+            return (a > 0) & (b > 0)
+
+        check_close("mixed int/float/bool locals", mx_mean(10, 0.5, True), 3.0)
+        check_close("mixed bool argument", mx_mean(4, 0.5, False), 0.75)
+        check_close("mixed all-int locals", mx_mean(4, 1, False), 1.5)
+        check("mixed bool result", mx_flags(1, 2.5), True)
+        check("mixed bool result type", type(mx_flags(-1, 2.5)).__name__, "bool")
+        check("mixed specializations", len(mx_mean._ndarray_specializations), 2)
+        check("mixed fallback", mx_flags(1, 10**30), True)
+
+        @jit(mode='ndarray')
+        def nd_minmax(a):
+            lo = a[0]
+            hi = a[0]
+            for i in range(1, a.size):
+                v = a[i]
+                if v < lo:
+                    lo = v
+                if v > hi:
+                    hi = v
+            return lo, hi, hi > lo
+
+        @jit(mode='mixed')
+        def mx_divmod(a, b):
+            return a // b, a % b, a / b
+
+        check("tuple return", nd_minmax(array.array('d', [3.0, -1.5, 7.25])), (-1.5, 7.25, True))
+        check("tuple return int items", nd_minmax(array.array('q', [4, 4])), (4, 4, False))
+        check("tuple return widened item", mx_divmod(7, 2), (3, 1, 3.5))
+    except Exception as e:
+        print(f"  [FAIL] mixed mode error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 29: static_args= (a variant per constant argument value)
+    # =========================================================================
+    print("\n--- Test 29: Static Arguments ---")
+
+    try:
+        @jit(mode='int', static_args=("order",))
+        def st_poly(x, order):
+            acc = 0
+            for _ in range(order):
+                acc = acc * x + 1
+            return acc
+
+        check("static arg order=3", st_poly(2, 3), 7)
+        check("static arg order=5", st_poly(2, 5), 31)
+        check("static arg keyword", st_poly(3, order=3), 13)
+        check("static variants", len(st_poly.static_variants), 2)
+        check("static variant reused", (st_poly(4, 3), len(st_poly.static_variants)), (21, 2))
+        for order in range(17):
+            st_poly(1, order)
+        check("static variants LRU limit", len(st_poly.static_variants), 16)
+        check("static variant dropped", ((int, 0),) in st_poly.static_variants, False)
+    except Exception as e:
+        print(f"  [FAIL] static_args error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 30: Local arrays in int and float mode
+    # =========================================================================
+    print("\n--- Test 30: Local Arrays ---")
+
+    try:
+        global local_array
+        from justjit import local_array
+
+        @jit(mode='int')
+        def la_hist(n, count):
+            table = [0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4]
+            hist = local_array(5)
+            total = 0
+            for i in range(count):
+                nibble = (n >> (4 * i)) & 15
+                hist[table[nibble]] += 1
+                total += table[nibble]
+            return total * 10 + hist[0]
+
+        @jit(mode='float')
+        def la_window(x, k):
+            buf = [0.0] * 4
+            acc = 0.0
+            for i in range(8):
+                buf[i % 4] = x * i
+                acc += buf[-1] + buf[k]
+            return acc
+
+        check("local arrays: int table and scratch", la_hist(0x0F31, 4), 71)
+        check_close("local arrays: float ring buffer", la_window(0.5, 1), 19.0)
+        try:
+            la_window(0.5, 7)
+            print("  [FAIL] local arrays: out-of-range index did not raise")
+            failed += 1
+        except IndexError:
+            print("  [OK] local arrays: out-of-range index raises IndexError")
+            passed += 1
+    except Exception as e:
+        print(f"  [FAIL] local array error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 31: Complex batch calls over interleaved buffers
+    # =========================================================================
+    print("\n--- Test 31: Complex Batch Calls ---")
+
+    try:
+        import array
+
+        @jit(mode='complex128')
+        def cb_mul(a, b):
+            return a * b
+
+        @jit(mode='complex64')
+        def cb_add(a, b):
+            return a + b
+
+        pairs = array.array('d', [1.0, 2.0, 3.0, 4.0, 0.0, 1.0])  # 1+2j, 3+4j, 1j
+        check("complex batch: complex128 map with a broadcast scalar",
+              list(cb_mul.map(pairs, 2j)), [-4.0, 2.0, -8.0, 6.0, -2.0, 0.0])
+        check("complex batch: complex128 reduce", cb_mul.reduce(pairs), -10 - 5j)
+        singles = array.array('f', [0.5, 1.0, 1.5, -2.0])
+        out = array.array('f', [0.0] * 4)
+        cb_add.map(singles, singles, out=out)
+        check("complex batch: complex64 map into out=", list(out), [1.0, 2.0, 3.0, -4.0])
+        check("complex batch: complex64 reduce with initial", cb_add.reduce(singles, 1j), 2 + 0j)
+    except Exception as e:
+        print(f"  [FAIL] complex batch error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 32: Range loop forms in typed modes
+    # =========================================================================
+    print("\n--- Test 32: Range Loop Forms ---")
+
+    try:
+        @jit(mode='int')
+        def rl_odd_weights(n):
+            total = 0
+            for k, i in enumerate(range(2 * n - 1, 0, -2), 1):
+                total += k * i
+            return total
+
+        @jit(mode='int')
+        def rl_stepped(a, b, s):
+            total = 0
+            for i in range(a + 1, b * 2, s):
+                total += i
+            return total
+
+        @jit(mode='int')
+        def rl_triangle(n):
+            count = 0
+            for i in range(n):
+                for j in range(i, n):
+                    count += j - i
+            return count
+
+        @jit(mode='float')
+        def rl_float_sum(a, b):
+            total = 0.0
+            for i in range(a, b):
+                total += i * 0.5
+            return total
+
+        def py_odd_weights(n):
+            return sum(k * i for k, i in enumerate(range(2 * n - 1, 0, -2), 1))
+
+        check("range loops: enumerate(range) with a negative step", rl_odd_weights(10), py_odd_weights(10))
+        check("range loops: expression bounds, variable step", rl_stepped(2, 20, 3), sum(range(3, 40, 3)))
+        check("range loops: negative variable step", rl_stepped(20, 2, -5), sum(range(21, 4, -5)))
+        check("range loops: empty range", rl_stepped(10, 2, 1), 0)
+        check("range loops: nested with an outer-variable bound", rl_triangle(12),
+              sum(j - i for i in range(12) for j in range(i, 12)))
+        check_close("range loops: float mode start and stop", rl_float_sum(3.0, 7.0), 9.0)
+        try:
+            rl_stepped(0, 5, 0)
+            print("  [FAIL] range loops: zero step did not raise")
+            failed += 1
+        except ValueError:
+            print("  [OK] range loops: zero step raises ValueError")
+            passed += 1
+    except Exception as e:
+        print(f"  [FAIL] range loops error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 33: ndarray bounds checks
+    # =========================================================================
+    print("\n--- Test 33: ndarray Bounds Checks ---")
+
+    try:
+        @jit(mode='ndarray')
+        def bc_get(a, i):
+            return a[i]
+
+        @jit(mode='ndarray', boundscheck=False)
+        def bc_get_unchecked(a, i):
+            return a[i]
+
+        @jit(mode='ndarray', boundscheck=True)
+        def bc_rows(a):
+            h, w = a.shape
+            t = 0.0
+            for i in range(h):
+                for j in range(w):
+                    t += a[i, j]
+            return t
+
+        @jit(mode='ndarray')
+        def bc_shifted(a):
+            t = 0.0
+            for i in range(a.size):
+                t += a[i + 1]
+            return t
+
+        data = array.array('d', [1.0, 2.0, 3.0, 4.0])
+        grid = memoryview(array.array('d', range(6))).cast('B').cast('d', [2, 3])
+        check_close("bounds: in-range index", bc_get(data, 2), 3.0)
+        check_close("bounds: negative index", bc_get(data, -1), 4.0)
+        check_close("bounds: unchecked in-range index", bc_get_unchecked(data, 1), 2.0)
+        check_close("bounds: boundscheck=True loop", bc_rows(grid), 15.0)
+        for label, call in (("index past the end", lambda: bc_get(data, 4)),
+                            ("index before the start", lambda: bc_get(data, -5)),
+                            ("loop index off by one", lambda: bc_shifted(data))):
+            try:
+                call()
+                print(f"  [FAIL] bounds: {label} did not raise")
+                failed += 1
+            except IndexError:
+                print(f"  [OK] bounds: {label} raises IndexError")
+                passed += 1
+    except Exception as e:
+        print(f"  [FAIL] bounds checks error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 34: f-string assembly
+    # =========================================================================
+    print("\n--- Test 34: f-string Assembly ---")
+
+    try:
+        @jit(mode='object')
+        def fs_line(name, n, t, code):
+            return f"[{name}] n={n:5d} t={t:.3f} code={code:08X} {t:e} {n!r}"
+
+        @jit(mode='object')
+        def fs_keys(prefix, count):
+            keys = []
+            for i in range(count):
+                keys.append(f"{prefix}:{i:03d}:\u00e9\U0001f600")
+            return keys
+
+        def py_line(name, n, t, code):
+            return f"[{name}] n={n:5d} t={t:.3f} code={code:08X} {t:e} {n!r}"
+
+        for args in (("svc", 42, 3.14159, 48879), ("\u00fc", -7, -0.0, 0), ("x", 10**30, float('inf'), 255),
+                     ("bool", True, 1e300, 7)):
+            check(f"f-strings: {args!r}", fs_line(*args), py_line(*args))
+        check("f-strings: negative hex falls back", fs_line("a", 1, 2.5, -255), py_line("a", 1, 2.5, -255))
+        check("f-strings: mixed character widths", fs_keys("k", 3),
+              [f"k:{i:03d}:\u00e9\U0001f600" for i in range(3)])
+        try:
+            fs_line("a", "not an int", 1.0, 1)
+            print("  [FAIL] f-strings: bad format did not raise")
+            failed += 1
+        except ValueError:
+            print("  [OK] f-strings: bad format raises ValueError")
+            passed += 1
+    except Exception as e:
+        print(f"  [FAIL] f-string error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 35: int boxing at the small-int cache edges
+    # =========================================================================
+    print("\n--- Test 35: Small-int Boxing ---")
+
+    try:
+        @jit(mode='object')
+        def box_edges():
+            a = -6
+            b = -5
+            c = 0
+            d = 256
+            e = 257
+            f = 9223372036854775807
+            return [a, b, c, d, e, f]
+
+        boxed = box_edges()
+        check("boxing: values across the cache edges", boxed, [-6, -5, 0, 256, 257, 9223372036854775807])
+        check("boxing: cached ints are the interpreter's objects",
+              [boxed[1] is int("-5"), boxed[2] is int("0"), boxed[3] is int("256")], [True, True, True])
+    except Exception as e:
+        print(f"  [FAIL] boxing error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 36: literal if/elif and match chains
+    # =========================================================================
+    print("\n--- Test 36: Literal Dispatch Chains ---")
+
+    try:
+        @jit(mode='object')
+        def classify_int(x):
+            if x == 1:
+                return "one"
+            elif x == 2:
+                return "two"
+            elif x == 7:
+                return "seven"
+            elif x == 2:
+                return "shadowed"
+            return "other"
+
+        @jit(mode='object')
+        def match_int(x):
+            match x:
+                case 0:
+                    return 10
+                case 1:
+                    return 11
+                case 1000000:
+                    return 12
+                case -3:
+                    return 13
+                case _:
+                    return -1
+
+        @jit(mode='object')
+        def match_str(s):
+            match s:
+                case "get":
+                    return 1
+                case "put":
+                    return 2
+                case "delete":
+                    return 3
+            return 0
+
+        class Loose(str):
+            def __eq__(self, other):
+                return other == "put"
+
+            __hash__ = str.__hash__
+
+        check("dispatch: if/elif on ints", [classify_int(v) for v in (1, 2, 7, 3, 2 ** 70)],
+              ["one", "two", "seven", "other", "other"])
+        check("dispatch: match on ints", [match_int(v) for v in (0, 1, 1000000, -3, 5)], [10, 11, 12, 13, -1])
+        check("dispatch: match on strs", [match_str(v) for v in ("get", "put", "delete", "post", "")],
+              [1, 2, 3, 0, 0])
+        check("dispatch: generic subjects", [classify_int(2.0), classify_int(True), match_str(Loose("x")),
+                                             match_str(42)], ["two", "one", 2, 0])
+    except Exception as e:
+        print(f"  [FAIL] dispatch error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 37: class patterns through the MATCH_CLASS cache
+    # =========================================================================
+    print("\n--- Test 37: Cached Class Patterns ---")
+
+    try:
+        from dataclasses import dataclass
+
+        @dataclass
+        class Click:
+            x: int
+            y: int
+
+        @dataclass(slots=True)
+        class Key:
+            code: int
+            shift: bool = False
+
+        class DoubleClick(Click):
+            pass
+
+        @jit(mode='object')
+        def route(event):
+            match event:
+                case Key(code, shift=True):
+                    return ("shift", code)
+                case Key(code):
+                    return ("key", code)
+                case Click(x, y):
+                    return ("click", x - y)
+            return None
+
+        events = [Click(1, 2), Key(65), Key(66, True), DoubleClick(3, 4), "noise", Click(5, 6)]
+        check("match class: dataclass and slots routes", [route(e) for e in events],
+              [("click", -1), ("key", 65), ("shift", 66), ("click", -1), None, ("click", -1)])
+        Click.__match_args__ = ("y", "x")
+        check("match class: __match_args__ change seen", [route(Click(10, 2)), route(DoubleClick(3, 1))],
+              [("click", -8), ("click", -2)])
+    except Exception as e:
+        print(f"  [FAIL] match class error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 38: UNPACK_SEQUENCE fast paths and errors
+    # =========================================================================
+    print("\n--- Test 38: Sequence Unpacking ---")
+
+    try:
+        @jit(mode='object')
+        def unpack_pairs(items):
+            total = 0
+            for k, v in items:
+                total += k * v
+            return total
+
+        @jit(mode='object')
+        def unpack_three(seq):
+            a, b, c = seq
+            return [c, b, a]
+
+        @jit(mode='object')
+        def unpack_gen(pairs):
+            for k, v in pairs:
+                yield v, k
+
+        def unpack_error(seq):
+            try:
+                unpack_three(seq)
+            except (TypeError, ValueError) as exc:
+                return f"{type(exc).__name__}: {exc}"
+            return "no error"
+
+        check("unpack: tuples and lists", unpack_pairs([(1, 2), [3, 4], (5, 6)]), 44)
+        check("unpack: dict items and iterators", [unpack_pairs({2: 3, 4: 5}.items()), unpack_three(iter("xyz")),
+                                                   unpack_three(range(3))], [26, ["z", "y", "x"], [2, 1, 0]])
+        check("unpack: CPython's errors", [unpack_error((1, 2)), unpack_error([1, 2, 3, 4]), unpack_error(5),
+                                           unpack_error(x for x in "abcd")],
+              ["ValueError: not enough values to unpack (expected 3, got 2)",
+               "ValueError: too many values to unpack (expected 3)",
+               "TypeError: cannot unpack non-iterable int object",
+               "ValueError: too many values to unpack (expected 3)"])
+        check("unpack: generator code", list(unpack_gen([(1, "a"), ["b", 2]])), [("a", 1), (2, "b")])
+    except Exception as e:
+        print(f"  [FAIL] unpack error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 39: fused dict view loops
+    # =========================================================================
+    print("\n--- Test 39: Dict View Loops ---")
+
+    try:
+        @jit(mode='object')
+        def dict_views(d):
+            pairs = []
+            for k, v in d.items():
+                pairs.append(k + v)
+            keys = []
+            for k in d.keys():
+                keys.append(k)
+            total = 0
+            for v in d.values():
+                total += v
+            return pairs, keys, total
+
+        @jit(mode='object')
+        def grow_while_iterating(d):
+            for k in d.keys():
+                d[k * 10] = 0
+            return len(d)
+
+        @jit(mode='object')
+        def replace_while_iterating(d):
+            for k in d.keys():
+                del d[k]
+                d[k + 100] = 0
+            return len(d)
+
+        @jit(mode='object')
+        def bump_while_iterating(d):
+            for k in d.keys():
+                d[k] += 1
+            return d
+
+        class Reversed(dict):
+            def items(self):
+                return reversed(list(dict.items(self)))
+
+        class Pairs:
+            def items(self):
+                return [(1, 2), (3, 4)]
+
+            def keys(self):
+                return iter("ab")
+
+            def values(self):
+                return (5, 6)
+
+        check("dict loops: exact dict", dict_views({1: 10, 2: 20, 3: 30}), ([11, 22, 33], [1, 2, 3], 60))
+        check("dict loops: empty dict", dict_views({}), ([], [], 0))
+        check("dict loops: subclass and duck-typed views",
+              [dict_views(Reversed({1: 1, 2: 2})), dict_views(Pairs())],
+              [([4, 2], [1, 2], 3), ([3, 7], ["a", "b"], 11)])
+        try:
+            grow_while_iterating({1: 0, 2: 0})
+            check("dict loops: resize raises", "no error", "RuntimeError")
+        except RuntimeError as exc:
+            check("dict loops: resize raises", str(exc), "dictionary changed size during iteration")
+        try:
+            replace_while_iterating({1: 0, 2: 0})
+            check("dict loops: same-size key replacement raises", "no error", "RuntimeError")
+        except RuntimeError as exc:
+            check("dict loops: same-size key replacement raises", str(exc), "dictionary keys changed during iteration")
+        check("dict loops: value updates allowed", bump_while_iterating({1: 0, 2: 5}), {1: 1, 2: 6})
+    except Exception as e:
+        print(f"  [FAIL] dict loop error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 40: membership in constant tuples and sets
+    # =========================================================================
+    print("\n--- Test 40: Constant Membership ---")
+
+    try:
+        @jit(mode='object')
+        def valid_code(x):
+            return x in (200, 201, 204, 2 ** 40)
+
+        @jit(mode='object')
+        def bad_method(m):
+            return m not in {"GET", "POST", "PUT"}
+
+        @jit(mode='object')
+        def small_count(n):
+            hits = 0
+            for i in range(n):
+                if i in (1, 3, 5, 7):
+                    hits += 1
+            return hits
+
+        check("membership: int tuple", [valid_code(v) for v in (200, 204, 404, 2 ** 40, 2 ** 70)],
+              [True, True, False, True, False])
+        check("membership: generic probes", [valid_code(200.0), valid_code(True), valid_code("200")], [True, False, False])
+        check("membership: str set", [bad_method(v) for v in ("GET", "PUT", "DELETE", "", 5)],
+              [False, False, True, True, True])
+        check("membership: loop counter", small_count(10), 4)
+    except Exception as e:
+        print(f"  [FAIL] membership error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 41: closure cells read as guarded constants
+    # =========================================================================
+    print("\n--- Test 41: Closure Constants ---")
+
+    try:
+        def make_scaler(k):
+            @jit(mode='object')
+            def scale(x):
+                return x * k
+            return scale
+
+        def make_counter():
+            step = 1
+
+            @jit(mode='object')
+            def bump(x):
+                return x + step
+
+            def set_step(value):
+                nonlocal step
+                step = value
+            return bump, set_step
+
+        scalers = [make_scaler(k) for k in (2, 3, "ab")]
+        check("closures: per-factory constants", [s(5) if i < 2 else s(2) for i, s in enumerate(scalers)],
+              [10, 15, "abab"])
+        bump, set_step = make_counter()
+        before = bump(10)
+        set_step(5)
+        check("closures: rebinding seen", [before, bump(10)], [11, 15])
+    except Exception as e:
+        print(f"  [FAIL] closure error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 42: with blocks through the per-site context manager cache
+    # =========================================================================
+    print("\n--- Test 42: With Blocks ---")
+
+    try:
+        import threading
+
+        class Tracker:
+            def __init__(self):
+                self.events = []
+
+            def __enter__(self):
+                self.events.append("enter")
+                return self
+
+            def __exit__(self, exc_type, exc, tb):
+                self.events.append("exit")
+
+        @jit(mode='object')
+        def use(cm, x):
+            with cm as entered:
+                entered.events.append(x)
+            return x
+
+        @jit(mode='object')
+        def guarded(cm, lock, x):
+            with lock:
+                held = lock.locked()
+            with cm:
+                if x < 0:
+                    return held
+            return -1
+
+        @jit(mode='object')
+        def enter_only(cm):
+            with cm:
+                return 1
+
+        t = Tracker()
+        use(t, 1)
+        use(t, 2)
+        check("with: enter/body/exit", t.events, ["enter", 1, "exit", "enter", 2, "exit"])
+        lock = threading.Lock()
+        t = Tracker()
+        check("with: Lock held inside, return from body",
+              [guarded(t, lock, -1), guarded(t, lock, 1), lock.locked(), t.events.count("exit")], [True, -1, False, 2])
+
+        class NoExit:
+            def __enter__(self):
+                return self
+        try:
+            enter_only(NoExit())
+            check("with: missing __exit__", "no error", "TypeError")
+        except TypeError as e:
+            check("with: missing __exit__", str(e),
+                  "'NoExit' object does not support the context manager protocol (missed __exit__ method)")
+    except Exception as e:
+        print(f"  [FAIL] with error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 43: ahead-of-time builds
+    # =========================================================================
+    print("\n--- Test 43: Ahead-of-Time Builds ---")
+
+    try:
+        import json
+        import os
+        import tempfile
+
+        previous_cache = justjit.get_cache_dir()
+        with tempfile.TemporaryDirectory() as tmp:
+            with open(os.path.join(tmp, "aot_kernels.py"), "w") as f:
+                f.write("from justjit import jit\n\n"
+                        "@jit(mode='int')\n"
+                        "def aot_triple(x):\n"
+                        "    return x * 3\n")
+            sys.path.insert(0, tmp)
+            try:
+                out = os.path.join(tmp, "build")
+                manifest = justjit.aot("aot_kernels", out)
+            finally:
+                sys.path.remove(tmp)
+            check("aot: functions in the manifest", [e["name"] for e in manifest["functions"]], ["aot_triple"])
+            check("aot: objects written", bool(manifest["objects"]), True)
+            check("aot: cache dir restored", justjit.get_cache_dir(), previous_cache)
+            check("aot: load_aot", justjit.load_aot(out)["module"], "aot_kernels")
+            check("aot: load_aot sets the cache", justjit.get_cache_dir(), os.path.abspath(out))
+            with open(os.path.join(out, justjit.AOT_MANIFEST)) as f:
+                stale = json.load(f)
+            stale["python"] = "0.0"
+            with open(os.path.join(out, justjit.AOT_MANIFEST), "w") as f:
+                json.dump(stale, f)
+            try:
+                justjit.load_aot(out)
+                check("aot: stale manifest rejected", "loaded", "RuntimeError")
+            except RuntimeError:
+                check("aot: stale manifest rejected", True, True)
+            justjit.set_cache_dir(previous_cache)
+    except Exception as e:
+        print(f"  [FAIL] aot error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 44: profile-driven warmup
+    # =========================================================================
+    print("\n--- Test 44: Profile Warmup ---")
+
+    try:
+        import json
+        import os
+        import tempfile
+
+        with tempfile.TemporaryDirectory() as tmp:
+            with open(os.path.join(tmp, "warm_kernels.py"), "w") as f:
+                f.write("from justjit import jit\n\n"
+                        "@jit(mode='int')\n"
+                        "def warm_double(x):\n"
+                        "    return x * 2\n\n"
+                        "@jit(mode='int', static_args='k')\n"
+                        "def warm_scale(x, k):\n"
+                        "    return x * k\n\n"
+                        "@jit(mode='int')\n"
+                        "def warm_unused(x):\n"
+                        "    return x\n")
+            sys.path.insert(0, tmp)
+            try:
+                import warm_kernels
+                calls = [warm_kernels.warm_double(4), warm_kernels.warm_scale(3, 5), warm_kernels.warm_scale(3, 7)]
+                profile_path = os.path.join(tmp, "profile.json")
+                justjit.save_profile(profile_path)
+                with open(profile_path) as f:
+                    recorded = {e["name"]: e for e in json.load(f)["functions"] if e["module"] == "warm_kernels"}
+                check("profile: results", calls, [8, 15, 21])
+                check("profile: compiled functions only", sorted(recorded), ["warm_double", "warm_scale"])
+                check("profile: static variants", sorted(v[0] for v in recorded["warm_scale"]["static_values"]), [5, 7])
+                check("profile: warmup", justjit.warmup(profile_path) >= 2, True)
+            finally:
+                sys.path.remove(tmp)
+                sys.modules.pop("warm_kernels", None)
+    except Exception as e:
+        print(f"  [FAIL] profile error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 45: whole-module compilation
+    # =========================================================================
+    print("\n--- Test 45: jit_module ---")
+
+    try:
+        import os
+        import tempfile
+
+        with tempfile.TemporaryDirectory() as tmp:
+            with open(os.path.join(tmp, "module_kernels.py"), "w") as f:
+                f.write("def square(x):\n"
+                        "    return x * x\n\n"
+                        "def sum_squares(n):\n"
+                        "    total = 0\n"
+                        "    i = 0\n"
+                        "    while i < n:\n"
+                        "        total = total + square(i)\n"
+                        "        i = i + 1\n"
+                        "    return total\n\n"
+                        "def skipped(x):\n"
+                        "    return x\n\n"
+                        "class Helper:\n"
+                        "    pass\n")
+            sys.path.insert(0, tmp)
+            try:
+                import module_kernels
+                names = justjit.jit_module(module_kernels, exclude=("skipped",))
+                check("jit_module: decorated names", sorted(names), ["square", "sum_squares"])
+                check("jit_module: results", [module_kernels.sum_squares(10), module_kernels.square(7)], [285, 49])
+                check("jit_module: excluded and classes untouched",
+                      [type(module_kernels.skipped).__name__, type(module_kernels.Helper).__name__], ["function", "type"])
+            finally:
+                sys.path.remove(tmp)
+                sys.modules.pop("module_kernels", None)
+    except Exception as e:
+        print(f"  [FAIL] jit_module error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 46: multi-target ahead-of-time builds
+    # =========================================================================
+    print("\n--- Test 46: Multi-Target AOT ---")
+
+    try:
+        import os
+        import platform
+        import tempfile
+
+        baseline = {"x86_64": "x86-64", "AMD64": "x86-64", "aarch64": "generic", "arm64": "generic"}.get(platform.machine())
+        check("targets: unknown CPU unsupported", justjit.host_supports_cpu("no-such-cpu"), False)
+        if baseline is not None:
+            check("targets: baseline supported", justjit.host_supports_cpu(baseline), True)
+            check("targets: select_target", justjit.select_target([baseline, "no-such-cpu"]), baseline)
+            check("targets: nothing runs", justjit.select_target(["no-such-cpu"]), None)
+
+            previous_cache = justjit.get_cache_dir()
+            with tempfile.TemporaryDirectory() as tmp:
+                with open(os.path.join(tmp, "fleet_kernels.py"), "w") as f:
+                    f.write("from justjit import jit\n\n"
+                            "@jit(mode='int')\n"
+                            "def fleet_add(x, y):\n"
+                            "    return x + y\n")
+                sys.path.insert(0, tmp)
+                try:
+                    out = os.path.join(tmp, "build")
+                    manifest = justjit.aot("fleet_kernels", out, targets=[baseline])
+                    check("targets: manifest", (manifest["targets"], [e["name"] for e in manifest["functions"]]),
+                          ([baseline], ["fleet_add"]))
+                    check("targets: load_aot selects", justjit.load_aot(out)["target"], baseline)
+                    import fleet_kernels
+                    check("targets: compiled for the selected CPU", fleet_kernels.fleet_add(2, 3), 5)
+                finally:
+                    sys.path.remove(tmp)
+                    sys.modules.pop("fleet_kernels", None)
+                    justjit._fleet_target = None
+                    justjit.set_cache_dir(previous_cache)
+    except Exception as e:
+        print(f"  [FAIL] multi-target aot error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 47: branch profiles of the profiling tier
+    # =========================================================================
+    print("\n--- Test 47: Branch Profiles ---")
+
+    try:
+        @justjit.jit(mode="object", tier_up_threshold=1000, lazy=False)
+        def every_third(n):
+            total = 0
+            for i in range(n):
+                if i % 3 == 0:
+                    total += i
+            return total
+
+        check("branch profile: results", [every_third(9), every_third(9)], [9, 9])
+        entries, branches = every_third._jit_instance.get_branch_profile("every_third")
+        check("branch profile: calls counted", entries, 2)
+        check("branch profile: if counted", (6, 12) in branches.values(), True)
+        check("branch profile: loop exit counted", (2, 18) in branches.values(), True)
+    except Exception as e:
+        print(f"  [FAIL] branch profile error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 48: on-stack replacement of a loop in an interpreted call
+    # =========================================================================
+    print("\n--- Test 48: On-Stack Replacement ---")
+
+    try:
+        # Module-level globals, no closure: the loop can move to native code.
+        # At i == 100 the loop waits for the compile worker, so the OSR entry
+        # (queued at the 50th backward jump) is ready for the next one
+        namespace = {"justjit": justjit}
+        exec(
+            "def long_job(n):\n"
+            "    total = 0\n"
+            "    i = 0\n"
+            "    while i < n:\n"
+            "        if i == 100:\n"
+            "            justjit._get_compile_executor().submit(int).result()\n"
+            "        total += i * i\n"
+            "        i += 1\n"
+            "    return total\n"
+            "def tagged_job(n, tag):\n"
+            "    total = 0\n"
+            "    i = 0\n"
+            "    while i < n:\n"
+            "        if i == 100:\n"
+            "            justjit._get_compile_executor().submit(int).result()\n"
+            "        total += i\n"
+            "        i += 1\n"
+            "    return total\n",
+            namespace,
+        )
+        saved_threshold = justjit._OSR_THRESHOLD
+        justjit._OSR_THRESHOLD = 50
+        try:
+            long_job = justjit.jit(mode="object", background=True, lazy=False)(namespace["long_job"])
+            check("osr: interpreted call result", long_job(5000), sum(i * i for i in range(5000)))
+            check("osr: loop finished natively", justjit.counters(long_job)["osr_entries"], 1)
+            check("osr: later call result", long_job(10), 285)
+            # The frame's locals are handed over and released when the entry returns
+            tagged_job = justjit.jit(mode="object", background=True, lazy=False)(namespace["tagged_job"])
+            tag = object()
+            refs = sys.getrefcount(tag)
+            check("osr: tagged call result", tagged_job(5000, tag), sum(range(5000)))
+            check("osr: tagged loop finished natively", justjit.counters(tagged_job)["osr_entries"], 1)
+            check("osr: frame locals released", sys.getrefcount(tag), refs)
+        finally:
+            justjit._OSR_THRESHOLD = saved_threshold
+    except Exception as e:
+        print(f"  [FAIL] osr error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 49: speculative tier-up resumes a call whose guard fails
+    # =========================================================================
+    print("\n--- Test 49: Speculation and Deoptimization ---")
+
+    try:
+        # Past tier_up_threshold calls the optimized tier takes over the entry
+        @justjit.jit(mode="int", tier_up_threshold=3, lazy=False)
+        def tier_sum(n):
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+
+        check("tier-up: baseline calls", [tier_sum(10) for _ in range(3)], [45, 45, 45])
+        justjit._get_compile_executor().submit(lambda: None).result()
+        baseline, hot = tier_sum._native_entries[0], tier_sum._native_entries[-1]
+        check("tier-up: hot tier compiled", (len(tier_sum._tier_instances), hot is not baseline), (2, True))
+        check("tier-up: hot tier result", tier_sum(100), 4950)
+        check("tier-up: calls reach the hot tier",
+              (baseline.counters["native_calls"], hot.counters["native_calls"]), (3, 1))
+
+        @justjit.jit(mode="object", tier_up_threshold=3, lazy=False)
+        def scale(log, a, b):
+            log.append(a)
+            return a * b + a
+
+        log = []
+        check("deopt: float calls", [scale(log, 1.5, 2.0) for _ in range(3)], [4.5, 4.5, 4.5])
+        justjit._get_compile_executor().submit(lambda: None).result()
+        # The hot tier only guards for floats: ints continue in the resume
+        # entry, past the append, which must not run twice
+        check("deopt: int call result", scale(log, 2, 3), 8)
+        check("deopt: no rerun", len(log), 4)
+        check("deopt: guard failure counted", justjit.counters(scale)["deopts"], 1)
+        check("deopt: float call after", scale(log, 0.5, 2.0), 1.5)
+    except Exception as e:
+        print(f"  [FAIL] deopt error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 50: jitclass records in ndarray-mode kernels
+    # =========================================================================
+    print("\n--- Test 50: jitclass ---")
+
+    try:
+        @justjit.jitclass
+        class Particle:
+            x: float
+            v: float = 1.0
+            steps: "int32"
+            alive: bool = True
+
+            def energy(self):
+                return 0.5 * self.v * self.v
+
+        @justjit.jit(mode="ndarray")
+        def advance(p, dt):
+            p.x = p.x + p.v * dt
+            p.steps += 1
+            if p.x > 10.0:
+                p.alive = False
+
+        particle = Particle(9.0, 4.0)
+        check("jitclass: defaults", (particle.steps, particle.alive), (0, True))
+        advance(particle, 0.25)
+        advance(particle, 0.25)
+        check("jitclass: fields stored", (particle.x, particle.steps, particle.alive), (11.0, 2, False))
+        compiled = [k for k, entry in advance._ndarray_specializations.items() if entry is not None]
+        check("jitclass: kernel compiled", compiled, ["{x:d,v:d,steps:i,alive:?}d"])
+        check("jitclass: native method", particle.energy(), 8.0)
+        check("jitclass: method compiled", None not in Particle.energy._ndarray_specializations.values(), True)
+    except Exception as e:
+        print(f"  [FAIL] jitclass error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 51: RecordArray columns in ndarray-mode loops
+    # =========================================================================
+    print("\n--- Test 51: RecordArray ---")
+
+    try:
+        @justjit.jitclass
+        class Tick:
+            price: float
+            qty: int
+            buy: bool
+
+        @justjit.jit(mode="ndarray")
+        def net_notional(ticks):
+            total = 0.0
+            for i in range(ticks.size):
+                if ticks[i].buy:
+                    total += ticks[i].price * ticks[i].qty
+                else:
+                    total -= ticks[i].price * ticks[i].qty
+            return total
+
+        @justjit.jit(mode="ndarray")
+        def mark(ticks, price):
+            for i in range(ticks.size):
+                ticks[i].price = price
+
+        ticks = justjit.RecordArray[Tick]([Tick(10.0, 3, True), Tick(12.5, 2, False), Tick(9.0, 1, True)])
+        check("record array: reduction", net_notional(ticks), 14.0)
+        mark(ticks, 1.5)
+        check("record array: column stored", ticks.column("price").tolist(), [1.5, 1.5, 1.5])
+        check("record array: element copy", (ticks[1].price, ticks[1].qty, ticks[1].buy), (1.5, 2, False))
+        compiled = [k for k, entry in net_notional._ndarray_specializations.items() if entry is not None]
+        check("record array: kernel compiled", compiled, ["[price:d,qty:q,buy:?]"])
+    except Exception as e:
+        print(f"  [FAIL] record array error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 52: typed List / Dict in ndarray-mode kernels
+    # =========================================================================
+    print("\n--- Test 52: Typed Containers ---")
+
+    try:
+        from justjit.typed import Dict, List, float64, int64
+
+        @justjit.jit(mode="ndarray")
+        def histogram(xs, counts):
+            for i in range(len(xs)):
+                k = xs[i] // 10
+                counts[k] = counts.get(k, 0.0) + 1.0
+
+        @justjit.jit(mode="ndarray")
+        def squares(n, out):
+            for i in range(n):
+                out.append(i * i)
+
+        @justjit.jit(mode="ndarray")
+        def lookup(d, k):
+            if k in d:
+                return d[k]
+            return d[k + 1]
+
+        xs = List[int64]([3, 14, 15, 92, 7])
+        counts = Dict[int64, float64]()
+        histogram(xs, counts)
+        check("typed dict: kernel histogram", counts.to_dict(), {0: 2.0, 1: 2.0, 9: 1.0})
+        out = List[int64]()
+        squares(1000, out)
+        check("typed list: kernel append", (len(out), out[-1], out[10]), (1000, 998001, 100))
+        check("typed dict: in / get", lookup(counts, 9), 1.0)
+        try:
+            lookup(counts, 4)
+            check("typed dict: missing key", "no error", "KeyError")
+        except KeyError as e:
+            check("typed dict: missing key", e.args, (5,))
+        compiled = [k for k, entry in histogram._ndarray_specializations.items() if entry is not None]
+        check("typed containers: kernel compiled", compiled, ["LqMd"])
+    except Exception as e:
+        print(f"  [FAIL] typed containers error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 53: bytes parsing in ndarray mode
+    # =========================================================================
+    print("\n--- Test 53: Bytes Parsing ---")
+
+    try:
+        @justjit.jit(mode="ndarray")
+        def decode_header(packet):
+            kind = packet[0]
+            length = int.from_bytes(packet[1:3], "big")
+            seq = int.from_bytes(packet[3:7], "little", signed=True)
+            return kind, length, seq
+
+        @justjit.jit(mode="ndarray")
+        def payload_sum(packet, offset):
+            body = 0
+            for i in range(len(packet[offset:])):
+                body += packet[offset:][i]
+            return body + int.from_bytes(packet[-2:], "little")
+
+        packet = bytes([7, 1, 2]) + (-5).to_bytes(4, "little", signed=True) + bytes([9, 10, 11])
+        check("bytes: fixed-width fields", decode_header(packet), (7, 258, -5))
+        check("bytes: bytearray argument", decode_header(bytearray(packet)), (7, 258, -5))
+        check("bytes: slices", payload_sum(packet, 7), 30 + 10 + 11 * 256)
+        check("bytes: short slice", payload_sum(bytes([1]), 0), 2)
+        compiled = [k for k, entry in decode_header._ndarray_specializations.items() if entry is not None]
+        check("bytes: kernel compiled", compiled, ["CB1"])
+    except Exception as e:
+        print(f"  [FAIL] bytes parsing error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 54: str operations in ndarray mode
+    # =========================================================================
+    print("\n--- Test 54: Native Str ---")
+
+    try:
+        @justjit.jit(mode="ndarray")
+        def csv_field(line, k):
+            start = 0
+            for _ in range(k):
+                start = line.find(",", start) + 1
+            end = line.find(",", start)
+            if end < 0:
+                end = len(line)
+            return line[start:end]
+
+        @justjit.jit(mode="ndarray")
+        def scan(s):
+            commas = 0
+            digits = 0
+            for c in s:
+                if c == ",":
+                    commas += 1
+                if c >= "0" and c <= "9":
+                    digits += ord(c) - ord("0")
+            return commas, digits
+
+        @justjit.jit(mode="ndarray")
+        def is_comment(line):
+            if line.startswith("#"):
+                return True
+            return "//" in line
+
+        @justjit.jit(mode="ndarray")
+        def last_char(s):
+            return s[-1]
+
+        line = "id,name,42,x"
+        check("str: csv fields", [csv_field(line, k) for k in range(4)], line.split(","))
+        check("str: wide code points", csv_field("α,βγ,δ", 1), "βγ")
+        check("str: character loop", scan("1,2,3,4"), (3, 10))
+        check("str: startswith / in", [is_comment(x) for x in ("# a", "a // b", "ab")], [True, True, False])
+        check("str: character result", last_char("héllo€"), "€")
+        compiled = [k for k, entry in csv_field._ndarray_specializations.items() if entry is not None]
+        check("str: kernel compiled", compiled, ["Uq"])
+    except Exception as e:
+        print(f"  [FAIL] str operations error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 55: streaming batch calls over files
+    # =========================================================================
+    print("\n--- Test 55: Streaming Over Files ---")
+
+    try:
+        import array
+        import mmap
+        import os
+        import tempfile
+
+        @jit(mode='int')
+        def stream_add(a, b):
+            return a + b
+
+        @jit(mode='int', parallel=True)
+        def stream_par_add(a, b):
+            return a + b
+
+        @jit(mode='float')
+        def stream_half(x):
+            return x * 0.5
+
+        with tempfile.TemporaryDirectory() as tmp:
+            ints_path = os.path.join(tmp, "ints.q")
+            with open(ints_path, "wb") as f:
+                array.array('q', range(100_000)).tofile(f)
+            total = 100_000 * 99_999 // 2
+            check("stream: file reduce", stream_add.stream(ints_path), total)
+            check("stream: small tiles", stream_add.stream(ints_path, 1000, initial=7), total + 7)
+            check("stream: parallel tiles", stream_par_add.stream(ints_path, 50_000), total)
+            with open(ints_path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+                check("stream: mmap source", stream_add.stream(mapped, 4096), total)
+
+            floats_path = os.path.join(tmp, "x.d")
+            half_path = os.path.join(tmp, "half.d")
+            with open(floats_path, "wb") as f:
+                array.array('d', [float(i) for i in range(3000)]).tofile(f)
+            stream_half.stream(floats_path, 1024, out=half_path)
+            halves = array.array('d')
+            with open(half_path, "rb") as f:
+                halves.frombytes(f.read())
+            check("stream: map to file", list(halves) == [i * 0.5 for i in range(3000)], True)
+            ragged_path = os.path.join(tmp, "ragged.q")
+            with open(ragged_path, "wb") as f:
+                f.write(b"0123456789")
+            try:
+                stream_add.stream(ragged_path)
+                check("stream: ragged file rejected", False, True)
+            except ValueError:
+                check("stream: ragged file rejected", True, True)
+    except Exception as e:
+        print(f"  [FAIL] streaming error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 56: fused map kernels
+    # =========================================================================
+    print("\n--- Test 56: Kernel Fusion ---")
+
+    try:
+        import array
+
+        @jit(mode='float')
+        def fuse_scale(x, a):
+            return x * a
+
+        @jit(mode='float')
+        def fuse_shift(x):
+            return x + 1.0
+
+        @jit(mode='float')
+        def fuse_clip(x):
+            return x if x < 10.0 else 10.0
+
+        @jit(mode='int')
+        def fuse_double(n):
+            return n * 2
+
+        pipeline = justjit.fuse(fuse_scale, fuse_shift, fuse_clip)
+        check("fuse: scalar call", pipeline(3.0, 2.0), 7.0)
+        xs = array.array('d', [0.0, 1.0, 2.0, 8.0])
+        check("fuse: fused map", list(pipeline.map(xs, 2.0)), [1.0, 3.0, 5.0, 10.0])
+        check("fuse: int stages", justjit.fuse(fuse_double, fuse_double)(5), 20)
+        try:
+            justjit.fuse(fuse_shift, fuse_scale)
+            check("fuse: arity checked", False, True)
+        except TypeError:
+            check("fuse: arity checked", True, True)
+        try:
+            justjit.fuse(fuse_shift, fuse_double)
+            check("fuse: one mode", False, True)
+        except TypeError:
+            check("fuse: one mode", True, True)
+    except Exception as e:
+        print(f"  [FAIL] fusion error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 57: generator pipelines
+    # =========================================================================
+    print("\n--- Test 57: Generator Pipelines ---")
+
+    try:
+        @jit(mode='int')
+        def pipe_count(n):
+            for i in range(n):
+                yield i
+
+        @jit(mode='int')
+        def pipe_square(x):
+            return x * x
+
+        @jit(mode='float')
+        def pipe_half(x):
+            return x * 0.5
+
+        @jit(mode='int')
+        def pipe_add(a, b):
+            return a + b
+
+        expected = sum(i * i for i in range(5000))
+        check("pipeline: map and reduce",
+              justjit.pipeline(pipe_count(5000), pipe_square, reduce=pipe_add, batch=64, depth=2), expected)
+        check("pipeline: initial", justjit.pipeline(pipe_count(4), reduce=pipe_add, initial=100), 106)
+        check("pipeline: collect", list(justjit.pipeline(pipe_count(4), pipe_square, pipe_half)), [0.0, 0.5, 2.0, 4.5])
+        gen = pipe_count(3)
+        justjit.pipeline(gen)
+        check("pipeline: source consumed", list(gen), [])
+        try:
+            justjit.pipeline(pipe_count(3), pipe_half, pipe_square)
+            check("pipeline: no float to int", False, True)
+        except TypeError:
+            check("pipeline: no float to int", True, True)
+    except Exception as e:
+        print(f"  [FAIL] pipeline error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 58: batched coroutine stepping
+    # =========================================================================
+    print("\n--- Test 58: Coroutine Gather ---")
+
+    try:
+        import asyncio
+
+        @jit
+        async def gather_work(x):
+            await asyncio.sleep(0)
+            await asyncio.sleep(0)
+            return x * 2
+
+        @jit
+        async def gather_wait(fut):
+            return await fut
+
+        @jit
+        async def gather_fail(x):
+            raise ValueError("bad")
+
+        async def gather_all():
+            return await justjit.gather(*(gather_work(i) for i in range(1000)))
+
+        check("gather: results in order", asyncio.run(gather_all()), [i * 2 for i in range(1000)])
+
+        async def gather_futures():
+            loop = asyncio.get_running_loop()
+            fut = loop.create_future()
+            loop.call_soon(fut.set_result, 7)
+            return await justjit.gather(gather_wait(fut), gather_work(1))
+
+        check("gather: parks on futures", asyncio.run(gather_futures()), [7, 2])
+
+        async def gather_errors():
+            return await justjit.gather(gather_fail(0), gather_work(2), return_exceptions=True)
+
+        got = asyncio.run(gather_errors())
+        check("gather: return_exceptions", (type(got[0]).__name__, got[1]), ("ValueError", 4))
+        try:
+            asyncio.run(justjit.gather(gather_fail(0)))
+            check("gather: raises", False, True)
+        except ValueError:
+            check("gather: raises", True, True)
+
+        # Coroutines still pending when one raises, or when the gather is
+        # cancelled, are closed: their finally blocks run
+        closed = []
+
+        async def gather_guarded(fut, tag):
+            try:
+                return await fut
+            finally:
+                closed.append(tag)
+
+        async def gather_fail_pending():
+            fut = asyncio.get_running_loop().create_future()
+            return await justjit.gather(gather_guarded(fut, "raised"), gather_fail(0))
+
+        try:
+            asyncio.run(gather_fail_pending())
+            check("gather: raise closes pending", False, True)
+        except ValueError:
+            check("gather: raise closes pending", closed, ["raised"])
+
+        async def gather_cancelled():
+            fut = asyncio.get_running_loop().create_future()
+            task = asyncio.ensure_future(justjit.gather(gather_guarded(fut, "cancelled"), gather_work(1)))
+            for _ in range(3):
+                await asyncio.sleep(0)
+            task.cancel()
+            try:
+                await task
+            except asyncio.CancelledError:
+                return "cancelled"
+
+        check("gather: cancel closes pending", (asyncio.run(gather_cancelled()), closed), ("cancelled", ["raised", "cancelled"]))
+    except Exception as e:
+        print(f"  [FAIL] gather error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 59: typed code shared between JIT instances
+    # =========================================================================
+    print("\n--- Test 59: Shared Object Cache ---")
+
+    try:
+        def shared_mul_add(a, b):
+            return a * b + 7
+
+        shared_instrs = [{"opcode": i.opcode, "arg": i.arg or 0, "argval": 0, "offset": i.offset}
+                         for i in dis.get_instructions(shared_mul_add)]
+        justjit.clear_stats()
+        shared_results = []
+        for _ in range(2):
+            core = justjit.JIT()
+            core.compile_int(shared_instrs, list(shared_mul_add.__code__.co_consts), "shared_mul_add", 2, 2)
+            shared_results.append(core.get_int_callable("shared_mul_add", 2)(3, 4))
+        check("shared cache: both instances run", shared_results, [19, 19])
+        shared_stats = [r["cached"] for r in justjit.stats() if r["name"] == "shared_mul_add"]
+        check("shared cache: second instance reuses the object", shared_stats, [False, True])
+    except Exception as e:
+        print(f"  [FAIL] shared cache error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 60: a loop compiled on its own, the rest left to the interpreter
+    # =========================================================================
+    print("\n--- Test 60: Loop Regions ---")
+
+    try:
+        import builtins
+
+        def region_job(n):
+            total = 0
+            i = 0
+            while i < n:
+                total += i * i
+                i += 1
+            label = "sum=" + str(total)
+            return label, i
+
+        region_code = region_job.__code__
+        region_header = min(ins.argval for ins in dis.get_instructions(region_job) if ins.opname == "JUMP_BACKWARD")
+        regions = dict(justjit.JIT.loop_regions(region_code))
+        check("regions: while loop found", region_header in regions, True)
+
+        core = justjit.JIT()
+        ok = core.compile(
+            region_code, list(region_code.co_consts), list(region_code.co_names), region_job.__globals__,
+            builtins.__dict__, [], region_code,
+            "region_job__region", 1, region_code.co_nlocals, region_code.co_nlocals,
+            osr_points=[(region_header, 0)], region_end=regions[region_header],
+        )
+        check("regions: loop compiles alone", ok, True)
+        entry = core.get_osr_callable("region_job__region", [region_code.co_nlocals], justjit._OSR_UNBOUND)
+        start = [10 if name == "n" else 0 if name in ("total", "i") else justjit._OSR_UNBOUND
+                 for name in region_code.co_varnames]
+        try:
+            entry(0, start)
+            exited = None
+        except justjit.DeoptError:
+            exited = justjit.JIT.take_deopt_frame(justjit._OSR_UNBOUND)
+        exit_offset, exit_locals = exited
+        final = dict(zip(region_code.co_varnames, exit_locals))
+        check("regions: loop ran natively", (final["total"], final["i"]), (285, 10))
+        unbound = tuple(k for k, value in enumerate(exit_locals) if value is justjit._OSR_UNBOUND)
+        tail = justjit._region_tail(region_job, exit_offset, unbound)
+        args = [None if value is justjit._OSR_UNBOUND else value for value in exit_locals]
+        check("regions: interpreter finishes the call", tail(*args), region_job(10))
+    except Exception as e:
+        print(f"  [FAIL] loop regions error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 61: long compiled loops poll the eval breaker
+    # =========================================================================
+    print("\n--- Test 61: Loop Polls ---")
+
+    try:
+        import threading
+        import _thread
+
+        core = justjit.JIT()
+        check("polls: default interval", core.get_poll_interval(), -1)
+        core.set_poll_interval(64)
+        check("polls: interval set", core.get_poll_interval(), 64)
+
+        @justjit.jit(mode="object", poll=1, lazy=False)
+        def poll_sum(n):
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+
+        check("polls: object loop result", poll_sum(1000), sum(range(1000)))
+
+        def spin(n):
+            total = 0
+            i = 0
+            while i < n:
+                total += i & 7
+                i += 1
+            return total
+
+        for spin_mode in ("object", "int"):
+            spinner = justjit.jit(spin, mode=spin_mode, poll=256, lazy=False)
+            # The timer is Python code: it only runs if the loop hands over the GIL
+            ticks = []
+            timer = threading.Timer(0.05, lambda: (ticks.append(1), _thread.interrupt_main()))
+            timer.start()
+            try:
+                spinner(1 << 62)
+                interrupted = False
+            except KeyboardInterrupt:
+                interrupted = True
+            timer.join()
+            check(f"polls: other thread ran during the {spin_mode} loop", ticks, [1])
+            check(f"polls: {spin_mode} loop sees Ctrl-C", interrupted, True)
+    except Exception as e:
+        print(f"  [FAIL] loop polls error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 62: temporaries that never escape are not allocated
+    # =========================================================================
+    print("\n--- Test 62: Virtual Tuples ---")
+
+    try:
+        @justjit.jit(mode="object", lazy=False)
+        def rotate4(a, b, c, d):
+            a, b, c, d = d, a, b, c
+            return [a, b, c, d]
+
+        check("virtual tuples: unpacked in place", rotate4(1, "x", 3.0, None), [None, 1, "x", 3.0])
+
+        @justjit.jit(mode="object", lazy=False)
+        def among(x, a, b, c):
+            return x in (a, b, c), x not in (a, b)
+
+        check("virtual tuples: in", among(2, 1, 2, 3), (True, False))
+        check("virtual tuples: not in", among("z", "a", "b", "c"), (False, True))
+
+        class Grumpy:
+            def __eq__(self, other):
+                raise ValueError("no compare")
+
+        try:
+            among(0, Grumpy(), 1, 2)
+            check("virtual tuples: compare error propagates", False, True)
+        except ValueError:
+            check("virtual tuples: compare error propagates", True, True)
+
+        class Base:
+            def greet(self, name):
+                return "hi " + name
+
+        class Child(Base):
+            def greet(self, name):
+                return super().greet(name) + "!"
+
+        Child.greet = justjit.jit(Child.greet, mode="object", lazy=False)
+        check("virtual tuples: super() without an args tuple", Child().greet("bo"), "hi bo!")
+
+        @justjit.jit
+        def method_gen(items):
+            for item in items:
+                yield item.upper()
+
+        check("virtual tuples: generator method calls", list(method_gen(["a", "b"])), ["A", "B"])
+    except Exception as e:
+        print(f"  [FAIL] virtual tuples error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 63: module attributes loaded through the globals cache
+    # =========================================================================
+    print("\n--- Test 63: Cached Module Attributes ---")
+
+    try:
+        import math
+        import types
+
+        knobs = types.ModuleType("knobs")
+        knobs.scale = 2
+        knobs.bump = lambda: setattr(knobs, "scale", knobs.scale + 1)
+        namespace = {"knobs": knobs, "math": math}
+        exec(
+            "def scaled_sum(n):\n"
+            "    total = 0\n"
+            "    for i in range(n):\n"
+            "        total += knobs.scale * int(math.sqrt(i * i))\n"
+            "    return total\n"
+            "def bumped_sum(n):\n"
+            "    total = 0\n"
+            "    for i in range(n):\n"
+            "        total += knobs.scale\n"
+            "        knobs.bump()\n"
+            "    return total\n",
+            namespace,
+        )
+        scaled_sum = justjit.jit(namespace["scaled_sum"], mode="object", lazy=False)
+        bumped_sum = justjit.jit(namespace["bumped_sum"], mode="object", lazy=False)
+        check("module attrs: loop result", scaled_sum(10), 2 * sum(range(10)))
+        knobs.scale = 5
+        check("module attrs: rebinding seen", scaled_sum(10), 5 * sum(range(10)))
+        check("module attrs: writes inside the loop seen", bumped_sum(4), 5 + 6 + 7 + 8)
+        del knobs.scale
+        try:
+            scaled_sum(1)
+            check("module attrs: missing attribute raises", False, True)
+        except AttributeError:
+            check("module attrs: missing attribute raises", True, True)
+    except Exception as e:
+        print(f"  [FAIL] module attrs error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 64: identical object-mode bodies compiled once
+    # =========================================================================
+    print("\n--- Test 64: Shared Object Bodies ---")
+
+    try:
+        namespace = {}
+        exec(
+            "def make_scaled(k, scale):\n"
+            "    return lambda x, s=scale: (x + k) * s\n"
+            "def make_triple():\n"
+            "    return lambda x: x * 3\n",
+            namespace,
+        )
+        scaled = [justjit.jit(namespace["make_scaled"](k, k + 1), mode="object", lazy=False) for k in range(5)]
+        check("shared bodies: cells and defaults stay per closure", [f(10) for f in scaled],
+              [(10 + k) * (k + 1) for k in range(5)])
+        check("shared bodies: later closures run one body", len({f.address for f in scaled[1:]}), 1)
+        check("shared bodies: keyword call binds own default", scaled[3](1, s=2), (1 + 3) * 2)
+        triples = [justjit.jit(namespace["make_triple"](), mode="object", lazy=False) for _ in range(3)]
+        check("shared bodies: closure-free code shares from the first", len({f.address for f in triples}), 1)
+        check("shared bodies: shared result", [f(7) for f in triples], [21, 21, 21])
+    except Exception as e:
+        print(f"  [FAIL] shared bodies error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 65: machine-generated functions with thousands of blocks
+    # =========================================================================
+    print("\n--- Test 65: Large Generated Functions ---")
+
+    try:
+        body = "".join(
+            f"    if a > {k}:\n        t += {k}\n    else:\n        t -= 1\n" for k in range(1500)
+        )
+        namespace = {}
+        exec(f"def generated(a):\n    t = 0\n{body}    return t\n", namespace)
+        generated = namespace["generated"]
+        big = justjit.jit(generated, mode="object", lazy=False)
+        check("large function: compiled", big is not generated, True)
+        check("large function: result", [big(a) for a in (-1, 700, 2000)], [generated(a) for a in (-1, 700, 2000)])
+    except Exception as e:
+        print(f"  [FAIL] large function error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 66: compile budgets (max_bytecode_size, max_compile_ms)
+    # =========================================================================
+    print("\n--- Test 66: Compile Budgets ---")
+
+    try:
+        import time
+
+        def budget_sum(n):
+            total = 0
+            for i in range(n):
+                total += i * 3
+            return total
+
+        before = len(justjit.stats())
+        small_budget = justjit.jit(budget_sum, mode="object", lazy=False, max_bytecode_size=5)
+        check("budget: over-size result", small_budget(10), budget_sum(10))
+        records = [r for r in justjit.stats()[before:] if r["name"] == "budget_sum"]
+        check("budget: over-size compiled at O0", [(r["opt_level"], r["budget"]) for r in records][:1], [(0, "size")])
+
+        deferred = justjit.jit(budget_sum, mode="object", max_compile_ms=0)
+        check("budget: deferred call runs interpreted", deferred(10), budget_sum(10))
+        check("budget: deferral counted", justjit.counters(deferred)["budget_deferrals"], 1)
+        deadline = time.time() + 30
+        while justjit.counters(deferred)["native_calls"] == 0 and time.time() < deadline:
+            deferred(10)
+            time.sleep(0.01)
+        check("budget: background compile takes over", justjit.counters(deferred)["native_calls"] > 0, True)
+        check("budget: deferred result", deferred(20), budget_sum(20))
+        try:
+            justjit.jit(budget_sum, max_compile_ms=-1)
+            check("budget: negative budget rejected", False, True)
+        except ValueError:
+            check("budget: negative budget rejected", True, True)
+    except Exception as e:
+        print(f"  [FAIL] compile budget error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 67: keyword calls go through vectorcall with kwnames
+    # =========================================================================
+    print("\n--- Test 67: Keyword Calls ---")
+
+    try:
+        def kw_target(a, b=2, *, c=3, **extra):
+            return (a, b, c, sorted(extra.items()))
+
+        class KwBox:
+            def scale(self, x, *, factor=1):
+                return x * factor
+
+        def kw_calls(n, box):
+            out = []
+            for i in range(n):
+                out.append(kw_target(i, c=i + 1))
+                out.append(kw_target(a=i, b=-i, z=i * 2))
+                out.append(box.scale(i, factor=3))
+                out.append(sorted([3, 1, 2], reverse=True))
+            return out
+
+        def kw_gen(n):
+            for i in range(n):
+                yield kw_target(i, b=i, y=1)
+
+        jit_kw_calls = justjit.jit(kw_calls, mode="object", lazy=False)
+        check("kw call: positional + keyword", jit_kw_calls(3, KwBox()), kw_calls(3, KwBox()))
+        check("kw call: generator", list(justjit.jit(kw_gen, lazy=False)(3)), list(kw_gen(3)))
+
+        def kw_missing():
+            return kw_target(b=1)
+
+        try:
+            justjit.jit(kw_missing, mode="object", lazy=False)()
+            check("kw call: missing argument raises", False, True)
+        except TypeError:
+            check("kw call: missing argument raises", True, True)
+    except Exception as e:
+        print(f"  [FAIL] keyword call error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 68: *args/**kwargs forwarding through CALL_FUNCTION_EX
+    # =========================================================================
+    print("\n--- Test 68: Argument Forwarding ---")
+
+    try:
+        import collections
+
+        def fwd_inner(*args, **kwargs):
+            kwargs["seen"] = True
+            return args, sorted(kwargs.items())
+
+        def fwd_wrapper(*args, **kwargs):
+            return fwd_inner(*args, **kwargs)
+
+        def fwd_mapping(mapping):
+            return fwd_inner(1, **mapping)
+
+        jit_fwd = justjit.jit(fwd_wrapper, mode="object", lazy=False)
+        check("forward: positional only", jit_fwd(1, 2), fwd_wrapper(1, 2))
+        check("forward: keywords", jit_fwd(1, b=2), fwd_wrapper(1, b=2))
+        caller_kwargs = {"b": 2}
+        jit_fwd(**caller_kwargs)
+        check("forward: caller dict untouched", caller_kwargs, {"b": 2})
+        check("forward: tp_call callee", justjit.jit(lambda *a, **k: collections.OrderedDict(*a, **k),
+                                                     mode="object", lazy=False)(x=1), collections.OrderedDict(x=1))
+        jit_fwd_mapping = justjit.jit(fwd_mapping, mode="object", lazy=False)
+        check("forward: non-dict mapping", jit_fwd_mapping(collections.ChainMap({"c": 3})),
+              fwd_mapping(collections.ChainMap({"c": 3})))
+        try:
+            jit_fwd_mapping(5)
+            check("forward: non-mapping raises", False, True)
+        except TypeError:
+            check("forward: non-mapping raises", True, True)
+    except Exception as e:
+        print(f"  [FAIL] argument forwarding error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 69: inline builtins (len, abs, min, max, isinstance, int, float)
+    # =========================================================================
+    print("\n--- Test 69: Inline Builtins ---")
+
+    try:
+        import builtins
+
+        class IntSub(int):
+            pass
+
+        def use_builtins(items, mapping, x, y):
+            return (
+                len(items), len(mapping), len("abc"),
+                abs(x), abs(-3), abs(-2.5),
+                min(x, y), max(x, y), min(2, 7), max(2.0, float("nan")),
+                isinstance(x, int), isinstance(IntSub(1), int), isinstance(True, int), isinstance(x, str),
+                int(x), int(2.9), int("12"), float(x), float("1.5"),
+            )
+
+        jit_builtins = justjit.jit(use_builtins, mode="object", lazy=False)
+        for case in (([1, 2], {"a": 1}, -4, 3), ((1,), {}, 2.5, -1.0), ([], {1: 2, 3: 4}, 10 ** 20, 5)):
+            check(f"builtins: {case[2]!r}, {case[3]!r}", repr(jit_builtins(*case)), repr(use_builtins(*case)))
+        try:
+            jit_builtins([1], {}, "s", "t")
+            check("builtins: abs() TypeError", False, True)
+        except TypeError:
+            check("builtins: abs() TypeError", True, True)
+
+        def count_len(items):
+            return len(items)
+
+        jit_len = justjit.jit(count_len, mode="object", lazy=False)
+        check("builtins: len before rebinding", jit_len([1, 2, 3]), 3)
+        saved_len = builtins.len
+        builtins.len = lambda obj: -1
+        try:
+            check("builtins: rebound builtin is called", jit_len([1, 2, 3]), -1)
+        finally:
+            builtins.len = saved_len
+        check("builtins: restored builtin", jit_len([1, 2, 3]), 3)
+    except Exception as e:
+        print(f"  [FAIL] inline builtins error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 70: auto_jit compiles hot functions without decorators
+    # =========================================================================
+    print("\n--- Test 70: Auto-JIT ---")
+
+    try:
+        import time
+
+        demo_source = (
+            "def hot_sum(n):\n"
+            "    total = 0\n"
+            "    for i in range(n):\n"
+            "        total += i\n"
+            "    return total\n"
+            "class Shape:\n"
+            "    def area(self, w):\n"
+            "        return w * w\n"
+            "def make_adder(k):\n"
+            "    def add(x):\n"
+            "        return x + k\n"
+            "    return add\n"
+        )
+        demo = {"__name__": "auto_jit_demo"}
+        exec(compile(demo_source, "auto_jit_demo.py", "exec"), demo)
+        skipped = {"__name__": "auto_jit_denied"}
+        exec(compile("def cold(x):\n    return x * 2\n", "auto_jit_denied.py", "exec"), skipped)
+        originals = (demo["hot_sum"], demo["Shape"].__dict__["area"], skipped["cold"])
+
+        justjit.auto_jit(threshold=20, denylist=("auto_jit_denied",), mode="object")
+        try:
+            adder = demo["make_adder"](1)
+            deadline = time.time() + 30
+            while time.time() < deadline and (demo["hot_sum"] is originals[0] or demo["Shape"].__dict__["area"] is originals[1]):
+                check_value = demo["hot_sum"](10), demo["Shape"]().area(3), skipped["cold"](4), adder(1)
+                time.sleep(0.001)
+        finally:
+            compiled_names = justjit.auto_jit_disable()
+        check("auto_jit: hot function rebound", demo["hot_sum"] is not originals[0], True)
+        check("auto_jit: method rebound", demo["Shape"].__dict__["area"] is not originals[1], True)
+        check("auto_jit: results", (demo["hot_sum"](10), demo["Shape"]().area(3)), (45, 9))
+        check("auto_jit: denylisted module untouched", skipped["cold"] is originals[2], True)
+        check("auto_jit: report", sorted(compiled_names), ["auto_jit_demo.Shape.area", "auto_jit_demo.hot_sum"])
+        # max_bytecode_size= counts instructions as jit() does, not code units
+        hot_code = originals[0].__code__
+        size = justjit._bytecode_size(hot_code)
+        check("auto_jit: size budget fits exactly",
+              (justjit._AutoJIT(1, (), size, {}).eligible(hot_code, "auto_jit_demo"),
+               justjit._AutoJIT(1, (), size - 1, {}).eligible(hot_code, "auto_jit_demo")), (True, False))
+    except Exception as e:
+        print(f"  [FAIL] auto_jit error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 71: Arrow columns in ndarray kernels, nulls propagated by bitmap
+    # =========================================================================
+    print("\n--- Test 71: Arrow Columns ---")
+
+    try:
+        @justjit.jit(mode="ndarray")
+        def arrow_scale(prices, qty, out):
+            for i in range(len(prices)):
+                out[i] = prices[i] * qty[i]
+
+        prices = justjit.ArrowColumn("d", 130)
+        qty = justjit.ArrowColumn("d", 130)
+        for i in range(130):
+            prices[i] = None if i % 3 == 0 else float(i)
+            qty[i] = None if i % 5 == 0 else 2.0
+        expected = [None if i % 3 == 0 or i % 5 == 0 else i * 2.0 for i in range(130)]
+        result = arrow_scale(prices, qty)
+        check("arrow: output column allocated", type(result) is justjit.ArrowColumn, True)
+        check("arrow: values and nulls", result.to_pylist(), expected)
+        check("arrow: null count", result.null_count, expected.count(None))
+
+        # A column handed over through the C Data Interface is shared, read-only
+        imported = justjit.ArrowColumn.from_arrow(prices)
+        check("arrow: import keeps nulls", imported.to_pylist(), prices.to_pylist())
+        check("arrow: imported is read-only", imported.writable, False)
+        check("arrow: imported input", arrow_scale(imported, qty).to_pylist(), expected)
+
+        try:
+            import pyarrow as pa
+        except ImportError:
+            pa = None
+        if pa is not None:
+            left = pa.array([1.5, None, 3.0, 4.0])
+            right = pa.array([2.0, 4.0, None, 0.5])
+            check("arrow: pyarrow inputs", arrow_scale(left, right).to_pylist(), [3.0, None, None, 2.0])
+            check("arrow: sliced pyarrow input",
+                  arrow_scale(pa.array([9.0, 1.0, None, 2.0]).slice(1), pa.array([3.0, 3.0, 3.0])).to_pylist(),
+                  [3.0, None, 6.0])
+            check("arrow: exported to pyarrow", pa.array(result).null_count, result.null_count)
+    except Exception as e:
+        print(f"  [FAIL] arrow columns error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 72: __array_interface__ and DLPack arrays taken without copies
+    # =========================================================================
+    print("\n--- Test 72: Foreign Arrays ---")
+
+    try:
+        import array as _array_mod
+
+        class InterfaceArray:
+            """An array known only through __array_interface__ (no buffer protocol)."""
+            def __init__(self, values):
+                self.storage = _array_mod.array("d", values)
+            @property
+            def __array_interface__(self):
+                address, count = self.storage.buffer_info()
+                return {"shape": (count,), "typestr": "<f8", "data": (address, False), "version": 3}
+
+        class DeviceArray:
+            __cuda_array_interface__ = {"shape": (3,), "typestr": "<f8", "data": (0, False), "version": 3}
+            def __len__(self):
+                return 3
+            def __getitem__(self, i):
+                return 1.0
+
+        @justjit.jit(mode="ndarray")
+        def foreign_double(src, out):
+            for i in range(len(src)):
+                out[i] = src[i] * 2.0
+
+        src = InterfaceArray([1.0, 2.5, -4.0])
+        out = InterfaceArray([0.0, 0.0, 0.0])
+        foreign_double(src, out)
+        check("foreign: array interface in and out", list(out.storage), [2.0, 5.0, -8.0])
+        check("foreign: zeros_like of an interface array", list(foreign_double(src)), [2.0, 5.0, -8.0])
+        check("foreign: shared memory", memoryview(justjit._core.foreign_array(src))[1], 2.5)
+        try:
+            justjit._core.foreign_array(DeviceArray())
+            check("foreign: device array refused", "accepted", "TypeError")
+        except TypeError:
+            check("foreign: device array refused", "TypeError", "TypeError")
+        check("foreign: not an array", justjit._core.foreign_array(object()), None)
+
+        try:
+            import numpy as np
+        except ImportError:
+            np = None
+        if np is not None and hasattr(np.ndarray, "__dlpack__"):
+            class DLPackOnly:
+                """An array known only through DLPack."""
+                def __init__(self, a):
+                    self.a = a
+                def __dlpack__(self, stream=None):
+                    return self.a.__dlpack__()
+                def __dlpack_device__(self):
+                    return self.a.__dlpack_device__()
+            backing = np.arange(6, dtype=np.float64)
+            dl_out = np.zeros(6)
+            foreign_double(DLPackOnly(backing), dl_out)
+            check("foreign: dlpack input", dl_out.tolist(), [0.0, 2.0, 4.0, 6.0, 8.0, 10.0])
+            strided = np.arange(12, dtype=np.float64)[::2]
+            foreign_double(DLPackOnly(strided), dl_out)
+            check("foreign: strided dlpack input", dl_out.tolist(), (strided * 2).tolist())
+
+        try:
+            import torch
+        except ImportError:
+            torch = None
+        if torch is not None:
+            t_in = torch.arange(4, dtype=torch.float64)
+            t_out = torch.zeros(4, dtype=torch.float64)
+            foreign_double(t_in, t_out)
+            check("foreign: torch tensors in place", t_out.tolist(), [0.0, 2.0, 4.0, 6.0])
+    except Exception as e:
+        print(f"  [FAIL] foreign arrays error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 73: lists and tuples of floats/ints as ndarray arguments
+    # =========================================================================
+    print("\n--- Test 73: Unboxed Lists ---")
+
+    try:
+        @justjit.jit(mode="ndarray")
+        def list_dot(xs, ys):
+            total = 0.0
+            for i in range(len(xs)):
+                total += xs[i] * ys[i]
+            return total
+
+        @justjit.jit(mode="ndarray")
+        def list_sum_ints(xs):
+            total = 0
+            for i in range(len(xs)):
+                total += xs[i]
+            return total
+
+        @justjit.jit(mode="ndarray")
+        def list_scale(xs, out):
+            for i in range(len(xs)):
+                out[i] = xs[i] * 3.0
+
+        @justjit.jit(mode="ndarray")
+        def list_fill(xs):
+            for i in range(len(xs)):
+                xs[i] = 1.0
+
+        check("lists: float lists", list_dot([1.0, 2.0, 3.0], [4.0, 5.0, 6.0]), 32.0)
+        check("lists: tuple and list", list_dot((0.5, 0.25), [2.0, 4.0]), 2.0)
+        check("lists: int list", list_sum_ints([1, 2, 3, 2**40]), 6 + 2**40)
+        check("lists: same specialization reused", list_dot([2.0], [3.0]), 6.0)
+        check("lists: mixed items run as Python", list_dot([1, 2.0], [1.0, 1.0]), 3.0)
+        check("lists: int64 overflow runs as Python", list_sum_ints([2**70, 1]), 2**70 + 1)
+        check("lists: output allocated from a list", list(list_scale([1.0, 2.0])), [3.0, 6.0])
+        filled = [0.0, 0.0]
+        list_fill(filled)
+        check("lists: stores into a list run as Python", filled, [1.0, 1.0])
+    except Exception as e:
+        print(f"  [FAIL] unboxed lists error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 74: array results from the pooled, aligned buffer pool
+    # =========================================================================
+    print("\n--- Test 74: Pooled Results ---")
+
+    try:
+        @justjit.jit(mode="ndarray")
+        def pooled_square(xs, out):
+            for i in range(len(xs)):
+                out[i] = xs[i] * xs[i]
+
+        source = memoryview(bytearray(8 * 1000)).cast("d")
+        for i in range(1000):
+            source[i] = float(i)
+        first = pooled_square(source)
+        check("pool: memoryview result", (type(first), first[999], first.readonly), (memoryview, 998001.0, False))
+        check("pool: zeroed", justjit.zeros_like(source)[10], 0.0)
+        first.release()
+        del first
+        before = justjit.buffer_pool_stats()
+        for _ in range(5):
+            pooled_square(source).release()
+        after = justjit.buffer_pool_stats()
+        check("pool: steady state reuses memory", after["reused"] - before["reused"], 5)
+        check("pool: 2-D shape", justjit.empty_like(memoryview(bytearray(48)).cast("d", (2, 3))).shape, (2, 3))
+        try:
+            import numpy as np
+        except ImportError:
+            np = None
+        if np is not None:
+            arr = np.arange(256, dtype=np.float64)
+            result = pooled_square(arr)
+            check("pool: numpy result", (type(result) is np.ndarray, result[15], result.ctypes.data % 64),
+                  (True, 225.0, 0))
+            check("pool: numpy zeros_like dtype", justjit.zeros_like(arr.reshape(16, 16), dtype="f").dtype,
+                  np.dtype(np.float32))
+    except Exception as e:
+        print(f"  [FAIL] pooled results error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 75: target='cuda' batch calls, on a GPU when one is usable
+    # =========================================================================
+    print("\n--- Test 75: CUDA Batch Calls ---")
+
+    try:
+        import array as array_module
+
+        try:
+            justjit.jit(lambda x: x, target="gpu")
+            check("cuda: bad target rejected", False, True)
+        except ValueError:
+            check("cuda: bad target rejected", True, True)
+
+        @justjit.jit(mode="float", target="cuda", lazy=False)
+        def cuda_axpy(a, x, y):
+            return a * x + y
+
+        @justjit.jit(mode="float", target="cuda", lazy=False)
+        def cuda_add(a, b):
+            return a + b
+
+        small = array_module.array("d", [1.0, 2.0, 3.0])
+        check("cuda: small map on the host", list(cuda_axpy.map(2.0, small, small)), [3.0, 6.0, 9.0])
+        large = array_module.array("d", range(70000))
+        mapped = cuda_axpy.map(2.0, large, 1.0)
+        check("cuda: large map", (len(mapped), mapped[0], mapped[69999]), (70000, 1.0, 139999.0))
+        check("cuda: large reduce", cuda_add.reduce(large, initial=1.0), 1.0 + 69999 * 70000 / 2)
+
+        if justjit.cuda_available():
+            on_device = justjit.to_device(large)
+            result = cuda_axpy.map(2.0, on_device, on_device)
+            check("cuda: device result", (type(result).__name__, len(result), result.copy_to_host()[10]),
+                  ("DeviceArray", 70000, 30.0))
+            check("cuda: device reduce", cuda_add.reduce(on_device), 69999 * 70000 / 2)
+        else:
+            class FakeDeviceArray:
+                __cuda_array_interface__ = {"shape": (4,), "typestr": "<f8", "data": (0, False), "version": 3}
+
+            try:
+                cuda_add.map(FakeDeviceArray(), 1.0)
+                check("cuda: device operand without a device", False, True)
+            except RuntimeError:
+                check("cuda: device operand without a device", True, True)
+            print("  [SKIP] no usable CUDA device")
+    except Exception as e:
+        print(f"  [FAIL] cuda batch error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 76: NUMA placement of the parallel pool
+    # =========================================================================
+    print("\n--- Test 76: NUMA Topology ---")
+
+    try:
+        import array as array_module
+        import os
+
+        threads = justjit._core.parallel_threads()
+        nodes = justjit._core.numa_topology()
+        check("numa: nodes are non-empty CPU lists", bool(nodes) and all(node and all(isinstance(cpu, int) for cpu in node)
+                                                                       for node in nodes), True)
+        cpus = [cpu for node in nodes for cpu in node]
+        check("numa: nodes do not share CPUs", len(cpus), len(set(cpus)))
+        if "JUSTJIT_NUM_THREADS" not in os.environ:
+            check("numa: one thread per CPU", threads, len(cpus))
+
+        try:
+            justjit._core.set_numa_topology([[0]])
+            check("numa: topology fixed once the pool runs", False, True)
+        except RuntimeError:
+            check("numa: topology fixed once the pool runs", True, True)
+
+        @jit(mode='float', parallel=True)
+        def numa_scale(x):
+            return x * 3.0
+
+        @jit(mode='int', parallel=True)
+        def numa_add(a, b):
+            return a + b
+
+        data = array_module.array('d', range(200003))
+        scaled = numa_scale.map(data)
+        check("numa: parallel map over node shares", (scaled[0], scaled[100001], scaled[200002]),
+              (0.0, 300003.0, 600006.0))
+        ints = array_module.array('q', range(200003))
+        check("numa: parallel reduce over node shares", numa_add.reduce(ints), 200002 * 200003 // 2)
+    except Exception as e:
+        print(f"  [FAIL] numa topology error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 77: uint64 mode for hashing kernels
+    # =========================================================================
+    print("\n--- Test 77: uint64 Mode ---")
+
+    try:
+        import array as array_module
+
+        def mix_py(h, x):
+            h ^= x
+            h = (h * 0x9E3779B97F4A7C15) & 0xFFFFFFFFFFFFFFFF
+            return (h << 31 | h >> 33) & 0xFFFFFFFFFFFFFFFF
+
+        def fnv_py(n):
+            h = 0xCBF29CE484222325
+            for i in range(n):
+                h = ((h ^ (i & 0xFF)) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+            return h
+
+        def mulhi_py(a, b):
+            return (a * b) >> 64
+
+        def above_py(a, b):
+            if a > b:
+                return 1
+            return 0
+
+        def udiv_py(a, b):
+            return a // b % 1000003
+
+        u_mix = jit(mode='uint64', lazy=False)(mix_py)
+        u_fnv = jit(mode='uint64', lazy=False)(fnv_py)
+        u_mulhi = jit(mode='uint64', lazy=False)(mulhi_py)
+        u_above = jit(mode='uint64', lazy=False)(above_py)
+        u_udiv = jit(mode='uint64', lazy=False)(udiv_py)
+        top = 2**64 - 1
+        check("uint64: mix with masks", [u_mix(h, x) for h, x in ((1, 2), (top, 5), (2**63, top))],
+              [mix_py(h, x) for h, x in ((1, 2), (top, 5), (2**63, top))])
+        check("uint64: fnv-1a loop", u_fnv(1000), fnv_py(1000))
+        check("uint64: 128-bit product high word", (u_mulhi(top, top), u_mulhi(2**32, 2**32)), (top - 1, 1))
+        check("uint64: unsigned compare", (u_above(2**63, 1), u_above(1, 2**63)), (1, 0))
+        check("uint64: unsigned division", u_udiv(top, 3), udiv_py(top, 3))
+        check("uint64: negative argument runs in the interpreter", u_mix(-1, 3), mix_py(-1, 3))
+        try:
+            u_udiv(1, 0)
+            check("uint64: division by zero raises", False, True)
+        except ZeroDivisionError:
+            check("uint64: division by zero raises", True, True)
+
+        # Interpreted calls must see the wrapped values too: unmasked ones
+        # fail the compile, and % 2**64 masks like & does
+        def unmasked_py(a, b):
+            return a * b + 1
+
+        try:
+            jit(mode='uint64', lazy=False)(unmasked_py)
+            check("uint64: unmasked result rejected", False, True)
+        except TypeError as e:
+            check("uint64: unmasked result rejected", "line" in str(e), True)
+
+        def hash_py(a, b):
+            return (a * 0x9E3779B97F4A7C15 ^ b << 17) % 2**64
+
+        u_hash = jit(mode='uint64', background=True)(hash_py)
+        interpreted = u_hash(top, 12345)
+        justjit._get_compile_executor().submit(lambda: None).result()
+        compiled = u_hash(top, 12345)
+        counts = justjit.counters(u_hash)
+        check("uint64: same call interpreted and native",
+              (interpreted, compiled, counts["fallback_pending"], counts["native_calls"]),
+              (hash_py(top, 12345), hash_py(top, 12345), 1, 1))
+
+        def xor_py(a, b):
+            return a ^ b
+
+        u_xor = jit(mode='uint64', lazy=False)(xor_py)
+        words = array_module.array('Q', [top, 2**63, 12345, 0])
+        mapped = u_mix.map(words, 7)
+        check("uint64: map over a 'Q' buffer", (mapped.typecode, list(mapped)), ('Q', [mix_py(w, 7) for w in words]))
+        check("uint64: reduce over a 'Q' buffer", u_xor.reduce(words), top ^ 2**63 ^ 12345)
+    except Exception as e:
+        print(f"  [FAIL] uint64 mode error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 78: Bit-manipulation intrinsics in int modes
+    # =========================================================================
+    print("\n--- Test 78: Bit Manipulation ---")
+
+    try:
+        global rotl, rotr
+        from justjit import rotl, rotr
+
+        @jit(mode='uint64')
+        def bits_rank(word, i):
+            return (word & ((1 << i) - 1)).bit_count()
+
+        @jit(mode='uint64')
+        def bits_length(word):
+            return word.bit_length()
+
+        @jit(mode='int')
+        def bits_lowest(word):
+            return (word & -word).bit_length() - 1
+
+        @jit(mode='int')
+        def bits_signed(x):
+            return x.bit_count() * 100 + x.bit_length()
+
+        @jit(mode='uint64')
+        def bits_rotate(x, r):
+            return rotl(x, r) ^ rotr(x, r + 1)
+
+        @jit(mode='int')
+        def bits_rot32(x, r):
+            return rotl(x, r, 32)
+
+        @jit(mode='int')
+        def bits_rot64(x, r):
+            return rotr(x, r)
+
+        @jit(mode='int32')
+        def bits_int32(x, y):
+            return rotl(x & y, 4, 32).bit_count() + (x ^ y).bit_length()
+
+        top = 2**64 - 1
+        check("bits: bit_count rank", [bits_rank(top, i) for i in (0, 1, 63)], [0, 1, 63])
+        check("bits: bit_length", [bits_length(w) for w in (0, 1, 2**63, top)], [0, 1, 64, 64])
+        check("bits: lowest set bit", [bits_lowest(w) for w in (0, 1, 8, -2**63, 12)], [-1, 0, 3, 63, 2])
+        check("bits: negative bit_count/bit_length", [bits_signed(x) for x in (-1, -6, -2**63)],
+              [101, 203, 164])
+        check("bits: 64-bit rotates", [bits_rotate(x, r) for x, r in ((1, 63), (2**63 + 5, 3), (top, 17))],
+              [rotl(x, r) ^ rotr(x, r + 1) for x, r in ((1, 63), (2**63 + 5, 3), (top, 17))])
+        check("bits: 32-bit rotate in int mode", (bits_rot32(0x80000001, 1), bits_rot32(-1, 5)), (3, 0xFFFFFFFF))
+        check("bits: int-mode rotate past int64 runs in the interpreter", (bits_rot64(2, 1), bits_rot64(1, 1)),
+              (1, 2**63))
+        check("bits: int32 bitwise and rotate", bits_int32(0x0F, 0x3C), rotl(0x0F & 0x3C, 4, 32).bit_count() + 6)
+    except Exception as e:
+        print(f"  [FAIL] bit manipulation error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 79: float16 / bfloat16 array items
+    # =========================================================================
+    print("\n--- Test 79: Half-Precision Arrays ---")
+
+    try:
+        import struct as struct_module
+        import array as array_module
+
+        @jit(mode='ndarray')
+        def half_dot(a, b):
+            t = 0.0
+            for i in range(a.shape[0]):
+                t += a[i] * b[i]
+            return t
+
+        @jit(mode='ndarray')
+        def half_scale(src, dst, k):
+            for i in range(src.shape[0]):
+                dst[i] = src[i] * k
+
+        def to_half(x):
+            return struct_module.unpack("e", struct_module.pack("e", x))[0]
+
+        values = [1.5, -2.0, 0.1, 3.0, 1000.1, 6.0e-08]
+        halves = memoryview(bytearray(struct_module.pack(f"{len(values)}e", *values))).cast('e')
+        ones = memoryview(bytearray(struct_module.pack(f"{len(values)}e", *[1.0] * len(values)))).cast('e')
+        expected = 0.0
+        for v in halves.tolist():
+            expected += v
+        check("half: float16 dot", half_dot(halves, ones), expected)
+        out = memoryview(bytearray(2 * len(values))).cast('e')
+        half_scale(halves, out, 3.0)
+        check("half: float16 stores round to nearest even", out.tolist(), [to_half(v * 3.0) for v in halves.tolist()])
+        compiled = [k for k, entry in half_dot._ndarray_specializations.items() if entry is not None]
+        check("half: float16 specialization compiled", len(compiled), 1)
+
+        def bf16_bits(x):
+            return struct_module.unpack("I", struct_module.pack("f", x))[0] >> 16
+
+        bf_values = [1.0, -2.5, 0.15625, 1024.0]
+        bf_a = justjit.bfloat16_view(array_module.array('H', [bf16_bits(v) for v in bf_values]))
+        bf_b = justjit.bfloat16_view(array_module.array('H', [bf16_bits(2.0)] * len(bf_values)))
+        check("half: bfloat16 view format", memoryview(bf_a).format, 'E')
+        check("half: bfloat16 dot", half_dot(bf_a, bf_b), 2.0 * sum(bf_values))
+        bf_out = array_module.array('H', [0] * len(bf_values))
+        half_scale(bf_a, justjit.bfloat16_view(bf_out), 0.5)
+        check("half: bfloat16 stores", list(bf_out), [bf16_bits(v * 0.5) for v in bf_values])
+    except Exception as e:
+        print(f"  [FAIL] half-precision arrays error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 80: a @ b in ndarray mode
+    # =========================================================================
+    print("\n--- Test 80: Matmul ---")
+
+    try:
+        import struct as struct_module
+
+        def matrix(fmt, rows, cols, values):
+            data = bytearray(struct_module.pack(f"{rows * cols}{fmt}", *values))
+            return memoryview(data).cast(fmt, shape=[rows, cols]) if cols else memoryview(data).cast(fmt)
+
+        def reference(a, b, n, k, m):
+            return [[sum(a[i * k + p] * b[p * m + j] for p in range(k)) for j in range(m)] for i in range(n)]
+
+        @jit(mode='ndarray')
+        def mm_slice(a, b, out):
+            out[:] = a @ b
+
+        @jit(mode='ndarray')
+        def mm_ellipsis(a, b, out):
+            out[...] = a @ b
+
+        @jit(mode='ndarray')
+        def mm_dot(x, y):
+            return x @ y
+
+        n, k, m = 5, 3, 7
+        a_values = [float(i % 7) - 2.5 for i in range(n * k)]
+        b_values = [0.5 * (i % 5) - 1.0 for i in range(k * m)]
+        out = matrix('d', n, m, [0.0] * (n * m))
+        mm_slice(matrix('d', n, k, a_values), matrix('d', k, m, b_values), out)
+        check("matmul: float64 tiles and tails", out.tolist(), reference(a_values, b_values, n, k, m))
+
+        ints_a = [i - 6 for i in range(n * k)]
+        ints_b = [3 * i - 10 for i in range(k * m)]
+        int_out = matrix('q', n, m, [0] * (n * m))
+        mm_ellipsis(matrix('q', n, k, ints_a), matrix('q', k, m, ints_b), int_out)
+        check("matmul: int64 out[...]", int_out.tolist(), reference(ints_a, ints_b, n, k, m))
+
+        vec = [1.0, -2.0, 0.25]
+        mv_out = matrix('d', n, 0, [0.0] * n)
+        mm_slice(matrix('d', n, k, a_values), matrix('d', k, 0, vec), mv_out)
+        check("matmul: matrix @ vector", mv_out.tolist(), [row[0] for row in reference(a_values, vec, n, k, 1)])
+
+        check("matmul: 1-D dot", mm_dot(matrix('d', 4, 0, [1.0, 2.0, 3.0, 4.0]), matrix('d', 4, 0, [0.5] * 4)), 5.0)
+
+        try:
+            import numpy as np
+            left = np.arange(6.0).reshape(2, 3)
+            try:
+                mm_slice(left, np.ones((2, 2)), np.zeros((2, 2)))
+                check("matmul: mismatched shapes raise", False, True)
+            except ValueError:
+                check("matmul: mismatched shapes raise", True, True)
+            square = np.arange(9.0).reshape(3, 3)
+            expected = square @ square
+            mm_slice(square, square, square)
+            check("matmul: out aliasing an operand", square.tolist(), expected.tolist())
+        except ImportError:
+            print("  [SKIP] numpy not available")
+    except Exception as e:
+        print(f"  [FAIL] matmul error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 81: Native exceptions from typed modes
+    # =========================================================================
+    print("\n--- Test 81: Native Exceptions ---")
+    try:
+        import array as array_module
+
+        def raises_zero(fn, *args):
+            try:
+                fn(*args)
+            except ZeroDivisionError as e:
+                return str(e)
+            return None
+
+        def idiv_py(a, b):
+            return a // b
+
+        def imod_py(a, b):
+            return a % b
+
+        def fdiv_py(a, b):
+            return a / b
+
+        def ffloor_py(a, b):
+            return a // b
+
+        i_div = jit(mode='int', lazy=False)(idiv_py)
+        i_mod = jit(mode='int', lazy=False)(imod_py)
+        i_fast = jit(mode='int', checked=False, lazy=False)(idiv_py)
+        i32_div = jit(mode='int32', lazy=False)(idiv_py)
+        f_div = jit(mode='float', lazy=False)(fdiv_py)
+        f_floor = jit(mode='float', lazy=False)(ffloor_py)
+        u_div = jit(mode='uint64', lazy=False)(idiv_py)
+        check("native: int // 0", raises_zero(i_div, 7, 0), "integer division or modulo by zero")
+        check("native: int % 0", raises_zero(i_mod, 7, 0), "integer modulo by zero")
+        check("native: unchecked int // 0", raises_zero(i_fast, 7, 0), "integer division or modulo by zero")
+        check("native: int32 // 0", raises_zero(i32_div, 7, 0), "integer division or modulo by zero")
+        check("native: int32 // -1", i32_div(-7, -1), 7)
+        check("native: float / 0.0", raises_zero(f_div, 1.0, 0.0), "division by zero")
+        check("native: float // 0.0", raises_zero(f_floor, 1.0, 0.0), "float floor division by zero")
+        check("native: int division still exact", (i_div(7, 2), i_mod(7, 3), f_div(1.0, 4.0)), (3, 1, 0.25))
+        values = array_module.array('Q', [4, 6, 8])
+        divisors = array_module.array('Q', [2, 0, 4])
+        try:
+            list(u_div.map(values, divisors))
+            check("native: uint64 map by zero raises", False, True)
+        except ZeroDivisionError:
+            check("native: uint64 map by zero raises", True, True)
+        check("native: uint64 map", list(u_div.map(values, array_module.array('Q', [2, 3, 4]))), [2, 2, 2])
+    except Exception as e:
+        print(f"  [FAIL] native exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 82: yield from delegation between JIT generators
+    # =========================================================================
+    print("\n--- Test 82: Yield From Delegation ---")
+    try:
+        class Node:
+            def __init__(self, value, left=None, right=None):
+                self.value = value
+                self.left = left
+                self.right = right
+
+        def build(lo, hi):
+            if lo >= hi:
+                return None
+            mid = (lo + hi) // 2
+            return Node(mid, build(lo, mid), build(mid + 1, hi))
+
+        @jit
+        def walk(node):
+            if node is not None:
+                yield from walk(node.left)
+                yield node.value
+                yield from walk(node.right)
+
+        @jit
+        def counted(n):
+            for i in range(n):
+                yield i
+            return n * 10
+
+        @jit
+        def outer(n):
+            total = yield from counted(n)
+            yield total
+
+        @jit
+        def echo():
+            while True:
+                got = yield
+                if got is None:
+                    return "done"
+                yield got * 2
+
+        @jit
+        def relay():
+            result = yield from echo()
+            yield result
+
+        @jit
+        def failing():
+            yield 1
+            raise ValueError("sub failed")
+
+        @jit
+        def wraps_failing():
+            yield from failing()
+            yield 2
+
+        tree = build(0, 200)
+        check("yield from: recursive tree walk", list(walk(tree)), list(range(200)))
+        walker = walk(tree)
+        check("yield from: next() then list()", [next(walker), next(walker)] + list(walker), list(range(200)))
+        check("yield from: sub-generator return value", list(outer(4)), [0, 1, 2, 3, 40])
+        r = relay()
+        next(r)
+        check("yield from: send() reaches the delegate", r.send(21), 42)
+        next(r)
+        check("yield from: delegate return after send()", r.send(None), "done")
+        try:
+            list(wraps_failing())
+            check("yield from: delegate error propagates", False, True)
+        except ValueError as e:
+            check("yield from: delegate error propagates", str(e), "sub failed")
+        w = walk(tree)
+        next(w)
+        w.close()
+        check("yield from: close() of a delegating generator", list(w), [])
+    except Exception as e:
+        print(f"  [FAIL] yield from error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 83: IMPORT_NAME site caches
+    # =========================================================================
+    print("\n--- Test 83: Import Caches ---")
+    try:
+        import sys as sys_module
+        import types as types_module
+        import os as os_module
+
+        @jit
+        def lazy_dumps(x):
+            import json
+            return json.dumps(x)
+
+        @jit
+        def lazy_join(a, b):
+            from os import path
+            return path.join(a, b)
+
+        @jit
+        def dotted():
+            import os.path
+            return os
+
+        @jit
+        def swapped():
+            import justjit_ci_swapped
+            return justjit_ci_swapped.tag
+
+        check("import: cached module", [lazy_dumps([i]) for i in range(3)], ["[0]", "[1]", "[2]"])
+        check("import: from-import", lazy_join("a", "b"), os_module.path.join("a", "b"))
+        check("import: dotted import returns the package", dotted() is os_module, True)
+        first = types_module.ModuleType("justjit_ci_swapped")
+        first.tag = "first"
+        second = types_module.ModuleType("justjit_ci_swapped")
+        second.tag = "second"
+        sys_module.modules["justjit_ci_swapped"] = first
+        check("import: fake module", (swapped(), swapped()), ("first", "first"))
+        sys_module.modules["justjit_ci_swapped"] = second
+        check("import: sys.modules change invalidates", swapped(), "second")
+        del sys_module.modules["justjit_ci_swapped"]
+        try:
+            swapped()
+            check("import: removed module raises", False, True)
+        except ImportError:
+            check("import: removed module raises", True, True)
+    except Exception as e:
+        print(f"  [FAIL] import cache error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 84: typed code loaded from the object cache raising
+    # =========================================================================
+    print("\n--- Test 84: Cached Code Exceptions ---")
+    try:
+        # Typed code loaded from the object cache raises like freshly built code
+        def cached_div(a, b):
+            return a // b
+
+        cached_instrs = [{"opcode": i.opcode, "arg": i.arg or 0, "argval": 0, "offset": i.offset}
+                         for i in dis.get_instructions(cached_div)]
+        justjit.clear_stats()
+        cached_calls = []
+        for _ in range(2):
+            core = justjit.JIT()
+            core.compile_int(cached_instrs, list(cached_div.__code__.co_consts), "cached_div", 2, 2)
+            cached_calls.append(core.get_native_function("cached_div", 2, "int", None))
+        check("cached exc: second compile cached",
+              [r["cached"] for r in justjit.stats() if r["name"] == "cached_div"], [False, True])
+        check("cached exc: cached code raises", [raised(f, 1, 0) for f in cached_calls], ["ZeroDivisionError"] * 2)
+    except Exception as e:
+        print(f"  [FAIL] cached code exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 85: methods rebound on the class after compile
+    # =========================================================================
+    print("\n--- Test 85: Method Rebinding ---")
+    try:
+        class Meter:
+            def __init__(self, base):
+                self.base = base
+
+            @jit(mode='object', lazy=False)
+            def read(self, x):
+                return self.base + x
+
+        @jit(mode='object')
+        def call_read(m, x):
+            return m.read(x)
+
+        meter = Meter(10)
+        check("method: native entry binds", (meter.read(1), call_read(meter, 2)), (11, 12))
+        bound = meter.read
+        check("method: bound method object", (bound(3), bound.__self__ is meter), (13, True))
+
+        # Rebinding the class attribute after the call site is warm
+        def scaled_read(self, x):
+            return self.base * x
+
+        Meter.read = jit(mode='object', lazy=False)(scaled_read)
+        check("method: rebound to another entry", call_read(meter, 3), 30)
+        Meter.read = lambda self, x: -x
+        check("method: rebound to a plain function", call_read(meter, 3), -3)
+        check("method: old bound method unchanged", bound(3), 13)
+
+        # An instance attribute shadows the method
+        meter.read = lambda x: x * 100
+        check("method: instance attribute shadows", call_read(meter, 2), 200)
+        del meter.read
+        del Meter.read
+        check("method: removed method raises", raised(call_read, meter, 1), "AttributeError")
+    except Exception as e:
+        print(f"  [FAIL] method rebinding error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 86: object-mode and generator code reloaded from the object cache
+    # =========================================================================
+    print("\n--- Test 86: Object Mode Cache Reload ---")
+    try:
+        import json
+        import os
+        import subprocess
+        import tempfile
+
+        # Each run is a fresh process: None, the constants, the closure cell
+        # and the site caches all live at other addresses in the second one
+        reload_src = (
+            "import json, sys\n"
+            "import justjit\n"
+            "justjit.set_cache_dir(sys.argv[1])\n"
+            "scale = 3\n"
+            "def make(offset):\n"
+            "    @justjit.jit(mode='object', lazy=False)\n"
+            "    def reloaded(xs):\n"
+            "        total = 0\n"
+            "        for x in xs:\n"
+            "            if x is None:\n"
+            "                continue\n"
+            "            total += len(str(x)) * scale + offset\n"
+            "        return [total, None, True]\n"
+            "    return reloaded\n"
+            "@justjit.jit(lazy=False)\n"
+            "def reloaded_gen(n):\n"
+            "    for i in range(n):\n"
+            "        yield str(i) + '!'\n"
+            "f = make(5)\n"
+            "result = [f([1, None, 22, 'abc']), f([]), list(reloaded_gen(3))]\n"
+            "cached = [r['cached'] for r in justjit.stats() if r['mode'] in ('object', 'generator')]\n"
+            "print(json.dumps({'result': result, 'cached': cached}))\n"
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            script = os.path.join(tmp, "reload_object.py")
+            with open(script, "w") as f:
+                f.write(reload_src)
+            env = dict(os.environ, PYTHONPATH=os.pathsep.join(p for p in sys.path if p))
+            runs = []
+            for _ in range(2):
+                out = subprocess.run([sys.executable, script, os.path.join(tmp, "cache")], env=env,
+                                     capture_output=True, text=True, check=True).stdout
+                runs.append(json.loads(out.strip().splitlines()[-1]))
+        expected = [[33, None, True], [0, None, True], ["0!", "1!", "2!"]]
+        check("object cache: both runs agree", [r["result"] for r in runs], [expected, expected])
+        check("object cache: first run not cached", any(runs[0]["cached"]), False)
+        check("object cache: second run reloads object and generator code",
+              (len(runs[1]["cached"]) >= 2, all(runs[1]["cached"])), (True, True))
+    except Exception as e:
+        print(f"  [FAIL] object cache reload error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 87: a lazy stub whose first call raises
+    # =========================================================================
+    print("\n--- Test 87: Lazy Stub Exceptions ---")
+    try:
+        # The first call compiles behind the stub; when it raises, the
+        # compiled code stays installed and keeps working
+        @jit(mode='object', lazy=True)
+        def lazy_div(a, b):
+            return a // b
+
+        check("lazy exc: first call raises", raised(lazy_div, 1, 0), "ZeroDivisionError")
+        check("lazy exc: after", lazy_div(7, 2), 3)
+    except Exception as e:
+        print(f"  [FAIL] lazy stub exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 88: code built for another CPU raising
+    # =========================================================================
+    print("\n--- Test 88: Target CPU Exceptions ---")
+    try:
+        # Code built for a generic CPU with no extra features raises like
+        # code built for the host
+        @jit(mode='int', target_cpu="generic", target_features="", lazy=False)
+        def targeted_div(a, b):
+            return a // b
+
+        check("target exc: generic CPU raises", raised(targeted_div, 1, 0), "ZeroDivisionError")
+        check("target exc: generic CPU after", targeted_div(7, 2), 3)
+    except Exception as e:
+        print(f"  [FAIL] target CPU exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 89: pipeline flags and error paths
+    # =========================================================================
+    print("\n--- Test 89: Tuned Pipeline Exceptions ---")
+    try:
+        # vectorize=, inline= and unroll= tune the pipeline without
+        # changing error paths
+        @jit(mode='int', vectorize=False, inline=False, unroll=4, lazy=False)
+        def tuned_div(a, b):
+            return a // b
+
+        check("pipeline exc: tuned pipeline raises", raised(tuned_div, 1, 0), "ZeroDivisionError")
+        check("pipeline exc: tuned pipeline after", tuned_div(7, 2), 3)
+    except Exception as e:
+        print(f"  [FAIL] tuned pipeline exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 90: exceptions through vectorcall CALL
+    # =========================================================================
+    print("\n--- Test 90: Vectorcall Exceptions ---")
+    try:
+        # The callee's exception reaches an except in the body, and one the
+        # body does not catch leaves the function
+        def explode(x):
+            raise KeyError(x)
+
+        @jit(mode='object')
+        def call_caught(f, x):
+            try:
+                return f(x)
+            except KeyError:
+                return -1
+
+        check("vectorcall exc: callee caught", call_caught(explode, 3), -1)
+        check("vectorcall exc: callee raises", raised(call_caught, int, "x"), "ValueError")
+    except Exception as e:
+        print(f"  [FAIL] vectorcall exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 91: LOAD_GLOBAL cache invalidated by a deletion
+    # =========================================================================
+    print("\n--- Test 91: Global Cache Exceptions ---")
+    try:
+        # A global deleted after the cache is warm raises instead of
+        # returning the cached value
+        namespace = {"jit": jit}
+        exec(
+            "factor = 2\n"
+            "@jit(mode='object')\n"
+            "def scaled(x):\n"
+            "    return x * factor\n",
+            namespace,
+        )
+        check("global cache exc: warm", [namespace["scaled"](i) for i in range(3)], [0, 2, 4])
+        del namespace["factor"]
+        check("global cache exc: deleted global", raised(namespace["scaled"], 1), "NameError")
+    except Exception as e:
+        print(f"  [FAIL] global cache exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 92: LOAD_ATTR cache invalidated by a deletion
+    # =========================================================================
+    print("\n--- Test 92: Attribute Cache Exceptions ---")
+    try:
+        # An attribute deleted after the cache is warm raises instead of
+        # returning the cached value
+        import types as types_module
+
+        knobs = types_module.ModuleType("knobs")
+        knobs.scale = 3
+        namespace = {"knobs": knobs, "jit": jit}
+        exec(
+            "@jit(mode='object')\n"
+            "def knob(x):\n"
+            "    return x * knobs.scale\n",
+            namespace,
+        )
+        check("attr cache exc: warm", [namespace["knob"](i) for i in range(3)], [0, 3, 6])
+        del knobs.scale
+        check("attr cache exc: deleted attribute", raised(namespace["knob"], 1), "AttributeError")
+    except Exception as e:
+        print(f"  [FAIL] attribute cache exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 93: guarded int/float BINARY_OP raising
+    # =========================================================================
+    print("\n--- Test 93: Guarded Binary Op Exceptions ---")
+    try:
+        # The guarded int and float paths raise the interpreter's errors
+        @jit(mode='object')
+        def divide(a, b):
+            return a / b
+
+        @jit(mode='object')
+        def floor_mod(a, b):
+            return a % b
+
+        check("binary op exc: int / 0", raised(divide, 1, 0), "ZeroDivisionError")
+        check("binary op exc: float / 0.0", raised(divide, 1.0, 0.0), "ZeroDivisionError")
+        check("binary op exc: int % 0", raised(floor_mod, 5, 0), "ZeroDivisionError")
+        check("binary op exc: still exact", (divide(1, 4), floor_mod(-7, 3)), (0.25, 2))
+    except Exception as e:
+        print(f"  [FAIL] guarded binary op exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 94: an unboxed loop-carried local when the loop raises
+    # =========================================================================
+    print("\n--- Test 94: Unboxed Local Exceptions ---")
+    try:
+        # The unboxed float accumulator survives a raise mid-loop
+        @jit(mode='object')
+        def accumulate(values):
+            total = 0.0
+            for v in values:
+                total += 1.0 / v
+            return total
+
+        check("unboxed exc: accumulator loop raises", raised(accumulate, [1.0, 2.0, 0.0, 4.0]), "ZeroDivisionError")
+        check_close("unboxed exc: accumulator loop after", accumulate([1.0, 2.0, 4.0]), 1.75)
+    except Exception as e:
+        print(f"  [FAIL] unboxed local exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 95: inline refcounting on the raising path
+    # =========================================================================
+    print("\n--- Test 95: Inline Refcount Exceptions ---")
+    try:
+        # The inline increfs and decrefs of a body that raises leave every
+        # count where it was, on the raising path and the normal one
+        @jit(mode='object')
+        def pair_then_raise(x, fail):
+            pair = (x, x)
+            first = pair[0]
+            if fail:
+                return first + None
+            return first
+
+        held = object()
+        before = sys.getrefcount(held)
+        check("inline refcount exc: raises", raised(pair_then_raise, held, True), "TypeError")
+        check("inline refcount exc: balanced after a raise", sys.getrefcount(held), before)
+        check("inline refcount exc: returns", pair_then_raise(held, False) is held, True)
+        check("inline refcount exc: balanced after a return", sys.getrefcount(held), before)
+    except Exception as e:
+        print(f"  [FAIL] inline refcount exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 96: elided refcount pairs on the raising path
+    # =========================================================================
+    print("\n--- Test 96: Refcount Elision Exceptions ---")
+    try:
+        # Locals borrowed by elided incref/decref pairs keep their counts
+        # when the body raises with them on the stack
+        @jit(mode='object')
+        def borrow_then_raise(x, items):
+            y = x
+            items.append(y)
+            return y + None
+
+        held = object()
+        sink = []
+        before = sys.getrefcount(held)
+        check("elision exc: raises", raised(borrow_then_raise, held, sink), "TypeError")
+        sink.clear()
+        check("elision exc: balanced", sys.getrefcount(held), before)
+    except Exception as e:
+        print(f"  [FAIL] refcount elision exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 97: inline FOR_ITER loops raising
+    # =========================================================================
+    print("\n--- Test 97: FOR_ITER Exceptions ---")
+    try:
+        # An error in the body leaves the inline loop, and an iterator that
+        # raises stops the loop with its exception
+        def failing_iter():
+            yield 1
+            raise RuntimeError("iterator failed")
+
+        @jit(mode='object')
+        def sum_items(items):
+            total = 0
+            for item in items:
+                total += item
+            return total
+
+        check("for_iter exc: list loop body raises", raised(sum_items, [1, 2, "x"]), "TypeError")
+        check("for_iter exc: tuple loop body raises", raised(sum_items, (1, None)), "TypeError")
+        check("for_iter exc: iterator raises", raised(sum_items, failing_iter()), "RuntimeError")
+        check("for_iter exc: loops after", (sum_items([1, 2]), sum_items(range(4))), (3, 6))
+    except Exception as e:
+        print(f"  [FAIL] FOR_ITER exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 98: subscript fast paths raising
+    # =========================================================================
+    print("\n--- Test 98: Subscript Exceptions ---")
+    try:
+        # The list, tuple, dict and bytearray fast paths raise CPython's errors
+        @jit(mode='object')
+        def get_item(c, k):
+            return c[k]
+
+        @jit(mode='object')
+        def set_item(c, k, v):
+            c[k] = v
+
+        check("subscript exc: list index", raised(get_item, [1, 2], 5), "IndexError")
+        check("subscript exc: tuple index", raised(get_item, (1,), -2), "IndexError")
+        check("subscript exc: dict key", raised(get_item, {"a": 1}, "b"), "KeyError")
+        check("subscript exc: bytearray index", raised(get_item, bytearray(b"ab"), 2), "IndexError")
+        check("subscript exc: list store index", raised(set_item, [1], 3, 0), "IndexError")
+        check("subscript exc: tuple store", raised(set_item, (1,), 0, 0), "TypeError")
+        check("subscript exc: bytearray store range", raised(set_item, bytearray(1), 0, 256), "ValueError")
+    except Exception as e:
+        print(f"  [FAIL] subscript exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 99: fused COMPARE_OP and POP_JUMP raising
+    # =========================================================================
+    print("\n--- Test 99: Fused Compare Exceptions ---")
+    try:
+        # A fused compare-and-branch raises the comparison's error, and the
+        # truth test of a non-bool result raises its own
+        class NoTruth:
+            def __bool__(self):
+                raise ValueError("no truth value")
+
+        class Odd:
+            def __lt__(self, other):
+                return NoTruth()
+
+        @jit(mode='object')
+        def fused_less(a, b):
+            if a < b:
+                return 1
+            return 0
+
+        check("compare exc: unorderable types", raised(fused_less, 1, "x"), "TypeError")
+        check("compare exc: result truth test", raised(fused_less, Odd(), 1), "ValueError")
+        check("compare exc: after", (fused_less(1, 2), fused_less(2.5, 1)), (1, 0))
+    except Exception as e:
+        print(f"  [FAIL] fused compare exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 100: pre-sized BUILD_* raising
+    # =========================================================================
+    print("\n--- Test 100: Pre-sized Build Exceptions ---")
+    try:
+        # An item that raises leaves no half-built container behind, and an
+        # unhashable key raises TypeError
+        @jit(mode='object')
+        def build_all(a, b):
+            return [a, 1 // b], (a, 1 // b), {a: 1 // b}
+
+        @jit(mode='object')
+        def build_map(k):
+            return {k: 1, "z": 2}
+
+        item = object()
+        before = sys.getrefcount(item)
+        check("build exc: item raises", raised(build_all, item, 0), "ZeroDivisionError")
+        check("build exc: built items released", sys.getrefcount(item), before)
+        check("build exc: BUILD_MAP unhashable key", raised(build_map, []), "TypeError")
+        check("build exc: after", build_all(1, 1), ([1, 1], (1, 1), {1: 1}))
+    except Exception as e:
+        print(f"  [FAIL] pre-sized build exception error: {e}")
+        failed += 1
+
+    # =========================================================================
+    # Test 101: type-feedback specialized sites raising
+    # =========================================================================
+    print("\n--- Test 101: Type Feedback Exceptions ---")
+    try:
+        # Specialized from type feedback, a call with other types still
+        # raises the interpreter's error
+        @justjit.jit(mode="object", tier_up_threshold=3, lazy=False)
+        def fb_add(a, b):
+            return a + b
+
+        check("feedback exc: warmup", [fb_add(i, 1) for i in range(3)], [1, 2, 3])
+        justjit._get_compile_executor().submit(lambda: None).result()
+        check("feedback exc: specialized site raises", raised(fb_add, 1, "x"), "TypeError")
+        check("feedback exc: specialized site after", fb_add(2, 3), 5)
+    except Exception as e:
+        print(f"  [FAIL] type feedback exception error: {e}")
+        failed += 1
+
     # =========================================================================
     # Summary
     # =========================================================================
@@ -414,14 +4769,117 @@ def main():
     print("""
 Tests covered:
   - All JIT modes: int, float, int32, float32, complex128, complex64, bool, object
+  - Checked int mode: overflow reruns in the interpreter, checked=False wraps
   - Mode chains: int->float, float->int32, int32->float32
   - Factorial computation
   - LLVM IR generation
   - inline_c: C functions, C->JIT, JIT->C chains
   - ptr mode: array access, ptr->JIT, ptr->C->JIT chains
   - GIL/RAII: acquire/release, parallel work, type conversion, refcount
-  - Generators: countdown, sum
+  - Generators: countdown, sum, native factory with keyword binding, async for over an async generator,
+    JIT coroutines awaiting JIT coroutines
   - Grand pipeline: int->C->float->float32->complex
+  - Shared engine: per-instance symbol namespaces, background compilation
+  - Auto mode: typed-mode inference, object fallback for other argument types
+  - Argument binding: keywords, defaults, *args/**kwargs in native entries and generators
+  - Exceptions: genuine errors propagate without re-running the function
+  - Batch calls: map/reduce over contiguous and strided buffers, parallel=True
+  - prange: parallel sum/max reductions, return inside the loop, float loops
+  - nogil: typed functions called from several threads with the GIL released
+  - Threads: concurrent first calls of auto, lazy and background functions
+  - compile_all: parallel warmup of lazy, background and int32 functions, failed compiles left interpreted
+  - ptr buffers: array.array, memoryview, bytearray arguments; per-format specializations
+  - ndarray mode: 2-D loads/stores, int32/int64 dtypes, strided views, fallback
+  - vector modes: whole-array calls, out= and in-place results, length checks, vec2d/native-width vecq
+  - reductions: ndarray sum/min/max with Python's summation, fastmath dot product, empty input
+  - fast-math: per-flag fastmath= in float/float32 modes, unknown flag names
+  - math: math.*/from-math calls in float, float32 and ndarray modes, vector_library=
+  - output arrays: zeros_like, ndarray kernels allocating their out parameter, out= keyword,
+    overlapping vs disjoint arguments
+  - @jit calls: int self-recursion, float calling float, auto calling int, object calling object
+    directly, rebinding the callee
+  - mixed mode: per-local bool/int/float types, bool arguments and results, tuple returns
+  - static_args: a variant per value of a constant parameter, keyword calls
+  - local arrays: constant tables, local_array scratch, [c] * n, out-of-range index
+  - complex batch calls: map/reduce of complex128/complex64 kernels over interleaved pairs
+  - range loops: expression bounds, negative/variable/zero steps, enumerate(range), nested loops
+  - ndarray bounds checks: IndexError past either end, range loops over extents, boundscheck=True/False
+  - f-strings: single-allocation BUILD_STRING, constant int/float specs, fallback cases
+  - small-int boxing: inline cache hits at -5..256, allocation outside
+  - literal dispatch: if/elif and match chains on ints and strs, float/bool/subclass subjects
+  - class patterns: dataclass/slots subjects, subclasses, __match_args__ changes after caching
+  - unpacking: exact tuple/list fast path, iterables, CPython's length and type errors
+  - dict view loops: items/keys/values over exact dicts, subclasses, duck types, resize and same-size key replacement errors
+  - constant membership: int tuples, str sets, float/bool probes, unboxed loop counters
+  - closures: free variables as guarded constants, rebinding by the enclosing function
+  - with blocks: class managers, threading.Lock, return from the body, missing __exit__
+  - ahead-of-time builds: justjit.aot manifest and objects, load_aot version check
+  - profile warmup: save_profile records compiled functions and static variants, warmup rebuilds them
+  - jit_module: every module function decorated and compiled callees first, exclusions
+  - multi-target AOT: host_supports_cpu, select_target, per-CPU builds picked by load_aot
+  - branch profiles: the profiling tier counts calls, jumps and loop exits for the recompile
+  - on-stack replacement: a hot while loop of an interpreted background call finishes natively
+  - speculation: a failed type guard of the tiered-up code continues the call without rerunning it
+  - jitclass: struct-backed fields loaded and stored by an ndarray kernel, natively compiled methods
+  - RecordArray: per-field columns indexed as arr[i].field in ndarray loops
+  - typed containers: List[int64] append and Dict[int64, float64] lookups done natively in ndarray kernels
+  - bytes parsing: byte indexing, slice views and int.from_bytes over bytes/bytearray in ndarray kernels
+  - str operations: characters, comparisons, in, find/startswith and str slices of PEP 393 data in ndarray kernels
+  - streaming: f.stream() folds and maps over files and mmaps tile by tile, serial and parallel
+  - fusion: justjit.fuse() chains @jit stages into one inlined function and one map loop
+  - pipelines: justjit.pipeline() streams a typed generator through threaded @jit stages
+  - gather: justjit.gather() steps many coroutines in one native loop, parking those on futures
+  - shared cache: a second JIT instance reuses typed machine code compiled by the first
+  - loop regions: a loop compiled alone, the interpreter finishing the call from its exit
+  - loop polls: Ctrl-C and other threads reaching object and int mode loops (poll=)
+  - virtual tuples: BUILD_TUPLE unpacked or tested with `in` in place, tuple-free super() and generator calls
+  - module attributes: `module.attr` cached under the globals epoch, rebinding and deletion seen
+  - shared object bodies: equal code and constants compile once; closures keep their cells and defaults
+  - large generated functions: thousands of blocks get stack depths and compile
+  - compile budgets: over-size functions compile at O0, over-time compiles finish in the background
+  - keyword calls: CALL_KW passes kwnames straight to vectorcall (methods, builtins, **extra, generators)
+  - argument forwarding: f(*args, **kwargs) hands the caller's tuple and dict over without copies
+  - inline builtins: len/abs/min/max/isinstance/int/float lowered inline, rebinding honoured
+  - auto_jit: sys.monitoring call counts compile and rebind hot functions, denylist honoured
+  - Arrow columns: C Data Interface arrays as kernel inputs and outputs, validity bitmaps ANDed per word
+  - foreign arrays: __array_interface__ and DLPack producers shared with kernels, device arrays refused
+  - unboxed lists: list/tuple of floats or ints read by ndarray kernels, other items and stores run as Python
+  - pooled results: allocated kernel outputs come from a 64-byte aligned pool and are reused once released
+  - CUDA batch calls: target='cuda' map/reduce on a GPU via NVPTX, host fallback without a device
+  - NUMA placement: detected node CPU lists, pool size, topology fixed once the pool runs, parallel calls
+  - uint64 mode: masked hash mixing, FNV-1a loops, 128-bit product high words, unsigned compare and division,
+    interpreter fallback, unmasked results rejected (same results interpreted and native), map/reduce over 'Q' buffers
+  - Bit manipulation: bit_count/bit_length (and the trailing-zero idiom) in int/uint64/int32 code,
+    rotl/rotr as rotates, an int-mode rotate past int64 in the interpreter
+  - Half-precision arrays: float16 ('e') and bfloat16 (bfloat16_view) ndarray loads and rounded stores
+  - Matmul: ndarray-mode a @ b as a 1-D dot and tiled out[:] / out[...] matrix products, mismatched
+    shapes and aliased outputs left to Python
+  - Native exceptions: ZeroDivisionError with Python's messages from int, int32, uint64 and float code
+    without an interpreter rerun, in map as well
+  - yield from: JIT sub-generators resumed as delegates (recursive tree walk, return values, send(),
+    errors, close())
+  - Import caches: function-body import / from-import / dotted import resolved per site, invalidated
+    when sys.modules changes
+  - Cached code exceptions: typed code reused from the object cache raises like freshly built code
+  - Method rebinding: native entries bound as methods, class attributes rebound after compile, instance
+    attributes shadowing
+  - Object cache reload: object-mode and generator code (None, constants, closure cells, site caches)
+    reused from set_cache_dir in a second process
+  - Lazy stub exceptions: a first call that raises compiles once and the code keeps working
+  - Target CPU exceptions: code built for a generic CPU raises ZeroDivisionError like host code
+  - Tuned pipeline exceptions: vectorize=False, inline=False, unroll=4 code raises like the default
+  - Vectorcall exceptions: a callee's exception caught in the body or raised to the caller
+  - Global cache exceptions: a global deleted after LOAD_GLOBAL is warm raises NameError
+  - Attribute cache exceptions: an attribute deleted after LOAD_ATTR is warm raises AttributeError
+  - Guarded binary op exceptions: int and float / and % by zero raise ZeroDivisionError
+  - Unboxed local exceptions: a float accumulator loop that raises, then runs again
+  - Inline refcount exceptions: counts balanced after a body raises with a tuple and its items live
+  - Refcount elision exceptions: borrowed locals keep their counts when the body raises
+  - FOR_ITER exceptions: list/tuple loop bodies and generic iterators raising, loops run again after
+  - Subscript exceptions: list/tuple/bytearray index, dict key, tuple store and byte range errors
+  - Fused compare exceptions: unorderable operands and a result whose truth test raises
+  - Pre-sized build exceptions: an item raising mid-BUILD_* releases the others, unhashable map keys
+  - Type feedback exceptions: a site specialized for ints raising TypeError for a str operand
 """)
 
     if failed > 0: